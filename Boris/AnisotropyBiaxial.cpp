@@ -92,6 +92,9 @@ double Anisotropy_Biaxial::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -117,16 +120,23 @@ double Anisotropy_Biaxial::UpdateField(void)
 
 				pMesh->Heff[idx] += Heff_value;
 
-				energy += K1 * (1 - u1*u1) + K2 * b1*b1*b2*b2;
+				double cell_energy = K1 * (1 - u1*u1) + K2 * b1*b1*b2*b2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_energy.linear_size()) Module_energy[idx] = K1 * (1 - u1*u1) + K2 * b1*b1*b2*b2;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -158,7 +168,9 @@ double Anisotropy_Biaxial::UpdateField(void)
 				pMesh->Heff[idx] += Heff_value;
 				pMesh->Heff2[idx] += Heff_value2;
 
-				energy += (K1_AFM.i * (1 - u1_A*u1_A) + K2_AFM.i * b1_A*b1_A*b2_A*b2_A + K1_AFM.j * (1 - u1_B*u1_B) + K2_AFM.j * b1_B*b1_B*b2_B*b2_B) / 2;
+				double cell_energy = (K1_AFM.i * (1 - u1_A*u1_A) + K2_AFM.i * b1_A*b1_A*b2_A*b2_A + K1_AFM.j * (1 - u1_B*u1_B) + K2_AFM.j * b1_B*b1_B*b2_B*b2_B) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Heff_value2;
@@ -166,6 +178,8 @@ double Anisotropy_Biaxial::UpdateField(void)
 				if (Module_energy2.linear_size()) Module_energy2[idx] = K1_AFM.j * (1 - u1_B*u1_B) + K2_AFM.j * b1_B*b1_B*b2_B*b2_B;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	if (pMesh->M.get_nonempty_cells()) energy /= pMesh->M.get_nonempty_cells();
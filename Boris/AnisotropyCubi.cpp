@@ -97,10 +97,16 @@ double Anisotropy_Cubic::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				double Ms = pMesh->Ms;
 				double K1 = pMesh->K1;
@@ -142,20 +148,37 @@ double Anisotropy_Cubic::UpdateField(void)
 				pMesh->Heff[idx] += Heff_value;
 
 				//update energy (E/V)
-				energy += K1 * (d1*d1*d2*d2 + d1*d1*d3*d3 + d2*d2*d3*d3) + K2 * d123*d123;
+				double cell_energy = K1 * (d1*d1*d2*d2 + d1*d1*d3*d3 + d2*d2*d3*d3) + K2 * d123*d123;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_energy.linear_size()) Module_energy[idx] = K1 * (d1*d1*d2*d2 + d1*d1*d3*d3 + d2*d2*d3*d3) + K2 * d123*d123;
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				DBL2 Ms_AFM = pMesh->Ms_AFM;
 				DBL2 K1_AFM = pMesh->K1_AFM;
@@ -228,14 +251,25 @@ double Anisotropy_Cubic::UpdateField(void)
 				pMesh->Heff2[idx] += Heff_value2;
 
 				//update energy (E/V)
-				energy += (K1_AFM.i * (d1*d1*d2*d2 + d1*d1*d3*d3 + d2*d2*d3*d3) + K2_AFM.i * d123*d123 + K1_AFM.j * (d1B*d1B*d2B*d2B + d1B*d1B*d3B*d3B + d2B*d2B*d3B*d3B) + K2_AFM.j * d123B*d123B) / 2;
+				double cell_energy = (K1_AFM.i * (d1*d1*d2*d2 + d1*d1*d3*d3 + d2*d2*d3*d3) + K2_AFM.i * d123*d123 + K1_AFM.j * (d1B*d1B*d2B*d2B + d1B*d1B*d3B*d3B + d2B*d2B*d3B*d3B) + K2_AFM.j * d123B*d123B) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Heff_value2;
 				if (Module_energy.linear_size()) Module_energy[idx] = K1_AFM.i * (d1*d1*d2*d2 + d1 * d1*d3*d3 + d2 * d2*d3*d3) + K2_AFM.i * d123*d123;
 				if (Module_energy2.linear_size()) Module_energy2[idx] = K2_AFM.i * d123*d123 + K1_AFM.j * (d1B*d1B*d2B*d2B + d1B * d1B*d3B*d3B + d2B * d2B*d3B*d3B) + K2_AFM.j * d123B*d123B;
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	if (pMesh->M.get_nonempty_cells()) energy /= pMesh->M.get_nonempty_cells();
@@ -88,6 +88,9 @@ double Anisotropy_Tensorial::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -135,16 +138,23 @@ double Anisotropy_Tensorial::UpdateField(void)
 				
 				pMesh->Heff[idx] += Heff_value;
 
-				energy += energy_;
+				double cell_energy = energy_;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_energy.linear_size()) Module_energy[idx] = energy_;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -226,7 +236,9 @@ double Anisotropy_Tensorial::UpdateField(void)
 				pMesh->Heff[idx] += Heff_value;
 				pMesh->Heff2[idx] += Heff_value2;
 
-				energy += (energy_ + energy2_) / 2;
+				double cell_energy = (energy_ + energy2_) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Heff_value2;
@@ -234,6 +246,8 @@ double Anisotropy_Tensorial::UpdateField(void)
 				if (Module_energy2.linear_size()) Module_energy2[idx] = energy2_;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	if (pMesh->M.get_nonempty_cells()) energy /= pMesh->M.get_nonempty_cells();
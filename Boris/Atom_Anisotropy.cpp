@@ -84,6 +84,9 @@ double Atom_Anisotropy_Uniaxial::UpdateField(void)
 {
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -103,12 +106,16 @@ double Atom_Anisotropy_Uniaxial::UpdateField(void)
 
 			paMesh->Heff1[idx] += Heff_value;
 
-			energy += (K1 + K2 * (1 - dotprod * dotprod)) * (1 - dotprod * dotprod);
+			double cell_energy = (K1 + K2 * (1 - dotprod * dotprod)) * (1 - dotprod * dotprod);
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 			if (Module_energy.linear_size()) Module_energy[idx] = (K1 + K2 * (1 - dotprod * dotprod)) * (1 - dotprod * dotprod) / paMesh->M1.h.dim();
 		}
 	}
+
+	if (deterministic) energy = energy_reduction.sum();
 	
 	//convert to energy density and return
 	if (non_empty_volume) this->energy = energy / non_empty_volume;
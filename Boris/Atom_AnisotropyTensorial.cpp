@@ -84,6 +84,9 @@ double Atom_Anisotropy_Tensorial::UpdateField(void)
 {
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -134,13 +137,17 @@ double Atom_Anisotropy_Tensorial::UpdateField(void)
 
 			paMesh->Heff1[idx] += Heff_value;
 
-			energy += energy_;
+			double cell_energy = energy_;
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 			if (Module_energy.linear_size()) Module_energy[idx] = energy_ / paMesh->M1.h.dim();
 		}
 	}
 
+	if (deterministic) energy = energy_reduction.sum();
+
 	//convert to energy density and return
 	if (non_empty_volume) this->energy = energy / non_empty_volume;
 	else this->energy = 0.0;
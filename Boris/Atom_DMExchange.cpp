@@ -86,6 +86,9 @@ double Atom_DMExchange::UpdateField(void)
 {
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -103,7 +106,9 @@ double Atom_DMExchange::UpdateField(void)
 			paMesh->Heff1[idx] += (Hexch_A + Hexch_D);
 
 			//update energy E = -mu_s * Bex
-			energy += paMesh->M1[idx] * (Hexch_A + Hexch_D);
+			double cell_energy = paMesh->M1[idx] * (Hexch_A + Hexch_D);
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			//spatial dependence display of effective field and energy density
 			if (Module_Heff.linear_size() && Module_energy.linear_size()) {
@@ -124,6 +129,8 @@ double Atom_DMExchange::UpdateField(void)
 		}
 	}
 
+	if (deterministic) energy = energy_reduction.sum();
+
 	//convert to energy density and return. Divide by two since in the Hamiltonian the sum is performed only once for every pair of spins, but if you use the M.H expression each sum appears twice.
 	//Also note, this energy density is not the same as the micromagnetic one, due to different zero-energy points.
 	if (non_empty_volume) this->energy = -MUB_MU0 * energy / (2*non_empty_volume);
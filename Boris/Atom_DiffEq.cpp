@@ -31,4 +31,30 @@ Atom_DifferentialEquation::~Atom_DifferentialEquation()
 	}
 	pameshODECUDA = nullptr;
 #endif
-}
\ No newline at end of file
+}
+
+//---------------------------------------- BULK THERMAL VECs GENERATION
+
+//generate Gaussian deviates for given number of thermal VECs, for all stochastic cells, in one pass with the counter-based prng (current step)
+void Atom_DifferentialEquation::GenerateThermalDeviates(int num_vecs, int num_cells)
+{
+	if (thermal_deviates.size() != 3 * num_vecs * num_cells) thermal_deviates.resize(3 * num_vecs * num_cells);
+
+	prng.rand_gauss_fill(thermal_deviates.size(), 0, thermal_deviates.data());
+}
+
+//check if thermal_prefactors must be recalculated for given number of thermal VECs, resizing it if so
+bool Atom_DifferentialEquation::ThermalPrefactors_Outdated(int num_vecs, int num_cells)
+{
+	double Temperature = paMesh->GetBaseTemperature();
+
+	//with a temperature VEC the cell temperatures can change at any time
+	if (thermal_prefactors_valid && !paMesh->Temp.linear_size() && thermal_prefactors_temperature == Temperature && thermal_prefactors.size() == num_vecs * num_cells) return false;
+
+	if (thermal_prefactors.size() != num_vecs * num_cells) thermal_prefactors.resize(num_vecs * num_cells);
+
+	thermal_prefactors_valid = true;
+	thermal_prefactors_temperature = Temperature;
+
+	return true;
+}
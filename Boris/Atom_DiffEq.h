@@ -44,6 +44,9 @@ protected:
 	OmpReduction<DBL3> dmdt_av_reduction;
 	OmpReduction<double> lte_reduction;
 
+	//SD (Barzilai-Borwein) and NCG sums packed in a DBL3 (2nd one for sub-lattice B), used only if deterministic reductions are enabled (otherwise an OpenMP reduction clause is used)
+	OmpReduction<DBL3> minimizer_reduction, minimizer_reduction2;
+
 	//Used to save starting atomic moments - all evaluation methods do this, even when not needed by the method itself
 	VEC<DBL3> sM1;
 
@@ -53,8 +56,17 @@ protected:
 	//Thermal field, enabled only for the stochastic equations
 	VEC<DBL3> H_Thermal;
 
-	//random number generator
-	BorisRand prng;
+	//bulk thermal VECs generation : Gaussian deviates for all stochastic cells (3 per cell for each thermal VEC, consecutive for each cell), generated in one pass
+	std::vector<double> thermal_deviates;
+
+	//thermal VECs prefactors for each stochastic cell (one per thermal VEC, consecutive for each cell) excluding the 1 / sqrt(deltaT) factor
+	//these are only recalculated when parameters or the temperature change (always recalculated if a temperature VEC is used)
+	std::vector<double> thermal_prefactors;
+	bool thermal_prefactors_valid = false;
+	double thermal_prefactors_temperature = 0.0;
+
+	//random number generator for thermal fields : counter-based, so results for a given seed do not depend on the number of threads
+	BorisCBRand prng;
 
 	Atom_Mesh *paMesh = nullptr;
 
@@ -177,6 +189,15 @@ protected:
 	virtual void RunRKDP54_Step5(void) = 0;
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	virtual void RunLSRK_Step0_withReductions(void) = 0;
+	virtual void RunLSRK_Step0(void) = 0;
+	virtual void RunLSRK_Step(void) = 0;
+	virtual void RunLSRK_Step4_withReductions(void) = 0;
+	virtual void RunLSRK_Step4(void) = 0;
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	virtual void RunSD_Start(void) = 0;
@@ -189,6 +210,19 @@ protected:
 	virtual void RunSD_Advance(void) = 0;
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	virtual void RunNCG_Reductions(void) = 0;
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	virtual void RunNCG_LineSearch(void) = 0;
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	virtual void RunNCG_Restart(void) = 0;
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	virtual void RunNCG_Direction_withReductions(void) = 0;
+	virtual void RunNCG_Direction(void) = 0;
+#endif
+
 	//---------------------------------------- OTHERS
 
 	//Restore atomic moments after a failed step for adaptive time-step methods
@@ -205,6 +239,12 @@ protected:
 	//called when using stochastic equations
 	virtual void GenerateThermalField(void) = 0;
 
+	//bulk thermal VECs generation : generate Gaussian deviates for given number of thermal VECs, for all stochastic cells
+	void GenerateThermalDeviates(int num_vecs, int num_cells);
+
+	//bulk thermal VECs generation : check if thermal_prefactors must be recalculated for given number of thermal VECs, resizing it if so
+	bool ThermalPrefactors_Outdated(int num_vecs, int num_cells);
+
 	//---------------------------------------- SET-UP METHODS
 
 	//allocate memory depending on set evaluation method - also cleans up previously allocated memory by calling CleanupMemory();
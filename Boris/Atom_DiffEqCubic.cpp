@@ -131,9 +131,27 @@ BError Atom_DifferentialEquationCubic::AllocateMemory(void)
 		if (!sEval6.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
 
+	case EVAL_LSRK4:
+		if (!sEval0.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+	case EVAL_LSRK43:
+		if (!sEval0.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+	//IMEX method is only implemented for ferromagnetic meshes
+	case EVAL_IMEX:
+		return error(BERROR_NOTAVAILABLE);
+
 	case EVAL_SD:
 		if (!sEval0.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
+
+	case EVAL_NCG:
+		if (!sEval0.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(paMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
 	}
 
 	//For stochastic equations must also allocate memory for thermal VECs
@@ -147,6 +165,9 @@ BError Atom_DifferentialEquationCubic::AllocateMemory(void)
 		break;
 	}
 
+	//seed the thermal field generator : if prng_seed > 0 the same sequence is generated every time, else use the system tick count
+	if (H_Thermal.linear_size()) prng.seed(paMesh->prng_seed == 0 ? GetSystemTickCount() : paMesh->prng_seed);
+
 	//----------------------- CUDA mirroring
 
 #if COMPILECUDA == 1
@@ -171,7 +192,10 @@ void Atom_DifferentialEquationCubic::CleanupMemory(void)
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKDP54 &&
 		evalMethod != EVAL_RKF56 &&
-		evalMethod != EVAL_SD) {
+		evalMethod != EVAL_LSRK4 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_SD &&
+		evalMethod != EVAL_NCG) {
 
 		sEval0.clear();
 	}
@@ -182,7 +206,9 @@ void Atom_DifferentialEquationCubic::CleanupMemory(void)
 		evalMethod != EVAL_RKF45 &&
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKF56 &&
-		evalMethod != EVAL_RKDP54) {
+		evalMethod != EVAL_RKDP54 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_NCG) {
 
 		sEval1.clear();
 	}
@@ -238,11 +264,20 @@ BError Atom_DifferentialEquationCubic::UpdateConfiguration(UPDATECONFIG_ cfgMess
 {
 	BError error(CLASS_STR(Atom_DifferentialEquationCubic));
 
+	//parameters, temperature or mesh may have changed : thermal VECs prefactors must be recalculated
+	thermal_prefactors_valid = false;
+
 	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_MESHCHANGE, UPDATECONFIG_ODE_SOLVER)) {
 
 		error = AllocateMemory();
 	}
 
+	//prng seed changed : restart the thermal field generator from the new seed at step 0 (also done when thermal VECs are allocated)
+	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_PRNG)) {
+
+		if (H_Thermal.linear_size()) prng.seed(paMesh->prng_seed == 0 ? GetSystemTickCount() : paMesh->prng_seed);
+	}
+
 	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_ODE_MOVEMESH)) {
 
 		/*
@@ -125,6 +125,15 @@ public:
 	void RunRKDP54_Step5(void);
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	void RunLSRK_Step0_withReductions(void);
+	void RunLSRK_Step0(void);
+	void RunLSRK_Step(void);
+	void RunLSRK_Step4_withReductions(void);
+	void RunLSRK_Step4(void);
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	void RunSD_Start(void);
@@ -137,6 +146,19 @@ public:
 	void RunSD_Advance(void);
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	void RunNCG_Reductions(void);
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	void RunNCG_LineSearch(void);
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	void RunNCG_Restart(void);
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	void RunNCG_Direction_withReductions(void);
+	void RunNCG_Direction(void);
+#endif
+
 	//---------------------------------------- EQUATIONS : Atom_DiffEqCubic_Equations.cpp and Atom_DiffEqCubic_SEquations.cpp
 
 	//Landau-Lifshitz-Gilbert equation
@@ -180,7 +202,7 @@ public:
 	//---------------------------------------- SET-UP METHODS
 
 	BError UpdateConfiguration(UPDATECONFIG_ cfgMessage);
-	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) {}
+	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) { thermal_prefactors_valid = false; }
 
 	//switch CUDA state on/off
 	BError SwitchCUDAState(bool cudaState);
@@ -311,6 +333,15 @@ public:
 	void RunRKDP54_Step5(void) {}
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	void RunLSRK_Step0_withReductions(void) {}
+	void RunLSRK_Step0(void) {}
+	void RunLSRK_Step(void) {}
+	void RunLSRK_Step4_withReductions(void) {}
+	void RunLSRK_Step4(void) {}
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	void RunSD_Start(void) {}
@@ -323,6 +354,19 @@ public:
 	void RunSD_Advance(void) {}
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	void RunNCG_Reductions(void) {}
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	void RunNCG_LineSearch(void) {}
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	void RunNCG_Restart(void) {}
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	void RunNCG_Direction_withReductions(void) {}
+	void RunNCG_Direction(void) {}
+#endif
+
 	//---------------------------------------- EQUATIONS : Atom_DiffEqCubic_Equations.cpp and Atom_DiffEqCubic_SEquations.cpp
 
 	//Landau-Lifshitz-Gilbert equation
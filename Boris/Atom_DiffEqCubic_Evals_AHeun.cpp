@@ -12,7 +12,7 @@
 
 void Atom_DifferentialEquationCubic::RunAHeun_Step0_withReductions(void)
 {
-	mxh_av_reduction.new_average_reduction();
+	mxh_av_reduction.new_average_reduction(paMesh->n.dim());
 
 	//Trapezoidal Euler can be used for stochastic equations - generate thermal VECs at the start
 	if (H_Thermal.linear_size()) GenerateThermalField();
@@ -32,7 +32,7 @@ void Atom_DifferentialEquationCubic::RunAHeun_Step0_withReductions(void)
 
 				//obtained average normalized torque term
 				double Mnorm = paMesh->M1[idx].norm();
-				mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm));
+				mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm), idx);
 
 				//First evaluate RHS of set equation at the current time step
 				DBL3 rhs = CALLFP(this, equation)(idx);
@@ -79,7 +79,7 @@ void Atom_DifferentialEquationCubic::RunAHeun_Step0(void)
 
 void Atom_DifferentialEquationCubic::RunAHeun_Step1_withReductions(void)
 {
-	dmdt_av_reduction.new_average_reduction();
+	dmdt_av_reduction.new_average_reduction(paMesh->n.dim());
 	lte_reduction.new_minmax_reduction();
 
 	//multiplicative conversion factor from atomic moment (units of muB) to A/m
@@ -114,7 +114,7 @@ void Atom_DifferentialEquationCubic::RunAHeun_Step1_withReductions(void)
 
 				//obtained average dmdt term
 				double Mnorm = paMesh->M1[idx].norm();
-				dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm));
+				dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm), idx);
 			}
 		}
 	}
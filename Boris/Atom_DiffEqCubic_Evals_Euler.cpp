@@ -12,8 +12,8 @@
 
 void Atom_DifferentialEquationCubic::RunEuler_withReductions(void)
 {
-	mxh_av_reduction.new_average_reduction();
-	dmdt_av_reduction.new_average_reduction();
+	mxh_av_reduction.new_average_reduction(paMesh->n.dim());
+	dmdt_av_reduction.new_average_reduction(paMesh->n.dim());
 
 	//Euler can be used for stochastic equations
 	if (H_Thermal.linear_size()) GenerateThermalField();
@@ -33,7 +33,7 @@ void Atom_DifferentialEquationCubic::RunEuler_withReductions(void)
 
 				//obtained average normalized torque term
 				double Mnorm = paMesh->M1[idx].norm();
-				mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm));
+				mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm), idx);
 
 				//First evaluate RHS of set equation at the current time step
 				DBL3 rhs = CALLFP(this, equation)(idx);
@@ -48,7 +48,7 @@ void Atom_DifferentialEquationCubic::RunEuler_withReductions(void)
 					paMesh->M1[idx].renormalize(mu_s);
 				}
 
-				dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm));
+				dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm), idx);
 			}
 		}
 	}
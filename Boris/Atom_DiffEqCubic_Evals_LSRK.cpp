@@ -0,0 +1,207 @@
+#include "stdafx.h"
+#include "Atom_DiffEqCubic.h"
+
+#ifdef MESH_COMPILATION_ATOM_CUBIC
+#ifdef ODE_EVAL_COMPILATION_LSRK
+
+#include "Atom_Mesh_Cubic.h"
+#include "SuperMesh.h"
+#include "Atom_MeshParamsControl.h"
+
+//--------------------------------------------- LOW-STORAGE RUNGE KUTTA (2N storage, 4th order solution, 3rd order embedded error for LSRK43)
+
+//sEval0 is the 2N register (dM), sEval1 accumulates the error estimate (adaptive method only). Moment is advanced in place at every stage.
+
+void Atom_DifferentialEquationCubic::RunLSRK_Step0_withReductions(void)
+{
+	bool adaptive = (evalMethod == EVAL_LSRK43);
+
+	mxh_reduction.new_minmax_reduction();
+
+	//multiplicative conversion factor from atomic moment (units of muB) to A/m
+	double conversion = MUB / paMesh->h.dim();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx)) {
+
+			//Save current moment for later use
+			sM1[idx] = paMesh->M1[idx];
+
+			if (!paMesh->M1.is_skipcell(idx)) {
+
+				//obtain maximum normalized torque term
+				double Mnorm = paMesh->M1[idx].norm();
+				double _mxh = GetMagnitude(paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm);
+				mxh_reduction.reduce_max(_mxh);
+
+				//First evaluate RHS of set equation at the current time step
+				DBL3 rhs = CALLFP(this, equation)(idx) * dT;
+
+				//first stage : lsrk_A[0] is zero so register is just set
+				sEval0[idx] = rhs;
+				if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+				paMesh->M1[idx] += lsrk_B[0] * sEval0[idx];
+			}
+		}
+	}
+
+	if (paMesh->grel.get0()) {
+
+		mxh_reduction.maximum();
+	}
+	else {
+
+		mxh_reduction.max = 0.0;
+	}
+}
+
+void Atom_DifferentialEquationCubic::RunLSRK_Step0(void)
+{
+	bool adaptive = (evalMethod == EVAL_LSRK43);
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx)) {
+
+			//Save current moment for later use
+			sM1[idx] = paMesh->M1[idx];
+
+			if (!paMesh->M1.is_skipcell(idx)) {
+
+				//First evaluate RHS of set equation at the current time step
+				DBL3 rhs = CALLFP(this, equation)(idx) * dT;
+
+				//first stage : lsrk_A[0] is zero so register is just set
+				sEval0[idx] = rhs;
+				if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+				paMesh->M1[idx] += lsrk_B[0] * sEval0[idx];
+			}
+		}
+	}
+}
+
+void Atom_DifferentialEquationCubic::RunLSRK_Step(void)
+{
+	bool adaptive = (evalMethod == EVAL_LSRK43);
+
+	//intermediate stage coefficients
+	double A = lsrk_A[evalStep], B = lsrk_B[evalStep], E = lsrk_E[evalStep];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			DBL3 rhs = CALLFP(this, equation)(idx) * dT;
+
+			sEval0[idx] = A * sEval0[idx] + rhs;
+			if (adaptive) sEval1[idx] += E * rhs;
+
+			paMesh->M1[idx] += B * sEval0[idx];
+		}
+	}
+}
+
+void Atom_DifferentialEquationCubic::RunLSRK_Step4_withReductions(void)
+{
+	bool adaptive = (evalMethod == EVAL_LSRK43);
+
+	dmdt_reduction.new_minmax_reduction();
+	if (adaptive) lte_reduction.new_minmax_reduction();
+
+	//multiplicative conversion factor from atomic moment (units of muB) to A/m
+	double conversion = MUB / paMesh->h.dim();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx)) {
+
+			if (!paMesh->M1.is_skipcell(idx)) {
+
+				DBL3 rhs = CALLFP(this, equation)(idx) * dT;
+
+				//last stage : 4th order evaluation
+				sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+				paMesh->M1[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+
+				if (adaptive) {
+
+					//local truncation error (difference between 4th and 3rd order evaluations)
+					double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / paMesh->M1[idx].norm();
+					lte_reduction.reduce_max(_lte);
+				}
+
+				if (renormalize) {
+
+					double mu_s = paMesh->mu_s;
+					paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s);
+					paMesh->M1[idx].renormalize(mu_s);
+				}
+
+				//obtained maximum dmdt term
+				double Mnorm = paMesh->M1[idx].norm();
+				double _dmdt = GetMagnitude(paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm);
+				dmdt_reduction.reduce_max(_dmdt);
+			}
+		}
+	}
+
+	if (paMesh->grel.get0()) {
+
+		dmdt_reduction.maximum();
+	}
+	else {
+
+		dmdt_reduction.max = 0.0;
+	}
+
+	if (adaptive) lte_reduction.maximum();
+}
+
+void Atom_DifferentialEquationCubic::RunLSRK_Step4(void)
+{
+	bool adaptive = (evalMethod == EVAL_LSRK43);
+
+	if (adaptive) lte_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx)) {
+
+			if (!paMesh->M1.is_skipcell(idx)) {
+
+				DBL3 rhs = CALLFP(this, equation)(idx) * dT;
+
+				//last stage : 4th order evaluation
+				sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+				paMesh->M1[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+
+				if (adaptive) {
+
+					//local truncation error (difference between 4th and 3rd order evaluations)
+					double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / paMesh->M1[idx].norm();
+					lte_reduction.reduce_max(_lte);
+				}
+
+				if (renormalize) {
+
+					double mu_s = paMesh->mu_s;
+					paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s);
+					paMesh->M1[idx].renormalize(mu_s);
+				}
+			}
+		}
+	}
+
+	if (adaptive) lte_reduction.maximum();
+}
+
+#endif
+#endif
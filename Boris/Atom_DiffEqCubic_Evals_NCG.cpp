@@ -0,0 +1,195 @@
+#include "stdafx.h"
+#include "Atom_DiffEqCubic.h"
+
+#ifdef MESH_COMPILATION_ATOM_CUBIC
+#ifdef ODE_EVAL_COMPILATION_NCG
+
+#include "Atom_Mesh_Cubic.h"
+#include "SuperMesh.h"
+#include "Atom_MeshParamsControl.h"
+
+//Nonlinear conjugate gradient solver (Polak-Ribiere+) on the product of unit spheres.
+//The steepest descent direction is the tangential field D = (gamma/2) * grel * (H - (H.m)m), same scaling as for the SD solver so dT has the same meaning.
+//The previous search direction is transported to the current point by projection on the tangent plane, and moments are moved along the search direction followed by renormalization (retraction).
+//Line search uses the directional derivative to choose the step, and the total energy density to check the accepted step decreases the energy (else backtrack along the steepest descent direction).
+
+//sEval0 : steepest descent direction at the line search start point, sEval1 : search direction, sM1 : normalized moment at the line search start point
+
+//--------------------------------------------- Nonlinear Conjugate Gradient Solver
+
+//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities
+void Atom_DifferentialEquationCubic::RunNCG_Reductions(void)
+{
+	double _ncg_DD = 0.0;
+	double _ncg_DDprev = 0.0;
+	double _ncg_Ddir = 0.0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) minimizer_reduction.new_sum_reduction(paMesh->n.dim());
+
+#pragma omp parallel for reduction(+:_ncg_DD, _ncg_DDprev, _ncg_Ddir)
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			double mu_s = paMesh->mu_s;
+			double grel = paMesh->grel;
+			paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s, paMesh->grel, grel);
+
+			DBL3 m = paMesh->M1[idx] / mu_s;
+			DBL3 H = paMesh->Heff1[idx];
+
+			//steepest descent direction
+			DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+			//search direction transported to current point
+			DBL3 d = sEval1[idx] - (sEval1[idx] * m) * m;
+
+			if (deterministic) minimizer_reduction.reduce_sum(DBL3(D * D, D * sEval0[idx], D * d), idx);
+			else {
+
+				_ncg_DD += D * D;
+				_ncg_DDprev += D * sEval0[idx];
+				_ncg_Ddir += D * d;
+			}
+		}
+	}
+
+	if (deterministic) {
+
+		DBL3 sums = minimizer_reduction.sum();
+		_ncg_DD = sums.x;
+		_ncg_DDprev = sums.y;
+		_ncg_Ddir = sums.z;
+	}
+
+	//accumulate across all meshes -> remember these should have been set to zero before starting a run across all meshes
+	ncg_DD += _ncg_DD;
+	ncg_DDprev += _ncg_DDprev;
+	ncg_Ddir += _ncg_Ddir;
+}
+
+//2. line search refinement : set moments at step dT along the search direction from the line search start point
+void Atom_DifferentialEquationCubic::RunNCG_LineSearch(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			double mu_s = paMesh->mu_s;
+			paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s);
+
+			paMesh->M1[idx] = (sM1[idx] + dT * sEval1[idx]) * mu_s;
+			paMesh->M1[idx].renormalize(mu_s);
+		}
+	}
+}
+
+//2b. line search failed : set steepest descent search direction at the line search start point, and set moments at step dT along it
+void Atom_DifferentialEquationCubic::RunNCG_Restart(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			double mu_s = paMesh->mu_s;
+			paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s);
+
+			sEval1[idx] = sEval0[idx];
+
+			paMesh->M1[idx] = (sM1[idx] + dT * sEval1[idx]) * mu_s;
+			paMesh->M1[idx].renormalize(mu_s);
+		}
+	}
+}
+
+//3. start new line search from the current moments
+void Atom_DifferentialEquationCubic::RunNCG_Direction_withReductions(void)
+{
+	mxh_reduction.new_minmax_reduction();
+	if (calculate_dmdt) dmdt_reduction.new_minmax_reduction();
+
+	//multiplicative conversion factor from atomic moment (units of muB) to A/m
+	double conversion = MUB / paMesh->h.dim();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			double mu_s = paMesh->mu_s;
+			double grel = paMesh->grel;
+			paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s, paMesh->grel, grel);
+
+			DBL3 m = paMesh->M1[idx] / mu_s;
+			DBL3 H = paMesh->Heff1[idx];
+
+			//obtained maximum normalized torque term
+			if (IsNZ(grel)) {
+
+				double _mxh = GetMagnitude(m ^ H) / (conversion * paMesh->M1[idx].norm());
+				mxh_reduction.reduce_max(_mxh);
+			}
+
+			//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+			DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+			DBL3 d = D;
+			if (ncg_beta) d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+
+			sEval0[idx] = D;
+			sEval1[idx] = d;
+			sM1[idx] = m;
+
+			//trial step along search direction
+			paMesh->M1[idx] = (m + dT * d) * mu_s;
+			paMesh->M1[idx].renormalize(mu_s);
+
+			if (calculate_dmdt && IsNZ(grel)) {
+
+				//obtained maximum dmdt term
+				double _dmdt = GetMagnitude(paMesh->M1[idx] / mu_s - m) / (dT * GAMMA * grel * conversion * mu_s);
+				dmdt_reduction.reduce_max(_dmdt);
+			}
+		}
+	}
+
+	mxh_reduction.maximum();
+	if (calculate_dmdt) dmdt_reduction.maximum();
+}
+
+void Atom_DifferentialEquationCubic::RunNCG_Direction(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+
+		if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+
+			double mu_s = paMesh->mu_s;
+			double grel = paMesh->grel;
+			paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s, paMesh->grel, grel);
+
+			DBL3 m = paMesh->M1[idx] / mu_s;
+			DBL3 H = paMesh->Heff1[idx];
+
+			//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+			DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+			DBL3 d = D;
+			if (ncg_beta) d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+
+			sEval0[idx] = D;
+			sEval1[idx] = d;
+			sM1[idx] = m;
+
+			//trial step along search direction
+			paMesh->M1[idx] = (m + dT * d) * mu_s;
+			paMesh->M1[idx].renormalize(mu_s);
+		}
+	}
+}
+
+#endif
+#endif
@@ -19,7 +19,7 @@ void Atom_DifferentialEquationCubic::RunRK4_Step0_withReductions(void)
 
 	if (stochastic) {
 
-		mxh_av_reduction.new_average_reduction();
+		mxh_av_reduction.new_average_reduction(paMesh->n.dim());
 
 		//multiplicative conversion factor from atomic moment (units of muB) to A/m
 		double conversion = MUB / paMesh->h.dim();
@@ -36,7 +36,7 @@ void Atom_DifferentialEquationCubic::RunRK4_Step0_withReductions(void)
 
 					//obtained maximum normalized torque term
 					double Mnorm = paMesh->M1[idx].norm();
-					mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm));
+					mxh_av_reduction.reduce_average((paMesh->M1[idx] ^ paMesh->Heff1[idx]) / (conversion * Mnorm * Mnorm), idx);
 
 					//First evaluate RHS of set equation at the current time step
 					sEval0[idx] = CALLFP(this, equation)(idx);
@@ -161,7 +161,7 @@ void Atom_DifferentialEquationCubic::RunRK4_Step3_withReductions(void)
 
 	if (stochastic) {
 
-		dmdt_av_reduction.new_average_reduction();
+		dmdt_av_reduction.new_average_reduction(paMesh->n.dim());
 
 		//multiplicative conversion factor from atomic moment (units of muB) to A/m
 		double conversion = MUB / paMesh->h.dim();
@@ -188,7 +188,7 @@ void Atom_DifferentialEquationCubic::RunRK4_Step3_withReductions(void)
 
 					//obtained maximum dmdt term
 					double Mnorm = paMesh->M1[idx].norm();
-					dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm));
+					dmdt_av_reduction.reduce_average((paMesh->M1[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * conversion * Mnorm), idx);
 				}
 			}
 		}
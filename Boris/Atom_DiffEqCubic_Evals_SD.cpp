@@ -87,6 +87,9 @@ void Atom_DifferentialEquationCubic::RunSD_BB(void)
 	double _delta_G_sq = 0.0;
 	double _delta_m_dot_delta_G = 0.0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) minimizer_reduction.new_sum_reduction(paMesh->n.dim());
+
 	//set new magnetization vectors
 #pragma omp parallel for reduction(+:_delta_m_sq, _delta_G_sq, _delta_m_dot_delta_G)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
@@ -130,13 +133,25 @@ void Atom_DifferentialEquationCubic::RunSD_BB(void)
 				/////////////////////////
 
 				//calculate num and denom for the two Barzilai-Borwein stepsize solutions (see Journal of Numerical Analysis (1988) 8, 141-148) so we can find new stepsize
-				_delta_m_sq += delta_m * delta_m;
-				_delta_G_sq += delta_G * delta_G;
-				_delta_m_dot_delta_G += delta_m * delta_G;
+				if (deterministic) minimizer_reduction.reduce_sum(DBL3(delta_m * delta_m, delta_G * delta_G, delta_m * delta_G), idx);
+				else {
+
+					_delta_m_sq += delta_m * delta_m;
+					_delta_G_sq += delta_G * delta_G;
+					_delta_m_dot_delta_G += delta_m * delta_G;
+				}
 			}
 		}
 	}
 
+	if (deterministic) {
+
+		DBL3 sums = minimizer_reduction.sum();
+		_delta_m_sq = sums.x;
+		_delta_G_sq = sums.y;
+		_delta_m_dot_delta_G = sums.z;
+	}
+
 	//accumulate across all meshes -> remember these should have been set to zero before starting a run across all meshes
 	delta_m_sq += _delta_m_sq;
 	delta_G_sq += _delta_G_sq;
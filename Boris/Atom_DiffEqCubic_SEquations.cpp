@@ -23,29 +23,52 @@ void Atom_DifferentialEquationCubic::GenerateThermalField(void)
 	double deltaT = (link_dTstoch ? dT : GetTime() - time_stoch);
 	time_stoch = GetTime();
 
+	//next step of the counter-based prng
+	prng.advance();
+
 	double grel = paMesh->grel.get0();
 
 	if (IsNZ(grel)) {
 
-		double Temperature = paMesh->GetBaseTemperature();
+		int num_cells = paMesh->n.dim();
 
-#pragma omp parallel for
-		for (int idx = 0; idx < paMesh->n.dim(); idx++) {
+		//1. Gaussian deviates for all cells (bulk counter-based generation)
+		GenerateThermalDeviates(1, num_cells);
+
+		//2. prefactors excluding the 1 / sqrt(deltaT) factor : only recalculated when the temperature or parameters change
+		//set for skip cells too, since these can change during a run (active set relaxation) without the prefactors being recalculated
+		if (ThermalPrefactors_Outdated(1, num_cells)) {
 
-			if (paMesh->M1.is_not_empty(idx) && !paMesh->M1.is_skipcell(idx)) {
+			double base_temperature = paMesh->GetBaseTemperature();
 
-				if (paMesh->Temp.linear_size()) Temperature = paMesh->Temp[H_Thermal.cellidx_to_position(idx)];
+#pragma omp parallel for
+			for (int idx = 0; idx < num_cells; idx++) {
+
+				if (paMesh->M1.is_not_empty(idx)) {
 
-				double mu_s = paMesh->mu_s;
-				double s_eff = paMesh->s_eff;
-				paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s, paMesh->s_eff, s_eff);
+					double Temperature = (paMesh->Temp.linear_size() ? paMesh->Temp[H_Thermal.cellidx_to_position(idx)] : base_temperature);
 
-				//do not include any damping here - this will be included in the stochastic equations
-				double Hth_const = s_eff * sqrt(2 * BOLTZMANN * Temperature / (MUB_MU0 * GAMMA * grel * mu_s * deltaT));
+					double mu_s = paMesh->mu_s;
+					double s_eff = paMesh->s_eff;
+					paMesh->update_parameters_mcoarse(idx, paMesh->mu_s, mu_s, paMesh->s_eff, s_eff);
 
-				H_Thermal[idx] = Hth_const * DBL3(prng.rand_gauss(0, 1), prng.rand_gauss(0, 1), prng.rand_gauss(0, 1));
+					//do not include any damping here - this will be included in the stochastic equations
+					thermal_prefactors[idx] = s_eff * sqrt(2 * BOLTZMANN * Temperature / (MUB_MU0 * GAMMA * grel * mu_s));
+				}
+				else thermal_prefactors[idx] = 0.0;
 			}
 		}
+
+		//3. thermal field
+		double inv_sqrt_deltaT = 1.0 / sqrt(deltaT);
+
+#pragma omp parallel for
+		for (int idx = 0; idx < num_cells; idx++) {
+
+			double Hth_const = thermal_prefactors[idx] * inv_sqrt_deltaT;
+
+			H_Thermal[idx] = Hth_const * DBL3(thermal_deviates[3 * idx], thermal_deviates[3 * idx + 1], thermal_deviates[3 * idx + 2]);
+		}
 	}
 }
 
@@ -9,6 +9,7 @@
 //-----------------------------------Collection of atomistic magnetic meshes
 
 vector_lut<Atom_DifferentialEquation*> Atom_ODECommon::pODE;
+vector_lut<Atom_DifferentialEquation*> Atom_ODECommon::pODE_held;
 
 //-----------------------------------Equation and Evaluation method values
 
@@ -30,6 +31,12 @@ double Atom_ODECommon::delta_m2_sq = 0.0;
 double Atom_ODECommon::delta_G2_sq = 0.0;
 double Atom_ODECommon::delta_m2_dot_delta_G2 = 0.0;
 
+//-----------------------------------Nonlinear Conjugate Gradient Solver
+
+double Atom_ODECommon::ncg_DD = 0.0;
+double Atom_ODECommon::ncg_DDprev = 0.0;
+double Atom_ODECommon::ncg_Ddir = 0.0;
+
 //-----------------------------------CUDA version
 
 #if COMPILECUDA == 1
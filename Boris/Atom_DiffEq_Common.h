@@ -51,6 +51,9 @@ protected:
 	//When a ODE is deleted in a ferromagnetic mesh, DifferentialEquation destructor is called, and it erases the entry n this vector using the unique odeId previously generated.
 	static vector_lut<Atom_DifferentialEquation*> pODE;
 
+	//multi-rate stepping : solvers held while only the micromagnetic meshes are being advanced (swapped in and out of pODE)
+	static vector_lut<Atom_DifferentialEquation*> pODE_held;
+
 	//-----------------------------------Equation and Evaluation method values
 
 	//currently set evaluation method
@@ -74,6 +77,12 @@ protected:
 	static double delta_G_sq, delta_G2_sq;
 	static double delta_m_dot_delta_G, delta_m2_dot_delta_G2;
 
+	//-----------------------------------Nonlinear Conjugate Gradient Solver
+
+	//quantities accumulated across multiple meshes, with D the steepest descent direction at the current magnetization and d the previous search direction transported to the current magnetization:
+	//ncg_DD = D.D, ncg_DDprev = D.Dprev (Dprev is D at the previous line search start point, used for Polak-Ribiere beta), ncg_Ddir = D.d (the directional derivative along the search direction is -ncg_Ddir)
+	static double ncg_DD, ncg_DDprev, ncg_Ddir;
+
 #if COMPILECUDA == 1
 	static Atom_ODECommonCUDA *pODECUDA;
 #endif
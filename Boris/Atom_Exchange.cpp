@@ -86,6 +86,9 @@ double Atom_Exchange::UpdateField(void)
 {
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -101,13 +104,17 @@ double Atom_Exchange::UpdateField(void)
 			paMesh->Heff1[idx] += Heff_value;
 
 			//update energy E = -mu_s * Bex. Will finish off at the end with prefactors.
-			energy += paMesh->M1[idx] * Heff_value;
+			double cell_energy = paMesh->M1[idx] * Heff_value;
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
 			if (Module_energy.linear_size()) Module_energy[idx] = -MUB_MU0 * paMesh->M1[idx] * Heff_value / (2  * paMesh->M1.h.dim());
 		}
 	}
 
+	if (deterministic) energy = energy_reduction.sum();
+
 	//convert to energy density and return. Divide by two since in the Hamiltonian the sum is performed only once for every pair of spins, but if you use the M.H expression each sum appears twice.
 	//Also note, this energy density is not the same as the micromagnetic one, due to different zero-energy points.
 	//To obtain the micromagnetic energy density you also have to subtract the energy density obtained at saturation from the Heisenberg Hamiltonian.
@@ -101,6 +101,9 @@ double Atom_MOptical::UpdateField(void)
 {
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -110,12 +113,16 @@ double Atom_MOptical::UpdateField(void)
 		//magneto-optical field along z direction only : spatial and time dependence set through the usual material parameter mechanism
 		paMesh->Heff1[idx] += DBL3(0, 0, cHmo);
 
-		energy += -MUB * paMesh->M1[idx] * MU0 * DBL3(0, 0, cHmo);
+		double cell_energy = -MUB * paMesh->M1[idx] * MU0 * DBL3(0, 0, cHmo);
+		if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+		else energy += cell_energy;
 
 		if (Module_Heff.linear_size()) Module_Heff[idx] = DBL3(0, 0, cHmo);
 		if (Module_energy.linear_size()) Module_energy[idx] = -MUB * paMesh->M1[idx] * MU0 * DBL3(0, 0, cHmo) / paMesh->M1.h.dim();
 	}
 
+	if (deterministic) energy = energy_reduction.sum();
+
 	//convert to energy density and return
 	if (non_empty_volume) this->energy = energy / non_empty_volume;
 	else this->energy = 0.0;
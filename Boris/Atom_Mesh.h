@@ -58,6 +58,9 @@ public:
 	//Atomic moments in units of Bohr magneton using double floating point precision (first sub-lattice : used in cubic, bcc, fcc, hcp)
 	VEC_VC<DBL3> M1;
 
+	//starting atomic moments state for all replicas in ensemble runs (see SimEnsemble.cpp). Empty if no ensemble run in progress.
+	std::vector<DBL3> ensemble_M1;
+
 	//effective field (units of A/m : easier to integrate with micromagnetic meshes in a multiscale simulation this way) - sum total field of all the added modules (first sub-lattice : used in cubic, bcc, fcc, hcp)
 	VEC<DBL3> Heff1;
 
@@ -213,6 +216,12 @@ public:
 	BError Set_Magnetic_PBC(INT3 pbc_images);
 	INT3 Get_Magnetic_PBC(void) { return INT3(M1.is_pbc_x(), M1.is_pbc_y(), M1.is_pbc_z()); }
 
+	//Ensemble runs : save current moments state as the starting state for all replicas, restore it before a new replica, or free memory at the end of the ensemble run
+	void Ensemble_SaveState(void);
+	void Ensemble_RestoreState(void);
+	void Ensemble_ClearState(void);
+	bool Ensemble_HasState(void) { return MeshBase::Ensemble_HasState() && ensemble_M1.size() == M1.linear_size(); }
+
 	//----------------------------------- MODULES CONTROL (implement MeshBase) : Atom_MeshModules.cpp
 
 	//Add module to list of set modules, also deleting any exclusive modules to this one
@@ -58,4 +58,43 @@ BError Atom_Mesh::Set_Magnetic_PBC(INT3 pbc_images)
 #endif
 
 	return error;
+}
+
+//Ensemble runs : save current moments state, as well as temperature, electrical potential and spin accumulation, as the starting state for all replicas
+void Atom_Mesh::Ensemble_SaveState(void)
+{
+	MeshBase::Ensemble_SaveState();
+
+#if COMPILECUDA == 1
+	if (paMeshCUDA && M1.linear_size()) paMeshCUDA->M1()->copy_to_cpuvec(M1);
+#endif
+
+	ensemble_M1.resize(M1.linear_size());
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M1.size(); idx++) ensemble_M1[idx] = M1[idx];
+}
+
+//Ensemble runs : restore starting moments state, as well as temperature, electrical potential and spin accumulation, before a new replica
+void Atom_Mesh::Ensemble_RestoreState(void)
+{
+	MeshBase::Ensemble_RestoreState();
+
+	//mesh could have been changed since the state was saved
+	if (ensemble_M1.size() != M1.linear_size()) return;
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M1.size(); idx++) M1[idx] = ensemble_M1[idx];
+
+#if COMPILECUDA == 1
+	if (paMeshCUDA && M1.linear_size()) paMeshCUDA->M1()->copy_from_cpuvec(M1);
+#endif
+}
+
+//Ensemble runs : free memory at the end of the ensemble run
+void Atom_Mesh::Ensemble_ClearState(void)
+{
+	MeshBase::Ensemble_ClearState();
+
+	ensemble_M1.clear(); ensemble_M1.shrink_to_fit();
 }
\ No newline at end of file
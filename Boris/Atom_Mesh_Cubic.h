@@ -56,7 +56,7 @@ class Atom_Mesh_Cubic :
 	unsigned,
 	//Members in this derived class
 	bool, SkyrmionTrack, bool,
-	double, double, bool, bool, bool, DBL3,
+	double, double, bool, bool, bool, DBL3, int, bool,
 	//Material Parameters
 	MatP<double, double>, MatP<double, double>, MatP<double, double>, MatP<DBL2, double>,
 	MatP<double, double>, MatP<double, double>, MatP<DBL3, DBL3>, MatP<double, double>, MatP<double, double>,
@@ -129,6 +129,30 @@ private:
 	//TO DO : Direct parallel shuffling is possible but a bit of a pain - probably best to use a bijective hash function to generate random permutations but need to look into this carefully. Probably not worth the effort for CPU code.
 	std::vector<std::pair<double, unsigned>> mc_indices_red, mc_indices_black;
 
+	// MONTE-CARLO LOCAL ENERGY EVALUATOR
+
+	//built at the start of every Monte Carlo step from the set modules : modules with a simple local energy are evaluated together inline (fused), all others through their Get_EnergyChange method
+	//number of fused modules containing the exchange term (MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE)
+	int mc_fused_exchange = 0;
+	//fused bulk (MOD_DMEXCHANGE) and interfacial (MOD_IDMEXCHANGE) DMI
+	bool mc_fused_dmi = false, mc_fused_idmi = false;
+	//fused uniaxial anisotropy (MOD_ANIUNI) and demag_N (MOD_DEMAG_N)
+	bool mc_fused_aniuni = false, mc_fused_demagn = false;
+	//fused Zeeman (MOD_ZEEMAN) if a uniform applied field is set, with the applied field value for the current step
+	bool mc_fused_zeeman = false;
+	DBL3 mc_zeeman_Ha;
+	//modules not fused
+	std::vector<Modules*> mc_modules_other;
+	//all modules other than exchange have on-site energies only (no DMI or dipolar interactions), so cluster updates are possible
+	bool mc_cluster_allowed = true;
+
+	// MONTE-CARLO CLUSTER UPDATES
+
+	//spins in current cluster are marked with 1 (size n.dim(), all 0 between updates)
+	std::vector<char> mc_cluster_marker;
+	//spins in current cluster, and spins whose neighbors remain to be checked
+	std::vector<int> mc_cluster_spins, mc_cluster_stack;
+
 private:
 
 	//Take a Monte Carlo step in this atomistic mesh : these functions implement the actual algorithms
@@ -137,6 +161,22 @@ private:
 	void Iterate_MonteCarlo_Parallel_Classic(void);
 	void Iterate_MonteCarlo_Parallel_Constrained(void);
 
+	//over-relaxation sweep and Wolff-type cluster update, taken after the Metropolis step if enabled
+	void Iterate_MonteCarlo_OverRelaxation(void);
+	void Iterate_MonteCarlo_Cluster(void);
+
+	//build the Monte Carlo local energy evaluator from the set modules
+	void MonteCarlo_BuildEnergyEvaluator(void);
+
+	//exchange and DMI local field (J) for spin at spin_idx, such that the exchange and DMI energy change for spin direction changed from s_old to s_new is (s_new - s_old) * local field
+	DBL3 MonteCarlo_ExchangeField(int spin_idx);
+
+	//energy change for spin at spin_idx moved to M_new, using the Monte Carlo local energy evaluator
+	double MonteCarlo_EnergyChange(int spin_idx, DBL3 M_new);
+
+	//energy change for spin at spin_idx moved to M_new, without the exchange and DMI contributions
+	double MonteCarlo_EnergyChange_NonExchange(int spin_idx, DBL3 M_new);
+
 public:
 
 	//constructor taking only a SuperMesh pointer (SuperMesh is the owner) only needed for loading : all required values will be set by LoadObjectState method in ProgramState
@@ -9,11 +9,165 @@
 #include "Atom_MeshParamsControl.h"
 #include "SuperMesh.h"
 
+//----------------------------------- MONTE-CARLO LOCAL ENERGY EVALUATOR
+
+//Every trial move requires the energy change from all modules. Instead of a virtual Get_EnergyChange call for each module (each one updating its parameters and normalizing the spins again),
+//modules with a simple local energy are fused : their contributions are evaluated together inline in a single pass, with the exchange and DMI neighbor sums combined in one effective local field.
+//Zeeman is fused only for a uniform applied field (the usual case in Monte Carlo simulations) : with a field equation, field VEC or global field it uses its Get_EnergyChange method, as do all other modules (e.g. surface exchange, demag).
+
+//build the Monte Carlo local energy evaluator from the set modules
+void Atom_Mesh_Cubic::MonteCarlo_BuildEnergyEvaluator(void)
+{
+	mc_fused_exchange = 0;
+	mc_fused_dmi = false;
+	mc_fused_idmi = false;
+	mc_fused_aniuni = false;
+	mc_fused_demagn = false;
+	mc_fused_zeeman = false;
+	mc_modules_other.clear();
+	mc_cluster_allowed = true;
+
+	for (int mod_idx = 0; mod_idx < pMod.size(); mod_idx++) {
+
+		switch (pMod.get_ID_from_index(mod_idx)) {
+
+		case MOD_EXCHANGE:
+			mc_fused_exchange++;
+			break;
+
+		case MOD_DMEXCHANGE:
+			mc_fused_exchange++;
+			mc_fused_dmi = true;
+			mc_cluster_allowed = false;
+			break;
+
+		case MOD_IDMEXCHANGE:
+			mc_fused_exchange++;
+			mc_fused_idmi = true;
+			mc_cluster_allowed = false;
+			break;
+
+		case MOD_ANIUNI:
+			mc_fused_aniuni = true;
+			break;
+
+		case MOD_DEMAG_N:
+			mc_fused_demagn = true;
+			break;
+
+		case MOD_ZEEMAN:
+		{
+			ZeemanBase* pZeeman = dynamic_cast<ZeemanBase*>(pMod[mod_idx]);
+
+			if (pZeeman && pZeeman->IsUniformField()) {
+
+				mc_fused_zeeman = true;
+				mc_zeeman_Ha = pZeeman->GetField();
+			}
+			else mc_modules_other.push_back(pMod[mod_idx]);
+		}
+		break;
+
+		//interactions between spins in the same mesh other than isotropic exchange : cluster updates not possible
+		case MOD_VIDMEXCHANGE:
+		case MOD_DEMAG:
+		case MOD_SDEMAG_DEMAG:
+		case MOD_ATOM_DIPOLEDIPOLE:
+			mc_cluster_allowed = false;
+			mc_modules_other.push_back(pMod[mod_idx]);
+			break;
+
+		default:
+			mc_modules_other.push_back(pMod[mod_idx]);
+			break;
+		}
+	}
+}
+
+//exchange and DMI local field (J) for spin at spin_idx : -J * Sum_over_neighbors_j Sj, together with -D * Sum_over_neighbors_j (rij x Sj) for bulk DMI, or -D * Sum_over_neighbors_j ((rij x z) x Sj) for interfacial DMI
+//energy change for spin direction changed from s_old to s_new is then (s_new - s_old) * local field
+inline DBL3 Atom_Mesh_Cubic::MonteCarlo_ExchangeField(int spin_idx)
+{
+	double J_val = J;
+	double D_val = D;
+	if (mc_fused_dmi || mc_fused_idmi) update_parameters_mcoarse(spin_idx, J, J_val, D, D_val);
+	else update_parameters_mcoarse(spin_idx, J, J_val);
+
+	DBL3 local_field = (-J_val * mc_fused_exchange) * M1.ngbr_dirsum(spin_idx);
+	if (mc_fused_dmi) local_field -= D_val * M1.anisotropic_ngbr_dirsum(spin_idx);
+	if (mc_fused_idmi) local_field -= D_val * M1.zanisotropic_ngbr_dirsum(spin_idx);
+
+	return local_field;
+}
+
+//energy change for spin at spin_idx moved to M_new, without the exchange and DMI contributions
+inline double Atom_Mesh_Cubic::MonteCarlo_EnergyChange_NonExchange(int spin_idx, DBL3 M_new)
+{
+	double energy_delta = 0.0;
+
+	DBL3 S = M1[spin_idx];
+	DBL3 s_old = S.normalized(), s_new = M_new.normalized();
+
+	//uniaxial anisotropy : -K1 * (S * ea)^2 - K2 * (S * ea)^4
+	if (mc_fused_aniuni) {
+
+		double K1_val = K1;
+		double K2_val = K2;
+		DBL3 mcanis_ea1_val = mcanis_ea1;
+		update_parameters_mcoarse(spin_idx, K1, K1_val, K2, K2_val, mcanis_ea1, mcanis_ea1_val);
+
+		double dpsq = (s_old * mcanis_ea1_val) * (s_old * mcanis_ea1_val);
+		double dpsq_new = (s_new * mcanis_ea1_val) * (s_new * mcanis_ea1_val);
+
+		energy_delta += -K1_val * (dpsq_new - dpsq) - K2_val * (dpsq_new * dpsq_new - dpsq * dpsq);
+	}
+
+	//demag_N : (mu0 / 2) * (MUB / V) * (Nx * Sx^2 + Ny * Sy^2 + Nz * Sz^2), no spatial or temperature dependence for Nxy
+	if (mc_fused_demagn) {
+
+		DBL2 Nxy_val = Nxy;
+		double Nz = 1 - Nxy_val.x - Nxy_val.y;
+
+		energy_delta += (MUB_MU0 / 2) * (MUB / h.dim()) * (Nxy_val.x * (M_new.x * M_new.x - S.x * S.x) + Nxy_val.y * (M_new.y * M_new.y - S.y * S.y) + Nz * (M_new.z * M_new.z - S.z * S.z));
+	}
+
+	//Zeeman, uniform applied field : -mu0 * MUB * S * (cHA * Ha)
+	if (mc_fused_zeeman) {
+
+		double cHA_val = cHA;
+		update_parameters_mcoarse(spin_idx, cHA, cHA_val);
+
+		energy_delta += -MUB_MU0 * (M_new - S) * (cHA_val * mc_zeeman_Ha);
+	}
+
+	for (int mod_idx = 0; mod_idx < mc_modules_other.size(); mod_idx++) {
+
+		energy_delta += mc_modules_other[mod_idx]->Get_EnergyChange(spin_idx, M_new);
+	}
+
+	return energy_delta;
+}
+
+//energy change for spin at spin_idx moved to M_new, using the Monte Carlo local energy evaluator
+inline double Atom_Mesh_Cubic::MonteCarlo_EnergyChange(int spin_idx, DBL3 M_new)
+{
+	double energy_delta = MonteCarlo_EnergyChange_NonExchange(spin_idx, M_new);
+
+	if (mc_fused_exchange) energy_delta += (M_new.normalized() - M1[spin_idx].normalized()) * MonteCarlo_ExchangeField(spin_idx);
+
+	return energy_delta;
+}
+
+//----------------------------------- MONTE-CARLO ALGORITHMS
+
 //Take a Monte Carlo step in this atomistic mesh
 void Atom_Mesh_Cubic::Iterate_MonteCarlo(double acceptance_rate)
 {
 	if (mc_disabled) return;
 
+	//modules could have changed since the last step
+	MonteCarlo_BuildEnergyEvaluator();
+
 	if (mc_constrain) {
 
 		if (mc_parallel) Iterate_MonteCarlo_Parallel_Constrained();
@@ -23,6 +177,10 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo(double acceptance_rate)
 
 		if (mc_parallel) Iterate_MonteCarlo_Parallel_Classic();
 		else Iterate_MonteCarlo_Serial_Classic();
+
+		//additional moves : these don't conserve the magnetization direction, so only used with classic Monte Carlo
+		for (int sweep = 0; sweep < mc_overrelax; sweep++) Iterate_MonteCarlo_OverRelaxation();
+		if (mc_cluster) Iterate_MonteCarlo_Cluster();
 	}
 
 	///////////////////////////////////////////////////////////////
@@ -102,11 +260,7 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo_Serial_Classic(void)
 			DBL3 M1_new = relrotate_polar(M1_old, theta_rot, phi_rot);
 
 			//find energy change : new - old
-			double energy_delta = 0.0;
-			for (int mod_idx = 0; mod_idx < pMod.size(); mod_idx++) {
-
-				energy_delta += pMod[mod_idx]->Get_EnergyChange(spin_idx, M1_new);
-			}
+			double energy_delta = MonteCarlo_EnergyChange(spin_idx, M1_new);
 
 			//Compute acceptance probability
 			double P_accept = 0.0, P = 1.0;
@@ -214,11 +368,7 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo_Serial_Constrained(void)
 				DBL3 M_new2 = rotate_polar(Mrot_new2, cmc_n);
 
 				//find energy change : new - old
-				double energy_delta = 0.0;
-				for (int mod_idx = 0; mod_idx < pMod.size(); mod_idx++) {
-
-					energy_delta += pMod[mod_idx]->Get_EnergyChange(spin_idx1, M_new1) + pMod[mod_idx]->Get_EnergyChange(spin_idx2, M_new2);
-				}
+				double energy_delta = MonteCarlo_EnergyChange(spin_idx1, M_new1) + MonteCarlo_EnergyChange(spin_idx2, M_new2);
 
 				double cmc_M_new = cmc_M + Mrot_new1.x + Mrot_new2.x - Mrot_old1.x - Mrot_old2.x;
 
@@ -312,11 +462,7 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo_Parallel_Classic(void)
 					DBL3 M1_new = relrotate_polar(M1_old, theta_rot, phi_rot);
 
 					//find energy change : new - old
-					double energy_delta = 0.0;
-					for (int mod_idx = 0; mod_idx < pMod.size(); mod_idx++) {
-
-						energy_delta += pMod[mod_idx]->Get_EnergyChange(spin_idx, M1_new);
-					}
+					double energy_delta = MonteCarlo_EnergyChange(spin_idx, M1_new);
 
 					//Compute acceptance probability
 					double P_accept = 0.0, P = 1.0;
@@ -520,11 +666,7 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo_Parallel_Constrained(void)
 					DBL3 M_new2 = rotate_polar(Mrot_new2, cmc_n);
 
 					//find energy change : new - old
-					double energy_delta = 0.0;
-					for (int mod_idx = 0; mod_idx < pMod.size(); mod_idx++) {
-
-						energy_delta += pMod[mod_idx]->Get_EnergyChange(spin_idx1, M_new1) + pMod[mod_idx]->Get_EnergyChange(spin_idx2, M_new2);
-					}
+					double energy_delta = MonteCarlo_EnergyChange(spin_idx1, M_new1) + MonteCarlo_EnergyChange(spin_idx2, M_new2);
 
 					//use abs: since we're not updating cmc_M after every spin it can become negative above the Curie temperature. with the cmc_M_new > 0.0 check this will result in solver getting stuck
 					double cmc_M_new = abs(cmc_M) + Mrot_new1.x + Mrot_new2.x - Mrot_old1.x - Mrot_old2.x;
@@ -569,4 +711,211 @@ void Atom_Mesh_Cubic::Iterate_MonteCarlo_Parallel_Constrained(void)
 	}
 }
 
+//Over-relaxation sweep : every spin is reflected about its exchange and DMI local field, which leaves the exchange and DMI energy unchanged, so the spins move a long way on the constant energy surface at no cost.
+//Any energy change from other contributions (e.g. anisotropy, Zeeman) is accepted or rejected using the Metropolis criterion, so the sweep is exactly microcanonical for exchange and DMI only.
+//Uses the same red-black ordering as the parallel Metropolis algorithm, as a spin's local field only depends on its neighbors. Doesn't contribute to mc_acceptance_rate (used to adapt the cone angle).
+void Atom_Mesh_Cubic::Iterate_MonteCarlo_OverRelaxation(void)
+{
+	//nothing to reflect about without exchange
+	if (!mc_fused_exchange) return;
+
+	prng.check_periodicity();
+
+	for (int rb = 0; rb < 2; rb++) {
+
+#pragma omp parallel for
+		for (int idx_jk = 0; idx_jk < M1.n.y * M1.n.z; idx_jk++) {
+
+			int j = idx_jk % M1.n.y;
+			int k = (idx_jk / M1.n.y) % M1.n.z;
+
+			bool red_nudge = (((j % 2) == 1 && (k % 2) == 0) || (((j % 2) == 0 && (k % 2) == 1)));
+
+			for (int i = (1 - rb) * red_nudge + rb * (!red_nudge); i < M1.n.x; i += 2) {
+
+				int spin_idx = i + j * M1.n.x + k * M1.n.x*M1.n.y;
+
+				if (M1.is_empty(spin_idx) || M1.is_skipcell(spin_idx)) continue;
+
+				DBL3 local_field = MonteCarlo_ExchangeField(spin_idx);
+				double local_field_sq = local_field * local_field;
+				if (local_field_sq == 0.0) continue;
+
+				//reflected spin : 2 * (S.h) h / h^2 - S
+				DBL3 M1_old = M1[spin_idx];
+				DBL3 M1_new = (2.0 * (M1_old * local_field) / local_field_sq) * local_field - M1_old;
+
+				double energy_delta = MonteCarlo_EnergyChange_NonExchange(spin_idx, M1_new);
+
+				if (energy_delta <= 0.0 || (base_temperature > 0.0 && prng.rand() <= exp(-energy_delta / (BOLTZMANN * base_temperature)))) {
+
+					M1[spin_idx] = M1_new;
+				}
+			}
+		}
+	}
+}
+
+//Wolff-type cluster update (U. Wolff, PRL 62, 361 (1989)) : a cluster is grown from a random seed spin through exchange bonds, and all its spins are reflected about the plane perpendicular to a random direction r.
+//A bond between cluster spin i and neighbor j is activated with probability 1 - exp(min(0, -2 * J * (r.si) * (r.sj) / kT)), which accounts for the exchange energy change, so large correlated regions are flipped in one move.
+//If J varies spatially the bond uses the mean of J at i and j, so the activation probability is symmetric in i and j as required for detailed balance.
+//The energy change from all other contributions is summed over the cluster spins, and the reflection accepted using the Metropolis criterion. Only possible if all other contributions are on-site, i.e. no DMI or dipolar interactions.
+void Atom_Mesh_Cubic::Iterate_MonteCarlo_Cluster(void)
+{
+	if (!mc_fused_exchange || !mc_cluster_allowed || base_temperature <= 0.0) return;
+
+	int N = n.dim();
+
+	if (mc_cluster_marker.size() != N) if (!malloc_vector(mc_cluster_marker, N, (char)0)) return;
+
+	std::vector<int>& ngbrFlags = M1.ngbrFlags_ref();
+
+	//seed spin picked at random from non-empty, non-frozen cells
+	int seed_idx = -1;
+	for (int attempt = 0; attempt < N && seed_idx < 0; attempt++) {
+
+		int idx = floor(prng.rand() * N);
+		if (idx >= N) idx = N - 1;
+
+		if (M1.is_not_empty(idx) && !M1.is_skipcell(idx)) seed_idx = idx;
+	}
+
+	if (seed_idx < 0) return;
+
+	//random reflection direction, uniform on the unit sphere
+	double cos_theta = 1.0 - 2.0 * prng.rand();
+	double phi = prng.rand() * 2 * PI;
+	double sin_theta = sqrt(1.0 - cos_theta * cos_theta);
+	DBL3 r = DBL3(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+
+	double beta = 1.0 / (BOLTZMANN * base_temperature);
+
+	//J has a spatial variation if spatial scaling is set, or if temperature dependence is set with a temperature VEC
+	bool J_spatial = J.is_sdep() || (J.is_tdep() && Temp.linear_size());
+
+	//sign applied to neighbors across periodic boundaries, as in the exchange energy
+	double pbc_sign_x = get_sign(M1.is_pbc_x()), pbc_sign_y = get_sign(M1.is_pbc_y()), pbc_sign_z = get_sign(M1.is_pbc_z());
+
+	//exchange energy change across bonds between cluster spins and frozen neighbors, which are never added to the cluster
+	double energy_frozen = 0.0;
+
+	mc_cluster_spins.clear();
+	mc_cluster_stack.clear();
+
+	mc_cluster_marker[seed_idx] = 1;
+	mc_cluster_spins.push_back(seed_idx);
+	mc_cluster_stack.push_back(seed_idx);
+
+	while (mc_cluster_stack.size()) {
+
+		int idx = mc_cluster_stack.back();
+		mc_cluster_stack.pop_back();
+
+		double J_val = J;
+		update_parameters_mcoarse(idx, J, J_val);
+
+		double r_si = r * M1[idx].normalized();
+
+		//neighbors, with periodic boundary conditions if set : same neighbors as used by VEC_VC::ngbr_dirsum for the exchange energy
+		//across a periodic boundary the neighbor enters with the sign of the boundary condition
+		int ngbr[6], num_ngbrs = 0;
+		double ngbr_sign[6];
+		auto add_ngbr = [&](int ngbr_idx, double sign) { ngbr[num_ngbrs] = ngbr_idx; ngbr_sign[num_ngbrs++] = sign; };
+		int flags = ngbrFlags[idx];
+
+		int i = idx % n.x;
+		int j = (idx / n.x) % n.y;
+		int k = idx / (n.x * n.y);
+
+		if (flags & NF_NPX) {
+
+			add_ngbr(idx + 1, 1.0);
+			if (flags & NF_NNX) add_ngbr(idx - 1, 1.0);
+			else if ((flags & NF_PBCX) && i == 0) add_ngbr(idx + n.x - 1, pbc_sign_x);
+		}
+		else if (flags & NF_NNX) {
+
+			add_ngbr(idx - 1, 1.0);
+			if ((flags & NF_PBCX) && i == n.x - 1) add_ngbr(idx - (n.x - 1), pbc_sign_x);
+		}
+
+		if (flags & NF_NPY) {
+
+			add_ngbr(idx + n.x, 1.0);
+			if (flags & NF_NNY) add_ngbr(idx - n.x, 1.0);
+			else if ((flags & NF_PBCY) && j == 0) add_ngbr(idx + (n.y - 1) * n.x, pbc_sign_y);
+		}
+		else if (flags & NF_NNY) {
+
+			add_ngbr(idx - n.x, 1.0);
+			if ((flags & NF_PBCY) && j == n.y - 1) add_ngbr(idx - (n.y - 1) * n.x, pbc_sign_y);
+		}
+
+		if (flags & NF_NPZ) {
+
+			add_ngbr(idx + n.x * n.y, 1.0);
+			if (flags & NF_NNZ) add_ngbr(idx - n.x * n.y, 1.0);
+			else if ((flags & NF_PBCZ) && k == 0) add_ngbr(idx + (n.z - 1) * n.x * n.y, pbc_sign_z);
+		}
+		else if (flags & NF_NNZ) {
+
+			add_ngbr(idx - n.x * n.y, 1.0);
+			if ((flags & NF_PBCZ) && k == n.z - 1) add_ngbr(idx - (n.z - 1) * n.x * n.y, pbc_sign_z);
+		}
+
+		for (int nidx = 0; nidx < num_ngbrs; nidx++) {
+
+			int ngbr_idx = ngbr[nidx];
+
+			if (mc_cluster_marker[ngbr_idx] || M1.is_empty(ngbr_idx)) continue;
+
+			double J_bond = J_val;
+			if (J_spatial) {
+
+				double J_ngbr = J;
+				update_parameters_mcoarse(ngbr_idx, J, J_ngbr);
+				J_bond = (J_val + J_ngbr) / 2;
+			}
+
+			double r_sj = ngbr_sign[nidx] * (r * M1[ngbr_idx].normalized());
+
+			//frozen neighbor : no bond, but reflecting the cluster spin changes the bond energy by -J * (s_i' - s_i) * s_j, with s_i' - s_i = -2 (r * s_i) r
+			if (M1.is_skipcell(ngbr_idx)) {
+
+				energy_frozen += 2.0 * J_bond * mc_fused_exchange * r_si * r_sj;
+				continue;
+			}
+
+			double exponent = -2.0 * beta * J_bond * mc_fused_exchange * r_si * r_sj;
+
+			if (exponent < 0.0 && prng.rand() < 1.0 - exp(exponent)) {
+
+				mc_cluster_marker[ngbr_idx] = 1;
+				mc_cluster_spins.push_back(ngbr_idx);
+				mc_cluster_stack.push_back(ngbr_idx);
+			}
+		}
+	}
+
+	//energy change from on-site contributions, and exchange with frozen neighbors
+	double energy_delta = energy_frozen;
+
+#pragma omp parallel for reduction(+:energy_delta)
+	for (int cidx = 0; cidx < mc_cluster_spins.size(); cidx++) {
+
+		int spin_idx = mc_cluster_spins[cidx];
+		energy_delta += MonteCarlo_EnergyChange_NonExchange(spin_idx, M1[spin_idx] - 2.0 * (M1[spin_idx] * r) * r);
+	}
+
+	bool accept = (energy_delta <= 0.0 || prng.rand() <= exp(-energy_delta * beta));
+
+#pragma omp parallel for
+	for (int cidx = 0; cidx < mc_cluster_spins.size(); cidx++) {
+
+		int spin_idx = mc_cluster_spins[cidx];
+		if (accept) M1[spin_idx] -= 2.0 * (M1[spin_idx] * r) * r;
+		mc_cluster_marker[spin_idx] = 0;
+	}
+}
+
 #endif
\ No newline at end of file
@@ -22,7 +22,7 @@ DBL3 Atom_Mesh_Cubic::Average_dmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -33,7 +33,7 @@ DBL3 Atom_Mesh_Cubic::Average_dmdt(Rect avRect)
 
 				if (M1.is_not_empty(idx)) {
 
-					reduction.reduce_average(meshODE.dMdt(idx) / M1[idx].norm());
+					reduction.reduce_average(meshODE.dMdt(idx) / M1[idx].norm(), idx);
 				}
 			}
 		}
@@ -53,7 +53,7 @@ DBL3 Atom_Mesh_Cubic::Average_mxdmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -65,7 +65,7 @@ DBL3 Atom_Mesh_Cubic::Average_mxdmdt(Rect avRect)
 				if (M1.is_not_empty(idx)) {
 
 					double norm = M1[idx].norm();
-					reduction.reduce_average((M1[idx] / norm) ^ (meshODE.dMdt(idx) / norm));
+					reduction.reduce_average((M1[idx] / norm) ^ (meshODE.dMdt(idx) / norm), idx);
 				}
 			}
 		}
@@ -210,6 +210,9 @@ double Atom_SurfExchange::UpdateField(void)
 	if (paMesh_Top.size() || pMesh_Top.size()) {
 
 		//surface exchange coupling at the top
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 #pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -318,17 +321,23 @@ double Atom_SurfExchange::UpdateField(void)
 				}
 
 				paMesh->Heff1[cell_idx] += Hsurfexch;
-				energy += cell_energy;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[cell_idx] += Hsurfexch;
 				if (Module_energy.linear_size()) Module_energy[cell_idx] += cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 
 	if (paMesh_Bot.size() || pMesh_Bot.size()) {
 
 		//surface exchange coupling at the bottom
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 #pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -428,12 +437,15 @@ double Atom_SurfExchange::UpdateField(void)
 				}
 
 				paMesh->Heff1[cell_idx] += Hsurfexch;
-				energy += cell_energy;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[cell_idx] = Hsurfexch;
 				if (Module_energy.linear_size()) Module_energy[cell_idx] = cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 
 	energy /= paMesh->M1.get_nonempty_cells();
@@ -176,6 +176,9 @@ double Atom_Zeeman::UpdateField(void)
 			// Field VEC set
 			/////////////////////////////////////////
 
+			bool deterministic = OmpReduction_Deterministic();
+			if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 			for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -184,11 +187,15 @@ double Atom_Zeeman::UpdateField(void)
 
 				paMesh->Heff1[idx] = Hext;
 
-				energy += -MUB_MU0 * paMesh->M1[idx] * Hext;
+				double cell_energy = -MUB_MU0 * paMesh->M1[idx] * Hext;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MUB_MU0 * paMesh->M1[idx] * Hext / paMesh->M1.h.dim();
 			}
+
+			if (deterministic) energy = energy_reduction.sum();
 		}
 		else {
 
@@ -196,6 +203,9 @@ double Atom_Zeeman::UpdateField(void)
 			// Fixed set field
 			/////////////////////////////////////////
 
+			bool deterministic = OmpReduction_Deterministic();
+			if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 			for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -207,11 +217,15 @@ double Atom_Zeeman::UpdateField(void)
 
 				paMesh->Heff1[idx] = Hext;
 
-				energy += -MUB_MU0 * paMesh->M1[idx] * Hext;
+				double cell_energy = -MUB_MU0 * paMesh->M1[idx] * Hext;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MUB_MU0 * paMesh->M1[idx] * Hext / paMesh->M1.h.dim();
 			}
+
+			if (deterministic) energy = energy_reduction.sum();
 		}
 	}
 
@@ -223,6 +237,9 @@ double Atom_Zeeman::UpdateField(void)
 
 		double time = pSMesh->GetStageTime();
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < paMesh->n.y; j++) {
 			for (int k = 0; k < paMesh->n.z; k++) {
@@ -242,13 +259,17 @@ double Atom_Zeeman::UpdateField(void)
 
 					paMesh->Heff1[idx] = Hext;
 
-					energy += -MUB_MU0 * paMesh->M1[idx] * Hext;
+					double cell_energy = -MUB_MU0 * paMesh->M1[idx] * Hext;
+					if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+					else energy += cell_energy;
 
 					if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 					if (Module_energy.linear_size()) Module_energy[idx] = -MUB_MU0 * paMesh->M1[idx] * Hext / paMesh->M1.h.dim();
 				}
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	//convert to energy density and return
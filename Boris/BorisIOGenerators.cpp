@@ -1141,6 +1141,126 @@ void Simulation::Print_GPUKernels_Config(void)
 	BD.DisplayFormattedConsoleMessage(gpukernels_info);
 }
 
+//---------------------------------------------------- FFTW PLANNER CONFIGURATION
+
+void Simulation::Print_FFTW_Planner(void)
+{
+	std::vector<std::string> planner_names = { "estimate", "measure", "patient", "exhaustive" };
+
+	std::string fftwplanner_info = "[tc1,1,1,1/tc]FFTW planner : " + planner_names[ConvolutionData::fftw_planner] + " (" + ToString(ConvolutionData::fftw_planner) + ")";
+	fftwplanner_info += "\n[tc1,1,1,1/tc]FFTW wisdom file : " + ConvolutionData::fftw_wisdom_fileName;
+
+	BD.DisplayFormattedConsoleMessage(fftwplanner_info);
+}
+
+void Simulation::Print_Convolution_Profile(void)
+{
+	std::vector<std::string> stage_names = { "x fft", "y fft", "z fft", "multiplication", "z ifft", "y ifft", "x ifft" };
+
+	std::string profile_info = "[tc1,1,1,1/tc]Convolution profiling : " + std::string(ConvolutionData::profiling ? "enabled" : "disabled");
+
+	size_t regions = ConvolutionData::profile_regions;
+
+	if (regions) {
+
+		profile_info += "\n[tc1,1,1,1/tc]Parallel regions : " + ToString(regions) + ", barriers : " + ToString(ConvolutionData::profile_barriers) + " (" + ToString((double)ConvolutionData::profile_barriers / regions) + " per region)";
+		profile_info += "\n[tc1,1,1,1/tc]Total time : " + ToString(ConvolutionData::profile_time_total * 1e3) + " ms (" + ToString(ConvolutionData::profile_time_total * 1e3 / regions) + " ms per region)";
+
+		for (int stage = 0; stage < CONVSTAGE_NUMENTRIES; stage++) {
+
+			profile_info += "\n[tc1,1,1,1/tc]" + stage_names[stage] + " : " + ToString(ConvolutionData::profile_time_stages[stage] * 1e3) + " ms";
+		}
+	}
+
+	BD.DisplayFormattedConsoleMessage(profile_info);
+}
+
+void Simulation::Print_FFT_Padding(void)
+{
+	std::string padding_info = "[tc1,1,1,1/tc]FFT fast padding : " + std::string(ConvolutionData::fft_fast_padding ? "enabled" : "disabled");
+
+	for (int idx = 0; idx < SMesh.size(); idx++) {
+
+		if (SMesh[idx]->is_atomistic() || !SMesh[idx]->IsModuleSet(MOD_DEMAG)) continue;
+
+		SZ3 n = SMesh[idx]->n;
+		INT3 pbc_images = SMesh[idx]->CallModuleMethod(&DemagBase::Get_PBC);
+
+		SZ3 N_default = ConvolutionData::Get_FFT_Dimensions(n, pbc_images, false);
+		SZ3 N_fast = ConvolutionData::Get_FFT_Dimensions(n, pbc_images, true);
+
+		padding_info += "\n[tc1,1,1,1/tc]" + SMesh.key_from_meshIdx(idx) + " : n = (" + ToString(n) + "), N = (" + ToString(N_fast) + ") with fast padding, (" + ToString(N_default) + ") without";
+		padding_info += ". Expected fft speedup : " + ToString(ConvolutionData::Estimate_FFT_Padding_Speedup(n, pbc_images));
+	}
+
+	BD.DisplayFormattedConsoleMessage(padding_info);
+}
+
+void Simulation::Print_Kernel_SIMD(void)
+{
+	std::string simd_info = "[tc1,1,1,1/tc]Kernel multiplication instruction set : " + KernelMultSIMD::Get_Level_Name(KernelMultSIMD::level) + " (" + ToString(KernelMultSIMD::level) + ")";
+	simd_info += "\n[tc1,1,1,1/tc]Highest allowed : " + KernelMultSIMD::Get_Level_Name(KernelMultSIMD::max_level) + ", highest supported by CPU : " + KernelMultSIMD::Get_Level_Name(KernelMultSIMD::Get_Supported_Level());
+
+	BD.DisplayFormattedConsoleMessage(simd_info);
+}
+
+void Simulation::Print_Demag_Asymptotic(void)
+{
+	std::string asymptotic_info;
+
+	if (DemagTFuncSettings::asymptotic_distance > 0) asymptotic_info = "[tc1,1,1,1/tc]Demag tensor asymptotic expansions used from distance (cells) : " + ToString(DemagTFuncSettings::asymptotic_distance);
+	else asymptotic_info = "[tc1,1,1,1/tc]Demag tensor asymptotic expansions disabled.";
+
+	if (DemagTFuncSettings::asymptotic_distance <= 0) {
+
+		BD.DisplayFormattedConsoleMessage(asymptotic_info);
+		return;
+	}
+
+	//error estimates only depend on cellsize ratios
+	DemagTFunc dtf;
+
+	for (int idx = 0; idx < SMesh.size(); idx++) {
+
+		if (SMesh[idx]->is_atomistic() || !SMesh[idx]->IsModuleSet(MOD_DEMAG)) continue;
+
+		DBL3 h = SMesh[idx]->h;
+
+		asymptotic_info += "\n[tc1,1,1,1/tc]" + SMesh.key_from_meshIdx(idx) + " : h = (" + ToString(h, "m") + "), estimated relative error : " + ToString(dtf.Asymptotic_Error_Estimate(h / maximum(h.x, h.y, h.z)));
+	}
+
+	if (SMesh.IsSuperMeshModuleSet(MODS_SDEMAG)) {
+
+		DBL3 h = SMesh.GetFMSMeshCellsize();
+
+		asymptotic_info += "\n[tc1,1,1,1/tc]supermesh : h = (" + ToString(h, "m") + "), estimated relative error : " + ToString(dtf.Asymptotic_Error_Estimate(h / maximum(h.x, h.y, h.z)));
+	}
+
+	BD.DisplayFormattedConsoleMessage(asymptotic_info);
+}
+
+void Simulation::Print_DemagTree_Config(void)
+{
+	std::string demagtree_info = "[tc1,1,1,1/tc]Demag tree code (near field distance in cells, opening angle) :";
+
+	bool found = false;
+
+	for (int idx = 0; idx < SMesh.size(); idx++) {
+
+		if (!SMesh[idx]->IsModuleSet(MOD_DEMAG_TREE)) continue;
+
+		demagtree_info += "\n[tc1,1,1,1/tc]" + SMesh.key_from_meshIdx(idx) + " : " +
+			ToString(SMesh[idx]->CallModuleMethod(&DemagTree::Get_NearField_Distance)) + ", " +
+			ToString(SMesh[idx]->CallModuleMethod(&DemagTree::Get_Opening_Angle));
+
+		found = true;
+	}
+
+	if (!found) demagtree_info += "\n[tc1,1,1,1/tc]demag_tree module not set in any mesh.";
+
+	BD.DisplayFormattedConsoleMessage(demagtree_info);
+}
+
 //---------------------------------------------------- MATERIALS DATABASE
 
 void Simulation::Print_MaterialsDatabase(void)
@@ -29,6 +29,7 @@ void Simulation::MakeIOInfo(void)
 
 	ioInfo.set(modulegeneric_info + std::string("<i><b>Stoner-Wohlfarth demag"), INT2(IOI_MODULE, MOD_DEMAG_N));
 	ioInfo.set(modulegeneric_info + std::string("<i><b>Full demag field"), INT2(IOI_MODULE, MOD_DEMAG));
+	ioInfo.set(modulegeneric_info + std::string("<i><b>Full demag field - tree code for sparse geometries"), INT2(IOI_MODULE, MOD_DEMAG_TREE));
 	ioInfo.set(modulegeneric_info + std::string("<i><b>Dipole-dipole interaction"), INT2(IOI_MODULE, MOD_ATOM_DIPOLEDIPOLE));
 	ioInfo.set(modulegeneric_info + std::string("<i><b>Direct exchange interaction"), INT2(IOI_MODULE, MOD_EXCHANGE));
 	ioInfo.set(modulegeneric_info + std::string("<i><b>Dzyaloshinskii-Moriya interaction - bulk"), INT2(IOI_MODULE, MOD_DMEXCHANGE));
@@ -358,6 +359,11 @@ void Simulation::MakeIOInfo(void)
 	ioInfo.set(showdata_info_generic + std::string("<i><b>magnetization solver time step</i>"), INT2(IOI_SHOWDATA, DATA_DT));
 	ioInfo.set(showdata_info_generic + std::string("<i><b>magnetization relaxation |mxh|</i>"), INT2(IOI_SHOWDATA, DATA_MXH));
 	ioInfo.set(showdata_info_generic + std::string("<i><b>magnetization relaxation |dm/dt|</i>"), INT2(IOI_SHOWDATA, DATA_DMDT));
+	ioInfo.set(showdata_info_generic + std::string("<i><b>Adaptive time step statistics: accepted steps, rejected steps, wasted field evaluations</i>"), INT2(IOI_SHOWDATA, DATA_ASTEPSTATS));
+	ioInfo.set(showdata_info_generic + std::string("<i><b>Active set relaxation: fraction of active cells</i>"), INT2(IOI_SHOWDATA, DATA_ACTIVEFRACTION));
+	ioInfo.set(showdata_info_generic + std::string("<i><b>Ensemble runs: replica currently running</i>"), INT2(IOI_SHOWDATA, DATA_REPLICA));
+	ioInfo.set(showdata_info_generic + std::string("<i><b>Energy barrier from last geodesic nudged elastic band run</i>"), INT2(IOI_SHOWDATA, DATA_GNEBBARRIER));
+	ioInfo.set(showdata_info_generic + std::string("<i><b>Parallel tempering swap acceptance rate</i>"), INT2(IOI_SHOWDATA, DATA_PTSWAPRATE));
 	ioInfo.set(showdata_info_generic + std::string("<i><b>Average magnetization</i>"), INT2(IOI_SHOWDATA, DATA_AVM));
 	ioInfo.set(showdata_info_generic + std::string("<i><b>Average magnetization sub-lattice B</i>"), INT2(IOI_SHOWDATA, DATA_AVM2));
 	ioInfo.set(showdata_info_generic + std::string("<i><b>Thermodynamic average magnetization</i>"), INT2(IOI_SHOWDATA, DATA_THAVM));
@@ -432,6 +438,11 @@ void Simulation::MakeIOInfo(void)
 	ioInfo.set(data_info_generic + std::string("<i><b>magnetization solver time step</i>"), INT2(IOI_DATA, DATA_DT));
 	ioInfo.set(data_info_generic + std::string("<i><b>magnetization relaxation |mxh|</i>"), INT2(IOI_DATA, DATA_MXH));
 	ioInfo.set(data_info_generic + std::string("<i><b>magnetization relaxation |dm/dt|</i>"), INT2(IOI_DATA, DATA_DMDT));
+	ioInfo.set(data_info_generic + std::string("<i><b>Adaptive time step statistics: accepted steps, rejected steps, wasted field evaluations</i>"), INT2(IOI_DATA, DATA_ASTEPSTATS));
+	ioInfo.set(data_info_generic + std::string("<i><b>Active set relaxation: fraction of active cells</i>"), INT2(IOI_DATA, DATA_ACTIVEFRACTION));
+	ioInfo.set(data_info_generic + std::string("<i><b>Ensemble runs: replica currently running</i>"), INT2(IOI_DATA, DATA_REPLICA));
+	ioInfo.set(data_info_generic + std::string("<i><b>Energy barrier from last geodesic nudged elastic band run</i>"), INT2(IOI_DATA, DATA_GNEBBARRIER));
+	ioInfo.set(data_info_generic + std::string("<i><b>Parallel tempering swap acceptance rate</i>"), INT2(IOI_DATA, DATA_PTSWAPRATE));
 	ioInfo.set(data_info_generic + std::string("<i><b>Average magnetization</i>"), INT2(IOI_DATA, DATA_AVM));
 	ioInfo.set(data_info_generic + std::string("<i><b>Average magnetization sub-lattice B</i>"), INT2(IOI_DATA, DATA_AVM2));
 	ioInfo.set(data_info_generic + std::string("<i><b>Thermodynamic average magnetization</i>"), INT2(IOI_DATA, DATA_THAVM));
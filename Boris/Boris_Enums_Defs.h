@@ -232,4 +232,11 @@ namespace ucfg {
 //If actual acceptance rate is within this tolerance close to target acceptance then don't adjust cone angle
 #define MONTECARLO_ACCEPTANCETOLERANCE	0.1
 //Try to perform reduction on acceptance rate only every given number of iterations
-#define MONTECARLO_REDUCTIONITERS		100
\ No newline at end of file
+#define MONTECARLO_REDUCTIONITERS		100
+
+//GNEB : default spring constant between images (J)
+#define GNEB_SPRING		1e-20
+//GNEB : default maximum rotation of magnetization in any cell per iteration (rad)
+#define GNEB_STEP		0.05
+//GNEB : default convergence tolerance on the residual torque field (A/m)
+#define GNEB_TOLERANCE	10.0
\ No newline at end of file
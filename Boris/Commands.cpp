@@ -288,6 +288,28 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_ENSEMBLE:
+		{
+			int replicas;
+
+			error = commandSpec.GetParameters(command_fields, replicas);
+
+			if (!error) {
+
+				StopSimulation();
+
+				SetEnsembleReplicas(replicas);
+			}
+			else if (verbose) {
+
+				if (ensemble_replicas) BD.DisplayConsoleListing("Ensemble runs : " + ToString(ensemble_replicas) + " replicas, currently running replica " + ToString(ensemble_replica) + ".");
+				else BD.DisplayConsoleListing("Ensemble runs disabled.");
+			}
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(INT2(ensemble_replicas, ensemble_replica)));
+		}
+		break;
+
 		case CMD_COMPUTEFIELDS:
 			ComputeFields();
 			break;
@@ -1801,6 +1823,259 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_FFTWPLANNER:
+		{
+			int level;
+
+			error = commandSpec.GetParameters(command_fields, level);
+
+			if (!error) {
+
+				ConvolutionData::Set_FFTW_Planner(level);
+				Save_Startup_Flags();
+			}
+			else if (verbose && error == BERROR_PARAMOUTOFBOUNDS) PrintCommandUsage(command_name);
+			else if (verbose) Print_FFTW_Planner();
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::fftw_planner));
+		}
+		break;
+
+		case CMD_DEMAGKERNELCACHE:
+		{
+			bool status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				DemagKernelCache::enabled = status;
+				Save_Startup_Flags();
+			}
+			else if (verbose) BD.DisplayConsoleListing("Demag kernel cache : " + std::string(DemagKernelCache::enabled ? "enabled" : "disabled") + " (" + DemagKernelCache::directory + ")");
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(DemagKernelCache::enabled));
+		}
+		break;
+
+		case CMD_FFTTILING:
+		{
+			bool status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				ConvolutionData::fft_tiling = status;
+				Save_Startup_Flags();
+			}
+			else if (verbose) BD.DisplayConsoleListing("FFT tiling : " + std::string(ConvolutionData::fft_tiling ? "enabled" : "disabled"));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::fft_tiling));
+		}
+		break;
+
+		case CMD_FFTSINGLEPRECISION:
+		{
+			bool status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				if (status != ConvolutionData::fft_single_precision) {
+
+					StopSimulation();
+
+					ConvolutionData::fft_single_precision = status;
+					Save_Startup_Flags();
+
+					//reconfigure convolutions so the new fft precision is used
+					error = SMesh.UpdateConfiguration(UPDATECONFIG_DEMAG_CONVCHANGE);
+
+					UpdateScreen();
+				}
+			}
+			else if (verbose) BD.DisplayConsoleListing("FFT single precision : " + std::string(ConvolutionData::fft_single_precision ? "enabled" : "disabled"));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::fft_single_precision));
+		}
+		break;
+
+		case CMD_FFTPRECISIONCHECK:
+		{
+			std::string meshName;
+
+			optional_meshname_check_focusedmeshdefault(command_fields);
+			error = commandSpec.GetParameters(command_fields, meshName);
+
+			DBL2 accuracy;
+
+			if (!error) {
+
+				if (cudaEnabled) error(BERROR_INCORRECTACTION);
+				else if (!SMesh[meshName]->IsModuleSet(MOD_DEMAG)) error(BERROR_INCORRECTMODCONFIG);
+				else {
+
+					StopSimulation();
+					error = SMesh[meshName]->CallModuleMethod<BError, Demag, DBL2&>(&Demag::Compare_FFT_Precision, accuracy);
+
+					if (!error && verbose) BD.DisplayConsoleListing("Single vs double precision FFTs : field error = " + ToString(accuracy.x) + ", energy error = " + ToString(accuracy.y));
+				}
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(accuracy));
+		}
+		break;
+
+		case CMD_FFTPADDING:
+		{
+			bool status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				if (status != ConvolutionData::fft_fast_padding) {
+
+					StopSimulation();
+
+					ConvolutionData::fft_fast_padding = status;
+					Save_Startup_Flags();
+
+					//reconfigure convolutions so the new fft dimensions are used
+					error = SMesh.UpdateConfiguration(UPDATECONFIG_DEMAG_CONVCHANGE);
+
+					UpdateScreen();
+				}
+			}
+			else if (verbose) Print_FFT_Padding();
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::fft_fast_padding));
+		}
+		break;
+
+		case CMD_KERNELSIMD:
+		{
+			int level;
+
+			error = commandSpec.GetParameters(command_fields, level);
+
+			if (!error) {
+
+				KernelMultSIMD::Set_Max_Level(level);
+				Save_Startup_Flags();
+			}
+			else if (verbose && error == BERROR_PARAMOUTOFBOUNDS) PrintCommandUsage(command_name);
+			else if (verbose) Print_Kernel_SIMD();
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(KernelMultSIMD::level));
+		}
+		break;
+
+		case CMD_DEMAGASYMPTOTIC:
+		{
+			int distance;
+
+			error = commandSpec.GetParameters(command_fields, distance);
+
+			if (!error) {
+
+				if (distance <= 0) distance = -1;
+
+				if (distance != DemagTFuncSettings::asymptotic_distance) {
+
+					StopSimulation();
+
+					DemagTFuncSettings::asymptotic_distance = distance;
+					Save_Startup_Flags();
+
+					//reconfigure convolutions so kernels are recalculated
+					error = SMesh.UpdateConfiguration(UPDATECONFIG_DEMAG_CONVCHANGE);
+
+					UpdateScreen();
+				}
+			}
+			else if (verbose && error == BERROR_PARAMOUTOFBOUNDS) PrintCommandUsage(command_name);
+			else if (verbose) Print_Demag_Asymptotic();
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(DemagTFuncSettings::asymptotic_distance));
+		}
+		break;
+
+		case CMD_MULTICONVTASKS:
+		{
+			int mode;
+
+			error = commandSpec.GetParameters(command_fields, mode);
+
+			if (!error) {
+
+				ConvolutionData::multiconv_tasks = mode;
+				Save_Startup_Flags();
+			}
+			else if (verbose && error == BERROR_PARAMOUTOFBOUNDS) PrintCommandUsage(command_name);
+			else if (verbose) BD.DisplayConsoleListing("Multi-layered convolution tasks mode : " + ToString(ConvolutionData::multiconv_tasks));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::multiconv_tasks));
+		}
+		break;
+
+		case CMD_DEMAGTREE:
+		{
+			std::string meshName;
+			int near_distance;
+			double opening_angle;
+
+			optional_meshname_check_focusedmeshdefault(command_fields);
+			error = commandSpec.GetParameters(command_fields, meshName, near_distance, opening_angle);
+
+			if (!error) {
+
+				if (!SMesh[meshName]->IsModuleSet(MOD_DEMAG_TREE)) error(BERROR_INCORRECTMODCONFIG);
+				else {
+
+					StopSimulation();
+					error = SMesh[meshName]->CallModuleMethod(&DemagTree::Set_Accuracy, near_distance, opening_angle);
+					UpdateScreen();
+				}
+			}
+			else if (verbose && error == BERROR_PARAMOUTOFBOUNDS) PrintCommandUsage(command_name);
+			else if (verbose) Print_DemagTree_Config();
+
+			if (script_client_connected && SMesh.contains(meshName) && SMesh[meshName]->IsModuleSet(MOD_DEMAG_TREE)) {
+
+				commSocket.SetSendData(commandSpec.PrepareReturnParameters(
+					SMesh[meshName]->CallModuleMethod(&DemagTree::Get_NearField_Distance),
+					SMesh[meshName]->CallModuleMethod(&DemagTree::Get_Opening_Angle)));
+			}
+		}
+		break;
+
+		case CMD_CONVPROFILING:
+		{
+			bool status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				ConvolutionData::Set_Profiling(status);
+			}
+			else if (verbose) Print_Convolution_Profile();
+
+			if (script_client_connected) {
+
+				double* ptime = ConvolutionData::profile_time_stages;
+
+				commSocket.SetSendData(commandSpec.PrepareReturnParameters(ConvolutionData::profiling, ConvolutionData::profile_regions, ConvolutionData::profile_barriers, ConvolutionData::profile_time_total * 1e3,
+					ptime[CONVSTAGE_FFTX] * 1e3, ptime[CONVSTAGE_FFTY] * 1e3, ptime[CONVSTAGE_FFTZ] * 1e3, ptime[CONVSTAGE_MULT] * 1e3,
+					ptime[CONVSTAGE_IFFTZ] * 1e3, ptime[CONVSTAGE_IFFTY] * 1e3, ptime[CONVSTAGE_IFFTX] * 1e3));
+			}
+		}
+		break;
+
 		case CMD_ODE:
 		{
 			if (verbose) Print_ODEs();
@@ -1945,6 +2220,25 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_ASTEPCONTROLLER:
+		{
+			int controller;
+			double kI = ASTEPCTRL_PI_KI, kP = ASTEPCTRL_PI_KP;
+
+			error = commandSpec.GetParameters(command_fields, controller, kI, kP);
+			if (error == BERROR_PARAMMISMATCH) { error.reset() = commandSpec.GetParameters(command_fields, controller); kI = ASTEPCTRL_PI_KI; kP = ASTEPCTRL_PI_KP; }
+
+			if (!error) {
+
+				SMesh.SetAdaptiveTimeStepController(controller, kI, kP);
+				UpdateScreen();
+			}
+			else if (verbose) BD.DisplayConsoleListing("Adaptive time step controller : " + ToString(SMesh.Get_AStepController()) + " (kI, kP) = " + ToString(SMesh.Get_AStepControllerGains()));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(SMesh.Get_AStepController(), SMesh.Get_AStepControllerGains().i, SMesh.Get_AStepControllerGains().j));
+		}
+		break;
+
 		case CMD_SHOWDATA:
 		{
 			std::string dataName;
@@ -4552,6 +4846,46 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_MULTIRATE:
+		{
+			int subcycles;
+
+			error = commandSpec.GetParameters(command_fields, subcycles);
+
+			if (!error) {
+
+				StopSimulation();
+
+				error = SMesh.SetMultirateSubcycles(subcycles);
+				UpdateScreen();
+			}
+			else if (verbose) BD.DisplayConsoleListing("Multi-rate stepping sub-cycles : " + ToString(SMesh.GetMultirateSubcycles()));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(SMesh.GetMultirateSubcycles()));
+		}
+		break;
+
+		case CMD_ACTIVESET:
+		{
+			double threshold;
+			int halo = ACTIVESET_HALO, period = ACTIVESET_PERIOD;
+
+			error = commandSpec.GetParameters(command_fields, threshold, halo, period);
+			if (error == BERROR_PARAMMISMATCH) { error.reset() = commandSpec.GetParameters(command_fields, threshold); halo = ACTIVESET_HALO; period = ACTIVESET_PERIOD; }
+
+			if (!error) {
+
+				StopSimulation();
+
+				SMesh.SetActiveSet(threshold, halo, period);
+				UpdateScreen();
+			}
+			else if (verbose) BD.DisplayConsoleListing("Active set relaxation (threshold, halo, period) : " + ToString(SMesh.GetActiveSet()));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(SMesh.GetActiveSet()));
+		}
+		break;
+
 		case CMD_CUDA:
 		{
 			bool status;
@@ -4769,6 +5103,109 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_BENCHKERNELSIMD:
+		{
+			int length = 1024, repeats = 1000;
+
+			error = commandSpec.GetParameters(command_fields, length, repeats);
+			if (error == BERROR_PARAMMISMATCH) { error.reset() = commandSpec.GetParameters(command_fields, length); repeats = 1000; }
+			if (error == BERROR_PARAMMISMATCH) { error.reset(); length = 1024; repeats = 1000; }
+
+			if (!error) {
+
+				std::vector<double> throughput, max_difference;
+
+				error = KernelMultSIMD::Benchmark(length, repeats, throughput, max_difference);
+
+				if (!error) {
+
+					if (verbose) {
+
+						for (int level = KERNELSIMD_SCALAR; level <= KernelMultSIMD::Get_Supported_Level(); level++) {
+
+							BD.DisplayConsoleListing("Kernel multiplication (" + ToString(length) + " points), " + KernelMultSIMD::Get_Level_Name(level) + " : " + ToString(throughput[level]) + " complex multiply-adds/s, max difference from scalar : " + ToString(max_difference[level]));
+						}
+					}
+
+					if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(throughput[KERNELSIMD_SCALAR], throughput[KERNELSIMD_AVX2], throughput[KERNELSIMD_AVX512]));
+				}
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
+		case CMD_BENCHFFTTILING:
+		{
+			INT3 n;
+			int repeats = 10;
+
+			error = commandSpec.GetParameters(command_fields, n, repeats);
+			if (error == BERROR_PARAMMISMATCH) { error.reset() = commandSpec.GetParameters(command_fields, n); repeats = 10; }
+
+			if (!error) {
+
+				DBL2 times;
+
+				error = ConvolutionData::Benchmark_FFT_Tiling(SZ3(n), repeats, times);
+
+				if (!error) {
+
+					if (verbose) BD.DisplayConsoleListing("FFT y, z passes (" + ToString(n) + ") : lines " + ToString(times.i) + " ms, tiles " + ToString(times.j) + " ms.");
+
+					if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(times));
+				}
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
+		case CMD_BENCHODE:
+		{
+			std::string meshName;
+			int repeats = 100;
+
+			optional_meshname_check_focusedmeshdefault(command_fields);
+			error = commandSpec.GetParameters(command_fields, meshName, repeats);
+			if (error == BERROR_PARAMMISMATCH) { error.reset() = commandSpec.GetParameters(command_fields, meshName); repeats = 100; }
+
+			if (!error) {
+
+				DifferentialEquation* pmeshODE = nullptr;
+
+				if (SMesh[meshName]->GetMeshType() == MESH_FERROMAGNETIC) pmeshODE = &dynamic_cast<FMesh*>(SMesh[meshName])->Get_DifferentialEquation();
+				else if (SMesh[meshName]->GetMeshType() == MESH_ANTIFERROMAGNETIC) pmeshODE = &dynamic_cast<AFMesh*>(SMesh[meshName])->Get_DifferentialEquation();
+
+				if (pmeshODE) {
+
+					StopSimulation();
+
+					DBL3 throughput;
+
+					error = pmeshODE->Benchmark_Equation(repeats, true, throughput.i);
+					if (!error) error = pmeshODE->Benchmark_Equation(repeats, false, throughput.j);
+
+					//overhead of deterministic reductions
+					if (!error) {
+
+						bool deterministic = OmpReduction_Deterministic();
+						OmpReduction_Deterministic() = true;
+						error = pmeshODE->Benchmark_Equation(repeats, false, throughput.k);
+						OmpReduction_Deterministic() = deterministic;
+					}
+
+					if (!error) {
+
+						if (verbose) BD.DisplayConsoleListing("Equation evaluation in " + meshName + " (" + ToString(dynamic_cast<Mesh*>(SMesh[meshName])->M.get_nonempty_cells()) + " cells) : function pointer " + ToString(throughput.i) + " cells/s, specialised " + ToString(throughput.j) + " cells/s, specialised with deterministic reductions " + ToString(throughput.k) + " cells/s, per thread.");
+
+						if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(throughput));
+					}
+				}
+				else error(BERROR_INCORRECTACTION);
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
 		case CMD_MATERIALSDATABASE:
 		{
 			std::string mdbName;
@@ -5592,6 +6029,26 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_DETERMINISTIC:
+		{
+			int status;
+
+			error = commandSpec.GetParameters(command_fields, status);
+
+			if (!error) {
+
+				StopSimulation();
+
+				OmpReduction_Deterministic() = (bool)status;
+
+				UpdateScreen();
+			}
+			else if (verbose) BD.DisplayConsoleListing("Deterministic reductions : " + std::string(OmpReduction_Deterministic() ? "on" : "off"));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters((int)OmpReduction_Deterministic()));
+		}
+		break;
+
 		case CMD_SERVERPORT:
 		{
 			int port;
@@ -5842,6 +6299,32 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_MCMOVES:
+		{
+			int overrelax;
+			bool cluster;
+			std::string meshName;
+
+			optional_meshname_check_focusedmeshdefault(command_fields);
+			error = commandSpec.GetParameters(command_fields, meshName, overrelax, cluster);
+
+			if (!error) {
+
+				if (!err_hndl.qcall(error, &SuperMesh::Set_MonteCarlo_Moves, &SMesh, overrelax, cluster, meshName)) UpdateScreen();
+			}
+			else if (verbose) {
+
+				for (int idx = 0; idx < SMesh.size(); idx++) {
+
+					INT2 moves = SMesh[idx]->Get_MonteCarlo_Moves();
+					BD.DisplayConsoleListing(SMesh.key_from_meshIdx(idx) + " : over-relaxation sweeps : " + ToString(moves.i) + ", cluster updates : " + ToString(moves.j));
+				}
+			}
+
+			if (script_client_connected && SMesh.contains(meshName)) commSocket.SetSendData(commandSpec.PrepareReturnParameters(SMesh[meshName]->Get_MonteCarlo_Moves()));
+		}
+		break;
+
 		case CMD_MCDISABLE:
 		{
 			bool status;
@@ -5894,6 +6377,167 @@ void Simulation::HandleCommand(std::string command_string)
 		}
 		break;
 
+		case CMD_PARALLELTEMPERING:
+		{
+			double Tmin, Tmax;
+			int replicas;
+
+			error = commandSpec.GetParameters(command_fields, Tmin, Tmax, replicas);
+
+			if (!error) {
+
+				StopSimulation();
+
+				error = SMesh.ParallelTempering_Set(Tmin, Tmax, replicas);
+
+				UpdateScreen();
+			}
+			else if (verbose) {
+
+				DBL3 settings = SMesh.ParallelTempering_Get_Settings();
+				if (SMesh.ParallelTempering_Enabled()) BD.DisplayConsoleListing("Parallel tempering : " + ToString((int)settings.k) + " replicas between " + ToString(settings.i, "K") + " and " + ToString(settings.j, "K") + ", swap acceptance rate : " + ToString(SMesh.ParallelTempering_Get_SwapRate()));
+				else BD.DisplayConsoleListing("Parallel tempering disabled.");
+			}
+
+			if (script_client_connected) {
+
+				DBL3 settings = SMesh.ParallelTempering_Get_Settings();
+				commSocket.SetSendData(commandSpec.PrepareReturnParameters(settings.i, settings.j, (int)settings.k));
+			}
+		}
+		break;
+
+		case CMD_PARALLELTEMPERINGDATA:
+		{
+			int dp_T, dp_E, dp_C, dp_M, dp_swap;
+
+			error = commandSpec.GetParameters(command_fields, dp_T, dp_E, dp_C, dp_M, dp_swap);
+
+			if (!error) {
+
+				if (!dpArr.GoodArrays_Unique(dp_T, dp_E, dp_C, dp_M, dp_swap)) error(BERROR_INCORRECTARRAYS);
+				else {
+
+					SMesh.ParallelTempering_Get_Data(dpArr[dp_T], dpArr[dp_E], dpArr[dp_C], dpArr[dp_M], dpArr[dp_swap]);
+
+					if (verbose) BD.DisplayConsoleMessage("Parallel tempering data extracted.");
+				}
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
+		case CMD_GNEB:
+		{
+			int images, iterations;
+
+			error = commandSpec.GetParameters(command_fields, images, iterations);
+
+			if (!error) {
+
+				StopSimulation();
+
+				bool converged = false;
+				error = SMesh.GNEB_Run(images, iterations, converged);
+
+				if (!error) {
+
+					DBL3 barrier = SMesh.GNEB_Get_Barrier();
+
+					if (verbose) BD.DisplayConsoleMessage("GNEB " + std::string(converged ? "converged" : "not converged") + " : barrier = " + ToString(barrier.x, "J") + " at image " + ToString((int)barrier.y) + ", residual = " + ToString(barrier.z, "A/m"));
+
+					if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(barrier.x, (int)barrier.y, barrier.z, (int)converged));
+				}
+
+				UpdateScreen();
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
+		case CMD_GNEBENDPOINT:
+		{
+			int endpoint;
+
+			error = commandSpec.GetParameters(command_fields, endpoint);
+
+			if (!error) {
+
+				StopSimulation();
+
+				error = SMesh.GNEB_SetEndpoint(endpoint);
+
+				if (!error && verbose) BD.DisplayConsoleMessage("GNEB " + std::string(endpoint ? "final" : "initial") + " state set.");
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
+		case CMD_GNEBSETTINGS:
+		{
+			double spring, step, tolerance;
+			bool climbing;
+
+			error = commandSpec.GetParameters(command_fields, spring, climbing, step, tolerance);
+
+			if (!error) {
+
+				SMesh.GNEB_SetSettings(spring, climbing, step, tolerance);
+			}
+			else if (verbose) {
+
+				DBL4 settings = SMesh.GNEB_GetSettings();
+				BD.DisplayConsoleListing("GNEB spring : " + ToString(settings.i, "J") + ", climbing image : " + ToString((int)settings.j) + ", step : " + ToString(settings.k) + " rad, tolerance : " + ToString(settings.l, "A/m"));
+			}
+
+			if (script_client_connected) {
+
+				DBL4 settings = SMesh.GNEB_GetSettings();
+				commSocket.SetSendData(commandSpec.PrepareReturnParameters(settings.i, (int)settings.j, settings.k, settings.l));
+			}
+		}
+		break;
+
+		case CMD_GNEBIMAGE:
+		{
+			int image;
+
+			error = commandSpec.GetParameters(command_fields, image);
+
+			if (!error) {
+
+				StopSimulation();
+
+				error = SMesh.GNEB_LoadImage(image);
+
+				UpdateScreen();
+			}
+			else if (verbose) BD.DisplayConsoleListing("GNEB images : " + ToString(SMesh.GNEB_Get_Images()));
+
+			if (script_client_connected) commSocket.SetSendData(commandSpec.PrepareReturnParameters(SMesh.GNEB_Get_Images()));
+		}
+		break;
+
+		case CMD_GNEBMEP:
+		{
+			int dp_coord, dp_energy;
+
+			error = commandSpec.GetParameters(command_fields, dp_coord, dp_energy);
+
+			if (!error) {
+
+				if (!dpArr.GoodArrays_Unique(dp_coord, dp_energy)) error(BERROR_INCORRECTARRAYS);
+				else {
+
+					SMesh.GNEB_Get_MEP(dpArr[dp_coord], dpArr[dp_energy]);
+
+					if (verbose) BD.DisplayConsoleMessage("Minimum energy path extracted.");
+				}
+			}
+			else if (verbose) PrintCommandUsage(command_name);
+		}
+		break;
+
 		case CMD_PRNGSEED:
 		{
 			int seed;
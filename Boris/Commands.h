@@ -15,6 +15,7 @@ enum CMD_
 	CMD_SAVESIM, CMD_LOADSIM, CMD_DEFAULT,
 
 	CMD_NEXTSTAGE, CMD_SETSCHEDULESTAGE, CMD_RUNSTAGE,
+	CMD_ENSEMBLE,
 
 	//-------------------------------------------SCRIPTING-------------------------------------------
 
@@ -98,16 +99,19 @@ enum CMD_
 	//Demag computation control
 
 	CMD_MULTICONV, CMD_2DMULTICONV, CMD_NCOMMONSTATUS, CMD_NCOMMON, CMD_EXCLUDEMULTICONVDEMAG,
-	CMD_GPUKERNELS,
+	CMD_GPUKERNELS, CMD_FFTWPLANNER, CMD_DEMAGKERNELCACHE, CMD_FFTTILING, CMD_CONVPROFILING, CMD_FFTSINGLEPRECISION, CMD_FFTPRECISIONCHECK, CMD_FFTPADDING, CMD_KERNELSIMD, CMD_DEMAGASYMPTOTIC, CMD_MULTICONVTASKS, CMD_DEMAGTREE,
 
 	//-------------------------------------------ODE-------------------------------------------
 
 	//General
 
 	CMD_ODE, CMD_SETODE, CMD_SETODEEVAL, CMD_SETATOMODE, CMD_SETDT, CMD_ASTEPCTRL,
+	CMD_ASTEPCONTROLLER,
 
 	CMD_EVALSPEEDUP, CMD_SETDTSPEEDUP, CMD_LINKDTSPEEDUP,
 
+	CMD_MULTIRATE, CMD_ACTIVESET,
+
 	//Stochasticity
 
 	CMD_STOCHASTIC, CMD_LINKSTOCHASTIC, CMD_SETDTSTOCH, CMD_LINKDTSTOCHASTIC,
@@ -167,12 +171,12 @@ enum CMD_
 	//-------------------------------------------OTHERS-------------------------------------------
 
 	CMD_OPENMANUAL,
-	CMD_BENCHTIME,
+	CMD_BENCHTIME, CMD_BENCHFFTTILING, CMD_BENCHKERNELSIMD, CMD_BENCHODE,
 	CMD_SHOWLENGHTS, CMD_SHOWMCELLS,
 	CMD_SCRIPTSERVER, CMD_CHECKUPDATES,
 	CMD_FLUSHERRORLOG, CMD_ERRORLOG,
 	CMD_STARTUPUPDATECHECK, CMD_STARTUPSCRIPTSERVER,
-	CMD_THREADS,
+	CMD_THREADS, CMD_DETERMINISTIC,
 	CMD_SERVERPORT, CMD_SERVERPWD, CMD_SERVERSLEEPMS,
 	CMD_NEWINSTANCE,
 
@@ -203,7 +207,11 @@ enum CMD_
 
 	//-------------------------------------------MONTE CARLO-------------------------------------------
 
-	CMD_MCSERIAL, CMD_MCDISABLE, CMD_MCCONSTRAIN, CMD_MCCOMPUTEFIELDS, CMD_MCCONEANGLELIMITS,
+	CMD_MCSERIAL, CMD_MCDISABLE, CMD_MCCONSTRAIN, CMD_MCMOVES, CMD_MCCOMPUTEFIELDS, CMD_MCCONEANGLELIMITS, CMD_PARALLELTEMPERING, CMD_PARALLELTEMPERINGDATA,
+
+	//-------------------------------------------ENERGY BARRIERS-------------------------------------------
+
+	CMD_GNEB, CMD_GNEBENDPOINT, CMD_GNEBSETTINGS, CMD_GNEBIMAGE, CMD_GNEBMEP,
 
 	//-------------------------------------------PRNG-------------------------------------------
 	
@@ -108,7 +108,10 @@
 #define ODE_EVAL_COMPILATION_RKF56
 #define ODE_EVAL_COMPILATION_RKCK
 #define ODE_EVAL_COMPILATION_RKDP
+#define ODE_EVAL_COMPILATION_LSRK
+#define ODE_EVAL_COMPILATION_IMEX
 #define ODE_EVAL_COMPILATION_SD
+#define ODE_EVAL_COMPILATION_NCG
 
 #elif ODE_EVAL_COMPILATION == ODE_EVAL_COMPILATION_TEST
 
@@ -147,6 +150,7 @@
 #define MODULE_COMPILATION_ANITENS
 #define MODULE_COMPILATION_DEMAG
 #define MODULE_COMPILATION_DEMAG_N
+#define MODULE_COMPILATION_DEMAG_TREE
 #define MODULE_COMPILATION_DMEXCHANGE
 #define MODULE_COMPILATION_EXCHANGE
 #define MODULE_COMPILATION_IDMEXCHANGE
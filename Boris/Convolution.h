@@ -34,6 +34,9 @@ private:
 	//if the object couldn't be created properly in the constructor an error is set here
 	BError convolution_error_on_create;
 
+	//dot product reduction (In * Out, used for the energy) over output lines, used only if deterministic reductions are enabled (otherwise an OpenMP reduction clause is used)
+	OmpReduction<double> dot_product_reduction;
+
 private:
 
 	//Embedded (default)
@@ -54,6 +57,12 @@ private:
 	double Convolute_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr);
 	double Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr);
 
+	//Embedded, single precision ffts (single_precision set)
+
+	//all three input/output combinations above : averaged inputs if pIn2 not null, duplicated outputs if pOut2 not null
+	double Convolute_2D_SP(VEC<DBL3> &In1, VEC<DBL3>* pIn2, VEC<DBL3> &Out1, VEC<DBL3>* pOut2, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr);
+	double Convolute_3D_SP(VEC<DBL3> &In1, VEC<DBL3>* pIn2, VEC<DBL3> &Out1, VEC<DBL3>* pOut2, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr);
+
 	//Not embedded
 
 	//SINGLE INPUT
@@ -128,8 +137,14 @@ protected:
 
 	//-------------------------- CHECK
 
-	//return true only if both n_ and h_ match the current FFT dimensions (n and h); also number of pbc images must match
-	bool CheckDimensions(SZ3 n_, DBL3 h_, INT3 pbc_images_) { return (n == n_ && h == h_ && pbc_images == pbc_images_); }
+	//return true only if both n_ and h_ match the current FFT dimensions (n and h); also number of pbc images must match, and fft precision in use must be the one currently selected
+	bool CheckDimensions(SZ3 n_, DBL3 h_, INT3 pbc_images_) { return (n == n_ && h == h_ && pbc_images == pbc_images_ && single_precision == (fft_single_precision && embed_multiplication)); }
+
+	//-------------------------- PRECISION CHECK
+
+	//run the convolution on In in both double and single precision fft modes (embedded multiplication only), and return in accuracy :
+	//x : maximum output difference relative to maximum output value, y : relative difference in dot product of In with output
+	BError Compare_Precision(VEC<DBL3> &In, DBL2& accuracy);
 
 	//-------------------------- RUN-TIME CONVOLUTION
 
@@ -141,6 +156,8 @@ protected:
 	//Return dot product of In with Out
 	double Convolute(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr)
 	{
+		if (single_precision) return (n.z == 1 ? Convolute_2D_SP(In, nullptr, Out, nullptr, clearOut, pH, penergy) : Convolute_3D_SP(In, nullptr, Out, nullptr, clearOut, pH, penergy));
+
 		if (n.z == 1) return Convolute_2D(In, Out, clearOut, pH, penergy);
 		else return Convolute_3D(In, Out, clearOut, pH, penergy);
 	}
@@ -152,6 +169,8 @@ protected:
 	//Same as Convolution with (In1 + In2) / 2 as input.
 	double Convolute_AveragedInputs(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr)
 	{
+		if (single_precision) return (n.z == 1 ? Convolute_2D_SP(In1, &In2, Out, nullptr, clearOut, pH, penergy) : Convolute_3D_SP(In1, &In2, Out, nullptr, clearOut, pH, penergy));
+
 		if (n.z == 1) return Convolute_2D(In1, In2, Out, clearOut, pH, penergy);
 		else return Convolute_3D(In1, In2, Out, clearOut, pH, penergy);
 	}
@@ -163,6 +182,8 @@ protected:
 	//Same as Convolution with (In1 + In2) / 2 as input and output copied to both Out1 and Out2.
 	double Convolute_AveragedInputs_DuplicatedOutputs(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH = nullptr, VEC<double>* penergy = nullptr)
 	{
+		if (single_precision) return (n.z == 1 ? Convolute_2D_SP(In1, &In2, Out1, &Out2, clearOut, pH, penergy) : Convolute_3D_SP(In1, &In2, Out1, &Out2, clearOut, pH, penergy));
+
 		if (n.z == 1) return Convolute_2D(In1, In2, Out1, Out2, clearOut, pH, penergy);
 		else return Convolute_3D(In1, In2, Out1, Out2, clearOut, pH, penergy);
 	}
@@ -263,406 +284,347 @@ double Convolution<Owner, Kernel>::Convolute_2D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 {
 	//2D
 
-	//1. FFTs along x
-#pragma omp parallel for
-	for (int j = 0; j < n.y; j++) {
-
-		int tn = omp_get_thread_num();
-
-		//write input into fft line (zero padding kept)
-		for (int i = 0; i < n.x; i++) {
-
-			int idx_in = i + j * n.x;
-
-			*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
-		}
-
-		//fft on line
-		fftw_execute(plan_fwd_x[tn]);
-
-		//write line to fft array
-		for (int i = 0; i < N.x / 2 + 1; i++) {
-
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
-		}
-	}
+	double dot_product = 0;
 
-	//2. FFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
 
-		int tn = omp_get_thread_num();
+	if (profiling) Profile_Start();
 
-		//fetch line from fft array (zero padding kept)
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
 		for (int j = 0; j < n.y; j++) {
 
-			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
-		}
+			int tn = omp_get_thread_num();
 
-		//fft on line
-		fftw_execute(plan_fwd_y[tn]);
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
 
-		//3. kernel multiplication on line
-		static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
+				int idx_in = i + j * n.x;
 
-		//4. ifft on line
-		fftw_execute(plan_inv_y[tn]);
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
+			}
 
-		//write line to fft array, truncating upper part (from n.y to N.y if different)
-		for (int j = 0; j < n.y; j++) {
+			//fft on line
+			fftw_execute(plan_fwd_x[tn]);
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
-		}
-	}
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-	double dot_product = 0;
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+			}
+		}
 
-	if (clearOut) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+		//2. FFTs along y
+#pragma omp for
+		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			//fetch line from fft array (zero padding kept)
+			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-			//write line to output
-			for (int i = 0; i < n.x; i++) {
+			fftw_execute(plan_fwd_y[tn]);
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = In[i + j * n.x];
+			//3. kernel multiplication on line
+			static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
 
-				Out[i + j * n.x] = Out_val;
+			//4. ifft on line
+			fftw_execute(plan_inv_y[tn]);
 
-				dot_product += In_val * Out_val;
+			//write line to fft array, truncating upper part (from n.y to N.y if different)
+			for (int j = 0; j < n.y; j++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
-	else {
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
 
-			int tn = omp_get_thread_num();
+		if (clearOut) {
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
-			}
+				int tn = omp_get_thread_num();
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
 
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
 
-			//add line to output
-			for (int i = 0; i < n.x; i++) {
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = In[i + j * n.x];
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = In[i + j * n.x];
 
-				Out[i + j * n.x] += Out_val;
+					Out[i + j * n.x] = Out_val;
 
-				dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
+		else {
 
-	return dot_product;
-}
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
 
-//AVERAGED INPUTS, SINGLE OUTPUT
-template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::Convolute_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{
-	//2D
+				int tn = omp_get_thread_num();
 
-	//1. FFTs along x
-#pragma omp parallel for
-	for (int j = 0; j < n.y; j++) {
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-		int tn = omp_get_thread_num();
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
 
-		//write input into fft line (zero padding kept)
-		for (int i = 0; i < n.x; i++) {
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
 
-			int idx_in = i + j * n.x;
 
-			*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
-		}
+				double line_dot_product = 0.0;
 
-		//fft on line
-		fftw_execute(plan_fwd_x[tn]);
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
 
-		//write line to fft array
-		for (int i = 0; i < N.x / 2 + 1; i++) {
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = In[i + j * n.x];
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
-		}
-	}
+					Out[i + j * n.x] += Out_val;
 
-	//2. FFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+					line_dot_product += In_val * Out_val;
 
-		int tn = omp_get_thread_num();
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
 
-		//fetch line from fft array (zero padding kept)
-		for (int j = 0; j < n.y; j++) {
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
 
-			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
+	}
 
-		//fft on line
-		fftw_execute(plan_fwd_y[tn]);
-
-		//3. kernel multiplication on line
-		static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
+	if (profiling) Profile_End();
 
-		//4. ifft on line
-		fftw_execute(plan_inv_y[tn]);
+	if (deterministic) dot_product = dot_product_reduction.sum();
 
-		//write line to fft array, truncating upper part (from n.y to N.y if different)
-		for (int j = 0; j < n.y; j++) {
+	return dot_product;
+}
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
-		}
-	}
+//AVERAGED INPUTS, SINGLE OUTPUT
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::Convolute_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
+	//2D
 
 	double dot_product = 0;
 
-	if (clearOut) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
 		for (int j = 0; j < n.y; j++) {
 
 			int tn = omp_get_thread_num();
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
+
+				int idx_in = i + j * n.x;
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-			//write line to output
-			for (int i = 0; i < n.x; i++) {
-
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
-
-				Out[i + j * n.x] = Out_val;
+			fftw_execute(plan_fwd_x[tn]);
 
-				dot_product += In_val * Out_val;
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
-	else {
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
+		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			//fetch line from fft array (zero padding kept)
+			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-
-			//add line to output
-			for (int i = 0; i < n.x; i++) {
+			fftw_execute(plan_fwd_y[tn]);
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+			//3. kernel multiplication on line
+			static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
 
-				Out[i + j * n.x] += Out_val;
+			//4. ifft on line
+			fftw_execute(plan_inv_y[tn]);
 
-				dot_product += In_val * Out_val;
+			//write line to fft array, truncating upper part (from n.y to N.y if different)
+			for (int j = 0; j < n.y; j++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
-
-	return dot_product;
-}
-
-//AVERAGED INPUTS, DUPLICATED OUTPUTS
-template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::Convolute_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{
-	//2D
-
-	//1. FFTs along x
-#pragma omp parallel for
-	for (int j = 0; j < n.y; j++) {
 
-		int tn = omp_get_thread_num();
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
 
-		//write input into fft line (zero padding kept)
-		for (int i = 0; i < n.x; i++) {
+		if (clearOut) {
 
-			int idx_in = i + j * n.x;
-
-			*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
-		}
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
 
-		//fft on line
-		fftw_execute(plan_fwd_x[tn]);
+				int tn = omp_get_thread_num();
 
-		//write line to fft array
-		for (int i = 0; i < N.x / 2 + 1; i++) {
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
-		}
-	}
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
 
-	//2. FFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
 
-		int tn = omp_get_thread_num();
+				double line_dot_product = 0.0;
 
-		//fetch line from fft array (zero padding kept)
-		for (int j = 0; j < n.y; j++) {
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
 
-			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
-		}
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
 
-		//fft on line
-		fftw_execute(plan_fwd_y[tn]);
+					Out[i + j * n.x] = Out_val;
 
-		//3. kernel multiplication on line
-		static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
+					line_dot_product += In_val * Out_val;
 
-		//4. ifft on line
-		fftw_execute(plan_inv_y[tn]);
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
 
-		//write line to fft array, truncating upper part (from n.y to N.y if different)
-		for (int j = 0; j < n.y; j++) {
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-
-	double dot_product = 0;
-
-	if (clearOut) {
+		else {
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
-
-			int tn = omp_get_thread_num();
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+				int tn = omp_get_thread_num();
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
-			}
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
 
-			//write line to output
-			for (int i = 0; i < n.x; i++) {
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x] ) / 2;
 
-				Out1[i + j * n.x] = Out_val;
-				Out2[i + j * n.x] = Out_val;
+				double line_dot_product = 0.0;
 
-				dot_product += In_val * Out_val;
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
-			}
-		}
-	}
-	else {
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
 
-		//5. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+					Out[i + j * n.x] += Out_val;
 
-			int tn = omp_get_thread_num();
+					line_dot_product += In_val * Out_val;
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-
-			//add line to output
-			for (int i = 0; i < n.x; i++) {
-
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
-
-				Out1[i + j * n.x] += Out_val;
-				Out2[i + j * n.x] += Out_val;
-
-				dot_product += In_val * Out_val;
-
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
-			}
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
-//-------------------------- RUN-TIME CONVOLUTION : 3D (multiplication embedded)
-
-//SINGLE INPUT, SINGLE OUTPUT
+//AVERAGED INPUTS, DUPLICATED OUTPUTS
 template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{	
-	//3D
+double Convolution<Owner, Kernel>::Convolute_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
+	//2D
 
-	//1. FFTs along x
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
 		for (int j = 0; j < n.y; j++) {
 
 			int tn = omp_get_thread_num();
@@ -670,9 +632,9 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 			//write input into fft line (zero padding kept)
 			for (int i = 0; i < n.x; i++) {
 
-				int idx_in = i + j * n.x + k * n.x * n.y;
+				int idx_in = i + j * n.x;
 
-				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
 			}
 
 			//fft on line
@@ -681,14 +643,15 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 			//write line to fft array
 			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
 
-	//2. FFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
 		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
@@ -696,29 +659,208 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 			//fetch line from fft array (zero padding kept)
 			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
 			fftw_execute(plan_fwd_y[tn]);
 
-			//write line to fft array
-			for (int j = 0; j < N.y; j++) {
+			//3. kernel multiplication on line
+			static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+			//4. ifft on line
+			fftw_execute(plan_inv_y[tn]);
+
+			//write line to fft array, truncating upper part (from n.y to N.y if different)
+			for (int j = 0; j < n.y; j++) {
+
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	//3. FFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
 
-			int tn = omp_get_thread_num();
+		if (clearOut) {
 
-			//fetch line from fft array (zero padding kept)
-			for (int k = 0; k < n.z; k++) {
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x] ) / 2;
+
+					Out1[i + j * n.x] = Out_val;
+					Out2[i + j * n.x] = Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
+		}
+		else {
+
+			//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+
+				double line_dot_product = 0.0;
+
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+
+					Out1[i + j * n.x] += Out_val;
+					Out2[i + j * n.x] += Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
+		}
+	}
+
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
+	return dot_product;
+}
+
+//-------------------------- RUN-TIME CONVOLUTION : 3D (multiplication embedded)
+
+//SINGLE INPUT, SINGLE OUTPUT
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{	
+	//3D
+
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
+
+			int tn = omp_get_thread_num();
+
+			int j = jk % n.y;
+			int k = jk / n.y;
+
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
+
+				int idx_in = i + j * n.x + k * n.x * n.y;
+
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
+			}
+
+			//fft on line
+			fftw_execute(plan_fwd_x[tn]);
+
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
+
+				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+			}
+		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
+
+			int tn = omp_get_thread_num();
+
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
+			//fetch line from fft array (zero padding kept)
+			for (int j = 0; j < n.y; j++) {
+
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+			}
+
+			//fft on line
+			fftw_execute(plan_fwd_y[tn]);
+
+			//write line to fft array
+			for (int j = 0; j < N.y; j++) {
+
+				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+			}
+		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
+
+		//3. FFTs along z
+#pragma omp for
+		for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
+
+			int tn = omp_get_thread_num();
+
+			int i = ij % (N.x / 2 + 1);
+			int j = ij / (N.x / 2 + 1);
+
+			//fetch line from fft array (zero padding kept)
+			for (int k = 0; k < n.z; k++) {
 
 				*reinterpret_cast<ReIm3*>(pline_zp_z[tn] + k * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
 			}
@@ -738,15 +880,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
 			}
 		}
-	}
 
-	//6. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
+
+		//6. IFFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
 			//fetch line from fft array
 			for (int j = 0; j < N.y; j++) {
 
@@ -762,19 +908,21 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	double dot_product = 0;
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
 
-	if (clearOut) {
+		if (clearOut) {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -784,6 +932,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -792,24 +942,31 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 
 					Out[i + j * n.x + k * n.x * n.y] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -819,6 +976,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -827,16 +986,26 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 
 					Out[i + j * n.x + k * n.x * n.y] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
@@ -844,13 +1013,24 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In, VEC<DBL3> &Out, b
 template <typename Owner, typename Kernel>
 double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
-	//1. FFTs along x
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int j = 0; j < n.y; j++) {
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
 			int tn = omp_get_thread_num();
 
+			int j = jk % n.y;
+			int k = jk / n.y;
+
 			//write input into fft line (zero padding kept)
 			for (int i = 0; i < n.x; i++) {
 
@@ -868,15 +1048,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
 
-	//2. FFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
 			//fetch line from fft array (zero padding kept)
 			for (int j = 0; j < n.y; j++) {
 
@@ -892,15 +1076,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	//3. FFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
+
+		//3. FFTs along z
+#pragma omp for
+		for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ij % (N.x / 2 + 1);
+			int j = ij / (N.x / 2 + 1);
+
 			//fetch line from fft array (zero padding kept)
 			for (int k = 0; k < n.z; k++) {
 
@@ -922,15 +1110,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
 			}
 		}
-	}
 
-	//6. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
+
+		//6. IFFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
 			//fetch line from fft array
 			for (int j = 0; j < N.y; j++) {
 
@@ -946,19 +1138,21 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	double dot_product = 0;
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
 
-	if (clearOut) {
+		if (clearOut) {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -968,6 +1162,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -976,24 +1172,31 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 
 					Out[i + j * n.x + k * n.x * n.y] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -1003,6 +1206,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -1011,16 +1216,26 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 
 					Out[i + j * n.x + k * n.x * n.y] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
@@ -1028,13 +1243,24 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 template <typename Owner, typename Kernel>
 double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
-	//1. FFTs along x
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int j = 0; j < n.y; j++) {
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
 			int tn = omp_get_thread_num();
 
+			int j = jk % n.y;
+			int k = jk / n.y;
+
 			//write input into fft line (zero padding kept)
 			for (int i = 0; i < n.x; i++) {
 
@@ -1052,15 +1278,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
 
-	//2. FFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
 			//fetch line from fft array (zero padding kept)
 			for (int j = 0; j < n.y; j++) {
 
@@ -1076,15 +1306,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	//3. FFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
+
+		//3. FFTs along z
+#pragma omp for
+		for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ij % (N.x / 2 + 1);
+			int j = ij / (N.x / 2 + 1);
+
 			//fetch line from fft array (zero padding kept)
 			for (int k = 0; k < n.z; k++) {
 
@@ -1106,15 +1340,19 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
 			}
 		}
-	}
 
-	//6. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
+
+		//6. IFFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
 			int tn = omp_get_thread_num();
 
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
+
 			//fetch line from fft array
 			for (int j = 0; j < N.y; j++) {
 
@@ -1130,19 +1368,21 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	double dot_product = 0;
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
 
-	if (clearOut) {
+		if (clearOut) {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -1152,6 +1392,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -1161,24 +1403,31 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 					Out1[i + j * n.x + k * n.x * n.y] = Out_val;
 					Out2[i + j * n.x + k * n.x * n.y] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//7. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -1188,6 +1437,8 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -1197,143 +1448,118 @@ double Convolution<Owner, Kernel>::Convolute_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 					Out1[i + j * n.x + k * n.x * n.y] += Out_val;
 					Out2[i + j * n.x + k * n.x * n.y] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
-//-------------------------- RUN-TIME CONVOLUTION : 2D (multiplication not embedded)
-
-//SINGLE INPUT
+//-------------------------- RUN-TIME CONVOLUTION : single precision ffts (multiplication embedded)
 
-//1. Forward (In -> F)
+//Same flow as the embedded convolutions above, but with fftwf on the Ff scratch space. Kernel multiplication is done on the double precision line.
+//If pIn2 is not null then (In1 + *pIn2) / 2 is used as input; if pOut2 is not null then output is also copied to it.
 template <typename Owner, typename Kernel>
-void Convolution<Owner, Kernel>::ForwardFFT_2D(VEC<DBL3> &In)
+double Convolution<Owner, Kernel>::Convolute_2D_SP(VEC<DBL3> &In1, VEC<DBL3>* pIn2, VEC<DBL3> &Out1, VEC<DBL3>* pOut2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
 	//2D
 
-	//1. FFTs along x
-#pragma omp parallel for
-	for (int j = 0; j < n.y; j++) {
-
-		int tn = omp_get_thread_num();
+	double dot_product = 0;
 
-		//write input into fft line (zero padding kept)
-		for (int i = 0; i < n.x; i++) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
 
-			int idx_in = i + j * n.x;
+	if (profiling) Profile_Start();
 
-			*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
-		}
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int j = 0; j < n.y; j++) {
 
-		//fft on line
-		fftw_execute(plan_fwd_x[tn]);
+			int tn = omp_get_thread_num();
 
-		//write line to fft array
-		for (int i = 0; i < N.x / 2 + 1; i++) {
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
-		}
-	}
+				int idx_in = i + j * n.x;
 
-	//2. FFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+				if (pIn2) *reinterpret_cast<FLT3*>(plinef_zp_x[tn] + i * 3) = (In1[idx_in] + (*pIn2)[idx_in]) / 2;
+				else *reinterpret_cast<FLT3*>(plinef_zp_x[tn] + i * 3) = In1[idx_in];
+			}
 
-		int tn = omp_get_thread_num();
+			//fft on line
+			fftwf_execute(planf_fwd_x[tn]);
 
-		//fetch line from fft array (zero padding kept)
-		for (int j = 0; j < n.y; j++) {
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
+				Ff[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3F*>(plinef[tn] + i * 3);
+			}
 		}
 
-		//fft on line
-		fftw_execute(plan_fwd_y[tn]);
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
 
-		//write line to fft array
-		for (int j = 0; j < N.y; j++) {
+		//2. FFTs along y
+#pragma omp for
+		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
-		}
-	}
-}
+			int tn = omp_get_thread_num();
 
-//SINGLE OUTPUT
+			//fetch line from fft array (zero padding kept)
+			for (int j = 0; j < n.y; j++) {
 
-//3. Inverse. Return dot product of In with Out. (F2 -> Out)
-template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{
-	//1. IFFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+				*reinterpret_cast<ReIm3F*>(plinef_zp_y[tn] + j * 3) = Ff[i + j * (N.x / 2 + 1)];
+			}
 
-		int tn = omp_get_thread_num();
+			//fft on line
+			fftwf_execute(planf_fwd_y[tn]);
 
-		//fetch line from fft array
-		for (int j = 0; j < N.y; j++) {
+			//3. kernel multiplication on line, in double precision
+			for (int j = 0; j < N.y; j++) {
 
-			*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
-		}
+				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = *reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3);
+			}
 
-		//fft on line
-		fftw_execute(plan_inv_y[tn]);
+			static_cast<Owner*>(this)->KernelMultiplication_2D_line(reinterpret_cast<ReIm3*>(pline[tn]), i);
 
-		//write line to fft array, truncating upper half
-		for (int j = 0; j < n.y; j++) {
-
-			F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
-		}
-	}
-
-	double dot_product = 0;
-
-	if (clearOut) {
-
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
-
-			int tn = omp_get_thread_num();
-
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			for (int j = 0; j < N.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3) = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-			//write line to output
-			for (int i = 0; i < n.x; i++) {
-
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = In[i + j * n.x];
+			//4. ifft on line
+			fftwf_execute(planf_inv_y[tn]);
 
-				Out[i + j * n.x] = Out_val;
-
-				dot_product += In_val * Out_val;
+			//write line to fft array, truncating upper part (from n.y to N.y if different)
+			for (int j = 0; j < n.y; j++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				Ff[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3);
 			}
 		}
-	}
-	else {
 
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
+
+		//5. IFFTs along x
+#pragma omp for reduction(+:dot_product)
 		for (int j = 0; j < n.y; j++) {
 
 			int tn = omp_get_thread_num();
@@ -1341,300 +1567,323 @@ double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In, VEC<DBL3> &Out,
 			//write input into fft line
 			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3F*>(plinef[tn] + i * 3) = Ff[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
+			fftwf_execute(planf_inv_x[tn]);
 
-			//add line to output
+			double line_dot_product = 0.0;
+
+			//write or add line to output : from here on double precision
 			for (int i = 0; i < n.x; i++) {
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = In[i + j * n.x];
+				int idx_out = i + j * n.x;
+
+				DBL3 Out_val = DBL3(*reinterpret_cast<FLT3*>(plinef_rev_x[tn] + i * 3)) / N.dim();
+				DBL3 In_val = (pIn2 ? (In1[idx_out] + (*pIn2)[idx_out]) / 2 : In1[idx_out]);
+
+				if (clearOut) Out1[idx_out] = Out_val;
+				else Out1[idx_out] += Out_val;
+
+				if (pOut2) {
 
-				Out[i + j * n.x] += Out_val;
+					if (clearOut) (*pOut2)[idx_out] = Out_val;
+					else (*pOut2)[idx_out] += Out_val;
+				}
 
-				dot_product += In_val * Out_val;
+				line_dot_product += In_val * Out_val;
 
 				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				if (pH) (*pH)[idx_out] = Out_val;
+				if (penergy) (*penergy)[idx_out] = -MU0 * (In_val * Out_val) / 2;
 			}
+
+			if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+			else dot_product += line_dot_product;
 		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
-//AVERAGED INPUTS
-
-//1. Forward (In -> F)
 template <typename Owner, typename Kernel>
-void Convolution<Owner, Kernel>::ForwardFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2)
+double Convolution<Owner, Kernel>::Convolute_3D_SP(VEC<DBL3> &In1, VEC<DBL3>* pIn2, VEC<DBL3> &Out1, VEC<DBL3>* pOut2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
-	//2D
+	//3D
 
-	//1. FFTs along x
-#pragma omp parallel for
-	for (int j = 0; j < n.y; j++) {
+	double dot_product = 0;
 
-		int tn = omp_get_thread_num();
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
 
-		//write input into fft line (zero padding kept)
-		for (int i = 0; i < n.x; i++) {
+	if (profiling) Profile_Start();
 
-			int idx_in = i + j * n.x;
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
-			*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
-		}
+			int tn = omp_get_thread_num();
 
-		//fft on line
-		fftw_execute(plan_fwd_x[tn]);
+			int j = jk % n.y;
+			int k = jk / n.y;
 
-		//write line to fft array
-		for (int i = 0; i < N.x / 2 + 1; i++) {
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
 
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
-		}
-	}
+				int idx_in = i + j * n.x + k * n.x * n.y;
 
-	//2. FFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+				if (pIn2) *reinterpret_cast<FLT3*>(plinef_zp_x[tn] + i * 3) = (In1[idx_in] + (*pIn2)[idx_in]) / 2;
+				else *reinterpret_cast<FLT3*>(plinef_zp_x[tn] + i * 3) = In1[idx_in];
+			}
 
-		int tn = omp_get_thread_num();
+			//fft on line
+			fftwf_execute(planf_fwd_x[tn]);
 
-		//fetch line from fft array (zero padding kept)
-		for (int j = 0; j < n.y; j++) {
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
+				Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3F*>(plinef[tn] + i * 3);
+			}
 		}
 
-		//fft on line
-		fftw_execute(plan_fwd_y[tn]);
-
-		//write line to fft array
-		for (int j = 0; j < N.y; j++) {
-
-			F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
-		}
-	}
-}
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
 
-//AVERAGED INPUTS, SINGLE OUTPUT
+		//2. FFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
-//3. Inverse. Return dot product of In with Out. (F2 -> Out)
-template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{
-	//1. IFFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+			int tn = omp_get_thread_num();
 
-		int tn = omp_get_thread_num();
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
 
-		//fetch line from fft array
-		for (int j = 0; j < N.y; j++) {
+			//fetch line from fft array (zero padding kept)
+			for (int j = 0; j < n.y; j++) {
 
-			*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
-		}
+				*reinterpret_cast<ReIm3F*>(plinef_zp_y[tn] + j * 3) = Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+			}
 
-		//fft on line
-		fftw_execute(plan_inv_y[tn]);
+			//fft on line
+			fftwf_execute(planf_fwd_y[tn]);
 
-		//write line to fft array, truncating upper half
-		for (int j = 0; j < n.y; j++) {
+			//write line to fft array
+			for (int j = 0; j < N.y; j++) {
 
-			F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3);
+			}
 		}
-	}
-
-	double dot_product = 0;
 
-	if (clearOut) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
 
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+		//3. FFTs along z
+#pragma omp for
+		for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
 
 			int tn = omp_get_thread_num();
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			int i = ij % (N.x / 2 + 1);
+			int j = ij / (N.x / 2 + 1);
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+			//fetch line from fft array (zero padding kept)
+			for (int k = 0; k < n.z; k++) {
+
+				*reinterpret_cast<ReIm3F*>(plinef_zp_z[tn] + k * 3) = Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-			//write line to output
-			for (int i = 0; i < n.x; i++) {
-
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+			fftwf_execute(planf_fwd_z[tn]);
 
-				Out[i + j * n.x] = Out_val;
-
-				dot_product += In_val * Out_val;
+			//4. kernel multiplication on line, in double precision
+			for (int k = 0; k < N.z; k++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				*reinterpret_cast<ReIm3*>(pline[tn] + k * 3) = *reinterpret_cast<ReIm3F*>(plinef[tn] + k * 3);
 			}
-		}
-	}
-	else {
-
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
 
-			int tn = omp_get_thread_num();
+			static_cast<Owner*>(this)->KernelMultiplication_3D_line(reinterpret_cast<ReIm3*>(pline[tn]), i, j);
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+			for (int k = 0; k < N.z; k++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3F*>(plinef[tn] + k * 3) = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
 			}
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
-
-			//add line to output
-			for (int i = 0; i < n.x; i++) {
-
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
-
-				Out[i + j * n.x] += Out_val;
+			//5. ifft on line
+			fftwf_execute(planf_inv_z[tn]);
 
-				dot_product += In_val * Out_val;
+			//write line to fft array, truncating upper half
+			for (int k = 0; k < n.z; k++) {
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3F*>(plinef[tn] + k * 3);
 			}
 		}
-	}
 
-	return dot_product;
-}
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_MULT);
 
-//AVERAGED INPUTS, DUPLICATED OUTPUTS
+		//6. IFFTs along y
+#pragma omp for
+		for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
 
-//3. Inverse. Return dot product of In with Out. (F2 -> Out)
-template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
-{
-	//1. IFFTs along y
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
+			int tn = omp_get_thread_num();
 
-		int tn = omp_get_thread_num();
+			int i = ik % (N.x / 2 + 1);
+			int k = ik / (N.x / 2 + 1);
 
-		//fetch line from fft array
-		for (int j = 0; j < N.y; j++) {
+			//fetch line from fft array
+			for (int j = 0; j < N.y; j++) {
 
-			*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
-		}
+				*reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3) = Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+			}
 
-		//fft on line
-		fftw_execute(plan_inv_y[tn]);
+			//fft on line
+			fftwf_execute(planf_inv_y[tn]);
 
-		//write line to fft array, truncating upper half
-		for (int j = 0; j < n.y; j++) {
+			//write line to fft array, truncating upper half
+			for (int j = 0; j < n.y; j++) {
 
-			F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3F*>(plinef[tn] + j * 3);
+			}
 		}
-	}
-
-	double dot_product = 0;
 
-	if (clearOut) {
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
 
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+		//7. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
 			int tn = omp_get_thread_num();
 
+			int j = jk % n.y;
+			int k = jk / n.y;
+
 			//write input into fft line
 			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				*reinterpret_cast<ReIm3F*>(plinef[tn] + i * 3) = Ff[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_x[tn]);
+			fftwf_execute(planf_inv_x[tn]);
+
+			double line_dot_product = 0.0;
 
-			//write line to output
+			//write or add line to output : from here on double precision
 			for (int i = 0; i < n.x; i++) {
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+				int idx_out = i + j * n.x + k * n.x * n.y;
 
-				Out1[i + j * n.x] = Out_val;
-				Out2[i + j * n.x] = Out_val;
+				DBL3 Out_val = DBL3(*reinterpret_cast<FLT3*>(plinef_rev_x[tn] + i * 3)) / N.dim();
+				DBL3 In_val = (pIn2 ? (In1[idx_out] + (*pIn2)[idx_out]) / 2 : In1[idx_out]);
+
+				if (clearOut) Out1[idx_out] = Out_val;
+				else Out1[idx_out] += Out_val;
+
+				if (pOut2) {
+
+					if (clearOut) (*pOut2)[idx_out] = Out_val;
+					else (*pOut2)[idx_out] += Out_val;
+				}
 
-				dot_product += In_val * Out_val;
+				line_dot_product += In_val * Out_val;
 
 				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				if (pH) (*pH)[idx_out] = Out_val;
+				if (penergy) (*penergy)[idx_out] = -MU0 * (In_val * Out_val) / 2;
 			}
+
+			if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+			else dot_product += line_dot_product;
 		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 	}
-	else {
 
-		//2. IFFTs along x
-#pragma omp parallel for reduction(+:dot_product)
-		for (int j = 0; j < n.y; j++) {
+	if (profiling) Profile_End();
 
-			int tn = omp_get_thread_num();
+	if (deterministic) dot_product = dot_product_reduction.sum();
 
-			//write input into fft line
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+	return dot_product;
+}
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
-			}
+//-------------------------- PRECISION CHECK
 
-			//fft on line
-			fftw_execute(plan_inv_x[tn]);
+//run the convolution on In in both double and single precision fft modes (embedded multiplication only), and return in accuracy :
+//x : maximum output difference relative to maximum output value, y : relative difference in dot product of In with output
+template <typename Owner, typename Kernel>
+BError Convolution<Owner, Kernel>::Compare_Precision(VEC<DBL3> &In, DBL2& accuracy)
+{
+	BError error(__FUNCTION__);
 
-			//add line to output
-			for (int i = 0; i < n.x; i++) {
+	if (!embed_multiplication) return error(BERROR_INCORRECTACTION);
 
-				DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-				DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+	bool single_precision_inuse = single_precision;
 
-				Out1[i + j * n.x] += Out_val;
-				Out2[i + j * n.x] += Out_val;
+	VEC<DBL3> Out_dp(In.n), Out_sp(In.n);
+	if (Out_dp.linear_size() != In.linear_size() || Out_sp.linear_size() != In.linear_size()) return error(BERROR_OUTOFMEMORY_NCRIT);
 
-				dot_product += In_val * Out_val;
+	//double precision
+	single_precision = false;
+	error = AllocateScratchSpaces();
 
-				//capture output effective field and energy with spatial resolution if required
-				if (pH) (*pH)[i + j * n.x] = Out_val;
-				if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
-			}
-		}
+	double dot_product_dp = 0.0;
+	if (!error) dot_product_dp = Convolute(In, Out_dp, true);
+
+	//single precision
+	single_precision = true;
+	if (!error) error = AllocateScratchSpaces();
+	if (!error) make_single_precision_plans();
+
+	double dot_product_sp = 0.0;
+	if (!error) dot_product_sp = Convolute(In, Out_sp, true);
+
+	//restore precision in use
+	single_precision = single_precision_inuse;
+	error = AllocateScratchSpaces();
+	if (error) return error;
+
+	double max_out = 0.0, max_diff = 0.0;
+
+	for (int idx = 0; idx < In.linear_size(); idx++) {
+
+		max_out = maximum(max_out, GetMagnitude(Out_dp[idx]));
+		max_diff = maximum(max_diff, GetMagnitude(Out_sp[idx] - Out_dp[idx]));
 	}
 
-	return dot_product;
+	accuracy.x = (max_out > 0.0 ? max_diff / max_out : 0.0);
+	accuracy.y = (dot_product_dp != 0.0 ? fabs(dot_product_sp - dot_product_dp) / fabs(dot_product_dp) : 0.0);
+
+	return error;
 }
 
-//-------------------------- RUN-TIME CONVOLUTION : 3D (multiplication not embedded)
+//-------------------------- RUN-TIME CONVOLUTION : 2D (multiplication not embedded)
 
 //SINGLE INPUT
 
 //1. Forward (In -> F)
 template <typename Owner, typename Kernel>
-void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
+void Convolution<Owner, Kernel>::ForwardFFT_2D(VEC<DBL3> &In)
 {
-	//1. FFTs along x
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+	//2D
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
 		for (int j = 0; j < n.y; j++) {
 
 			int tn = omp_get_thread_num();
@@ -1642,7 +1891,7 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
 			//write input into fft line (zero padding kept)
 			for (int i = 0; i < n.x; i++) {
 
-				int idx_in = i + j * n.x + k * n.x * n.y;
+				int idx_in = i + j * n.x;
 
 				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
 			}
@@ -1653,14 +1902,15 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
 			//write line to fft array
 			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
 
-	//2. FFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
 		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
@@ -1668,7 +1918,7 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
 			//fetch line from fft array (zero padding kept)
 			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
@@ -1677,69 +1927,34 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
 			//write line to fft array
 			for (int j = 0; j < N.y; j++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
-
-	//3. FFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int tn = omp_get_thread_num();
-
-			//fetch line from fft array (zero padding kept)
-			for (int k = 0; k < n.z; k++) {
-
-				*reinterpret_cast<ReIm3*>(pline_zp_z[tn] + k * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
-			}
-
-			//fft on line
-			fftw_execute(plan_fwd_z[tn]);
-
-			//write line to fft array
-			for (int k = 0; k < N.z; k++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
-			}
-		}
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
 	}
+
+	if (profiling) Profile_End();
 }
 
 //SINGLE OUTPUT
 
 //3. Inverse. Return dot product of In with Out. (F2 -> Out)
 template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
-	//1. IFFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int tn = omp_get_thread_num();
-
-			//fetch line from fft array
-			for (int k = 0; k < N.z; k++) {
-
-				*reinterpret_cast<ReIm3*>(pline[tn] + k * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
-			}
-
-			//ifft on line
-			fftw_execute(plan_inv_z[tn]);
+	double dot_product = 0;
 
-			//write line to fft array, truncating upper half
-			for (int k = 0; k < n.z; k++) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
-			}
-		}
-	}
+	if (profiling) Profile_Start();
 
-	//2. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+#pragma omp parallel
+	{
+		//1. IFFTs along y
+#pragma omp for
 		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
@@ -1747,7 +1962,7 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out,
 			//fetch line from fft array
 			for (int j = 0; j < N.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
@@ -1756,18 +1971,17 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out,
 			//write line to fft array, truncating upper half
 			for (int j = 0; j < n.y; j++) {
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
-	}
 
-	double dot_product = 0;
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
 
-	if (clearOut) {
+		if (clearOut) {
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
 			for (int j = 0; j < n.y; j++) {
 
 				int tn = omp_get_thread_num();
@@ -1775,34 +1989,40 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out,
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
 				}
 
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
 					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-					DBL3 In_val = In[i + j * n.x + k * n.x * n.y];
+					DBL3 In_val = In[i + j * n.x];
 
-					Out[i + j * n.x + k * n.x * n.y] = Out_val;
+					Out[i + j * n.x] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
-					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
-					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
 			for (int j = 0; j < n.y; j++) {
 
 				int tn = omp_get_thread_num();
@@ -1810,30 +2030,42 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out,
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
 				}
 
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
 					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-					DBL3 In_val = In[i + j * n.x + k * n.x * n.y];
+					DBL3 In_val = In[i + j * n.x];
 
-					Out[i + j * n.x + k * n.x * n.y] += Out_val;
+					Out[i + j * n.x] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
-					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
-					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
@@ -1841,11 +2073,16 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out,
 
 //1. Forward (In -> F)
 template <typename Owner, typename Kernel>
-void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
+void Convolution<Owner, Kernel>::ForwardFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 {
-	//1. FFTs along x
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+	//2D
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
 		for (int j = 0; j < n.y; j++) {
 
 			int tn = omp_get_thread_num();
@@ -1853,7 +2090,7 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 			//write input into fft line (zero padding kept)
 			for (int i = 0; i < n.x; i++) {
 
-				int idx_in = i + j * n.x + k * n.x * n.y;
+				int idx_in = i + j * n.x;
 
 				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
 			}
@@ -1864,14 +2101,15 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 			//write line to fft array
 			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
-	}
 
-	//2. FFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. FFTs along y
+#pragma omp for
 		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
@@ -1879,7 +2117,7 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 			//fetch line from fft array (zero padding kept)
 			for (int j = 0; j < n.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
@@ -1888,101 +2126,359 @@ void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 			//write line to fft array
 			for (int j = 0; j < N.y; j++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				F[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 			}
 		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTY);
 	}
 
-	//3. FFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+	if (profiling) Profile_End();
+}
 
-			int tn = omp_get_thread_num();
+//AVERAGED INPUTS, SINGLE OUTPUT
 
-			//fetch line from fft array (zero padding kept)
-			for (int k = 0; k < n.z; k++) {
+//3. Inverse. Return dot product of In with Out. (F2 -> Out)
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
+	double dot_product = 0;
 
-				*reinterpret_cast<ReIm3*>(pline_zp_z[tn] + k * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. IFFTs along y
+#pragma omp for
+		for (int i = 0; i < (N.x / 2 + 1); i++) {
+
+			int tn = omp_get_thread_num();
+
+			//fetch line from fft array
+			for (int j = 0; j < N.y; j++) {
+
+				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
 			}
 
 			//fft on line
-			fftw_execute(plan_fwd_z[tn]);
+			fftw_execute(plan_inv_y[tn]);
 
-			//write line to fft array
-			for (int k = 0; k < N.z; k++) {
+			//write line to fft array, truncating upper half
+			for (int j = 0; j < n.y; j++) {
 
-				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
+				F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+			}
+		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
+
+		if (clearOut) {
+
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+
+					Out[i + j * n.x] = Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
+		}
+		else {
+
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+
+					Out[i + j * n.x] += Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
+
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
+	return dot_product;
 }
 
-//AVERAGED INPUTS, SINGLE OUTPUT
+//AVERAGED INPUTS, DUPLICATED OUTPUTS
 
 //3. Inverse. Return dot product of In with Out. (F2 -> Out)
 template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+double Convolution<Owner, Kernel>::InverseFFT_2D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
 {
-	//1. IFFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. IFFTs along y
+#pragma omp for
 		for (int i = 0; i < (N.x / 2 + 1); i++) {
 
 			int tn = omp_get_thread_num();
 
 			//fetch line from fft array
-			for (int k = 0; k < N.z; k++) {
+			for (int j = 0; j < N.y; j++) {
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + k * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1)];
 			}
 
-			//ifft on line
-			fftw_execute(plan_inv_z[tn]);
+			//fft on line
+			fftw_execute(plan_inv_y[tn]);
 
 			//write line to fft array, truncating upper half
-			for (int k = 0; k < n.z; k++) {
+			for (int j = 0; j < n.y; j++) {
+
+				F2[i + j * (N.x / 2 + 1)] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+			}
+		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
+
+		if (clearOut) {
+
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+
+					Out1[i + j * n.x] = Out_val;
+					Out2[i + j * n.x] = Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
+		}
+		else {
+
+			//2. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int j = 0; j < n.y; j++) {
+
+				int tn = omp_get_thread_num();
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1)];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x] + In2[i + j * n.x]) / 2;
+
+					Out1[i + j * n.x] += Out_val;
+					Out2[i + j * n.x] += Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, j);
+				else dot_product += line_dot_product;
+			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
-	//2. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
+	return dot_product;
+}
+
+//-------------------------- RUN-TIME CONVOLUTION : 3D (multiplication not embedded)
+
+//SINGLE INPUT
+
+//1. Forward (In -> F)
+template <typename Owner, typename Kernel>
+void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In)
+{
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
 			int tn = omp_get_thread_num();
 
-			//fetch line from fft array
-			for (int j = 0; j < N.y; j++) {
+			int j = jk % n.y;
+			int k = jk / n.y;
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
+
+				int idx_in = i + j * n.x + k * n.x * n.y;
+
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = In[idx_in];
 			}
 
 			//fft on line
-			fftw_execute(plan_inv_y[tn]);
+			fftw_execute(plan_fwd_x[tn]);
 
-			//write line to fft array, truncating upper half
-			for (int j = 0; j < n.y; j++) {
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. and 3. FFTs along y and z
+		ForwardFFT_3D_yz();
 	}
 
+	if (profiling) Profile_End();
+}
+
+//SINGLE OUTPUT
+
+//3. Inverse. Return dot product of In with Out. (F2 -> Out)
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
 	double dot_product = 0;
 
-	if (clearOut) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. and 2. IFFTs along z and y
+		InverseFFT_3D_zy();
+
+		if (clearOut) {
+
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -1992,32 +2488,41 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
 					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-					DBL3 In_val = (In1[i + j * n.x + k * n.x * n.y] + In2[i + j * n.x + k * n.x * n.y]) / 2;
+					DBL3 In_val = In[i + j * n.x + k * n.x * n.y];
 
 					Out[i + j * n.x + k * n.x * n.y] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -2027,92 +2532,230 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
 					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
-					DBL3 In_val = (In1[i + j * n.x + k * n.x * n.y] + In2[i + j * n.x + k * n.x * n.y]) / 2;
+					DBL3 In_val = In[i + j * n.x + k * n.x * n.y];
 
 					Out[i + j * n.x + k * n.x * n.y] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
 
-//AVERAGED INPUTS, DUPLICATED OUTPUTS
+//AVERAGED INPUTS
 
-//3. Inverse. Return dot product of In with Out. (F2 -> Out)
+//1. Forward (In -> F)
 template <typename Owner, typename Kernel>
-double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+void Convolution<Owner, Kernel>::ForwardFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2)
 {
-	//1. IFFTs along z
-#pragma omp parallel for
-	for (int j = 0; j < N.y; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. FFTs along x
+#pragma omp for
+		for (int jk = 0; jk < n.y * n.z; jk++) {
 
 			int tn = omp_get_thread_num();
 
-			//fetch line from fft array
-			for (int k = 0; k < N.z; k++) {
+			int j = jk % n.y;
+			int k = jk / n.y;
+
+			//write input into fft line (zero padding kept)
+			for (int i = 0; i < n.x; i++) {
+
+				int idx_in = i + j * n.x + k * n.x * n.y;
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + k * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				*reinterpret_cast<DBL3*>(pline_zp_x[tn] + i * 3) = (In1[idx_in] + In2[idx_in]) / 2;
 			}
 
-			//ifft on line
-			fftw_execute(plan_inv_z[tn]);
+			//fft on line
+			fftw_execute(plan_fwd_x[tn]);
 
-			//write line to fft array, truncating upper half
-			for (int k = 0; k < n.z; k++) {
+			//write line to fft array
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
+				F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 			}
 		}
+
+#pragma omp master
+		if (profiling) Profile_Stage(CONVSTAGE_FFTX);
+
+		//2. and 3. FFTs along y and z
+		ForwardFFT_3D_yz();
 	}
 
-	//2. IFFTs along y
-	for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
+	if (profiling) Profile_End();
+}
 
-			int tn = omp_get_thread_num();
+//AVERAGED INPUTS, SINGLE OUTPUT
 
-			//fetch line from fft array
-			for (int j = 0; j < N.y; j++) {
+//3. Inverse. Return dot product of In with Out. (F2 -> Out)
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
+	double dot_product = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
+
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. and 2. IFFTs along z and y
+		InverseFFT_3D_zy();
+
+		if (clearOut) {
+
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
+
+				int tn = omp_get_thread_num();
+
+				int j = jk % n.y;
+				int k = jk / n.y;
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
+
+				//write line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x + k * n.x * n.y] + In2[i + j * n.x + k * n.x * n.y]) / 2;
+
+					Out[i + j * n.x + k * n.x * n.y] = Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
+				}
 
-				*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
 
-			//fft on line
-			fftw_execute(plan_inv_y[tn]);
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
+		}
+		else {
 
-			//write line to fft array, truncating upper half
-			for (int j = 0; j < n.y; j++) {
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
+
+				int tn = omp_get_thread_num();
+
+				int j = jk % n.y;
+				int k = jk / n.y;
+
+				//write input into fft line
+				for (int i = 0; i < N.x / 2 + 1; i++) {
+
+					*reinterpret_cast<ReIm3*>(pline[tn] + i * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+				}
+
+				//fft on line
+				fftw_execute(plan_inv_x[tn]);
+
+				double line_dot_product = 0.0;
 
-				F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+				//add line to output
+				for (int i = 0; i < n.x; i++) {
+
+					DBL3 Out_val = *reinterpret_cast<DBL3*>(pline_rev_x[tn] + i * 3) / N.dim();
+					DBL3 In_val = (In1[i + j * n.x + k * n.x * n.y] + In2[i + j * n.x + k * n.x * n.y]) / 2;
+
+					Out[i + j * n.x + k * n.x * n.y] += Out_val;
+
+					line_dot_product += In_val * Out_val;
+
+					//capture output effective field and energy with spatial resolution if required
+					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
+					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
+				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
+	return dot_product;
+}
+
+//AVERAGED INPUTS, DUPLICATED OUTPUTS
+
+//3. Inverse. Return dot product of In with Out. (F2 -> Out)
+template <typename Owner, typename Kernel>
+double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2, VEC<DBL3> &Out1, VEC<DBL3> &Out2, bool clearOut, VEC<DBL3>* pH, VEC<double>* penergy)
+{
 	double dot_product = 0;
 
-	if (clearOut) {
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) dot_product_reduction.new_sum_reduction(n.y * n.z);
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+	if (profiling) Profile_Start();
+
+#pragma omp parallel
+	{
+		//1. and 2. IFFTs along z and y
+		InverseFFT_3D_zy();
+
+		if (clearOut) {
+
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -2122,6 +2765,8 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//write line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -2131,24 +2776,31 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 					Out1[i + j * n.x + k * n.x * n.y] = Out_val;
 					Out2[i + j * n.x + k * n.x * n.y] = Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
-	}
-	else {
+		else {
 
-		//3. IFFTs along x
-		for (int k = 0; k < n.z; k++) {
-#pragma omp parallel for reduction(+:dot_product)
-			for (int j = 0; j < n.y; j++) {
+			//3. IFFTs along x
+#pragma omp for reduction(+:dot_product)
+			for (int jk = 0; jk < n.y * n.z; jk++) {
 
 				int tn = omp_get_thread_num();
 
+				int j = jk % n.y;
+				int k = jk / n.y;
+
 				//write input into fft line
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
@@ -2158,6 +2810,8 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 				//fft on line
 				fftw_execute(plan_inv_x[tn]);
 
+				double line_dot_product = 0.0;
+
 				//add line to output
 				for (int i = 0; i < n.x; i++) {
 
@@ -2167,15 +2821,25 @@ double Convolution<Owner, Kernel>::InverseFFT_3D(VEC<DBL3> &In1, VEC<DBL3> &In2,
 					Out1[i + j * n.x + k * n.x * n.y] += Out_val;
 					Out2[i + j * n.x + k * n.x * n.y] += Out_val;
 
-					dot_product += In_val * Out_val;
+					line_dot_product += In_val * Out_val;
 
 					//capture output effective field and energy with spatial resolution if required
 					if (pH) (*pH)[i + j * n.x + k * n.x * n.y] = Out_val;
 					if (penergy) (*penergy)[i + j * n.x + k * n.x * n.y] = -MU0 * (In_val * Out_val) / 2;
 				}
+
+				if (deterministic) dot_product_reduction.reduce_sum(line_dot_product, jk);
+				else dot_product += line_dot_product;
 			}
+
+#pragma omp master
+			if (profiling) Profile_Stage(CONVSTAGE_IFFTX);
 		}
 	}
 
+	if (profiling) Profile_End();
+
+	if (deterministic) dot_product = dot_product_reduction.sum();
+
 	return dot_product;
 }
\ No newline at end of file
@@ -1,6 +1,336 @@
 #include "stdafx.h"
 #include "ConvolutionData.h"
 
+//-------------------------- FFTW PLANNING
+
+int ConvolutionData::fftw_planner = FFTWPLANNER_PATIENT;
+std::string ConvolutionData::fftw_wisdom_fileName = "";
+size_t ConvolutionData::fftw_wisdom_length = 0;
+std::string ConvolutionData::fftwf_wisdom_fileName = "";
+size_t ConvolutionData::fftwf_wisdom_length = 0;
+
+//length of wisdom string currently accumulated by fftw
+static size_t get_fftw_wisdom_length(void)
+{
+	char* wisdom = fftw_export_wisdom_to_string();
+	if (!wisdom) return 0;
+
+	size_t length = strlen(wisdom);
+	free(wisdom);
+
+	return length;
+}
+
+//same for single precision plans
+static size_t get_fftwf_wisdom_length(void)
+{
+	char* wisdom = fftwf_export_wisdom_to_string();
+	if (!wisdom) return 0;
+
+	size_t length = strlen(wisdom);
+	free(wisdom);
+
+	return length;
+}
+
+//set directory for fftw wisdom file (file name generated from FFTW version) and load any wisdom already saved there
+void ConvolutionData::Set_FFTW_Wisdom_Directory(std::string directory)
+{
+	//wisdom is not portable between FFTW versions, so keep separate files
+	fftw_wisdom_fileName = directory + "fftw_wisdom_" + std::string(fftw_version) + ".txt";
+
+	fftw_import_wisdom_from_filename(fftw_wisdom_fileName.c_str());
+	fftw_wisdom_length = get_fftw_wisdom_length();
+
+	fftwf_wisdom_fileName = directory + "fftwf_wisdom_" + std::string(fftwf_version) + ".txt";
+
+	fftwf_import_wisdom_from_filename(fftwf_wisdom_fileName.c_str());
+	fftwf_wisdom_length = get_fftwf_wisdom_length();
+}
+
+//save fftw wisdom to file only if new plans have been made since last load / save
+void ConvolutionData::Save_FFTW_Wisdom(void)
+{
+	if (fftw_wisdom_fileName.length() && get_fftw_wisdom_length() != fftw_wisdom_length) {
+
+		//merge in any wisdom saved in the meantime by other program instances
+		fftw_import_wisdom_from_filename(fftw_wisdom_fileName.c_str());
+
+		//write to temporary file first then rename, so other instances never load a partially written file
+		std::string temp_fileName = fftw_wisdom_fileName + "." + ToString(GetSystemTickCount()) + ".tmp";
+
+		if (fftw_export_wisdom_to_filename(temp_fileName.c_str())) {
+
+			if (std::rename(temp_fileName.c_str(), fftw_wisdom_fileName.c_str())) std::remove(temp_fileName.c_str());
+		}
+
+		fftw_wisdom_length = get_fftw_wisdom_length();
+	}
+
+	//same for single precision plans
+	if (fftwf_wisdom_fileName.length() && get_fftwf_wisdom_length() != fftwf_wisdom_length) {
+
+		fftwf_import_wisdom_from_filename(fftwf_wisdom_fileName.c_str());
+
+		std::string temp_fileName = fftwf_wisdom_fileName + "." + ToString(GetSystemTickCount()) + ".tmp";
+
+		if (fftwf_export_wisdom_to_filename(temp_fileName.c_str())) {
+
+			if (std::rename(temp_fileName.c_str(), fftwf_wisdom_fileName.c_str())) std::remove(temp_fileName.c_str());
+		}
+
+		fftwf_wisdom_length = get_fftwf_wisdom_length();
+	}
+}
+
+//fftw planner flags to use when creating plans, as given by fftw_planner
+unsigned ConvolutionData::Get_FFTW_Planner_Flags(void)
+{
+	switch (fftw_planner) {
+
+	case FFTWPLANNER_ESTIMATE:
+		return FFTW_ESTIMATE;
+
+	case FFTWPLANNER_MEASURE:
+		return FFTW_MEASURE;
+
+	case FFTWPLANNER_EXHAUSTIVE:
+		return FFTW_EXHAUSTIVE;
+
+	default:
+	case FFTWPLANNER_PATIENT:
+		return FFTW_PATIENT;
+	}
+}
+
+//-------------------------- FFT TILING
+
+bool ConvolutionData::fft_tiling = false;
+
+//-------------------------- FFT PADDING
+
+bool ConvolutionData::fft_fast_padding = true;
+
+//smallest 2^a 3^b 5^c 7^d value >= length
+int ConvolutionData::Get_Fast_FFT_Length(int length)
+{
+	for (int value = maximum(length, 1); ; value++) {
+
+		int remainder = value;
+		for (int factor : { 2, 3, 5, 7 }) while (remainder % factor == 0) remainder /= factor;
+
+		if (remainder == 1) return value;
+	}
+}
+
+//fft dimensions for given mesh dimensions and pbc images, with or without fast padding
+SZ3 ConvolutionData::Get_FFT_Dimensions(SZ3 n_, INT3 pbc_images_, bool fast_padding)
+{
+	//with pbc the tensor calculation assumes N = 2n in the directions without pbc, so fast padding is only used without pbc
+	if (!pbc_images_.IsNull()) fast_padding = false;
+
+	//pbc : can use wrap-around
+	//no pbc : no wrap-around thus need at least 2n - 1 points, with input to be zero-padded
+	auto padded_length = [&](int n_dim, int pbc_dim) -> int {
+
+		if (pbc_dim) return n_dim;
+		else if (fast_padding) return Get_Fast_FFT_Length(2 * n_dim - 1);
+		else return 2 * n_dim;
+	};
+
+	SZ3 N_ = SZ3(padded_length(n_.x, pbc_images_.x), padded_length(n_.y, pbc_images_.y), 1);
+
+	if (n_.z > 1) N_.z = padded_length(n_.z, pbc_images_.z);
+
+	return N_;
+}
+
+//expected speedup of the ffts in a convolution with embedded multiplication, using fast padding compared to 2n padding.
+//Estimated by timing fft lines (estimate plans) for both sets of dimensions, weighted by the number of lines in a convolution.
+double ConvolutionData::Estimate_FFT_Padding_Speedup(SZ3 n_, INT3 pbc_images_)
+{
+	SZ3 N_default = Get_FFT_Dimensions(n_, pbc_images_, false);
+	SZ3 N_fast = Get_FFT_Dimensions(n_, pbc_images_, true);
+
+	if (N_default == N_fast) return 1.0;
+
+	//time for all fft and ifft lines in a convolution with given fft dimensions
+	auto fft_time = [&](SZ3 N_) -> double {
+
+		int maxN = maximum(N_.x, N_.y, N_.z);
+
+		double* pline_real = fftw_alloc_real(maxN * 3);
+		fftw_complex* pline_cplx = fftw_alloc_complex(maxN * 3);
+
+		for (int idx = 0; idx < maxN * 3; idx++) {
+
+			pline_real[idx] = 0.0;
+			pline_cplx[idx][0] = 0.0;
+			pline_cplx[idx][1] = 0.0;
+		}
+
+		//number of lines along x, y and z in a convolution (same for forward and inverse passes)
+		SZ3 lines;
+		if (n_.z == 1) lines = SZ3(n_.y, N_.x / 2 + 1, 0);
+		else lines = SZ3(n_.y * n_.z, (N_.x / 2 + 1) * n_.z, (N_.x / 2 + 1) * N_.y);
+
+		double time = 0.0;
+
+		for (int axis = 0; axis < 3; axis++) {
+
+			int length = (axis == 0 ? N_.x : (axis == 1 ? N_.y : N_.z));
+			int num_lines = (axis == 0 ? lines.x : (axis == 1 ? lines.y : lines.z));
+			if (length < 2 || !num_lines) continue;
+
+			int dims[1] = { length };
+
+			fftw_plan plan_fwd, plan_inv;
+
+			if (axis == 0) {
+
+				plan_fwd = fftw_plan_many_dft_r2c(1, dims, 3, pline_real, nullptr, 3, 1, pline_cplx, nullptr, 3, 1, FFTW_ESTIMATE);
+				plan_inv = fftw_plan_many_dft_c2r(1, dims, 3, pline_cplx, nullptr, 3, 1, pline_real, nullptr, 3, 1, FFTW_ESTIMATE);
+			}
+			else {
+
+				plan_fwd = fftw_plan_many_dft(1, dims, 3, pline_cplx, nullptr, 3, 1, pline_cplx, nullptr, 3, 1, FFTW_FORWARD, FFTW_ESTIMATE);
+				plan_inv = fftw_plan_many_dft(1, dims, 3, pline_cplx, nullptr, 3, 1, pline_cplx, nullptr, 3, 1, FFTW_BACKWARD, FFTW_ESTIMATE);
+			}
+
+			//enough executions for a reliable time
+			int repeats = maximum(16, 1048576 / length);
+
+			double start = omp_get_wtime();
+
+			for (int r = 0; r < repeats; r++) {
+
+				fftw_execute(plan_fwd);
+				fftw_execute(plan_inv);
+			}
+
+			time += (omp_get_wtime() - start) * num_lines / repeats;
+
+			fftw_destroy_plan(plan_fwd);
+			fftw_destroy_plan(plan_inv);
+		}
+
+		fftw_free((double*)pline_real);
+		fftw_free((fftw_complex*)pline_cplx);
+
+		return time;
+	};
+
+	double time_default = fft_time(N_default);
+	double time_fast = fft_time(N_fast);
+
+	return (time_fast > 0.0 ? time_default / time_fast : 1.0);
+}
+
+//-------------------------- PRECISION
+
+bool ConvolutionData::fft_single_precision = false;
+
+//time y and z direction ffts and iffts for a 3D convolution (multiplication not embedded) with given mesh dimensions, done one line at a time and tiled.
+//Average times in ms for a forward and inverse pass, over given number of repeats, returned in times as (lines, tiles).
+BError ConvolutionData::Benchmark_FFT_Tiling(SZ3 n_, int repeats, DBL2& times)
+{
+	BError error(__FUNCTION__);
+
+	if (n_.z < 2 || repeats < 1) return error(BERROR_INCORRECTVALUE);
+
+	ConvolutionData convdata;
+
+	error = convdata.SetConvolutionDimensions(n_, DBL3(1.0), false);
+	if (error) return error;
+
+	bool fft_tiling_set = fft_tiling;
+
+	for (int tiled = 0; tiled < 2; tiled++) {
+
+		fft_tiling = tiled;
+
+		//first pass not timed
+#pragma omp parallel
+		{
+			convdata.ForwardFFT_3D_yz();
+			convdata.InverseFFT_3D_zy();
+		}
+
+		unsigned int start_ms = GetSystemTickCount();
+
+		for (int r = 0; r < repeats; r++) {
+
+#pragma omp parallel
+			{
+				convdata.ForwardFFT_3D_yz();
+				convdata.InverseFFT_3D_zy();
+			}
+		}
+
+		double time_ms = (double)(GetSystemTickCount() - start_ms) / repeats;
+
+		if (tiled) times.j = time_ms;
+		else times.i = time_ms;
+	}
+
+	fft_tiling = fft_tiling_set;
+
+	return error;
+}
+
+//-------------------------- MULTI-LAYERED CONVOLUTION SCHEDULING
+
+int ConvolutionData::multiconv_tasks = MULTICONVTASKS_AUTO;
+
+//-------------------------- PROFILING
+
+bool ConvolutionData::profiling = false;
+size_t ConvolutionData::profile_regions = 0;
+size_t ConvolutionData::profile_barriers = 0;
+double ConvolutionData::profile_time_total = 0.0;
+double ConvolutionData::profile_time_stages[CONVSTAGE_NUMENTRIES] = {};
+double ConvolutionData::profile_time_start = 0.0;
+double ConvolutionData::profile_time_last = 0.0;
+
+//set profiling status and reset accumulated profile values
+void ConvolutionData::Set_Profiling(bool status)
+{
+	profiling = status;
+
+	profile_regions = 0;
+	profile_barriers = 0;
+	profile_time_total = 0.0;
+	for (int stage = 0; stage < CONVSTAGE_NUMENTRIES; stage++) profile_time_stages[stage] = 0.0;
+}
+
+//call before entering the parallel region of a convolution
+void ConvolutionData::Profile_Start(void)
+{
+	profile_time_start = omp_get_wtime();
+	profile_time_last = profile_time_start;
+}
+
+//call from master thread at end of stage, straight after the barrier
+void ConvolutionData::Profile_Stage(int stage)
+{
+	double time = omp_get_wtime();
+
+	profile_time_stages[stage] += time - profile_time_last;
+	profile_time_last = time;
+
+	profile_barriers++;
+}
+
+//call after exiting the parallel region of a convolution
+void ConvolutionData::Profile_End(void)
+{
+	profile_time_total += omp_get_wtime() - profile_time_start;
+
+	//implicit barrier at end of parallel region
+	profile_barriers++;
+	profile_regions++;
+}
+
 //-------------------------- CONSTRUCTORS
 
 ConvolutionData::ConvolutionData(void)
@@ -19,6 +349,28 @@ ConvolutionData::ConvolutionData(void)
 	pline_zp_z.resize(OmpThreads);
 	pline.resize(OmpThreads);
 	pline_rev_x.resize(OmpThreads);
+
+	plan_fwd_y_tile.resize(OmpThreads);
+	plan_fwd_z_tile.resize(OmpThreads);
+	plan_inv_y_tile.resize(OmpThreads);
+	plan_inv_z_tile.resize(OmpThreads);
+
+	ptile_zp_y.resize(OmpThreads);
+	ptile_zp_z.resize(OmpThreads);
+	ptile.resize(OmpThreads);
+
+	planf_fwd_x.resize(OmpThreads);
+	planf_fwd_y.resize(OmpThreads);
+	planf_fwd_z.resize(OmpThreads);
+	planf_inv_x.resize(OmpThreads);
+	planf_inv_y.resize(OmpThreads);
+	planf_inv_z.resize(OmpThreads);
+
+	plinef_zp_x.resize(OmpThreads);
+	plinef_zp_y.resize(OmpThreads);
+	plinef_zp_z.resize(OmpThreads);
+	plinef.resize(OmpThreads);
+	plinef_rev_x.resize(OmpThreads);
 }
 
 ConvolutionData::~ConvolutionData()
@@ -51,7 +403,121 @@ void ConvolutionData::free_memory(void)
 		}
 	}
 
+	if (fftw_tile_plans_created) {
+
+		for (int idx = 0; idx < OmpThreads; idx++) {
+
+			fftw_destroy_plan(plan_fwd_y_tile[idx]);
+			fftw_destroy_plan(plan_fwd_z_tile[idx]);
+			fftw_destroy_plan(plan_inv_y_tile[idx]);
+			fftw_destroy_plan(plan_inv_z_tile[idx]);
+
+			fftw_free((fftw_complex*)ptile_zp_y[idx]);
+			fftw_free((fftw_complex*)ptile_zp_z[idx]);
+			fftw_free((fftw_complex*)ptile[idx]);
+		}
+	}
+
+	if (fftwf_plans_created) {
+
+		for (int idx = 0; idx < OmpThreads; idx++) {
+
+			fftwf_destroy_plan(planf_fwd_x[idx]);
+			fftwf_destroy_plan(planf_fwd_y[idx]);
+			fftwf_destroy_plan(planf_fwd_z[idx]);
+			fftwf_destroy_plan(planf_inv_x[idx]);
+			fftwf_destroy_plan(planf_inv_y[idx]);
+			fftwf_destroy_plan(planf_inv_z[idx]);
+
+			fftwf_free((float*)plinef_zp_x[idx]);
+			fftwf_free((fftwf_complex*)plinef_zp_y[idx]);
+			fftwf_free((fftwf_complex*)plinef_zp_z[idx]);
+			fftwf_free((fftwf_complex*)plinef[idx]);
+			fftwf_free((float*)plinef_rev_x[idx]);
+		}
+	}
+
 	fftw_plans_created = false;
+	fftw_tile_plans_created = false;
+	fftwf_plans_created = false;
+}
+
+//make single precision fft plans and lines, if not already made
+void ConvolutionData::make_single_precision_plans(void)
+{
+	if (fftwf_plans_created) return;
+
+	for (int idx = 0; idx < OmpThreads; idx++) {
+
+		plinef_zp_x[idx] = fftwf_alloc_real(N.x * 3);
+		plinef_rev_x[idx] = fftwf_alloc_real(N.x * 3);
+
+		plinef_zp_y[idx] = fftwf_alloc_complex(N.y * 3);
+		plinef_zp_z[idx] = fftwf_alloc_complex(N.z * 3);
+
+		plinef[idx] = fftwf_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z) * 3);
+
+		//zero lines (zero padding is kept)
+		for (int i = 0; i < N.x * 3; i++) {
+
+			plinef_zp_x[idx][i] = 0.0f;
+			plinef_rev_x[idx][i] = 0.0f;
+		}
+
+		for (int j = 0; j < N.y; j++) {
+
+			*reinterpret_cast<ReIm3F*>(plinef_zp_y[idx] + j * 3) = ReIm3F();
+		}
+
+		for (int k = 0; k < N.z; k++) {
+
+			*reinterpret_cast<ReIm3F*>(plinef_zp_z[idx] + k * 3) = ReIm3F();
+		}
+
+		for (int i = 0; i < maximum(N.x / 2 + 1, N.y, N.z); i++) {
+
+			*reinterpret_cast<ReIm3F*>(plinef[idx] + i * 3) = ReIm3F();
+		}
+	}
+
+	int dims_x[1] = { (int)N.x };
+	int dims_y[1] = { (int)N.y };
+	int dims_z[1] = { (int)N.z };
+
+	for (int idx = 0; idx < OmpThreads; idx++) {
+
+		planf_fwd_x[idx] = fftwf_plan_many_dft_r2c(1, dims_x, 3,
+			plinef_zp_x[idx], nullptr, 3, 1,
+			plinef[idx], nullptr, 3, 1,
+			Get_FFTW_Planner_Flags());
+
+		planf_fwd_y[idx] = fftwf_plan_many_dft(1, dims_y, 3,
+			plinef_zp_y[idx], nullptr, 3, 1,
+			plinef[idx], nullptr, 3, 1,
+			FFTW_FORWARD, Get_FFTW_Planner_Flags());
+
+		planf_fwd_z[idx] = fftwf_plan_many_dft(1, dims_z, 3,
+			plinef_zp_z[idx], nullptr, 3, 1,
+			plinef[idx], nullptr, 3, 1,
+			FFTW_FORWARD, Get_FFTW_Planner_Flags());
+
+		planf_inv_z[idx] = fftwf_plan_many_dft(1, dims_z, 3,
+			plinef[idx], nullptr, 3, 1,
+			plinef[idx], nullptr, 3, 1,
+			FFTW_BACKWARD, Get_FFTW_Planner_Flags());
+
+		planf_inv_y[idx] = fftwf_plan_many_dft(1, dims_y, 3,
+			plinef[idx], nullptr, 3, 1,
+			plinef[idx], nullptr, 3, 1,
+			FFTW_BACKWARD, Get_FFTW_Planner_Flags());
+
+		planf_inv_x[idx] = fftwf_plan_many_dft_c2r(1, dims_x, 3,
+			plinef[idx], nullptr, 3, 1,
+			plinef_rev_x[idx], nullptr, 3, 1,
+			Get_FFTW_Planner_Flags());
+	}
+
+	fftwf_plans_created = true;
 }
 
 //Allocate memory for F and F2 (if needed) scratch spaces)
@@ -62,14 +528,26 @@ BError ConvolutionData::AllocateScratchSpaces(void)
 	if (embed_multiplication) {
 
 		//if multiplication is embedded, we don't need the upper z-axis points (3D) or upper y-axis points (2D). We also don't need the F2 scratch space.
+		//Single precision uses Ff instead of F, with the same dimensions.
 
-		if (n.z > 1) {
+		if (single_precision) {
+
+			F.clear();
+
+			if (n.z > 1) { if (!Ff.resize(SZ3(N.x / 2 + 1, N.y, n.z))) return error(BERROR_OUTOFMEMORY_CRIT); }
+			else { if (!Ff.resize(SZ3(N.x / 2 + 1, n.y, 1))) return error(BERROR_OUTOFMEMORY_CRIT); }
+		}
+		else if (n.z > 1) {
+
+			Ff.clear();
 
 			//3D : don't need to allocate up to N.z as kernel multiplication is embedded with the z-direction fft / ifft
 			if (!F.resize(SZ3(N.x / 2 + 1, N.y, n.z))) return error(BERROR_OUTOFMEMORY_CRIT);
 		}
 		else {
 
+			Ff.clear();
+
 			//2D : don't need to allocate up to N.y as kernel multiplication is embedded with the y-direction fft / ifft
 			if (!F.resize(SZ3(N.x / 2 + 1, n.y, 1))) return error(BERROR_OUTOFMEMORY_CRIT);
 		}
@@ -109,40 +587,11 @@ BError ConvolutionData::SetConvolutionDimensions(SZ3 n_, DBL3 h_, bool embed_mul
 	n = n_;
 	h = h_;
 
-	N = SZ3(1, 1, 1);
-
 	//set N values for FFT dimensions
-	if (pbc_images.x) {
-
-		//pbc : can use wrap-around
-		N.x = n.x;
-	}
-	else {
-
-		//no wrap-around thus double the size, with input to be zero-padded
-		N.x = 2 * n.x;
-	}
-
-	if (pbc_images.y) {
-
-		N.y = n.y;
-	}
-	else {
-
-		N.y = 2 * n.y;
-	}
-
-	if (n.z > 1) {
-
-		if (pbc_images.z) {
-
-			N.z = n.z;
-		}
-		else {
+	N = Get_FFT_Dimensions(n, pbc_images, fft_fast_padding && fast_padding_supported);
 
-			N.z = 2 * n.z;
-		}
-	}
+	//single precision ffts only available with embedded multiplication
+	single_precision = fft_single_precision && embed_multiplication;
 
 	//now allocate memory
 
@@ -180,36 +629,87 @@ BError ConvolutionData::SetConvolutionDimensions(SZ3 n_, DBL3 h_, bool embed_mul
 		plan_fwd_x[idx] = fftw_plan_many_dft_r2c(1, dims_x, 3,
 			pline_zp_x[idx], nullptr, 3, 1,
 			pline[idx], nullptr, 3, 1,
-			FFTW_PATIENT);
+			Get_FFTW_Planner_Flags());
 
 		plan_fwd_y[idx] = fftw_plan_many_dft(1, dims_y, 3,
 			pline_zp_y[idx], nullptr, 3, 1,
 			pline[idx], nullptr, 3, 1,
-			FFTW_FORWARD, FFTW_PATIENT);
+			FFTW_FORWARD, Get_FFTW_Planner_Flags());
 
 		plan_fwd_z[idx] = fftw_plan_many_dft(1, dims_z, 3,
 			pline_zp_z[idx], nullptr, 3, 1,
 			pline[idx], nullptr, 3, 1,
-			FFTW_FORWARD, FFTW_PATIENT);
+			FFTW_FORWARD, Get_FFTW_Planner_Flags());
 
 		plan_inv_z[idx] = fftw_plan_many_dft(1, dims_z, 3,
 			pline[idx], nullptr, 3, 1,
 			pline[idx], nullptr, 3, 1,
-			FFTW_BACKWARD, FFTW_PATIENT);
+			FFTW_BACKWARD, Get_FFTW_Planner_Flags());
 
 		plan_inv_y[idx] = fftw_plan_many_dft(1, dims_y, 3,
 			pline[idx], nullptr, 3, 1,
 			pline[idx], nullptr, 3, 1,
-			FFTW_BACKWARD, FFTW_PATIENT);
+			FFTW_BACKWARD, Get_FFTW_Planner_Flags());
 
 		plan_inv_x[idx] = fftw_plan_many_dft_c2r(1, dims_x, 3,
 			pline[idx], nullptr, 3, 1,
 			pline_rev_x[idx], nullptr, 3, 1,
-			FFTW_PATIENT);
+			Get_FFTW_Planner_Flags());
 	}
 	
 	fftw_plans_created = true;
 
+	//tiles for y and z direction ffts : only used for 3D without embedded multiplication
+	if (n.z > 1 && !embed_multiplication) {
+
+		//number of lines in a tile : largest power of 2 (up to 32) for which the input and output tiles fit in 1MB (so typically kept in L2 cache), and not more lines than available
+		tile_lines = 1;
+		while (tile_lines < 32 && 2 * tile_lines < N.x / 2 + 1 && 2 * (2 * tile_lines) * maximum(N.y, N.z) * sizeof(ReIm3) <= 1048576) tile_lines *= 2;
+
+		for (int idx = 0; idx < OmpThreads; idx++) {
+
+			ptile_zp_y[idx] = fftw_alloc_complex(N.y * tile_lines * 3);
+			ptile_zp_z[idx] = fftw_alloc_complex(N.z * tile_lines * 3);
+			ptile[idx] = fftw_alloc_complex(maximum(N.y, N.z) * tile_lines * 3);
+		}
+
+		zero_fft_tiles();
+
+		//each tile is a batch of 3 * tile_lines interleaved ffts : stride between points in each fft is 3 * tile_lines, and consecutive ffts are adjacent
+		int howmany = 3 * tile_lines;
+
+		for (int idx = 0; idx < OmpThreads; idx++) {
+
+			plan_fwd_y_tile[idx] = fftw_plan_many_dft(1, dims_y, howmany,
+				ptile_zp_y[idx], nullptr, howmany, 1,
+				ptile[idx], nullptr, howmany, 1,
+				FFTW_FORWARD, Get_FFTW_Planner_Flags());
+
+			plan_fwd_z_tile[idx] = fftw_plan_many_dft(1, dims_z, howmany,
+				ptile_zp_z[idx], nullptr, howmany, 1,
+				ptile[idx], nullptr, howmany, 1,
+				FFTW_FORWARD, Get_FFTW_Planner_Flags());
+
+			plan_inv_z_tile[idx] = fftw_plan_many_dft(1, dims_z, howmany,
+				ptile[idx], nullptr, howmany, 1,
+				ptile[idx], nullptr, howmany, 1,
+				FFTW_BACKWARD, Get_FFTW_Planner_Flags());
+
+			plan_inv_y_tile[idx] = fftw_plan_many_dft(1, dims_y, howmany,
+				ptile[idx], nullptr, howmany, 1,
+				ptile[idx], nullptr, howmany, 1,
+				FFTW_BACKWARD, Get_FFTW_Planner_Flags());
+		}
+
+		fftw_tile_plans_created = true;
+	}
+
+	//single precision plans (double precision lines are still needed for kernel multiplication)
+	if (single_precision) make_single_precision_plans();
+
+	//keep any new plans for subsequent runs
+	Save_FFTW_Wisdom();
+
 	return error;
 }
 
@@ -241,4 +741,316 @@ void ConvolutionData::zero_fft_lines(void)
 	}
 }
 
+//zero fftw tiles memory (only call if allocated)
+void ConvolutionData::zero_fft_tiles(void)
+{
+	for (int idx = 0; idx < OmpThreads; idx++) {
+
+		for (int t = 0; t < N.y * tile_lines; t++) {
+
+			*reinterpret_cast<ReIm3*>(ptile_zp_y[idx] + t * 3) = ReIm3();
+		}
+
+		for (int t = 0; t < N.z * tile_lines; t++) {
+
+			*reinterpret_cast<ReIm3*>(ptile_zp_z[idx] + t * 3) = ReIm3();
+		}
+
+		for (int t = 0; t < maximum(N.y, N.z) * tile_lines; t++) {
+
+			*reinterpret_cast<ReIm3*>(ptile[idx] + t * 3) = ReIm3();
+		}
+	}
+}
+
 //-------------------------- RUN-TIME METHODS
+
+//3D, multiplication not embedded : y and z direction ffts on F, after the x direction ffts have been done. Tiled if fft_tiling is set.
+//Call from inside a parallel region : the work is shared between the threads of the enclosing region.
+void ConvolutionData::ForwardFFT_3D_yz(void)
+{
+	if (fft_tiling && fftw_tile_plans_created) ForwardFFT_3D_yz_tiles();
+	else ForwardFFT_3D_yz_lines();
+}
+
+//3D, multiplication not embedded : z and y direction iffts on F2, before the x direction iffts are done. Tiled if fft_tiling is set.
+//Call from inside a parallel region : the work is shared between the threads of the enclosing region.
+void ConvolutionData::InverseFFT_3D_zy(void)
+{
+	if (fft_tiling && fftw_tile_plans_created) InverseFFT_3D_zy_tiles();
+	else InverseFFT_3D_zy_lines();
+}
+
+void ConvolutionData::ForwardFFT_3D_yz_lines(void)
+{
+	//2. FFTs along y
+#pragma omp for
+	for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
+
+		int tn = omp_get_thread_num();
+
+		int i = ik % (N.x / 2 + 1);
+		int k = ik / (N.x / 2 + 1);
+
+		//fetch line from fft array (zero padding kept)
+		for (int j = 0; j < n.y; j++) {
+
+			*reinterpret_cast<ReIm3*>(pline_zp_y[tn] + j * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+		}
+
+		//fft on line
+		fftw_execute(plan_fwd_y[tn]);
+
+		//write line to fft array
+		for (int j = 0; j < N.y; j++) {
+
+			F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_FFTY);
+
+	//3. FFTs along z
+#pragma omp for
+	for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
+
+		int tn = omp_get_thread_num();
+
+		int i = ij % (N.x / 2 + 1);
+		int j = ij / (N.x / 2 + 1);
+
+		//fetch line from fft array (zero padding kept)
+		for (int k = 0; k < n.z; k++) {
+
+			*reinterpret_cast<ReIm3*>(pline_zp_z[tn] + k * 3) = F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+		}
+
+		//fft on line
+		fftw_execute(plan_fwd_z[tn]);
+
+		//write line to fft array
+		for (int k = 0; k < N.z; k++) {
+
+			F[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_FFTZ);
+}
+
+void ConvolutionData::InverseFFT_3D_zy_lines(void)
+{
+	//1. IFFTs along z
+#pragma omp for
+	for (int ij = 0; ij < (N.x / 2 + 1) * N.y; ij++) {
+
+		int tn = omp_get_thread_num();
+
+		int i = ij % (N.x / 2 + 1);
+		int j = ij / (N.x / 2 + 1);
+
+		//fetch line from fft array
+		for (int k = 0; k < N.z; k++) {
+
+			*reinterpret_cast<ReIm3*>(pline[tn] + k * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+		}
+
+		//ifft on line
+		fftw_execute(plan_inv_z[tn]);
+
+		//write line to fft array, truncating upper half
+		for (int k = 0; k < n.z; k++) {
+
+			F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_IFFTZ);
+
+	//2. IFFTs along y
+#pragma omp for
+	for (int ik = 0; ik < (N.x / 2 + 1) * n.z; ik++) {
+
+		int tn = omp_get_thread_num();
+
+		int i = ik % (N.x / 2 + 1);
+		int k = ik / (N.x / 2 + 1);
+
+		//fetch line from fft array
+		for (int j = 0; j < N.y; j++) {
+
+			*reinterpret_cast<ReIm3*>(pline[tn] + j * 3) = F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y];
+		}
+
+		//fft on line
+		fftw_execute(plan_inv_y[tn]);
+
+		//write line to fft array, truncating upper half
+		for (int j = 0; j < n.y; j++) {
+
+			F2[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
+}
+
+//Tiles : lines i0 to i0 + tile_lines - 1 along x (consecutive in F) are copied together, so each copy is a contiguous block of memory.
+//The last tile along x may have fewer lines : the whole tile is still transformed, but only the valid lines are copied back.
+void ConvolutionData::ForwardFFT_3D_yz_tiles(void)
+{
+	int Nx2 = N.x / 2 + 1;
+	int num_tiles = (Nx2 + tile_lines - 1) / tile_lines;
+
+	//2. FFTs along y (tiles for all k planes distributed between threads)
+#pragma omp for
+	for (int tk = 0; tk < num_tiles * n.z; tk++) {
+
+		int tn = omp_get_thread_num();
+
+		int k = tk / num_tiles;
+		int i0 = (tk % num_tiles) * tile_lines;
+		int lines = minimum(tile_lines, Nx2 - i0);
+
+		ReIm3* ptile_in = reinterpret_cast<ReIm3*>(ptile_zp_y[tn]);
+		ReIm3* ptile_out = reinterpret_cast<ReIm3*>(ptile[tn]);
+
+		//fetch tile from fft array (zero padding kept)
+		for (int j = 0; j < n.y; j++) {
+			for (int t = 0; t < lines; t++) {
+
+				ptile_in[t + j * tile_lines] = F[i0 + t + j * Nx2 + k * Nx2 * N.y];
+			}
+		}
+
+		//batched fft on tile
+		fftw_execute(plan_fwd_y_tile[tn]);
+
+		//write tile to fft array
+		for (int j = 0; j < N.y; j++) {
+			for (int t = 0; t < lines; t++) {
+
+				F[i0 + t + j * Nx2 + k * Nx2 * N.y] = ptile_out[t + j * tile_lines];
+			}
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_FFTY);
+
+	//3. FFTs along z
+#pragma omp for
+	for (int tj = 0; tj < num_tiles * N.y; tj++) {
+
+		int tn = omp_get_thread_num();
+
+		int j = tj / num_tiles;
+		int i0 = (tj % num_tiles) * tile_lines;
+		int lines = minimum(tile_lines, Nx2 - i0);
+
+		ReIm3* ptile_in = reinterpret_cast<ReIm3*>(ptile_zp_z[tn]);
+		ReIm3* ptile_out = reinterpret_cast<ReIm3*>(ptile[tn]);
+
+		//fetch tile from fft array (zero padding kept)
+		for (int k = 0; k < n.z; k++) {
+			for (int t = 0; t < lines; t++) {
+
+				ptile_in[t + k * tile_lines] = F[i0 + t + j * Nx2 + k * Nx2 * N.y];
+			}
+		}
+
+		//batched fft on tile
+		fftw_execute(plan_fwd_z_tile[tn]);
+
+		//write tile to fft array
+		for (int k = 0; k < N.z; k++) {
+			for (int t = 0; t < lines; t++) {
+
+				F[i0 + t + j * Nx2 + k * Nx2 * N.y] = ptile_out[t + k * tile_lines];
+			}
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_FFTZ);
+}
+
+void ConvolutionData::InverseFFT_3D_zy_tiles(void)
+{
+	int Nx2 = N.x / 2 + 1;
+	int num_tiles = (Nx2 + tile_lines - 1) / tile_lines;
+
+	//1. IFFTs along z
+#pragma omp for
+	for (int tj = 0; tj < num_tiles * N.y; tj++) {
+
+		int tn = omp_get_thread_num();
+
+		int j = tj / num_tiles;
+		int i0 = (tj % num_tiles) * tile_lines;
+		int lines = minimum(tile_lines, Nx2 - i0);
+
+		ReIm3* ptile_inout = reinterpret_cast<ReIm3*>(ptile[tn]);
+
+		//fetch tile from fft array
+		for (int k = 0; k < N.z; k++) {
+			for (int t = 0; t < lines; t++) {
+
+				ptile_inout[t + k * tile_lines] = F2[i0 + t + j * Nx2 + k * Nx2 * N.y];
+			}
+		}
+
+		//batched ifft on tile
+		fftw_execute(plan_inv_z_tile[tn]);
+
+		//write tile to fft array, truncating upper half
+		for (int k = 0; k < n.z; k++) {
+			for (int t = 0; t < lines; t++) {
+
+				F2[i0 + t + j * Nx2 + k * Nx2 * N.y] = ptile_inout[t + k * tile_lines];
+			}
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_IFFTZ);
+
+	//2. IFFTs along y
+#pragma omp for
+	for (int tk = 0; tk < num_tiles * n.z; tk++) {
+
+		int tn = omp_get_thread_num();
+
+		int k = tk / num_tiles;
+		int i0 = (tk % num_tiles) * tile_lines;
+		int lines = minimum(tile_lines, Nx2 - i0);
+
+		ReIm3* ptile_inout = reinterpret_cast<ReIm3*>(ptile[tn]);
+
+		//fetch tile from fft array
+		for (int j = 0; j < N.y; j++) {
+			for (int t = 0; t < lines; t++) {
+
+				ptile_inout[t + j * tile_lines] = F2[i0 + t + j * Nx2 + k * Nx2 * N.y];
+			}
+		}
+
+		//batched ifft on tile
+		fftw_execute(plan_inv_y_tile[tn]);
+
+		//write tile to fft array, truncating upper half
+		for (int j = 0; j < n.y; j++) {
+			for (int t = 0; t < lines; t++) {
+
+				F2[i0 + t + j * Nx2 + k * Nx2 * N.y] = ptile_inout[t + j * tile_lines];
+			}
+		}
+	}
+
+#pragma omp master
+	if (profiling) Profile_Stage(CONVSTAGE_IFFTY);
+}
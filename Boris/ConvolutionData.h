@@ -7,10 +7,137 @@
 #include "fftw3.h"
 
 #pragma comment(lib, "libfftw3-3.lib")
+//single precision FFTW library, used by the fftsingleprecision mode : see README for how to obtain libfftw3f-3.lib
+#pragma comment(lib, "libfftw3f-3.lib")
+
+//FFTW planner rigor, from fastest planning (but possibly slower transforms) to slowest planning
+enum FFTWPLANNER_ {
+
+	FFTWPLANNER_ESTIMATE = 0,
+	FFTWPLANNER_MEASURE,
+	FFTWPLANNER_PATIENT,
+	FFTWPLANNER_EXHAUSTIVE,
+
+	FFTWPLANNER_NUMENTRIES
+};
+
+//convolution stages, as recorded when profiling : for embedded multiplication CONVSTAGE_MULT includes the last direction fft and ifft.
+enum CONVSTAGE_ {
+
+	CONVSTAGE_FFTX = 0,
+	CONVSTAGE_FFTY,
+	CONVSTAGE_FFTZ,
+	CONVSTAGE_MULT,
+	CONVSTAGE_IFFTZ,
+	CONVSTAGE_IFFTY,
+	CONVSTAGE_IFFTX,
+
+	CONVSTAGE_NUMENTRIES
+};
+
+//scheduling of multi-layered convolutions (separate convolutions for each mesh, with forward and inverse ffts done separately from the kernel multiplications)
+enum MULTICONVTASKS_ {
+
+	MULTICONVTASKS_DISABLED = 0,
+	MULTICONVTASKS_AUTO,
+	MULTICONVTASKS_ALWAYS,
+
+	MULTICONVTASKS_NUMENTRIES
+};
 
 class ConvolutionData
 {
 
+public:
+
+	//-------------------------- FFTW PLANNING (shared by all convolution and kernel objects)
+
+	//planner rigor used for all fftw plans (FFTWPLANNER_ enum) - FFTWPLANNER_PATIENT by default
+	static int fftw_planner;
+
+	//fftw wisdom is loaded from and saved to this file so repeated runs with same FFT dimensions skip planning; empty to disable.
+	//FFTW keys wisdom internally by transform size, thus the file name only needs to be specific to the FFTW version (see Set_FFTW_Wisdom_Directory).
+	static std::string fftw_wisdom_fileName;
+
+	//length of fftw wisdom string last loaded from or saved to file : if current wisdom differs then new plans have been made and wisdom file needs updating
+	static size_t fftw_wisdom_length;
+
+	//same for single precision plans (fftwf keeps separate wisdom)
+	static std::string fftwf_wisdom_fileName;
+	static size_t fftwf_wisdom_length;
+
+	//set directory for fftw wisdom file (file name generated from FFTW version) and load any wisdom already saved there
+	static void Set_FFTW_Wisdom_Directory(std::string directory);
+
+	//save fftw wisdom to file only if new plans have been made since last load / save
+	static void Save_FFTW_Wisdom(void);
+
+	//set planner rigor (FFTWPLANNER_ enum). Takes effect next time plans are made.
+	static void Set_FFTW_Planner(int fftw_planner_) { if (fftw_planner_ >= FFTWPLANNER_ESTIMATE && fftw_planner_ < FFTWPLANNER_NUMENTRIES) fftw_planner = fftw_planner_; }
+
+	//fftw planner flags to use when creating plans, as given by fftw_planner
+	static unsigned Get_FFTW_Planner_Flags(void);
+
+	//-------------------------- FFT TILING (shared by all convolution objects)
+
+	//3D convolutions without embedded multiplication : y and z direction ffts done on tiles of consecutive x-lines copied to contiguous buffers, with a single batched fft per tile.
+	//Otherwise ffts are done one line at a time. Off by default.
+	static bool fft_tiling;
+
+	//time y and z direction ffts and iffts for a 3D convolution (multiplication not embedded) with given mesh dimensions, done one line at a time and tiled.
+	//Average times in ms for a forward and inverse pass, over given number of repeats, returned in times as (lines, tiles).
+	static BError Benchmark_FFT_Tiling(SZ3 n_, int repeats, DBL2& times);
+
+	//-------------------------- FFT PADDING (shared by all convolution objects)
+
+	//In directions without pbc the zero-padded fft length is the smallest 2^a 3^b 5^c 7^d value >= 2n - 1 (sufficient for a linear convolution), rather than 2n which can have large prime factors.
+	//Only used by kernels which support any fft length (fast_padding_supported set, e.g. DemagKernel), and without pbc. On by default.
+	//Takes effect next time convolution dimensions are set.
+	static bool fft_fast_padding;
+
+	//smallest 2^a 3^b 5^c 7^d value >= length
+	static int Get_Fast_FFT_Length(int length);
+
+	//fft dimensions for given mesh dimensions and pbc images, with or without fast padding
+	static SZ3 Get_FFT_Dimensions(SZ3 n_, INT3 pbc_images_, bool fast_padding);
+
+	//expected speedup of the ffts in a convolution with embedded multiplication, using fast padding compared to 2n padding.
+	//Estimated by timing fft lines (estimate plans) for both sets of dimensions, weighted by the number of lines in a convolution.
+	static double Estimate_FFT_Padding_Speedup(SZ3 n_, INT3 pbc_images_);
+
+	//-------------------------- PRECISION (shared by all convolution objects)
+
+	//Convolutions with embedded multiplication use single precision ffts (fftwf) and fft scratch space, halving scratch memory and memory bandwidth in the ffts.
+	//Kernels and kernel multiplication remain in double precision (lines converted), as do output fields and energy values. Off by default.
+	//Takes effect next time convolution dimensions are set : CheckDimensions returns false if this doesn't match the precision in use.
+	static bool fft_single_precision;
+
+	//-------------------------- MULTI-LAYERED CONVOLUTION SCHEDULING (shared by all convolution objects)
+
+	//Multi-layered convolution (MULTICONVTASKS_ enum) : the forward fft, kernel multiplication and inverse fft of each mesh are independent tasks, each run by a single thread, with tasks for different meshes running concurrently.
+	//Otherwise each stage of each mesh is parallelized in turn, which for many thin layers is dominated by synchronization since each stage has little work.
+	//MULTICONVTASKS_AUTO (default) : only use tasks if there are at least as many meshes as threads. Tasks are not used when profiling (profiling records individual convolution stages).
+	static int multiconv_tasks;
+
+	//-------------------------- PROFILING (shared by all convolution objects)
+
+	//Each convolution call (or forward / inverse fft call if multiplication not embedded) runs in a single parallel region, with a barrier at the end of each stage.
+	//When profiling is set, the number of parallel regions and barriers, and time spent in each stage are accumulated. Off by default.
+	static bool profiling;
+
+	//accumulated since profiling was last set : number of parallel regions and barriers (including the one at the end of each region), total time and time in each stage (CONVSTAGE_ enum), in seconds.
+	static size_t profile_regions, profile_barriers;
+	static double profile_time_total;
+	static double profile_time_stages[CONVSTAGE_NUMENTRIES];
+
+	//set profiling status and reset accumulated profile values
+	static void Set_Profiling(bool status);
+
+private:
+
+	//start time of current parallel region, and time at end of last stage
+	static double profile_time_start, profile_time_last;
+
 protected:
 	
 	int OmpThreads;
@@ -21,12 +148,15 @@ protected:
 	//intput mesh cellsize
 	DBL3 h;
 
-	//dimensions of FFT spaces, even so can always divide by 2 :
-	//In directions without PBC these are double the n values, but not necessarily a power of 2.
+	//dimensions of FFT spaces :
+	//In directions without PBC these are double the n values, but not necessarily a power of 2 (or the smallest 2^a 3^b 5^c 7^d value >= 2n - 1 with fast padding).
 	//In directions with PBC these are the same as the n values.
 	//For pbc all we have to do is calculate the kernel differently and set N value to n rather than double that of n.
 	SZ3 N;
 
+	//set by kernels which can be used with any fft length, including odd (kernel multiplication mustn't assume a mid point at N / 2) : fft_fast_padding only applies if set
+	bool fast_padding_supported = false;
+
 	//periodic boundary conditions -> setting these changes convolution dimensions and workflow for kernel calculation.
 	//Set to zero to remove pbc conditions. This gives the number of images to use when computing tensors with pbc conditions.
 	INT3 pbc_images;
@@ -66,6 +196,46 @@ protected:
 
 	bool fftw_plans_created = false;
 
+	//tiled y and z direction ffts (3D only, used if fft_tiling is set) : tile_lines consecutive x-lines are transformed together by one batched fft
+	int tile_lines = 1;
+
+	std::vector<fftw_plan> plan_fwd_y_tile, plan_fwd_z_tile;
+	std::vector<fftw_plan> plan_inv_y_tile, plan_inv_z_tile;
+
+	//forward fft tiles with constant zero padding : N.y * tile_lines and N.z * tile_lines ReIm3 values, with the tile_lines values for each line position stored contiguously
+	std::vector<fftw_complex*> ptile_zp_y, ptile_zp_z;
+
+	//fft and ifft tile without zero padding : maximum(N.y, N.z) * tile_lines ReIm3 values
+	std::vector<fftw_complex*> ptile;
+
+	//the flow for tiles is:
+	//F -> ptile_zp_y -fft-> ptile -> F
+	//F -> ptile_zp_z -fft-> ptile -> F
+	//
+	//F2 -> ptile -ifft-> ptile -> F2 (z then y)
+
+	bool fftw_tile_plans_created = false;
+
+	//single precision ffts in use (fft_single_precision set and multiplication embedded) : Ff used instead of F, which is not allocated
+	bool single_precision = false;
+
+	//single precision FFT calculation space : same dimensions as F
+	VEC<ReIm3F> Ff;
+
+	std::vector<fftwf_plan> planf_fwd_x, planf_fwd_y, planf_fwd_z;
+	std::vector<fftwf_plan> planf_inv_x, planf_inv_y, planf_inv_z;
+
+	//single precision lines, as for the double precision ones
+	std::vector<float*> plinef_zp_x;
+	std::vector<fftwf_complex*> plinef_zp_y, plinef_zp_z;
+	std::vector<fftwf_complex*> plinef;
+	std::vector<float*> plinef_rev_x;
+
+	//the flow is the same as for double precision, except the kernel multiplication is done on the double precision line:
+	//Ff -> plinef_zp_z -fft-> plinef -> pline -*K> pline -> plinef -ifft-> plinef -> Ff
+
+	bool fftwf_plans_created = false;
+
 private:
 
 	//-------------------------- HELPERS
@@ -73,10 +243,13 @@ private:
 	//free memmory allocated for fftw
 	void free_memory(void);
 
-	//Allocate memory for F and F2 (if needed) scratch spaces)
+protected:
+
+	//Allocate memory for F and F2 (if needed) scratch spaces), or Ff if single precision
 	BError AllocateScratchSpaces(void);
 
-protected:
+	//make single precision fft plans and lines, if not already made
+	void make_single_precision_plans(void);
 
 	//-------------------------- CONSTRUCTORS
 
@@ -91,6 +264,9 @@ protected:
 	//zero fftw memory
 	void zero_fft_lines(void);
 
+	//zero fftw tiles memory (only call if allocated)
+	void zero_fft_tiles(void);
+
 	//-------------------------- GETTERS
 
 	//Get pointer to the F scratch space
@@ -99,6 +275,35 @@ protected:
 	//Get pointer to the F2 scratch space
 	VEC<ReIm3>* Get_Output_Scratch_Space(void) { return &F2; }
 
+	//-------------------------- PROFILING
+
+	//call before entering the parallel region of a convolution
+	static void Profile_Start(void);
+
+	//call from master thread at end of stage, straight after the barrier
+	static void Profile_Stage(int stage);
+
+	//call after exiting the parallel region of a convolution
+	static void Profile_End(void);
+
 	//-------------------------- RUN-TIME METHODS
 
+	//3D, multiplication not embedded : y and z direction ffts on F, after the x direction ffts have been done. Tiled if fft_tiling is set.
+	//Call from inside a parallel region : the work is shared between the threads of the enclosing region.
+	void ForwardFFT_3D_yz(void);
+
+	//3D, multiplication not embedded : z and y direction iffts on F2, before the x direction iffts are done. Tiled if fft_tiling is set.
+	//Call from inside a parallel region : the work is shared between the threads of the enclosing region.
+	void InverseFFT_3D_zy(void);
+
+private:
+
+	//one line at a time versions of the above
+	void ForwardFFT_3D_yz_lines(void);
+	void InverseFFT_3D_zy_lines(void);
+
+	//tiled versions of the above
+	void ForwardFFT_3D_yz_tiles(void);
+	void InverseFFT_3D_zy_tiles(void);
+
 };
@@ -106,10 +106,16 @@ double DMExchange::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
-#pragma omp parallel for reduction(+:energy) 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), n.dim());
+
+#pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				double Ms = pMesh->Ms;
 				double A = pMesh->A;
@@ -186,7 +192,10 @@ double DMExchange::UpdateField(void)
 
 				pMesh->Heff[idx] += Hexch_A + Hexch_D;
 
-				energy += pMesh->M[idx] * (Hexch_A + Hexch_D);
+				double cell_energy = pMesh->M[idx] * (Hexch_A + Hexch_D);
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				//spatial dependence display of effective field and energy density
 				if (Module_Heff.linear_size() && Module_energy.linear_size()) {
@@ -205,7 +214,15 @@ double DMExchange::UpdateField(void)
 					}
 				}
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -214,10 +231,16 @@ double DMExchange::UpdateField(void)
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
-#pragma omp parallel for reduction(+:energy) 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), n.dim());
+
+#pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				DBL2 Ms_AFM = pMesh->Ms_AFM;
 				DBL2 A_AFM = pMesh->A_AFM;
@@ -296,7 +319,10 @@ double DMExchange::UpdateField(void)
 				pMesh->Heff[idx] += Hexch_A + Hexch_D;
 				pMesh->Heff2[idx] += Hexch_A2 + Hexch_D2;
 
-				energy += (pMesh->M[idx] * (Hexch_A + Hexch_D) + pMesh->M2[idx] * (Hexch_A2 + Hexch_D2)) / 2;
+				double cell_energy = (pMesh->M[idx] * (Hexch_A + Hexch_D) + pMesh->M2[idx] * (Hexch_A2 + Hexch_D2)) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				//spatial dependence display of effective field and energy density
 				if (Module_Heff.linear_size() && Module_energy.linear_size()) {
@@ -331,7 +357,15 @@ double DMExchange::UpdateField(void)
 					}
 				}
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -8,6 +8,7 @@ enum DATA_
 	//Simulation schedule related data
 	DATA_STAGESTEP = 1, DATA_TIME = 2, DATA_STAGETIME = 3, DATA_ITERATIONS = 4, DATA_SITERATIONS = 5, 
 	DATA_DT = 6, DATA_MXH = 7, DATA_DMDT = 34,
+	DATA_ASTEPSTATS = 68, DATA_ACTIVEFRACTION = 69, DATA_REPLICA = 70, DATA_GNEBBARRIER = 71, DATA_PTSWAPRATE = 72,
 
 	//Mesh quantities output, magnetic data
 	DATA_AVM = 8, DATA_AVM2 = 36, DATA_HA = 9,
@@ -54,4 +55,4 @@ enum DATA_
 	//Previously used by DATA_E_EXCH_MAX, now deleted
 	DATA_RESERVED = 39
 };
-//Current maximum : 67
+//Current maximum : 72
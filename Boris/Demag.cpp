@@ -148,6 +148,17 @@ BError Demag::Set_PBC(INT3 demag_pbc_images_)
 	return error;
 }
 
+//compare single and double precision fft convolutions on current magnetization : x is maximum field difference relative to maximum demag field, y is relative demag energy difference
+BError Demag::Compare_FFT_Precision(DBL2& accuracy)
+{
+	BError error(CLASS_STR(Demag));
+
+	if (!initialized) error = Initialize();
+	if (error) return error;
+
+	return Compare_Precision(pMesh->M, accuracy);
+}
+
 BError Demag::MakeCUDAModule(void)
 {
 	BError error(CLASS_STR(Demag));
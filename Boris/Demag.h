@@ -59,6 +59,11 @@ public:
 	//Set PBC
 	BError Set_PBC(INT3 demag_pbc_images_);
 
+	//-------------------Precision
+
+	//compare single and double precision fft convolutions on current magnetization : x is maximum field difference relative to maximum demag field, y is relative demag energy difference
+	BError Compare_FFT_Precision(DBL2& accuracy);
+
 	//-------------------Energy methods
 
 	//FM mesh
@@ -106,6 +111,10 @@ public:
 
 	//Set PBC
 	BError Set_PBC(INT3 demag_pbc_images_) { return BError(); }
+
+	//-------------------Precision
+
+	BError Compare_FFT_Precision(DBL2& accuracy) { return BError(); }
 };
 
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "DemagKernel.h"
+#include "DemagKernelCache.h"
+#include "KernelMultSIMD.h"
 
 #if defined MODULE_COMPILATION_DEMAG || defined MODULE_COMPILATION_SDEMAG
 
@@ -44,41 +46,15 @@ void DemagKernel::KernelMultiplication_2D_line(ReIm3* pline, int i)
 	//above N.y/2 use kernel symmetries to recover kernel values
 	//diagonal components are even about the N.y/2 point
 	//off-diagonal values are odd about the N.y/2 point
+	//N.y can be odd (fast padding), in which case there is no mid point
 
-	//j = 0
-	ReIm3 FM = pline[0];
+	int ker_stride = N.x / 2 + 1;
 
-	int idx_start = i;
+	//j = 0 to N.y / 2 inclusive (mid point included for even N.y)
+	KernelMultSIMD::Multiply_2D(pline, pline, N.y / 2 + 1, 1, Kdiag.data() + i, K2D_odiag.data() + i, ker_stride, 1.0);
 
-	pline[0].x = (Kdiag[idx_start].x  * FM.x) + (K2D_odiag[idx_start] * FM.y);
-	pline[0].y = (K2D_odiag[idx_start] * FM.x) + (Kdiag[idx_start].y  * FM.y);
-	pline[0].z = (Kdiag[idx_start].z  * FM.z);
-
-	//points between 1 and N.y / 2 - 1 inclusive
-	for (int j = 1; j < N.y / 2; j++) {
-
-		ReIm3 FM_l = pline[j];
-		ReIm3 FM_h = pline[N.y - j];
-
-		int ker_index = i + j * (N.x / 2 + 1);
-
-		pline[j].x = (Kdiag[ker_index].x  * FM_l.x) + (K2D_odiag[ker_index] * FM_l.y);
-		pline[j].y = (K2D_odiag[ker_index] * FM_l.x) + (Kdiag[ker_index].y  * FM_l.y);
-		pline[j].z = (Kdiag[ker_index].z  * FM_l.z);
-
-		pline[N.y - j].x = (Kdiag[ker_index].x  * FM_h.x) + (-K2D_odiag[ker_index] * FM_h.y);
-		pline[N.y - j].y = (-K2D_odiag[ker_index] * FM_h.x) + (Kdiag[ker_index].y  * FM_h.y);
-		pline[N.y - j].z = (Kdiag[ker_index].z  * FM_h.z);
-	}
-
-	//j = N.y / 2
-	FM = pline[N.y / 2];
-
-	int idx_mid = i + (N.y / 2) * (N.x / 2 + 1);
-
-	pline[N.y / 2].x = (Kdiag[idx_mid].x  * FM.x) + (K2D_odiag[idx_mid] * FM.y);
-	pline[N.y / 2].y = (K2D_odiag[idx_mid] * FM.x) + (Kdiag[idx_mid].y  * FM.y);
-	pline[N.y / 2].z = (Kdiag[idx_mid].z  * FM.z);
+	//j = N.y - 1 down to N.y - (N.y + 1) / 2 + 1 : kernel values from j = 1 upwards
+	KernelMultSIMD::Multiply_2D(pline + N.y - 1, pline + N.y - 1, (N.y + 1) / 2 - 1, -1, Kdiag.data() + i + ker_stride, K2D_odiag.data() + i + ker_stride, ker_stride, -1.0);
 }
 
 //multiply kernels in line along z direction (so use stride of (N.x/2 + 1) * N.y to read from kernels), starting at given i and j indexes (these must be an indexes in the first xy plane)
@@ -89,89 +65,62 @@ void DemagKernel::KernelMultiplication_3D_line(ReIm3* pline, int i, int j)
 	//Kxy is even about N.z/2 and odd about N.y/2
 	//Kxz is odd about N.z/2 and even about N.y/2
 	//Kyz is odd about N.z/2 and odd about N.y/2
+	//N.y and N.z can be odd (fast padding), in which case there is no mid point
 
-	if (j <= N.y / 2) {
-
-		//k = 0
-		ReIm3 FM = pline[0];
+	int ker_stride = (N.x / 2 + 1) * (N.y / 2 + 1);
 
-		int idx_start = i + j * (N.x / 2 + 1);
+	//signs of Kxy, Kxz, Kyz for the lower half of the line (k <= N.z / 2) and upper half
+	DBL3 sign_l, sign_h;
+	int idx_start;
 
-		pline[0].x = (Kdiag[idx_start].x * FM.x) + (Kodiag[idx_start].x * FM.y) + (Kodiag[idx_start].y * FM.z);
-		pline[0].y = (Kodiag[idx_start].x * FM.x) + (Kdiag[idx_start].y * FM.y) + (Kodiag[idx_start].z * FM.z);
-		pline[0].z = (Kodiag[idx_start].y * FM.x) + (Kodiag[idx_start].z * FM.y) + (Kdiag[idx_start].z * FM.z);
-
-		//points between 1 and N.z /2 - 1 inclusive
-		for (int k = 1; k < N.z / 2; k++) {
-
-			ReIm3 FM_l = pline[k];
-			ReIm3 FM_h = pline[N.z - k];
-
-			int ker_index = idx_start + k * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-			pline[k].x = (Kdiag[ker_index].x * FM_l.x) + (Kodiag[ker_index].x * FM_l.y) + (Kodiag[ker_index].y * FM_l.z);
-			pline[k].y = (Kodiag[ker_index].x * FM_l.x) + (Kdiag[ker_index].y * FM_l.y) + (Kodiag[ker_index].z * FM_l.z);
-			pline[k].z = (Kodiag[ker_index].y * FM_l.x) + (Kodiag[ker_index].z * FM_l.y) + (Kdiag[ker_index].z * FM_l.z);
-
-			pline[N.z - k].x = (Kdiag[ker_index].x * FM_h.x) + (Kodiag[ker_index].x * FM_h.y) + (-Kodiag[ker_index].y * FM_h.z);
-			pline[N.z - k].y = (Kodiag[ker_index].x * FM_h.x) + (Kdiag[ker_index].y * FM_h.y) + (-Kodiag[ker_index].z * FM_h.z);
-			pline[N.z - k].z = (-Kodiag[ker_index].y * FM_h.x) + (-Kodiag[ker_index].z * FM_h.y) + (Kdiag[ker_index].z * FM_h.z);
-		}
-
-		//k = N.z / 2
-		FM = pline[N.z / 2];
-
-		int idx_mid = idx_start + (N.z / 2) * (N.x / 2 + 1) * (N.y / 2 + 1);
+	if (j <= N.y / 2) {
 
-		pline[N.z / 2].x = (Kdiag[idx_mid].x * FM.x) + (Kodiag[idx_mid].x * FM.y) + (Kodiag[idx_mid].y * FM.z);
-		pline[N.z / 2].y = (Kodiag[idx_mid].x * FM.x) + (Kdiag[idx_mid].y * FM.y) + (Kodiag[idx_mid].z * FM.z);
-		pline[N.z / 2].z = (Kodiag[idx_mid].y * FM.x) + (Kodiag[idx_mid].z * FM.y) + (Kdiag[idx_mid].z * FM.z);
+		idx_start = i + j * (N.x / 2 + 1);
+		sign_l = DBL3(1, 1, 1);
+		sign_h = DBL3(1, -1, -1);
 	}
 	else {
 
-		//k = 0
-		ReIm3 FM = pline[0];
-
-		int idx_start = i + (N.y - j) * (N.x / 2 + 1);
-
-		pline[0].x = (Kdiag[idx_start].x * FM.x) + (-Kodiag[idx_start].x * FM.y) + (Kodiag[idx_start].y * FM.z);
-		pline[0].y = (-Kodiag[idx_start].x * FM.x) + (Kdiag[idx_start].y * FM.y) + (-Kodiag[idx_start].z * FM.z);
-		pline[0].z = (Kodiag[idx_start].y * FM.x) + (-Kodiag[idx_start].z * FM.y) + (Kdiag[idx_start].z * FM.z);
-
-		//points between 1 and N.z /2 - 1 inclusive
-		for (int k = 1; k < N.z / 2; k++) {
-
-			ReIm3 FM_l = pline[k];
-			ReIm3 FM_h = pline[N.z - k];
+		idx_start = i + (N.y - j) * (N.x / 2 + 1);
+		sign_l = DBL3(-1, 1, -1);
+		sign_h = DBL3(-1, -1, 1);
+	}
 
-			int ker_index = idx_start + k * (N.x / 2 + 1) * (N.y / 2 + 1);
+	//k = 0 to N.z / 2 inclusive (mid point included for even N.z)
+	KernelMultSIMD::Multiply_3D(pline, pline, N.z / 2 + 1, 1, Kdiag.data() + idx_start, Kodiag.data() + idx_start, ker_stride, sign_l);
 
-			pline[k].x = (Kdiag[ker_index].x * FM_l.x) + (-Kodiag[ker_index].x * FM_l.y) + (Kodiag[ker_index].y * FM_l.z);
-			pline[k].y = (-Kodiag[ker_index].x * FM_l.x) + (Kdiag[ker_index].y * FM_l.y) + (-Kodiag[ker_index].z * FM_l.z);
-			pline[k].z = (Kodiag[ker_index].y * FM_l.x) + (-Kodiag[ker_index].z * FM_l.y) + (Kdiag[ker_index].z * FM_l.z);
+	//k = N.z - 1 down to N.z - (N.z + 1) / 2 + 1 : kernel values from k = 1 upwards
+	KernelMultSIMD::Multiply_3D(pline + N.z - 1, pline + N.z - 1, (N.z + 1) / 2 - 1, -1, Kdiag.data() + idx_start + ker_stride, Kodiag.data() + idx_start + ker_stride, ker_stride, sign_h);
+}
 
-			pline[N.z - k].x = (Kdiag[ker_index].x * FM_h.x) + (-Kodiag[ker_index].x * FM_h.y) + (-Kodiag[ker_index].y * FM_h.z);
-			pline[N.z - k].y = (-Kodiag[ker_index].x * FM_h.x) + (Kdiag[ker_index].y * FM_h.y) + (Kodiag[ker_index].z * FM_h.z);
-			pline[N.z - k].z = (-Kodiag[ker_index].y * FM_h.x) + (Kodiag[ker_index].z * FM_h.y) + (Kdiag[ker_index].z * FM_h.z);
-		}
+//-------------------------- KERNEL CALCULATION
 
-		//k = N.z / 2
-		FM = pline[N.z / 2];
+//x line ffts are packed in place : line L is read from L * N.x and packed to L * (N.x / 2 + 1), overwriting inputs of earlier lines.
+//Starting at line_start (all earlier lines already done), return end of block of lines which can be transformed in parallel (up to num_lines).
+int DemagKernel::Get_Inplace_Pack_Block(int line_start, int num_lines)
+{
+	//N.x = 1 or 2 : packed line not shorter than input line, so lines never overlap
+	if (N.x / 2 + 1 >= N.x) return num_lines;
 
-		int idx_mid = idx_start + (N.z / 2) * (N.x / 2 + 1) * (N.y / 2 + 1);
+	//all lines in block must be packed below the first unread input, i.e. line_end * (N.x / 2 + 1) <= line_start * N.x
+	//block sizes roughly double each time so the number of blocks only grows logarithmically with number of lines (a line is always safe on its own)
+	int line_end = (int)(((long long)line_start * N.x) / (N.x / 2 + 1));
 
-		pline[N.z / 2].x = (Kdiag[idx_mid].x * FM.x) + (-Kodiag[idx_mid].x * FM.y) + (Kodiag[idx_mid].y * FM.z);
-		pline[N.z / 2].y = (-Kodiag[idx_mid].x * FM.x) + (Kdiag[idx_mid].y * FM.y) + (-Kodiag[idx_mid].z * FM.z);
-		pline[N.z / 2].z = (Kodiag[idx_mid].y * FM.x) + (-Kodiag[idx_mid].z * FM.y) + (Kdiag[idx_mid].z * FM.z);
-	}
+	return minimum(maximum(line_end, line_start + 1), num_lines);
 }
 
-//-------------------------- KERNEL CALCULATION
-
 BError DemagKernel::Calculate_Demag_Kernels_2D(bool include_self_demag)
 {
 	BError error(__FUNCTION__);
 
+	//-------------- KERNEL STORE
+
+	//kernels already computed for same discretisation (in this or a previous run)?
+	std::string kernel_key = DemagKernelCache::Make_Key("DemagKernel_2D", n, h, N, pbc_images, DBL3(), DBL3(), DBL3(), include_self_demag);
+	std::vector<std::pair<void*, size_t>> kernel_arrays = { { Kdiag.data(), Kdiag.linear_size() * sizeof(DBL3) }, { K2D_odiag.data(), K2D_odiag.size() * sizeof(double) } };
+
+	if (DemagKernelCache::Load(kernel_key, kernel_arrays)) return error;
+
 	//-------------- CALCULATE DEMAG TENSOR
 
 	//Demag tensor components
@@ -202,94 +151,118 @@ BError DemagKernel::Calculate_Demag_Kernels_2D(bool include_self_demag)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens2D_PBC(
 			Ddiag, N, h / maximum(h.x, h.y, h.z),
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 
 		if (!dtf.CalcOffDiagTens2D_PBC(
 			Dodiag, N, h / maximum(h.x, h.y, h.z), 
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
-	
-	double* pline_real = fftw_alloc_real(maximum(N.x, N.y, N.z) * 3);
-	double* pline_real_odiag = fftw_alloc_real(maximum(N.x, N.y, N.z));
-	fftw_complex* pline_odiag = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z));
-	fftw_complex* pline = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z) * 3);
+
+	//lines are transformed in parallel, thus each thread needs its own line buffers and fft plans
+	int OmpThreads = omp_get_num_procs();
+
+	std::vector<double*> pline_real(OmpThreads), pline_real_odiag(OmpThreads);
+	std::vector<fftw_complex*> pline(OmpThreads), pline_odiag(OmpThreads);
+	std::vector<fftw_plan> plan_fwd_x(OmpThreads), plan_fwd_x_odiag(OmpThreads), plan_fwd_y(OmpThreads), plan_fwd_y_odiag(OmpThreads);
 
 	//make fft plans
 	int dims_x[1] = { (int)N.x };
 	int dims_y[1] = { (int)N.y };
 
-	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
-		pline_real, nullptr, 3, 1,
-		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+	for (int tn = 0; tn < OmpThreads; tn++) {
+
+		pline_real[tn] = fftw_alloc_real(maximum(N.x, N.y, N.z) * 3);
+		pline_real_odiag[tn] = fftw_alloc_real(maximum(N.x, N.y, N.z));
+		pline_odiag[tn] = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z));
+		pline[tn] = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z) * 3);
 
-	fftw_plan plan_fwd_x_odiag = fftw_plan_many_dft_r2c(1, dims_x, 1,
-		pline_real_odiag, nullptr, 1, 1,
-		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		plan_fwd_x[tn] = fftw_plan_many_dft_r2c(1, dims_x, 3,
+			pline_real[tn], nullptr, 3, 1,
+			pline[tn], nullptr, 3, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
 
-	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
-		pline_real, nullptr, 3, 1,
-		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		plan_fwd_x_odiag[tn] = fftw_plan_many_dft_r2c(1, dims_x, 1,
+			pline_real_odiag[tn], nullptr, 1, 1,
+			pline_odiag[tn], nullptr, 1, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
 
-	fftw_plan plan_fwd_y_odiag = fftw_plan_many_dft_r2c(1, dims_y, 1,
-		pline_real_odiag, nullptr, 1, 1,
-		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		plan_fwd_y[tn] = fftw_plan_many_dft_r2c(1, dims_y, 3,
+			pline_real[tn], nullptr, 3, 1,
+			pline[tn], nullptr, 3, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
+
+		plan_fwd_y_odiag[tn] = fftw_plan_many_dft_r2c(1, dims_y, 1,
+			pline_real_odiag[tn], nullptr, 1, 1,
+			pline_odiag[tn], nullptr, 1, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
+	}
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
 	//1. FFTs along x
-	for (int j = 0; j < N.y; j++) {
+	//packing is done in place so transform lines in blocks, such that no line in a block overwrites the input of a line not yet read (see Get_Inplace_Pack_Block)
+	for (int j_start = 0; j_start < N.y;) {
 
-		//write input into fft line
-		for (int i = 0; i < N.x; i++) {
+		int j_end = Get_Inplace_Pack_Block(j_start, N.y);
 
-			int idx_in = i + j * N.x;
+#pragma omp parallel for
+		for (int j = j_start; j < j_end; j++) {
 
-			*reinterpret_cast<DBL3*>(pline_real + i * 3) = Ddiag[idx_in];
-			*reinterpret_cast<double*>(pline_real_odiag + i) = Dodiag[idx_in];
-		}
+			int tn = omp_get_thread_num();
 
-		//fft on line
-		fftw_execute(plan_fwd_x);
-		fftw_execute(plan_fwd_x_odiag);
+			//write input into fft line
+			for (int i = 0; i < N.x; i++) {
+
+				int idx_in = i + j * N.x;
 
-		//pack into tensor for next step
-		for (int i = 0; i < N.x / 2 + 1; i++) {
+				*reinterpret_cast<DBL3*>(pline_real[tn] + i * 3) = Ddiag[idx_in];
+				*reinterpret_cast<double*>(pline_real_odiag[tn] + i) = Dodiag[idx_in];
+			}
+
+			//fft on line
+			fftw_execute(plan_fwd_x[tn]);
+			fftw_execute(plan_fwd_x_odiag[tn]);
 
-			ReIm3 value = *reinterpret_cast<ReIm3*>(pline + i * 3);
-			ReIm value_odiag = *reinterpret_cast<ReIm*>(pline_odiag + i);
+			//pack into tensor for next step
+			for (int i = 0; i < N.x / 2 + 1; i++) {
 
-			Ddiag[i + j * (N.x / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
-			Dodiag[i + j * (N.x / 2 + 1)] = value_odiag.Im;
+				ReIm3 value = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
+				ReIm value_odiag = *reinterpret_cast<ReIm*>(pline_odiag[tn] + i);
+
+				Ddiag[i + j * (N.x / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
+				Dodiag[i + j * (N.x / 2 + 1)] = value_odiag.Im;
+			}
 		}
+
+		j_start = j_end;
 	}
 
 	//2. FFTs along y
+#pragma omp parallel for
 	for (int i = 0; i < (N.x / 2 + 1); i++) {
 
+		int tn = omp_get_thread_num();
+
 		//fetch line from array
 		for (int j = 0; j < N.y; j++) {
 
-			*reinterpret_cast<DBL3*>(pline_real + j * 3) = Ddiag[i + j * (N.x / 2 + 1)];
-			*reinterpret_cast<double*>(pline_real_odiag + j) = Dodiag[i + j * (N.x / 2 + 1)];
+			*reinterpret_cast<DBL3*>(pline_real[tn] + j * 3) = Ddiag[i + j * (N.x / 2 + 1)];
+			*reinterpret_cast<double*>(pline_real_odiag[tn] + j) = Dodiag[i + j * (N.x / 2 + 1)];
 		}
 
 		//fft on line
-		fftw_execute(plan_fwd_y);
-		fftw_execute(plan_fwd_y_odiag);
+		fftw_execute(plan_fwd_y[tn]);
+		fftw_execute(plan_fwd_y_odiag[tn]);
 
 		//pack into output real kernels with reduced strides
 		for (int j = 0; j < N.y / 2 + 1; j++) {
 
-			ReIm3 value = *reinterpret_cast<ReIm3*>(pline + j * 3);
-			ReIm value_odiag = *reinterpret_cast<ReIm*>(pline_odiag + j);
+			ReIm3 value = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
+			ReIm value_odiag = *reinterpret_cast<ReIm*>(pline_odiag[tn] + j);
 
 			//even w.r.t. y so output is purely real
 			Kdiag[i + j * (N.x / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
@@ -302,14 +275,20 @@ BError DemagKernel::Calculate_Demag_Kernels_2D(bool include_self_demag)
 
 	//-------------- CLEANUP
 
-	fftw_destroy_plan(plan_fwd_x);
-	fftw_destroy_plan(plan_fwd_x_odiag);
-	fftw_destroy_plan(plan_fwd_y);
-	fftw_destroy_plan(plan_fwd_y_odiag);
+	for (int tn = 0; tn < OmpThreads; tn++) {
+
+		fftw_destroy_plan(plan_fwd_x[tn]);
+		fftw_destroy_plan(plan_fwd_x_odiag[tn]);
+		fftw_destroy_plan(plan_fwd_y[tn]);
+		fftw_destroy_plan(plan_fwd_y_odiag[tn]);
 
-	fftw_free((double*)pline_real);
-	fftw_free((double*)pline_real_odiag);
-	fftw_free((fftw_complex*)pline);
+		fftw_free((double*)pline_real[tn]);
+		fftw_free((double*)pline_real_odiag[tn]);
+		fftw_free((fftw_complex*)pline[tn]);
+		fftw_free((fftw_complex*)pline_odiag[tn]);
+	}
+
+	DemagKernelCache::Save(kernel_key, kernel_arrays);
 	
 	return error;
 }
@@ -317,6 +296,14 @@ BError DemagKernel::Calculate_Demag_Kernels_2D(bool include_self_demag)
 BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 {
 	BError error(__FUNCTION__);
+
+	//-------------- KERNEL STORE
+
+	//kernels already computed for same discretisation (in this or a previous run)?
+	std::string kernel_key = DemagKernelCache::Make_Key("DemagKernel_3D", n, h, N, pbc_images, DBL3(), DBL3(), DBL3(), include_self_demag);
+	std::vector<std::pair<void*, size_t>> kernel_arrays = { { Kdiag.data(), Kdiag.linear_size() * sizeof(DBL3) }, { Kodiag.data(), Kodiag.linear_size() * sizeof(DBL3) } };
+
+	if (DemagKernelCache::Load(kernel_key, kernel_arrays)) return error;
 	
 	//-------------- DEMAG TENSOR
 
@@ -337,28 +324,38 @@ BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 
 	//-------------- SETUP FFT
 
-	double* pline_real = fftw_alloc_real(maximum(N.x, N.y, N.z) * 3);
-	fftw_complex* pline = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z) * 3);
+	//lines are transformed in parallel, thus each thread needs its own line buffers and fft plans
+	int OmpThreads = omp_get_num_procs();
+
+	std::vector<double*> pline_real(OmpThreads);
+	std::vector<fftw_complex*> pline(OmpThreads);
+	std::vector<fftw_plan> plan_fwd_x(OmpThreads), plan_fwd_y(OmpThreads), plan_fwd_z(OmpThreads);
 
 	//make fft plans
 	int dims_x[1] = { (int)N.x };
 	int dims_y[1] = { (int)N.y };
 	int dims_z[1] = { (int)N.z };
 
-	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
-		pline_real, nullptr, 3, 1,
-		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+	for (int tn = 0; tn < OmpThreads; tn++) {
+
+		pline_real[tn] = fftw_alloc_real(maximum(N.x, N.y, N.z) * 3);
+		pline[tn] = fftw_alloc_complex(maximum(N.x / 2 + 1, N.y, N.z) * 3);
 
-	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
-		pline_real, nullptr, 3, 1,
-		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		plan_fwd_x[tn] = fftw_plan_many_dft_r2c(1, dims_x, 3,
+			pline_real[tn], nullptr, 3, 1,
+			pline[tn], nullptr, 3, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
 
-	fftw_plan plan_fwd_z = fftw_plan_many_dft_r2c(1, dims_z, 3,
-		pline_real, nullptr, 3, 1,
-		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		plan_fwd_y[tn] = fftw_plan_many_dft_r2c(1, dims_y, 3,
+			pline_real[tn], nullptr, 3, 1,
+			pline[tn], nullptr, 3, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
+
+		plan_fwd_z[tn] = fftw_plan_many_dft_r2c(1, dims_z, 3,
+			pline_real[tn], nullptr, 3, 1,
+			pline[tn], nullptr, 3, 1,
+			ConvolutionData::Get_FFTW_Planner_Flags());
+	}
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -366,58 +363,72 @@ BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 	auto tensor_to_kernel = [&](VEC<DBL3>& tensor, VEC<DBL3>& kernel, bool off_diagonal) -> void {
 
 		//1. FFTs along x
-		for (int k = 0; k < N.z; k++) {
-			for (int j = 0; j < N.y; j++) {
+		//x lines are indexed by jk = j + k * N.y. Packing is done in place so transform lines in blocks, such that no line in a block overwrites the input of a line not yet read (see Get_Inplace_Pack_Block)
+		for (int jk_start = 0; jk_start < N.y * N.z;) {
+
+			int jk_end = Get_Inplace_Pack_Block(jk_start, N.y * N.z);
+
+#pragma omp parallel for
+			for (int jk = jk_start; jk < jk_end; jk++) {
+
+				int tn = omp_get_thread_num();
 
 				//write input into fft line (zero padding kept)
 				for (int i = 0; i < N.x; i++) {
 
-					int idx_in = i + j * N.x + k * N.x * N.y;
+					int idx_in = i + jk * N.x;
 
-					*reinterpret_cast<DBL3*>(pline_real + i * 3) = tensor[idx_in];
+					*reinterpret_cast<DBL3*>(pline_real[tn] + i * 3) = tensor[idx_in];
 				}
 
 				//fft on line
-				fftw_execute(plan_fwd_x);
+				fftw_execute(plan_fwd_x[tn]);
 
 				//pack into tensor for next step
 				for (int i = 0; i < N.x / 2 + 1; i++) {
 
-					ReIm3 value = *reinterpret_cast<ReIm3*>(pline + i * 3);
+					ReIm3 value = *reinterpret_cast<ReIm3*>(pline[tn] + i * 3);
 
 					if (!off_diagonal) {
 
 						//even w.r.t. to x so output is purely real
-						tensor[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = DBL3(value.x.Re, value.y.Re, value.z.Re);
+						tensor[i + jk * (N.x / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
 					}
 					else {
 
 						//Dxy : odd x, Dxz : odd x, Dyz : even x
-						tensor[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y] = DBL3(value.x.Im, value.y.Im, value.z.Re);
+						tensor[i + jk * (N.x / 2 + 1)] = DBL3(value.x.Im, value.y.Im, value.z.Re);
 					}
 				}
 			}
+
+			jk_start = jk_end;
 		}
 
 		//2. FFTs along y
-		for (int k = 0; k < N.z; k++) {
-			for (int i = 0; i < (N.x / 2 + 1); i++) {
+		//Packing is also done in place, but all reads and writes for a given i index only touch elements with the same i index : parallelize over i, taking planes in order for each i
+#pragma omp parallel for
+		for (int i = 0; i < (N.x / 2 + 1); i++) {
+
+			int tn = omp_get_thread_num();
+
+			for (int k = 0; k < N.z; k++) {
 
 				//fetch line from fft array (zero padding kept)
 				for (int j = 0; j < N.y; j++) {
 
 					int idx_in = i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
 
-					*reinterpret_cast<DBL3*>(pline_real + j * 3) = tensor[idx_in];
+					*reinterpret_cast<DBL3*>(pline_real[tn] + j * 3) = tensor[idx_in];
 				}
 
 				//fft on line
-				fftw_execute(plan_fwd_y);
+				fftw_execute(plan_fwd_y[tn]);
 
 				//pack into lower half of tensor column for next step (keep same row and plane strides)
 				for (int j = 0; j < N.y / 2 + 1; j++) {
 
-					ReIm3 value = *reinterpret_cast<ReIm3*>(pline + j * 3);
+					ReIm3 value = *reinterpret_cast<ReIm3*>(pline[tn] + j * 3);
 
 					if (!off_diagonal) {
 
@@ -434,38 +445,39 @@ BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 		}
 
 		//3. FFTs along z
-		for (int j = 0; j < N.y / 2 + 1; j++) {
-			for (int i = 0; i < N.x / 2 + 1; i++) {
+#pragma omp parallel for
+		for (int ij = 0; ij < (N.x / 2 + 1) * (N.y / 2 + 1); ij++) {
 
-				//fetch line from fft array (zero padding kept)
-				for (int k = 0; k < N.z; k++) {
+			int tn = omp_get_thread_num();
 
-					int idx_in = i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * (N.y / 2 + 1);
+			//fetch line from fft array (zero padding kept)
+			for (int k = 0; k < N.z; k++) {
 
-					*reinterpret_cast<DBL3*>(pline_real + k * 3) = tensor[idx_in];
-				}
+				int idx_in = ij + k * (N.x / 2 + 1) * (N.y / 2 + 1);
 
-				//fft on line
-				fftw_execute(plan_fwd_z);
+				*reinterpret_cast<DBL3*>(pline_real[tn] + k * 3) = tensor[idx_in];
+			}
 
-				//pack into output kernels with reduced strides
-				for (int k = 0; k < N.z / 2 + 1; k++) {
+			//fft on line
+			fftw_execute(plan_fwd_z[tn]);
 
-					ReIm3 value = *reinterpret_cast<ReIm3*>(pline + k * 3);
+			//pack into output kernels with reduced strides
+			for (int k = 0; k < N.z / 2 + 1; k++) {
 
-					if (!off_diagonal) {
+				ReIm3 value = *reinterpret_cast<ReIm3*>(pline[tn] + k * 3);
 
-						//even w.r.t. to z so output is purely real
-						kernel[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * (N.y / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
-					}
-					else {
+				if (!off_diagonal) {
 
-						//Dxy : even z, Dxz : odd z, Dyz : odd z
-						//Also multiply by -1 since all off-diagonal tensor elements have been odd twice
-						//The final output is thus purely real but we always treated the input as purely real even when it should have been purely imaginary
-						//This means we need to account for i * i = -1 at the end
-						kernel[i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * (N.y / 2 + 1)] = DBL3(-value.x.Re, -value.y.Im, -value.z.Im);
-					}
+					//even w.r.t. to z so output is purely real
+					kernel[ij + k * (N.x / 2 + 1) * (N.y / 2 + 1)] = DBL3(value.x.Re, value.y.Re, value.z.Re);
+				}
+				else {
+
+					//Dxy : even z, Dxz : odd z, Dyz : odd z
+					//Also multiply by -1 since all off-diagonal tensor elements have been odd twice
+					//The final output is thus purely real but we always treated the input as purely real even when it should have been purely imaginary
+					//This means we need to account for i * i = -1 at the end
+					kernel[ij + k * (N.x / 2 + 1) * (N.y / 2 + 1)] = DBL3(-value.x.Re, -value.y.Im, -value.z.Im);
 				}
 			}
 		}
@@ -483,7 +495,7 @@ BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 	else {
 
 		//pbcs used in at least one dimension
-		if (!dtf.CalcDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+		if (!dtf.CalcDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 	
 	tensor_to_kernel(D, Kdiag, false);
@@ -498,19 +510,24 @@ BError DemagKernel::Calculate_Demag_Kernels_3D(bool include_self_demag)
 	else {
 
 		//pbcs used in at least one dimension
-		if (!dtf.CalcOffDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+		if (!dtf.CalcOffDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, Kodiag, true);
 
 	//-------------- CLEANUP
 
-	fftw_destroy_plan(plan_fwd_x);
-	fftw_destroy_plan(plan_fwd_y);
-	fftw_destroy_plan(plan_fwd_z);
+	for (int tn = 0; tn < OmpThreads; tn++) {
+
+		fftw_destroy_plan(plan_fwd_x[tn]);
+		fftw_destroy_plan(plan_fwd_y[tn]);
+		fftw_destroy_plan(plan_fwd_z[tn]);
+
+		fftw_free((double*)pline_real[tn]);
+		fftw_free((fftw_complex*)pline[tn]);
+	}
 
-	fftw_free((double*)pline_real);
-	fftw_free((fftw_complex*)pline);
+	DemagKernelCache::Save(kernel_key, kernel_arrays);
 
 	//Done
 	return error;
@@ -35,6 +35,10 @@ private:
 
 	//-------------------------- KERNEL CALCULATION
 
+	//x line ffts are packed in place : line L is read from L * N.x and packed to L * (N.x / 2 + 1), overwriting inputs of earlier lines.
+	//Starting at line_start (all earlier lines already done), return end of block of lines which can be transformed in parallel (up to num_lines).
+	int Get_Inplace_Pack_Block(int line_start, int num_lines);
+
 	//versions without pbc
 	BError Calculate_Demag_Kernels_2D(bool include_self_demag);
 	BError Calculate_Demag_Kernels_3D(bool include_self_demag);
@@ -43,7 +47,8 @@ protected:
 
 	//-------------------------- CONSTRUCTOR
 
-	DemagKernel(void) {}
+	//kernel multiplication works for any fft length (odd or even) so fast padding can be used
+	DemagKernel(void) { fast_padding_supported = true; }
 
 	virtual ~DemagKernel() {}
 
@@ -7,6 +7,7 @@
 
 #include "DemagTFunc.h"
 #include "DemagTFuncCUDA.h"
+#include "ConvolutionData.h"
 
 //-------------------------- MEMORY ALLOCATION
 
@@ -99,12 +100,12 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_2D(bool include_self_demag, bool
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens2D_PBC(
 			Ddiag, N, h / maximum(h.x, h.y, h.z), 
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 
 		if (!dtf.CalcOffDiagTens2D_PBC(
 			Dodiag, N, h / maximum(h.x, h.y, h.z), 
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
@@ -138,22 +139,22 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_2D(bool include_self_demag, bool
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_x_odiag = fftw_plan_many_dft_r2c(1, dims_x, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y_odiag = fftw_plan_many_dft_r2c(1, dims_y, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -277,7 +278,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_2D_onGPU(bool include_self_demag
 
 		if (!dtf_gpu.CalcDiagTens2D_PBC(
 			cuInx, cuIny, cuInz, N, h / maximum(h.x, h.y, h.z),
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -331,7 +332,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_2D_onGPU(bool include_self_demag
 
 		if (!dtf_gpu.CalcOffDiagTens2D_PBC(
 			cuInx, N, h / maximum(h.x, h.y, h.z), 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//Now FFT along x from input to output
@@ -412,17 +413,17 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_3D(bool include_self_demag, bool
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft_r2c(1, dims_z, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -561,7 +562,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_3D(bool include_self_demag, bool
 	else {
 
 		//pbcs used in at least one dimension
-		if (!dtf.CalcDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+		if (!dtf.CalcDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, false);
@@ -579,7 +580,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_3D(bool include_self_demag, bool
 	else {
 
 		//pbcs used in at least one dimension
-		if (!dtf.CalcOffDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+		if (!dtf.CalcOffDiagTens3D_PBC(D, N, h / maximum(h.x, h.y, h.z), true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, true);
@@ -632,7 +633,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_3D_onGPU(bool include_self_demag
 
 		if (!dtf_gpu.CalcDiagTens3D_PBC(
 			cuInx, cuIny, cuInz, N, h / maximum(h.x, h.y, h.z),
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 	
 	//-------------- SETUP FFT
@@ -736,7 +737,7 @@ BError DemagKernelCUDA::Calculate_Demag_Kernels_3D_onGPU(bool include_self_demag
 		//pbcs used in at least one dimension
 		if (!dtf_gpu.CalcOffDiagTens3D_PBC(
 			cuInx, cuIny, cuInz, N, h / maximum(h.x, h.y, h.z),
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
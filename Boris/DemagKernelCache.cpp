@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "DemagKernelCache.h"
+#include "DemagTFunc_Defs.h"
+
+bool DemagKernelCache::enabled = false;
+std::string DemagKernelCache::directory = "";
+
+//64-bit FNV-1a hash of key, as hexadecimal string
+std::string DemagKernelCache::Hash_Key(const std::string& key)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (unsigned char c : key) {
+
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+
+	std::ostringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+	return ss.str();
+}
+
+//file name (with directory) for given key
+std::string DemagKernelCache::Key_FileName(const std::string& key)
+{
+	return directory + "demagkernel_" + Hash_Key(key) + ".bkn";
+}
+
+//make key from all values demag kernels depend on. Floating point values are written exactly (hex format)
+std::string DemagKernelCache::Make_Key(std::string kernel_type, SZ3 n, DBL3 h, SZ3 N, INT3 pbc_images, DBL3 shift, DBL3 h_src, DBL3 h_dst, bool include_self_demag)
+{
+	std::ostringstream ss;
+	ss << std::hexfloat;
+
+	ss << kernel_type << ";v" << format_version;
+	ss << ";n" << n.x << "," << n.y << "," << n.z;
+	ss << ";h" << h.x << "," << h.y << "," << h.z;
+	ss << ";N" << N.x << "," << N.y << "," << N.z;
+	ss << ";pbc" << pbc_images.x << "," << pbc_images.y << "," << pbc_images.z;
+	ss << ";shift" << shift.x << "," << shift.y << "," << shift.z;
+	ss << ";hsrc" << h_src.x << "," << h_src.y << "," << h_src.z;
+	ss << ";hdst" << h_dst.x << "," << h_dst.y << "," << h_dst.z;
+	ss << ";self" << include_self_demag;
+	ss << ";asympt" << DemagTFuncSettings::asymptotic_distance;
+
+	return ss.str();
+}
+
+//load kernel arrays for given key into already allocated memory : each entry is a (pointer, size in bytes) pair, which must match the stored array sizes.
+//return true if found and loaded.
+bool DemagKernelCache::Load(const std::string& key, const std::vector<std::pair<void*, size_t>>& arrays)
+{
+	if (!enabled) return false;
+
+	std::ifstream bdin(Key_FileName(key), std::ios::in | std::ios::binary);
+	if (!bdin.is_open()) return false;
+
+	//header
+	unsigned long long header[4] = {};
+	if (!bdin.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+
+	//magic number, version, key length and number of arrays must all match
+	if (header[0] != magic_number || header[1] != format_version || header[2] != key.length() || header[3] != arrays.size()) return false;
+
+	std::vector<unsigned long long> sizes(arrays.size());
+	if (!bdin.read(reinterpret_cast<char*>(sizes.data()), sizes.size() * sizeof(unsigned long long))) return false;
+
+	for (int idx = 0; idx < arrays.size(); idx++) {
+
+		if (sizes[idx] != arrays[idx].second) return false;
+	}
+
+	//full key must match (file name is only a hash)
+	std::string stored_key(key.length(), ' ');
+	if (!bdin.read(&stored_key[0], stored_key.length()) || stored_key != key) return false;
+
+	//arrays
+	for (int idx = 0; idx < arrays.size(); idx++) {
+
+		size_t offset = ((size_t)bdin.tellg() + alignment - 1) / alignment * alignment;
+		bdin.seekg(offset);
+
+		if (!bdin.read(reinterpret_cast<char*>(arrays[idx].first), arrays[idx].second)) return false;
+	}
+
+	return true;
+}
+
+//store kernel arrays for given key : each entry is a (pointer, size in bytes) pair
+void DemagKernelCache::Save(const std::string& key, const std::vector<std::pair<void*, size_t>>& arrays)
+{
+	if (!enabled) return;
+
+	std::string fileName = Key_FileName(key);
+
+	//write to temporary file first then rename, so other program instances never load a partially written file
+	std::string temp_fileName = fileName + "." + ToString(GetSystemTickCount()) + ".tmp";
+
+	std::ofstream bdout(temp_fileName, std::ios::out | std::ios::binary);
+	if (!bdout.is_open()) return;
+
+	unsigned long long header[4] = { magic_number, format_version, key.length(), arrays.size() };
+	bdout.write(reinterpret_cast<char*>(header), sizeof(header));
+
+	for (int idx = 0; idx < arrays.size(); idx++) {
+
+		unsigned long long size = arrays[idx].second;
+		bdout.write(reinterpret_cast<char*>(&size), sizeof(unsigned long long));
+	}
+
+	bdout.write(key.c_str(), key.length());
+
+	for (int idx = 0; idx < arrays.size(); idx++) {
+
+		//zero padding up to aligned offset
+		size_t position = (size_t)bdout.tellp();
+		size_t offset = (position + alignment - 1) / alignment * alignment;
+		std::vector<char> padding(offset - position, 0);
+		bdout.write(padding.data(), padding.size());
+
+		bdout.write(reinterpret_cast<char*>(arrays[idx].first), arrays[idx].second);
+	}
+
+	bool success = bdout.good();
+	bdout.close();
+
+	if (!success || std::rename(temp_fileName.c_str(), fileName.c_str())) std::remove(temp_fileName.c_str());
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BorisLib.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Disk store for demag kernels, already transformed (Kdiag, Kodiag, etc.), so runs with identical discretisation don't need to recompute them.
+
+//Kernels are identified by a key containing all the values they depend on : kernel type, n, h, N, pbc_images, shift, source and destination cellsizes.
+//Each kernel is stored in its own file, named using a hash of the key (the full key is also stored in the file and checked on loading).
+//
+//File layout :
+//header : magic number, format version, key length, number of arrays, byte size of each array
+//key string
+//raw arrays, each starting at a 64-byte aligned file offset (thus the file can also be memory-mapped and arrays used directly)
+
+class DemagKernelCache {
+
+public:
+
+	//is the kernel store in use (off by default)
+	static bool enabled;
+
+	//directory where kernel files are kept (files named as demagkernel_<hash>.bkn)
+	static std::string directory;
+
+private:
+
+	//identifies kernel files
+	static const unsigned long long magic_number = 0x4e524b53524f42ULL;
+
+	//file offsets for arrays aligned to this many bytes
+	static const size_t alignment = 64;
+
+	//change this if the kernel calculation changes so old files are not used
+	static const unsigned format_version = 1;
+
+	//64-bit FNV-1a hash of key, as hexadecimal string
+	static std::string Hash_Key(const std::string& key);
+
+	//file name (with directory) for given key
+	static std::string Key_FileName(const std::string& key);
+
+public:
+
+	//make key from all values demag kernels depend on. Floating point values are written exactly (hex format)
+	static std::string Make_Key(std::string kernel_type, SZ3 n, DBL3 h, SZ3 N, INT3 pbc_images, DBL3 shift = DBL3(), DBL3 h_src = DBL3(), DBL3 h_dst = DBL3(), bool include_self_demag = true);
+
+	//load kernel arrays for given key into already allocated memory : each entry is a (pointer, size in bytes) pair, which must match the stored array sizes.
+	//return true if found and loaded.
+	static bool Load(const std::string& key, const std::vector<std::pair<void*, size_t>>& arrays);
+
+	//store kernel arrays for given key : each entry is a (pointer, size in bytes) pair
+	static void Save(const std::string& key, const std::vector<std::pair<void*, size_t>>& arrays);
+};
@@ -6,6 +6,7 @@
 #ifdef MODULE_COMPILATION_SDEMAG
 
 #include "DemagTFunc.h"
+#include "ConvolutionData.h"
 
 //-------------------------- KERNEL CALCULATION
 
@@ -223,12 +224,12 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Self(int index, boo
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens2D_PBC(
 			Ddiag, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 
 		if (!dtf.CalcOffDiagTens2D_PBC(
 			Dodiag, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
@@ -262,22 +263,22 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Self(int index, boo
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_x_odiag = fftw_plan_many_dft_r2c(1, dims_x, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y_odiag = fftw_plan_many_dft_r2c(1, dims_y, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -426,12 +427,12 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_zShifted(int index,
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -529,7 +530,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_zShifted(int index,
 
 		if (!dtf.CalcDiagTens2D_Shifted_Irregular_PBC(
 			D, N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, false);
@@ -547,7 +548,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_zShifted(int index,
 
 		if (!dtf.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			D, N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, true);
@@ -624,12 +625,12 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Complex_Full(int in
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -700,7 +701,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Complex_Full(int in
 
 		if (!dtf.CalcDiagTens2D_Shifted_Irregular_PBC(
 			D, N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu);
@@ -718,7 +719,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Complex_Full(int in
 
 		if (!dtf.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			D, N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu);
@@ -796,17 +797,17 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Self(int index, boo
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft_r2c(1, dims_z, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -948,7 +949,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Self(int index, boo
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens3D_PBC(
 			D, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, false);
@@ -968,7 +969,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Self(int index, boo
 		//pbcs used in at least one dimension
 		if (!dtf.CalcOffDiagTens3D_PBC(
 			D, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, true);
@@ -1049,17 +1050,17 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_zShifted(int index,
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft(1, dims_z, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -1162,7 +1163,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_zShifted(int index,
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, Scratch);
@@ -1182,7 +1183,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_zShifted(int index,
 		//pbcs used in at least one dimension
 		if (!dtf.CalcOffDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, Scratch);
@@ -1263,17 +1264,17 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Complex_Full(int in
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft(1, dims_z, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -1375,7 +1376,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Complex_Full(int in
 
 		if (!dtf.CalcDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, Scratch);
@@ -1393,7 +1394,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Complex_Full(int in
 
 		if (!dtf.CalcOffDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, K_cpu, Scratch);
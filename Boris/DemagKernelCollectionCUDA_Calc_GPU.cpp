@@ -44,7 +44,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Self_onGPU(int inde
 
 		if (!dtf_gpu.CalcDiagTens2D_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -98,7 +98,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Self_onGPU(int inde
 
 		if (!dtf_gpu.CalcOffDiagTens2D_PBC(
 			cuInx, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//Now FFT along x from input to output
@@ -158,7 +158,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_zShifted_onGPU(int
 		if (!dtf_gpu.CalcDiagTens2D_Shifted_Irregular_PBC(
 			cuInx, cuIny, cuInz, 
 			N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -232,7 +232,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_zShifted_onGPU(int
 		if (!dtf_gpu.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			cuInx, cuIny, cuInz, 
 			N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
@@ -285,7 +285,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Complex_Full_onGPU(
 		if (!dtf_gpu.CalcDiagTens2D_Shifted_Irregular_PBC(
 			cuInx, cuIny, cuInz,
 			N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -343,7 +343,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_2D_Complex_Full_onGPU(
 		if (!dtf_gpu.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			cuInx, cuIny, cuInz,
 			N, (*kernels[index])()->Get_h_src() / h_max, (*kernels[index])()->Get_h_dst() / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
@@ -393,7 +393,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Self_onGPU(int inde
 
 		if (!dtf_gpu.CalcDiagTens3D_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -497,7 +497,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Self_onGPU(int inde
 		//pbcs used in at least one dimension
 		if (!dtf_gpu.CalcOffDiagTens3D_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
@@ -547,7 +547,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_zShifted_onGPU(int
 
 		if (!dtf_gpu.CalcDiagTens3D_Shifted_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -618,7 +618,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_zShifted_onGPU(int
 		//pbcs used in at least one dimension
 		if (!dtf_gpu.CalcOffDiagTens3D_Shifted_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
@@ -668,7 +668,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Complex_Full_onGPU(
 
 		if (!dtf_gpu.CalcDiagTens3D_Shifted_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//-------------- SETUP FFT
@@ -739,7 +739,7 @@ BError DemagKernelCollectionCUDA::Calculate_Demag_Kernels_3D_Complex_Full_onGPU(
 		//pbcs used in at least one dimension
 		if (!dtf_gpu.CalcOffDiagTens3D_Shifted_PBC(
 			cuInx, cuIny, cuInz, N, h / h_max, (*kernels[index])()->Get_shift() / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFGPUMEMORY_NCRIT);
 	}
 
 	//off-diagonal components
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "DemagKernelCollection.h"
+#include "DemagKernelCache.h"
 
 #ifdef MODULE_COMPILATION_SDEMAG
 
@@ -10,6 +11,25 @@ BError DemagKernelCollection::Calculate_Demag_Kernels(std::vector<DemagKernelCol
 {
 	BError error(__FUNCTION__);
 
+	//compute kernel at given index using given calculation method, unless already available in the kernel store from a previous computation with same discretisation
+	auto calculate_kernel = [&](int index, BError(DemagKernelCollection::*Calculate_Kernel)(int), std::string kernel_type) -> BError {
+
+		std::shared_ptr<KerType> kernel = kernels[index];
+
+		std::string kernel_key = DemagKernelCache::Make_Key("DemagKernelCollection_" + kernel_type, n, h, N, pbc_images, kernel->shift, kernel->h_src, kernel->h_dst);
+		std::vector<std::pair<void*, size_t>> kernel_arrays = {
+			{ kernel->K2D_odiag.data(), kernel->K2D_odiag.size() * sizeof(double) },
+			{ kernel->Kdiag_cmpl.data(), kernel->Kdiag_cmpl.linear_size() * sizeof(ReIm3) }, { kernel->Kodiag_cmpl.data(), kernel->Kodiag_cmpl.linear_size() * sizeof(ReIm3) },
+			{ kernel->Kdiag_real.data(), kernel->Kdiag_real.linear_size() * sizeof(DBL3) }, { kernel->Kodiag_real.data(), kernel->Kodiag_real.linear_size() * sizeof(DBL3) } };
+
+		if (DemagKernelCache::Load(kernel_key, kernel_arrays)) return BError(__FUNCTION__);
+
+		BError error = (this->*Calculate_Kernel)(index);
+		if (!error) DemagKernelCache::Save(kernel_key, kernel_arrays);
+
+		return error;
+	};
+
 	for (int index = 0; index < Rect_collection.size(); index++) {
 
 		if (!error) {
@@ -63,8 +83,8 @@ BError DemagKernelCollection::Calculate_Demag_Kernels(std::vector<DemagKernelCol
 					kernels[index]->h_src = h;
 
 					//use self versions
-					if (n.z == 1) error = Calculate_Demag_Kernels_2D_Self(index);
-					else error = Calculate_Demag_Kernels_3D_Self(index);
+					if (n.z == 1) error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_2D_Self, "2D_Self");
+					else error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_3D_Self, "3D_Self");
 				}
 				else {
 					
@@ -78,12 +98,12 @@ BError DemagKernelCollection::Calculate_Demag_Kernels(std::vector<DemagKernelCol
 						if (IsZ(kernels[index]->shift.x) && IsZ(kernels[index]->shift.y)) {
 
 							//z-shifted kernels for 2D
-							error = Calculate_Demag_Kernels_2D_zShifted(index);
+							error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_2D_zShifted, "2D_zShifted");
 						}
 						else {
 
 							//general 2D kernels (not z-shifted)
-							error = Calculate_Demag_Kernels_2D_Complex_Full(index);
+							error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_2D_Complex_Full, "2D_Complex_Full");
 						}
 					}
 					else {
@@ -91,12 +111,12 @@ BError DemagKernelCollection::Calculate_Demag_Kernels(std::vector<DemagKernelCol
 						if (IsZ(kernels[index]->shift.x) && IsZ(kernels[index]->shift.y)) {
 
 							//z-shifted kernels for 3D
-							error = Calculate_Demag_Kernels_3D_zShifted(index);
+							error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_3D_zShifted, "3D_zShifted");
 						}
 						else {
 						
 							//general 3D kernels (not z-shifted)
-							error = Calculate_Demag_Kernels_3D_Complex_Full(index);
+							error = calculate_kernel(index, &DemagKernelCollection::Calculate_Demag_Kernels_3D_Complex_Full, "3D_Complex_Full");
 						}
 					}
 				}
@@ -175,12 +195,12 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_Self(int index)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens2D_PBC(
 			Ddiag, N, h / h_max, 
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 
 		if (!dtf.CalcOffDiagTens2D_PBC(
 			Dodiag, N, h / h_max, 
-			true, ASYMPTOTIC_DISTANCE, 
+			true, DemagTFuncSettings::asymptotic_distance, 
 			pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 	
@@ -198,22 +218,22 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_Self(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_x_odiag = fftw_plan_many_dft_r2c(1, dims_x, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y_odiag = fftw_plan_many_dft_r2c(1, dims_y, 1,
 		pline_real_odiag, nullptr, 1, 1,
 		pline_odiag, nullptr, 1, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -321,12 +341,12 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_zShifted(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -410,7 +430,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_zShifted(int index)
 
 		if (!dtf.CalcDiagTens2D_Shifted_Irregular_PBC(
 			D, N, kernels[index]->h_src / h_max, kernels[index]->h_dst / h_max, kernels[index]->shift / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kdiag_real, false);
@@ -425,7 +445,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_zShifted(int index)
 
 		if (!dtf.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			D, N, kernels[index]->h_src / h_max, kernels[index]->h_dst / h_max, kernels[index]->shift / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kodiag_real, true);
@@ -476,12 +496,12 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_Complex_Full(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -546,7 +566,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_Complex_Full(int index)
 
 		if (!dtf.CalcDiagTens2D_Shifted_Irregular_PBC(
 			D, N, kernels[index]->h_src / h_max, kernels[index]->h_dst / h_max, kernels[index]->shift / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kdiag_cmpl);
@@ -561,7 +581,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_2D_Complex_Full(int index)
 
 		if (!dtf.CalcOffDiagTens2D_Shifted_Irregular_PBC(
 			D, N, kernels[index]->h_src / h_max, kernels[index]->h_dst / h_max, kernels[index]->shift / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kodiag_cmpl);
@@ -613,17 +633,17 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Self(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft_r2c(1, dims_y, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft_r2c(1, dims_z, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -749,7 +769,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Self(int index)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens3D_PBC(
 			D, N, h / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kdiag_real, false);
@@ -766,7 +786,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Self(int index)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcOffDiagTens3D_PBC(
 			D, N, h / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kodiag_real, true);
@@ -819,17 +839,17 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_zShifted(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft(1, dims_z, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -925,7 +945,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_zShifted(int index)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, kernels[index]->shift / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kdiag_cmpl);
@@ -942,7 +962,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_zShifted(int index)
 		//pbcs used in at least one dimension
 		if (!dtf.CalcOffDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, kernels[index]->shift / h_max, 
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kodiag_cmpl);
@@ -995,17 +1015,17 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Complex_Full(int index)
 	fftw_plan plan_fwd_x = fftw_plan_many_dft_r2c(1, dims_x, 3,
 		pline_real, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_PATIENT);
+		ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_y = fftw_plan_many_dft(1, dims_y, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	fftw_plan plan_fwd_z = fftw_plan_many_dft(1, dims_z, 3,
 		pline, nullptr, 3, 1,
 		pline, nullptr, 3, 1,
-		FFTW_FORWARD, FFTW_PATIENT);
+		FFTW_FORWARD, ConvolutionData::Get_FFTW_Planner_Flags());
 
 	//-------------- FFT REAL TENSOR INTO REAL KERNELS
 
@@ -1099,7 +1119,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Complex_Full(int index)
 
 		if (!dtf.CalcDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, kernels[index]->shift / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kdiag_cmpl);
@@ -1114,7 +1134,7 @@ BError DemagKernelCollection::Calculate_Demag_Kernels_3D_Complex_Full(int index)
 
 		if (!dtf.CalcOffDiagTens3D_Shifted_PBC(
 			D, N, h / h_max, kernels[index]->shift / h_max,
-			true, ASYMPTOTIC_DISTANCE, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
+			true, DemagTFuncSettings::asymptotic_distance, pbc_images.x, pbc_images.y, pbc_images.z)) return error(BERROR_OUTOFMEMORY_NCRIT);
 	}
 
 	tensor_to_kernel(D, kernels[index]->Kodiag_cmpl);
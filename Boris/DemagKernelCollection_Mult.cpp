@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "DemagKernelCollection.h"
+#include "KernelMultSIMD.h"
 
 #ifdef MODULE_COMPILATION_SDEMAG
 
@@ -16,63 +17,23 @@ void DemagKernelCollection::KernelMultiplication_2D_Self(VEC<ReIm3>& In, VEC<ReI
 	VEC<DBL3>& Kdiag = kernels[self_contribution_index]->Kdiag_real;
 	std::vector<double>& K2D_odiag = kernels[self_contribution_index]->K2D_odiag;
 
-	//zero-th line
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-		ReIm3 FM = In[i];
-		ReIm3 Outvalue = Out[i];
-
-		Out[i].x = (Kdiag[i].x  * FM.x) + (K2D_odiag[i] * FM.y);
-		Out[i].y = (K2D_odiag[i] * FM.x) + (Kdiag[i].y  * FM.y);
-		Out[i].z = (Kdiag[i].z  * FM.z);
-
-		if (!set_output) { Out[i].x += Outvalue.x; Out[i].y += Outvalue.y; Out[i].z += Outvalue.z; }
-	}
-
+	//each row along x is multiplied in one go : Kdiag even about N.y/2, K2D_odiag odd about N.y/2
 #pragma omp parallel for
-	for (int j = 1; j < N.y / 2; j++) {
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int idx_l = i + j * (N.x / 2 + 1);
-			int idx_h = i + (N.y - j) * (N.x / 2 + 1);
+	for (int j = 0; j <= N.y / 2; j++) {
 
-			ReIm3 FM_l = In[idx_l];
-			ReIm3 FM_h = In[idx_h];
-			ReIm3 Outvalue_l = Out[idx_l];
-			ReIm3 Outvalue_h = Out[idx_h];
+		int idx_l = j * (N.x / 2 + 1);
 
-			Out[idx_l].x = (Kdiag[idx_l].x  * FM_l.x) + (K2D_odiag[idx_l] * FM_l.y);
-			Out[idx_l].y = (K2D_odiag[idx_l] * FM_l.x) + (Kdiag[idx_l].y  * FM_l.y);
-			Out[idx_l].z = (Kdiag[idx_l].z  * FM_l.z);
+		//zero-th line, lines in between, half-way line
+		KernelMultSIMD::Multiply_2D(In.data() + idx_l, Out.data() + idx_l, N.x / 2 + 1, 1, Kdiag.data() + idx_l, K2D_odiag.data() + idx_l, 1, 1.0, !set_output);
 
-			Out[idx_h].x = (Kdiag[idx_l].x  * FM_h.x) + (-K2D_odiag[idx_l] * FM_h.y);
-			Out[idx_h].y = (-K2D_odiag[idx_l] * FM_h.x) + (Kdiag[idx_l].y  * FM_h.y);
-			Out[idx_h].z = (Kdiag[idx_l].z  * FM_h.z);
+		//upper lines using kernel symmetries
+		if (j > 0 && j < N.y / 2) {
 
-			if (!set_output) { 
+			int idx_h = (N.y - j) * (N.x / 2 + 1);
 
-				Out[idx_l].x += Outvalue_l.x; Out[idx_l].y += Outvalue_l.y; Out[idx_l].z += Outvalue_l.z; 
-				Out[idx_h].x += Outvalue_h.x; Out[idx_h].y += Outvalue_h.y; Out[idx_h].z += Outvalue_h.z;
-			}
+			KernelMultSIMD::Multiply_2D(In.data() + idx_h, Out.data() + idx_h, N.x / 2 + 1, 1, Kdiag.data() + idx_l, K2D_odiag.data() + idx_l, 1, -1.0, !set_output);
 		}
 	}
-
-	//half-way line
-#pragma omp parallel for
-	for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-		int idx = i + (N.y / 2) * (N.x / 2 + 1);
-
-		ReIm3 FM = In[idx];
-		ReIm3 Outvalue = Out[idx];
-
-		Out[idx].x = (Kdiag[idx].x  * FM.x) + (K2D_odiag[idx] * FM.y);
-		Out[idx].y = (K2D_odiag[idx] * FM.x) + (Kdiag[idx].y  * FM.y);
-		Out[idx].z = (Kdiag[idx].z  * FM.z);
-
-		if (!set_output) { Out[idx].x += Outvalue.x; Out[idx].y += Outvalue.y; Out[idx].z += Outvalue.z; }
-	}
 }
 
 void DemagKernelCollection::KernelMultiplication_3D_Self(VEC<ReIm3>& In, VEC<ReIm3>& Out, bool set_output)
@@ -82,141 +43,30 @@ void DemagKernelCollection::KernelMultiplication_3D_Self(VEC<ReIm3>& In, VEC<ReI
 
 	//Full multiplication with use of kernel symmetries -> re-arranged for better cache use compared to the line versions
 
-	for (int k = 0; k <= N.z / 2; k++) {
-
-		//zero-th line
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int idx = i + k * (N.x / 2 + 1) * N.y;
+	for (int k = 0; k < N.z; k++) {
 
-			ReIm3 FM = In[idx];
-			ReIm3 Outvalue = Out[idx];
-
-			int ker_index = i + k * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-			Out[idx].x = (Kdiag[ker_index].x * FM.x) + (Kodiag[ker_index].x * FM.y) + (Kodiag[ker_index].y * FM.z);
-			Out[idx].y = (Kodiag[ker_index].x * FM.x) + (Kdiag[ker_index].y * FM.y) + (Kodiag[ker_index].z * FM.z);
-			Out[idx].z = (Kodiag[ker_index].y * FM.x) + (Kodiag[ker_index].z * FM.y) + (Kdiag[ker_index].z * FM.z);
-
-			if (!set_output) { Out[idx].x += Outvalue.x; Out[idx].y += Outvalue.y; Out[idx].z += Outvalue.z; }
-		}
+		//above N.z/2 use kernel symmetries : Kxz and Kyz are odd about N.z/2
+		int ker_k = (k <= N.z / 2 ? k : N.z - k);
+		double sign_z = (k <= N.z / 2 ? 1.0 : -1.0);
 
+		//each row along x is multiplied in one go : Kxy and Kyz are odd about N.y/2
 #pragma omp parallel for
-		for (int j = 1; j < N.y / 2; j++) {
-			for (int i = 0; i < (N.x / 2 + 1); i++) {
+		for (int j = 0; j <= N.y / 2; j++) {
 
-				int idx_l = i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
-				int idx_h = i + (N.y - j) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
+			int idx_l = j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
+			int ker_index = j * (N.x / 2 + 1) + ker_k * (N.x / 2 + 1) * (N.y / 2 + 1);
 
-				ReIm3 FM_l = In[idx_l];
-				ReIm3 FM_h = In[idx_h];
-				ReIm3 Outvalue_l = Out[idx_l];
-				ReIm3 Outvalue_h = Out[idx_h];
-
-				int ker_index = i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * (N.y / 2 + 1);
+			//zero-th line, lines in between, half-way line
+			KernelMultSIMD::Multiply_3D(In.data() + idx_l, Out.data() + idx_l, N.x / 2 + 1, 1, Kdiag.data() + ker_index, Kodiag.data() + ker_index, 1, DBL3(1, sign_z, sign_z), !set_output);
 
-				Out[idx_l].x = (Kdiag[ker_index].x * FM_l.x) + (Kodiag[ker_index].x * FM_l.y) + (Kodiag[ker_index].y * FM_l.z);
-				Out[idx_l].y = (Kodiag[ker_index].x * FM_l.x) + (Kdiag[ker_index].y * FM_l.y) + (Kodiag[ker_index].z * FM_l.z);
-				Out[idx_l].z = (Kodiag[ker_index].y * FM_l.x) + (Kodiag[ker_index].z * FM_l.y) + (Kdiag[ker_index].z * FM_l.z);
+			//upper lines using kernel symmetries
+			if (j > 0 && j < N.y / 2) {
 
-				Out[idx_h].x = (Kdiag[ker_index].x * FM_h.x) + (-Kodiag[ker_index].x * FM_h.y) + (Kodiag[ker_index].y * FM_h.z);
-				Out[idx_h].y = (-Kodiag[ker_index].x * FM_h.x) + (Kdiag[ker_index].y * FM_h.y) + (-Kodiag[ker_index].z * FM_h.z);
-				Out[idx_h].z = (Kodiag[ker_index].y * FM_h.x) + (-Kodiag[ker_index].z * FM_h.y) + (Kdiag[ker_index].z * FM_h.z);
+				int idx_h = (N.y - j) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
 
-				if (!set_output) {
-
-					Out[idx_l].x += Outvalue_l.x; Out[idx_l].y += Outvalue_l.y; Out[idx_l].z += Outvalue_l.z;
-					Out[idx_h].x += Outvalue_h.x; Out[idx_h].y += Outvalue_h.y; Out[idx_h].z += Outvalue_h.z;
-				}
+				KernelMultSIMD::Multiply_3D(In.data() + idx_h, Out.data() + idx_h, N.x / 2 + 1, 1, Kdiag.data() + ker_index, Kodiag.data() + ker_index, 1, DBL3(-1, sign_z, -sign_z), !set_output);
 			}
 		}
-
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int idx = i + (N.y / 2) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
-
-			ReIm3 FM = In[idx];
-			ReIm3 Outvalue = Out[idx];
-
-			int ker_index = i + (N.y / 2) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-			Out[idx].x = (Kdiag[ker_index].x * FM.x) + (Kodiag[ker_index].x * FM.y) + (Kodiag[ker_index].y * FM.z);
-			Out[idx].y = (Kodiag[ker_index].x * FM.x) + (Kdiag[ker_index].y * FM.y) + (Kodiag[ker_index].z * FM.z);
-			Out[idx].z = (Kodiag[ker_index].y * FM.x) + (Kodiag[ker_index].z * FM.y) + (Kdiag[ker_index].z * FM.z);
-
-			if (!set_output) { Out[idx].x += Outvalue.x; Out[idx].y += Outvalue.y; Out[idx].z += Outvalue.z; }
-		}
-	}
-
-
-	for (int k = N.z / 2 + 1; k < N.z; k++) {
-
-		//zero-th line
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int idx = i + k * (N.x / 2 + 1) * N.y;
-
-			ReIm3 FM = In[idx];
-			ReIm3 Outvalue = Out[idx];
-
-			int ker_index = i + (N.z - k) * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-			Out[idx].x = (Kdiag[ker_index].x * FM.x) + (Kodiag[ker_index].x * FM.y) + (-Kodiag[ker_index].y * FM.z);
-			Out[idx].y = (Kodiag[ker_index].x * FM.x) + (Kdiag[ker_index].y * FM.y) + (-Kodiag[ker_index].z * FM.z);
-			Out[idx].z = (-Kodiag[ker_index].y * FM.x) + (-Kodiag[ker_index].z * FM.y) + (Kdiag[ker_index].z * FM.z);
-
-			if (!set_output) { Out[idx].x += Outvalue.x; Out[idx].y += Outvalue.y; Out[idx].z += Outvalue.z; }
-		}
-
-#pragma omp parallel for
-		for (int j = 1; j < N.y / 2; j++) {
-			for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-				int idx_l = i + j * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
-				int idx_h = i + (N.y - j) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
-
-				ReIm3 FM_l = In[idx_l];
-				ReIm3 FM_h = In[idx_h];
-				ReIm3 Outvalue_l = Out[idx_l];
-				ReIm3 Outvalue_h = Out[idx_h];
-
-				int ker_index = i + j * (N.x / 2 + 1) + (N.z - k) * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-				Out[idx_l].x = (Kdiag[ker_index].x * FM_l.x) + (Kodiag[ker_index].x * FM_l.y) + (-Kodiag[ker_index].y * FM_l.z);
-				Out[idx_l].y = (Kodiag[ker_index].x * FM_l.x) + (Kdiag[ker_index].y * FM_l.y) + (-Kodiag[ker_index].z * FM_l.z);
-				Out[idx_l].z = (-Kodiag[ker_index].y * FM_l.x) + (-Kodiag[ker_index].z * FM_l.y) + (Kdiag[ker_index].z * FM_l.z);
-
-				Out[idx_h].x = (Kdiag[ker_index].x * FM_h.x) + (-Kodiag[ker_index].x * FM_h.y) + (-Kodiag[ker_index].y * FM_h.z);
-				Out[idx_h].y = (-Kodiag[ker_index].x * FM_h.x) + (Kdiag[ker_index].y * FM_h.y) + (Kodiag[ker_index].z * FM_h.z);
-				Out[idx_h].z = (-Kodiag[ker_index].y * FM_h.x) + (Kodiag[ker_index].z * FM_h.y) + (Kdiag[ker_index].z * FM_h.z);
-
-				if (!set_output) {
-
-					Out[idx_l].x += Outvalue_l.x; Out[idx_l].y += Outvalue_l.y; Out[idx_l].z += Outvalue_l.z;
-					Out[idx_h].x += Outvalue_h.x; Out[idx_h].y += Outvalue_h.y; Out[idx_h].z += Outvalue_h.z;
-				}
-			}
-		}
-
-#pragma omp parallel for
-		for (int i = 0; i < (N.x / 2 + 1); i++) {
-
-			int idx = i + (N.y / 2) * (N.x / 2 + 1) + k * (N.x / 2 + 1) * N.y;
-
-			ReIm3 FM = In[idx];
-			ReIm3 Outvalue = Out[idx];
-
-			int ker_index = i + (N.y / 2) * (N.x / 2 + 1) + (N.z - k) * (N.x / 2 + 1) * (N.y / 2 + 1);
-
-			Out[idx].x = (Kdiag[ker_index].x * FM.x) + (Kodiag[ker_index].x * FM.y) + (-Kodiag[ker_index].y * FM.z);
-			Out[idx].y = (Kodiag[ker_index].x * FM.x) + (Kdiag[ker_index].y * FM.y) + (-Kodiag[ker_index].z * FM.z);
-			Out[idx].z = (-Kodiag[ker_index].y * FM.x) + (-Kodiag[ker_index].z * FM.y) + (Kdiag[ker_index].z * FM.z);
-
-			if (!set_output) { Out[idx].x += Outvalue.x; Out[idx].y += Outvalue.y; Out[idx].z += Outvalue.z; }
-		}
 	}
 }
 
@@ -1,6 +1,8 @@
 #include "stdafx.h"
 #include "DemagTFunc.h"
 
+int DemagTFuncSettings::asymptotic_distance = ASYMPTOTIC_DISTANCE;
+
 DemagTFunc::DemagTFunc(void)
 {
 	int OmpThreads = omp_get_num_procs();
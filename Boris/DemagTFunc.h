@@ -131,18 +131,18 @@ public:
 	//Need mesh dimensions n, convolution mesh dimensions N (this must be a power of 2 and N/2 smallest integer >= n for all dimensions -> from n to N/2 pad with zeroes).
 	//Need cellsize hRatios -> these can be normalized (e.g. to have largest value 1)
 	//You can opt to set self-demag coefficients to zero (include_self_demag = false);
-	bool CalcDiagTens3D(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcDiagTens3D(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 	
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
-	bool CalcOffDiagTens3D(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcOffDiagTens3D(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//2D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
-	bool CalcDiagTens2D(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcDiagTens2D(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy only) which has sizes given by N. 
-	bool CalcOffDiagTens2D(std::vector<double> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcOffDiagTens2D(std::vector<double> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//---------------------ZERO SHIFT VERSION (FOR INTERNAL FIELD) WITH PBC
 
@@ -155,24 +155,24 @@ public:
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
 	bool CalcDiagTens3D_PBC(VEC<DBL3> &Ddiag, INT3 N, DBL3 hRatios, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D_PBC(VEC<DBL3> &Dodiag, INT3 N, DBL3 hRatios, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//2D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
 	bool CalcDiagTens2D_PBC(VEC<DBL3> &Ddiag, INT3 N, DBL3 hRatios, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens2D_PBC(std::vector<double> &Dodiag, INT3 N, DBL3 hRatios, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//---------------------SHIFTED VERSIONS
@@ -180,18 +180,18 @@ public:
 	//3D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. 
-	bool CalcDiagTens3D_Shifted(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcDiagTens3D_Shifted(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
-	bool CalcOffDiagTens3D_Shifted(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcOffDiagTens3D_Shifted(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//2D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
-	bool CalcDiagTens2D_Shifted(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcDiagTens2D_Shifted(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
-	bool CalcOffDiagTens2D_Shifted(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcOffDiagTens2D_Shifted(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 hRatios, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//---------------------SHIFTED VERSIONS with PBC
 
@@ -202,24 +202,24 @@ public:
 	
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. 
 	bool CalcDiagTens3D_Shifted_PBC(VEC<DBL3> &Ddiag, INT3 N, DBL3 hRatios, DBL3 shift, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D_Shifted_PBC(VEC<DBL3> &Dodiag, INT3 N, DBL3 hRatios, DBL3 shift, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE, 
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, 
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//2D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
 	bool CalcDiagTens2D_Shifted_PBC(VEC<DBL3> &Ddiag, INT3 N, DBL3 hRatios, DBL3 shift, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens2D_Shifted_PBC(VEC<DBL3> &Dodiag, INT3 N, DBL3 hRatios, DBL3 shift, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 		
 	//---------------------SHIFTED AND IRREGULAR VERSIONS
@@ -227,10 +227,10 @@ public:
 	//2D
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
-	bool CalcDiagTens2D_Shifted_Irregular(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 s, DBL3 d, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcDiagTens2D_Shifted_Irregular(VEC<DBL3> &Ddiag, INT3 n, INT3 N, DBL3 s, DBL3 d, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
-	bool CalcOffDiagTens2D_Shifted_Irregular(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 s, DBL3 d, DBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+	bool CalcOffDiagTens2D_Shifted_Irregular(VEC<DBL3> &Dodiag, INT3 n, INT3 N, DBL3 s, DBL3 d, DBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//---------------------SHIFTED AND IRREGULAR VERSIONS with PBC
 
@@ -239,12 +239,12 @@ public:
 
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
 	bool CalcDiagTens2D_Shifted_Irregular_PBC(VEC<DBL3> &Ddiag, INT3 N, DBL3 s, DBL3 d, DBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
 	bool CalcOffDiagTens2D_Shifted_Irregular_PBC(VEC<DBL3> &Dodiag, INT3 N, DBL3 s, DBL3 d, DBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//---------------------SINGLE VALUE COMPUTE (TESTING ONLY)
@@ -255,11 +255,18 @@ public:
 	//all off-diagonal components - single value computation version
 	DBL3 Lodia_single(DBL3 dist, DBL3 h, bool minus = true);
 
+	//---------------------ASYMPTOTIC EXPANSIONS ACCURACY
+
+	//estimate relative error of asymptotic expansions used from given distance (in cells) for given cellsize ratios.
+	//Maximum difference between asymptotic and exact tensor elements at points sampled on the first octant of a sphere of radius asymptotic_distance (tensor symmetries cover the rest), relative to the largest exact element at each point.
+	//The exact equations lose accuracy with distance due to cancellation errors, whilst the asymptotic expansions gain accuracy, so the difference at the switching distance estimates the largest relative error of the tensor elements overall.
+	double Asymptotic_Error_Estimate(DBL3 hRatios, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
+
 	//---------------------SINGLE VALUE COMPUTE (SELF DEMAG METHODS)
 
 	//Self demag coefficients only (Dxx, Dyy, Dzz) for the given cellsize - you can calculate these separately e.g. if you set include_self_demag = false in the above methods (useful for super-mesh demag).
 	DBL3 SelfDemag(DBL3 h, bool minus = true);
 
 	//As above but also add PBC contribution to self demag
-	DBL3 SelfDemag_PBC(DBL3 h, DBL3 n, INT3 demag_pbc_images, int asymptotic_distance = ASYMPTOTIC_DISTANCE, bool minus = true);
+	DBL3 SelfDemag_PBC(DBL3 h, DBL3 n, INT3 demag_pbc_images, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance, bool minus = true);
 };
\ No newline at end of file
@@ -172,24 +172,24 @@ public:
 	//You can opt to set self-demag coefficients to zero (include_self_demag = false);
 	bool CalcDiagTens3D(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33, 
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23, 
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//2D
 
 	//Compute diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
 	bool CalcDiagTens2D(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33, 
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool include_self_demag = true, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute the off-diagonal tensor elements (Dxy only) which has sizes given by N. 
 	bool CalcOffDiagTens2D(
 		cu_arr<double>& D12,
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	
 	//---------------------ZERO SHIFT VERSION (FOR INTERNAL FIELD) WITH PBC
@@ -205,14 +205,14 @@ public:
 	bool CalcDiagTens3D_PBC(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
 		cuINT3 N, cuDBL3 hRatios,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D_PBC(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
 		cuINT3 N, cuDBL3 hRatios,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//2D
@@ -221,14 +221,14 @@ public:
 	bool CalcDiagTens2D_PBC(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33, 
 		cuINT3 N, cuDBL3 hRatios, 
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens2D_PBC(
 		cu_arr<double>& D12,
 		cuINT3 N, cuDBL3 hRatios,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//---------------------SHIFTED VERSIONS
@@ -238,24 +238,24 @@ public:
 	//Compute in Ddiag the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. 
 	bool CalcDiagTens3D_Shifted(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D_Shifted(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 	
 	//2D
 
 	//Compute the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N.
 	bool CalcDiagTens2D_Shifted(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens2D_Shifted(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
-		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 hRatios, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 	
 	//---------------------SHIFTED VERSIONS with PBC
 
@@ -268,14 +268,14 @@ public:
 	bool CalcDiagTens3D_Shifted_PBC(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
 		cuINT3 N, cuDBL3 hRatios, cuDBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute in Dodiag the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens3D_Shifted_PBC(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
 		cuINT3 N, cuDBL3 hRatios, cuDBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//2D
@@ -284,14 +284,14 @@ public:
 	bool CalcDiagTens2D_Shifted_PBC(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
 		INT3 N, DBL3 hRatios, DBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. 
 	bool CalcOffDiagTens2D_Shifted_PBC(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
 		INT3 N, DBL3 hRatios, DBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 		
 	//---------------------SHIFTED AND IRREGULAR VERSIONS
@@ -301,12 +301,12 @@ public:
 	//Compute the diagonal tensor elements (Dxx, Dyy, Dzz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
 	bool CalcDiagTens2D_Shifted_Irregular(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33, 
-		cuINT3 n, cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
 	bool CalcOffDiagTens2D_Shifted_Irregular(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
-		cuINT3 n, cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift, bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE);
+		cuINT3 n, cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift, bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance);
 	
 	//---------------------SHIFTED AND IRREGULAR VERSIONS with PBC
 
@@ -317,14 +317,14 @@ public:
 	bool CalcDiagTens2D_Shifted_Irregular_PBC(
 		cu_arr<double>& D11, cu_arr<double>& D22, cu_arr<double>& D33,
 		cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 
 	//Compute the off-diagonal tensor elements (Dxy, Dxz, Dyz) which has sizes given by N. This applies for irregular cells, specifically for 2D with s.z and d.z allowed to differ; s.x, d.x resp s.y, d.y must be the same.
 	bool CalcOffDiagTens2D_Shifted_Irregular_PBC(
 		cu_arr<double>& D12, cu_arr<double>& D13, cu_arr<double>& D23,
 		cuINT3 N, cuDBL3 s, cuDBL3 d, cuDBL3 shift,
-		bool minus = true, int asymptotic_distance = ASYMPTOTIC_DISTANCE,
+		bool minus = true, int asymptotic_distance = DemagTFuncSettings::asymptotic_distance,
 		int x_images = PBC_X_IMAGES, int y_images = PBC_Y_IMAGES, int z_images = PBC_Z_IMAGES);
 };
 
@@ -5,5 +5,15 @@
 #define PBC_Y_IMAGES	10
 #define PBC_Z_IMAGES	10
 
-//-1 to disable
+//default distance (in cells) from which asymptotic expansions are used for demag tensor elements instead of the exact Newell equations : -1 to disable
 #define ASYMPTOTIC_DISTANCE 40
+
+//program-wide demag tensor settings, used for all demag kernels (CPU and GPU)
+class DemagTFuncSettings {
+
+public:
+
+	//distance (in cells) from which asymptotic expansions are used for demag tensor elements : ASYMPTOTIC_DISTANCE by default, -1 to disable.
+	//Shorter distances speed up tensor computation for large meshes, but the best distance for accuracy depends on the cellsize ratios (see DemagTFunc::Asymptotic_Error_Estimate).
+	static int asymptotic_distance;
+};
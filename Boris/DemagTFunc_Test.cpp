@@ -109,6 +109,60 @@ DBL3 DemagTFunc::Lodia_single(DBL3 dist, DBL3 h, bool minus)
 		Lodia_single(dist.y, dist.z, dist.x, h.y, h.z, h.x)) * sign;
 }
 
+//estimate relative error of asymptotic expansions used from given distance (in cells) for given cellsize ratios.
+double DemagTFunc::Asymptotic_Error_Estimate(DBL3 hRatios, int asymptotic_distance)
+{
+	//asymptotic expansions not used
+	if (asymptotic_distance <= 0) return 0.0;
+
+	//same setup as used in tensor calculations (e.g. CalcDiagTens3D, CalcOffDiagTens3D)
+	DemagAsymptoticDiag demagAsymptoticDiag_xx(hRatios.x, hRatios.y, hRatios.z);
+	DemagAsymptoticDiag demagAsymptoticDiag_yy(hRatios.y, hRatios.x, hRatios.z);
+	DemagAsymptoticDiag demagAsymptoticDiag_zz(hRatios.z, hRatios.y, hRatios.x);
+
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_xy(hRatios.x, hRatios.y, hRatios.z);
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_xz(hRatios.x, hRatios.z, hRatios.y);
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_yz(hRatios.y, hRatios.z, hRatios.x);
+
+	//number of polar and azimuthal angle divisions in the first octant
+	const int angle_divisions = 8;
+
+	auto max_abs = [](DBL3 value) -> double { return maximum(fabs(value.x), fabs(value.y), fabs(value.z)); };
+
+	std::vector<double> max_error((angle_divisions + 1) * (angle_divisions + 1), 0.0);
+
+#pragma omp parallel for
+	for (int idx = 0; idx < (angle_divisions + 1) * (angle_divisions + 1); idx++) {
+
+		double theta = (PI / 2) * (idx % (angle_divisions + 1)) / angle_divisions;
+		double phi = (PI / 2) * (idx / (angle_divisions + 1)) / angle_divisions;
+
+		//position in cells, then scaled by cellsize ratios
+		DBL3 pos = DBL3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)) * asymptotic_distance;
+		double x = pos.x * hRatios.x, y = pos.y * hRatios.y, z = pos.z * hRatios.z;
+
+		//exact values (sign not relevant here)
+		DBL3 Ldia_exact = Ldia_single(DBL3(x, y, z), hRatios, false);
+		DBL3 Lodia_exact = Lodia_single(DBL3(x, y, z), hRatios, false);
+
+		DBL3 Ldia_asympt = DBL3(
+			demagAsymptoticDiag_xx.AsymptoticLdia(x, y, z),
+			demagAsymptoticDiag_yy.AsymptoticLdia(y, x, z),
+			demagAsymptoticDiag_zz.AsymptoticLdia(z, y, x));
+
+		DBL3 Lodia_asympt = DBL3(
+			demagAsymptoticOffDiag_xy.AsymptoticLodia(x, y, z),
+			demagAsymptoticOffDiag_xz.AsymptoticLodia(x, z, y),
+			demagAsymptoticOffDiag_yz.AsymptoticLodia(y, z, x));
+
+		double max_element = maximum(max_abs(Ldia_exact), max_abs(Lodia_exact));
+
+		if (max_element > 0.0) max_error[idx] = maximum(max_abs(Ldia_exact - Ldia_asympt), max_abs(Lodia_exact - Lodia_asympt)) / max_element;
+	}
+
+	return *std::max_element(max_error.begin(), max_error.end());
+}
+
 //diagonal component for irregular tensor, where source and destination cells can differ in z cellsize : xx and yy components only
 double DemagTFunc::Ldia_shifted_irregular_xx_yy_single(double x, double y, double z, double hx, double hy, double sz, double dz)
 {
@@ -0,0 +1,573 @@
+#include "stdafx.h"
+#include "DemagTree.h"
+
+#ifdef MODULE_COMPILATION_DEMAG_TREE
+
+#include "SimScheduleDefs.h"
+
+#include "Mesh.h"
+#include "SuperMesh.h"
+
+#include "DemagTFunc.h"
+#include "DemagTFunc_Asympt.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+DemagTree::DemagTree(Mesh *pMesh_) :
+	Modules(),
+	ProgramStateNames(this, { VINFO(near_distance), VINFO(opening_angle) }, {})
+{
+	pMesh = pMesh_;
+
+	error_on_create = UpdateConfiguration(UPDATECONFIG_FORCEUPDATE);
+
+	//-------------------------- Is CUDA currently enabled?
+
+	//If cuda is enabled we also need to make the cuda module version
+	if (pMesh->cudaEnabled) {
+
+		if (!error_on_create) error_on_create = SwitchCUDAState(true);
+	}
+}
+
+DemagTree::~DemagTree()
+{
+}
+
+BError DemagTree::Initialize(void)
+{
+	BError error(CLASS_STR(DemagTree));
+
+	if (!initialized) {
+
+		hRatios = pMesh->h / maximum(pMesh->h.x, pMesh->h.y, pMesh->h.z);
+
+		Build_Tree();
+
+		error = Calculate_NearField_Tensor();
+
+		if (!error) initialized = true;
+	}
+
+	//Make sure display data has memory allocated (or freed) as required
+	error = Update_Module_Display_VECs(
+		pMesh->h, pMesh->meshRect,
+		(MOD_)pMesh->Get_Module_Heff_Display() == MOD_DEMAG_TREE || pMesh->IsOutputDataSet_withRect(DATA_E_DEMAG) || pMesh->IsStageSet(SS_MONTECARLO),
+		(MOD_)pMesh->Get_Module_Energy_Display() == MOD_DEMAG_TREE || pMesh->IsOutputDataSet_withRect(DATA_E_DEMAG) || pMesh->IsStageSet(SS_MONTECARLO));
+	if (error) initialized = false;
+
+	//if a Monte Carlo stage is set then we need to compute fields
+	if (pMesh->IsStageSet(SS_MONTECARLO)) pMesh->Set_Force_MonteCarlo_ComputeFields(true);
+
+	return error;
+}
+
+BError DemagTree::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
+{
+	BError error(CLASS_STR(DemagTree));
+
+	//the tree depends on the mesh shape, and the near field tensor on the cellsize (and asymptotic expansions settings)
+	if (cfgMessage == UPDATECONFIG_FORCEUPDATE || cfgMessage == UPDATECONFIG_MESHSHAPECHANGE || cfgMessage == UPDATECONFIG_MESHCHANGE || cfgMessage == UPDATECONFIG_DEMAG_CONVCHANGE) {
+
+		Uninitialize();
+
+		//free memory, allocated again on initialization
+		cells_list.clear();
+		cells_list.shrink_to_fit();
+		nodes.clear();
+		nodes.shrink_to_fit();
+		nodes_m.clear();
+		nodes_m.shrink_to_fit();
+		nodes_q.clear();
+		nodes_q.shrink_to_fit();
+		Mcells.clear();
+		Mcells.shrink_to_fit();
+	}
+
+	//------------------------ CUDA UpdateConfiguration if set
+
+#if COMPILECUDA == 1
+	if (pModuleCUDA) {
+
+		if (!error) error = pModuleCUDA->UpdateConfiguration(cfgMessage);
+	}
+#endif
+
+	return error;
+}
+
+BError DemagTree::MakeCUDAModule(void)
+{
+	BError error(CLASS_STR(DemagTree));
+
+#if COMPILECUDA == 1
+
+	//CPU-only module : tree traversal for sparse geometries is not suited to the GPU, where the FFT convolution (demag module) should be used instead
+	if (pMesh->pMeshCUDA) return error(BERROR_NOTAVAILABLE);
+
+#endif
+
+	return error;
+}
+
+//-------------------Setters
+
+//set near field distance (cells) and opening angle
+BError DemagTree::Set_Accuracy(int near_distance_, double opening_angle_)
+{
+	BError error(CLASS_STR(DemagTree));
+
+	//opening angle must be below 1 so clusters never contain the destination cell
+	if (near_distance_ < 1 || opening_angle_ <= 0.0 || opening_angle_ >= 1.0) return error(BERROR_INCORRECTVALUE);
+
+	if (near_distance != near_distance_ || opening_angle != opening_angle_) {
+
+		near_distance = near_distance_;
+		opening_angle = opening_angle_;
+
+		Uninitialize();
+	}
+
+	return error;
+}
+
+//-------------------Tree
+
+//build octree from current non-empty cells in M
+void DemagTree::Build_Tree(void)
+{
+	INT3 n = pMesh->n;
+
+	cells_list.clear();
+	nodes.clear();
+
+	cells_list.reserve(pMesh->M.get_nonempty_cells());
+
+	//bounding box of non-empty cells
+	INT3 box_s = n, box_e = INT3();
+
+	for (int idx = 0; idx < n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			cells_list.push_back(idx);
+
+			INT3 ijk = INT3(idx % n.x, (idx / n.x) % n.y, idx / (n.x * n.y));
+
+			box_s = INT3(minimum(box_s.i, ijk.i), minimum(box_s.j, ijk.j), minimum(box_s.k, ijk.k));
+			box_e = INT3(maximum(box_e.i, ijk.i + 1), maximum(box_e.j, ijk.j + 1), maximum(box_e.k, ijk.k + 1));
+		}
+	}
+
+	Mcells.assign(cells_list.size(), DBL3());
+
+	if (!cells_list.size()) {
+
+		nodes_m.clear();
+		nodes_q.clear();
+		return;
+	}
+
+	nodes.push_back(TreeNode(0, cells_list.size(), box_s, box_e, 0));
+
+	//split nodes in order : children are always appended after their parent, so parent node indexes are smaller than their children
+	std::vector<int> octant_cells;
+
+	for (int node_idx = 0; node_idx < nodes.size(); node_idx++) {
+
+		int cells_start = nodes[node_idx].cells_start;
+		int cells_end = nodes[node_idx].cells_end;
+
+		INT3 s = nodes[node_idx].box_s, e = nodes[node_idx].box_e;
+
+		if (cells_end - cells_start <= leaf_size || (e - s) == INT3(1) || nodes[node_idx].level >= max_depth) continue;
+
+		//box mid-points : only split dimensions with more than 1 cell
+		INT3 mid = INT3((s.i + e.i) / 2, (s.j + e.j) / 2, (s.k + e.k) / 2);
+		if (e.i - s.i == 1) mid.i = e.i;
+		if (e.j - s.j == 1) mid.j = e.j;
+		if (e.k - s.k == 1) mid.k = e.k;
+
+		auto get_octant = [&](int idx) -> int {
+
+			return (idx % n.x >= mid.i) + 2 * ((idx / n.x) % n.y >= mid.j) + 4 * (idx / (n.x * n.y) >= mid.k);
+		};
+
+		//counting sort of node cells by octant
+		int octant_count[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+		for (int cidx = cells_start; cidx < cells_end; cidx++) octant_count[get_octant(cells_list[cidx])]++;
+
+		int octant_start[9];
+		octant_start[0] = cells_start;
+		for (int oct = 0; oct < 8; oct++) octant_start[oct + 1] = octant_start[oct] + octant_count[oct];
+
+		octant_cells.assign(cells_list.begin() + cells_start, cells_list.begin() + cells_end);
+
+		int octant_fill[8];
+		for (int oct = 0; oct < 8; oct++) octant_fill[oct] = octant_start[oct];
+
+		for (int cidx = 0; cidx < octant_cells.size(); cidx++) cells_list[octant_fill[get_octant(octant_cells[cidx])]++] = octant_cells[cidx];
+
+		//make children for non-empty octants
+		nodes[node_idx].child_start = nodes.size();
+
+		for (int oct = 0; oct < 8; oct++) {
+
+			if (!octant_count[oct]) continue;
+
+			INT3 child_s = INT3(oct & 1 ? mid.i : s.i, oct & 2 ? mid.j : s.j, oct & 4 ? mid.k : s.k);
+			INT3 child_e = INT3(oct & 1 ? e.i : mid.i, oct & 2 ? e.j : mid.j, oct & 4 ? e.k : mid.k);
+
+			nodes.push_back(TreeNode(octant_start[oct], octant_start[oct + 1], child_s, child_e, nodes[node_idx].level + 1));
+		}
+
+		nodes[node_idx].child_end = nodes.size();
+	}
+
+	//node centroids and radii
+#pragma omp parallel for schedule(dynamic)
+	for (int node_idx = 0; node_idx < nodes.size(); node_idx++) {
+
+		TreeNode& node = nodes[node_idx];
+
+		DBL3 centre = DBL3();
+
+		for (int cidx = node.cells_start; cidx < node.cells_end; cidx++) {
+
+			int idx = cells_list[cidx];
+			centre += (DBL3(idx % n.x, (idx / n.x) % n.y, idx / (n.x * n.y)) + DBL3(0.5)) & hRatios;
+		}
+
+		node.centre = centre / (node.cells_end - node.cells_start);
+
+		double radius = 0.0;
+
+		for (int cidx = node.cells_start; cidx < node.cells_end; cidx++) {
+
+			int idx = cells_list[cidx];
+			DBL3 position = (DBL3(idx % n.x, (idx / n.x) % n.y, idx / (n.x * n.y)) + DBL3(0.5)) & hRatios;
+
+			radius = maximum(radius, (position - node.centre).norm());
+		}
+
+		node.radius = radius + hRatios.norm() / 2;
+	}
+
+	nodes_m.assign(nodes.size(), DBL3());
+	nodes_q.assign(nodes.size(), DBL33());
+}
+
+//calculate near field tensor for current hRatios and near_distance
+BError DemagTree::Calculate_NearField_Tensor(void)
+{
+	BError error(CLASS_STR(DemagTree));
+
+	int num_points = (near_distance + 1) * (near_distance + 1) * (near_distance + 1);
+
+	if (!malloc_vector(Ddiag, num_points) || !malloc_vector(Dodiag, num_points)) return error(BERROR_OUTOFMEMORY_CRIT);
+
+	DemagTFunc dtf;
+
+	//use asymptotic expansions from same distance as for the demag kernels
+	DemagAsymptoticDiag demagAsymptoticDiag_xx(hRatios.x, hRatios.y, hRatios.z);
+	DemagAsymptoticDiag demagAsymptoticDiag_yy(hRatios.y, hRatios.x, hRatios.z);
+	DemagAsymptoticDiag demagAsymptoticDiag_zz(hRatios.z, hRatios.y, hRatios.x);
+
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_xy(hRatios.x, hRatios.y, hRatios.z);
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_xz(hRatios.x, hRatios.z, hRatios.y);
+	DemagAsymptoticOffDiag demagAsymptoticOffDiag_yz(hRatios.y, hRatios.z, hRatios.x);
+
+	int asymptotic_distance = DemagTFuncSettings::asymptotic_distance;
+
+#pragma omp parallel for
+	for (int idx = 0; idx < num_points; idx++) {
+
+		int i = idx % (near_distance + 1);
+		int j = (idx / (near_distance + 1)) % (near_distance + 1);
+		int k = idx / ((near_distance + 1) * (near_distance + 1));
+
+		double x = i * hRatios.x, y = j * hRatios.y, z = k * hRatios.z;
+
+		if (!i && !j && !k) {
+
+			Ddiag[idx] = dtf.SelfDemag(hRatios);
+			Dodiag[idx] = DBL3();
+		}
+		else if (asymptotic_distance > 0 && i * i + j * j + k * k >= asymptotic_distance * asymptotic_distance) {
+
+			Ddiag[idx] = -1.0 * DBL3(
+				demagAsymptoticDiag_xx.AsymptoticLdia(x, y, z),
+				demagAsymptoticDiag_yy.AsymptoticLdia(y, x, z),
+				demagAsymptoticDiag_zz.AsymptoticLdia(z, y, x));
+
+			Dodiag[idx] = -1.0 * DBL3(
+				demagAsymptoticOffDiag_xy.AsymptoticLodia(x, y, z),
+				demagAsymptoticOffDiag_xz.AsymptoticLodia(x, z, y),
+				demagAsymptoticOffDiag_yz.AsymptoticLodia(y, z, x));
+		}
+		else {
+
+			Ddiag[idx] = dtf.Ldia_single(DBL3(x, y, z), hRatios);
+			Dodiag[idx] = dtf.Lodia_single(DBL3(x, y, z), hRatios);
+		}
+	}
+
+	return error;
+}
+
+//compute multipole moments for all nodes from Mcells
+void DemagTree::Calculate_Moments(void)
+{
+	INT3 n = pMesh->n;
+	double volume = hRatios.dim();
+
+	//leaf nodes directly from cells
+#pragma omp parallel for schedule(dynamic)
+	for (int node_idx = 0; node_idx < nodes.size(); node_idx++) {
+
+		TreeNode& node = nodes[node_idx];
+
+		if (!node.is_leaf()) continue;
+
+		DBL3 m = DBL3();
+		DBL33 q = DBL33();
+
+		for (int cidx = node.cells_start; cidx < node.cells_end; cidx++) {
+
+			int idx = cells_list[cidx];
+			DBL3 position = (DBL3(idx % n.x, (idx / n.x) % n.y, idx / (n.x * n.y)) + DBL3(0.5)) & hRatios;
+
+			DBL3 m_cell = Mcells[cidx] * volume;
+
+			m += m_cell;
+			q += m_cell | (position - node.centre);
+		}
+
+		nodes_m[node_idx] = m;
+		nodes_q[node_idx] = q;
+	}
+
+	//parent nodes from children, shifting the children moments to the parent centre : children have larger indexes than parents so go in reverse
+	for (int node_idx = (int)nodes.size() - 1; node_idx >= 0; node_idx--) {
+
+		TreeNode& node = nodes[node_idx];
+
+		if (node.is_leaf()) continue;
+
+		DBL3 m = DBL3();
+		DBL33 q = DBL33();
+
+		for (int child_idx = node.child_start; child_idx < node.child_end; child_idx++) {
+
+			m += nodes_m[child_idx];
+			q += nodes_q[child_idx] + (nodes_m[child_idx] | (nodes[child_idx].centre - node.centre));
+		}
+
+		nodes_m[node_idx] = m;
+		nodes_q[node_idx] = q;
+	}
+}
+
+//compute demag field at given non-empty cell (index in cells_list)
+DBL3 DemagTree::Evaluate_Field(int cell_list_idx)
+{
+	INT3 n = pMesh->n;
+	double volume = hRatios.dim();
+
+	int idx_dst = cells_list[cell_list_idx];
+	INT3 dst = INT3(idx_dst % n.x, (idx_dst / n.x) % n.y, idx_dst / (n.x * n.y));
+	DBL3 position = (DBL3(dst) + DBL3(0.5)) & hRatios;
+
+	//near field computed with the demag tensor directly, far field (multipoles and point dipoles) without the 1 / 4PI factor
+	DBL3 Hnear = DBL3(), Hfar = DBL3();
+
+	//nodes still to visit : at most 8 per tree level, and Build_Tree does not split nodes beyond max_depth
+	int stack[8 * (max_depth + 1)];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+
+		int node_idx = stack[--stack_size];
+		const TreeNode& node = nodes[node_idx];
+
+		//distance in cells (along each axis) from destination cell to the nearest cell in node
+		int node_distance = maximum(
+			maximum(maximum(node.box_s.i - dst.i, dst.i - node.box_e.i + 1), 0),
+			maximum(maximum(node.box_s.j - dst.j, dst.j - node.box_e.j + 1), 0),
+			maximum(maximum(node.box_s.k - dst.k, dst.k - node.box_e.k + 1), 0));
+
+		if (node_distance > near_distance) {
+
+			DBL3 R = position - node.centre;
+			double R2 = R * R;
+
+			if (node.radius * node.radius < opening_angle * opening_angle * R2) {
+
+				//far field : multipole expansion to quadrupole order
+				double R_1 = 1.0 / sqrt(R2);
+				double R_3 = R_1 * R_1 * R_1;
+				double R_5 = R_3 * R_1 * R_1;
+				double R_7 = R_5 * R_1 * R_1;
+
+				const DBL3& m = nodes_m[node_idx];
+				const DBL33& q = nodes_q[node_idx];
+
+				//dipole term
+				Hfar += (3 * (R * m) * R_5) * R - R_3 * m;
+
+				//first order correction from distribution of dipoles about the centre : -(delta . grad) H_dipole summed over cells
+				Hfar -= 3 * R_5 * ((q | R) + (q.x.x + q.y.y + q.z.z) * R + q * R) - (15 * (R * (q * R)) * R_7) * R;
+
+				continue;
+			}
+		}
+
+		if (node.is_leaf()) {
+
+			for (int cidx = node.cells_start; cidx < node.cells_end; cidx++) {
+
+				int idx_src = cells_list[cidx];
+				INT3 offset = INT3(idx_src % n.x, (idx_src / n.x) % n.y, idx_src / (n.x * n.y)) - dst;
+
+				INT3 abs_offset = INT3(abs(offset.i), abs(offset.j), abs(offset.k));
+
+				const DBL3& M = Mcells[cidx];
+
+				if (maximum(abs_offset.i, abs_offset.j, abs_offset.k) <= near_distance) {
+
+					//near field : exact tensor, with off-diagonal elements odd in the respective coordinates
+					int nf_idx = nearfield_index(abs_offset.i, abs_offset.j, abs_offset.k);
+
+					DBL3 Dd = Ddiag[nf_idx];
+					DBL3 Dod = Dodiag[nf_idx];
+
+					int sx = (offset.i < 0 ? -1 : 1), sy = (offset.j < 0 ? -1 : 1), sz = (offset.k < 0 ? -1 : 1);
+					Dod = DBL3(Dod.x * sx * sy, Dod.y * sx * sz, Dod.z * sy * sz);
+
+					Hnear += DBL3(
+						Dd.x * M.x + Dod.x * M.y + Dod.y * M.z,
+						Dod.x * M.x + Dd.y * M.y + Dod.z * M.z,
+						Dod.y * M.x + Dod.z * M.y + Dd.z * M.z);
+				}
+				else {
+
+					//point dipole
+					DBL3 R = DBL3(-offset.i, -offset.j, -offset.k) & hRatios;
+
+					double R_1 = 1.0 / R.norm();
+					double R_3 = R_1 * R_1 * R_1;
+
+					Hfar += volume * ((3 * (R * M) * R_3 * R_1 * R_1) * R - R_3 * M);
+				}
+			}
+		}
+		else {
+
+			for (int child_idx = node.child_start; child_idx < node.child_end; child_idx++) stack[stack_size++] = child_idx;
+		}
+	}
+
+	return Hnear + Hfar / (4 * PI);
+}
+
+//-------------------Field
+
+double DemagTree::UpdateField(void)
+{
+	//shape changed without configuration update (e.g. moving mesh) : rebuild tree
+	if (cells_list.size() != pMesh->M.get_nonempty_cells()) Build_Tree();
+
+	if (!cells_list.size()) {
+
+		this->energy = 0.0;
+		return this->energy;
+	}
+
+	bool afm = (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC);
+
+#pragma omp parallel for
+	for (int cidx = 0; cidx < cells_list.size(); cidx++) {
+
+		int idx = cells_list[cidx];
+
+		if (afm) Mcells[cidx] = (pMesh->M[idx] + pMesh->M2[idx]) / 2;
+		else Mcells[cidx] = pMesh->M[idx];
+	}
+
+	Calculate_Moments();
+
+	double energy = 0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction((int)cells_list.size());
+
+#pragma omp parallel for schedule(dynamic, 16) reduction(+:energy)
+	for (int cidx = 0; cidx < cells_list.size(); cidx++) {
+
+		int idx = cells_list[cidx];
+
+		DBL3 Heff_value = Evaluate_Field(cidx);
+
+		pMesh->Heff[idx] += Heff_value;
+		if (afm) pMesh->Heff2[idx] += Heff_value;
+
+		double cell_energy = Mcells[cidx] * Heff_value;
+		if (deterministic) energy_reduction.reduce_sum(cell_energy, cidx);
+		else energy += cell_energy;
+
+		if (Module_Heff.linear_size()) Module_Heff[idx] = Heff_value;
+		if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * (Mcells[cidx] * Heff_value) / 2;
+	}
+
+	if (deterministic) energy = energy_reduction.sum();
+
+	if (pMesh->M.get_nonempty_cells()) this->energy = -energy * MU0 / (2 * pMesh->M.get_nonempty_cells());
+	else this->energy = 0;
+
+	return this->energy;
+}
+
+//-------------------Energy methods
+
+//FM mesh
+double DemagTree::Get_EnergyChange(int spin_index, DBL3 Mnew)
+{
+	//Module_Heff needs to be calculated (done during a Monte Carlo simulation, where this method would be used)
+	if (Module_Heff.linear_size()) {
+
+		//do not divide by 2 as we are not double-counting here
+		if (Mnew != DBL3()) return -pMesh->h.dim() * MU0 * Module_Heff[pMesh->M.cellidx_to_position(spin_index)] * (Mnew - pMesh->M[spin_index]);
+		else return -pMesh->h.dim() * MU0 * Module_Heff[pMesh->M.cellidx_to_position(spin_index)] * pMesh->M[spin_index];
+	}
+	else return 0.0;
+}
+
+//AFM mesh
+DBL2 DemagTree::Get_EnergyChange(int spin_index, DBL3 Mnew_A, DBL3 Mnew_B)
+{
+	//Module_Heff needs to be calculated (done during a Monte Carlo simulation, where this method would be used)
+	if (Module_Heff.linear_size()) {
+
+		DBL3 M = (pMesh->M[spin_index] + pMesh->M2[spin_index]) / 2;
+		DBL3 Mnew = (Mnew_A + Mnew_B) / 2;
+
+		double energy_ = 0.0;
+
+		//do not divide by 2 as we are not double-counting here
+		if (Mnew_A != DBL3() && Mnew_B != DBL3()) {
+
+			energy_ = -pMesh->h.dim() * MU0 * Module_Heff[pMesh->M.cellidx_to_position(spin_index)] * (Mnew - M);
+		}
+		else {
+
+			energy_ = -pMesh->h.dim() * MU0 * Module_Heff[pMesh->M.cellidx_to_position(spin_index)] * M;
+		}
+
+		return DBL2(energy_, energy_);
+	}
+	else return DBL2();
+}
+
+#endif
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "BorisLib.h"
+#include "Modules.h"
+
+class Mesh;
+
+#ifdef MODULE_COMPILATION_DEMAG_TREE
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Demag using a hierarchical (tree code) method on non-empty cells only, for sparse geometries where most of the mesh rectangle is empty.
+// Memory and computation time scale with the number of non-empty cells, not the number of cells in the mesh rectangle (as for the FFT convolution in Demag).
+//
+// Non-empty cells are arranged in an octree. For each non-empty cell the field is obtained by traversing the tree :
+// 1) near field : source cells within near_distance (in cells, along each axis) use the exact Newell tensor (precomputed for all relative cell positions in range)
+// 2) far field : clusters of cells which satisfy the opening angle criterion (cluster radius / distance < opening_angle) use a multipole expansion about the cluster centroid, to quadrupole order.
+//    Remaining source cells outside near_distance are treated as point dipoles.
+// Accuracy is controlled with near_distance and opening_angle : larger near distance and smaller opening angle are more accurate but slower.
+
+class DemagTree :
+	public Modules,
+	public ProgramState<DemagTree, std::tuple<int, double>, std::tuple<>>
+{
+
+private:
+
+	//a node in the octree : contains cells_list entries from cells_start up to (not including) cells_end
+	struct TreeNode {
+
+		//range in cells_list
+		int cells_start = 0, cells_end = 0;
+
+		//children nodes in nodes list, child_start up to (not including) child_end - leaf if empty
+		int child_start = 0, child_end = 0;
+
+		//cell index box covered by node : from box_s up to (not including) box_e
+		INT3 box_s, box_e;
+
+		//centroid of non-empty cells in node, with cell centres at (i + 0.5, j + 0.5, k + 0.5) * hRatios
+		DBL3 centre;
+
+		//distance from centre to the furthest cell corner in node (same units as centre)
+		double radius = 0.0;
+
+		//tree level of node (root at level 0)
+		int level = 0;
+
+		TreeNode(void) {}
+		TreeNode(int cells_start_, int cells_end_, INT3 box_s_, INT3 box_e_, int level_) :
+			cells_start(cells_start_), cells_end(cells_end_), box_s(box_s_), box_e(box_e_), level(level_)
+		{}
+
+		bool is_leaf(void) const { return child_start == child_end; }
+	};
+
+private:
+
+	//pointer to mesh object holding this effective field module
+	Mesh *pMesh;
+
+	//source cells up to this distance (in cells, along each axis) from a destination cell use the exact tensor
+	int near_distance = 4;
+
+	//clusters with radius / distance smaller than this use the multipole expansion
+	double opening_angle = 0.5;
+
+	//cellsize normalized so the largest component is 1 (all tensor computations are done in these units)
+	DBL3 hRatios;
+
+	//linear cell indexes of all non-empty cells, ordered so each tree node contains a contiguous range
+	std::vector<int> cells_list;
+
+	//the octree, root node at index 0
+	std::vector<TreeNode> nodes;
+
+	//node multipole moments, recomputed for each field evaluation : dipole moment (M * cell volume summed) and dipole moment first moment (M * V) x (r - centre) summed
+	std::vector<DBL3> nodes_m;
+	std::vector<DBL33> nodes_q;
+
+	//near field tensor for relative cell positions (i, j, k) with 0 <= i, j, k <= near_distance (other octants obtained from symmetries)
+	//Ddiag : (Dxx, Dyy, Dzz), Dodiag : (Dxy, Dxz, Dyz), with Heff = D * M
+	std::vector<DBL3> Ddiag, Dodiag;
+
+	//input magnetization for non-empty cells (same ordering as cells_list) : M for ferromagnetic meshes, (M + M2) / 2 for antiferromagnetic meshes
+	std::vector<DBL3> Mcells;
+
+	//maximum octree leaf size (number of non-empty cells)
+	static const int leaf_size = 16;
+
+	//maximum octree depth : nodes at this level are not split further, even if they contain more than leaf_size cells. Sets the traversal stack size in Evaluate_Field.
+	static const int max_depth = 64;
+
+private:
+
+	//build octree from current non-empty cells in M
+	void Build_Tree(void);
+
+	//calculate near field tensor for current hRatios and near_distance
+	BError Calculate_NearField_Tensor(void);
+
+	//compute multipole moments for all nodes from Mcells
+	void Calculate_Moments(void);
+
+	//compute demag field at given non-empty cell (index in cells_list)
+	DBL3 Evaluate_Field(int cell_list_idx);
+
+	//index in Ddiag, Dodiag for given absolute relative cell position
+	int nearfield_index(int i, int j, int k) { return i + (near_distance + 1) * (j + (near_distance + 1) * k); }
+
+public:
+
+	DemagTree(Mesh *pMesh_);
+	~DemagTree();
+
+	//-------------------Implement ProgramState method
+
+	void RepairObjectState(void) {}
+
+	//-------------------Abstract base class method implementations
+
+	void Uninitialize(void) { initialized = false; }
+
+	BError Initialize(void);
+
+	BError UpdateConfiguration(UPDATECONFIG_ cfgMessage);
+	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) {}
+
+	BError MakeCUDAModule(void);
+
+	double UpdateField(void);
+
+	//-------------------Setters
+
+	//set near field distance (cells) and opening angle
+	BError Set_Accuracy(int near_distance_, double opening_angle_);
+
+	//-------------------Getters
+
+	int Get_NearField_Distance(void) { return near_distance; }
+	double Get_Opening_Angle(void) { return opening_angle; }
+
+	//number of octree nodes
+	int Get_Tree_Nodes(void) { return nodes.size(); }
+
+	//-------------------Energy methods
+
+	//FM mesh
+	double Get_EnergyChange(int spin_index, DBL3 Mnew);
+
+	//AFM mesh
+	DBL2 Get_EnergyChange(int spin_index, DBL3 Mnew_A, DBL3 Mnew_B);
+};
+
+#else
+
+class DemagTree :
+	public Modules
+{
+
+private:
+
+public:
+
+	DemagTree(Mesh *pMesh_) {}
+	~DemagTree() {}
+
+	//-------------------Abstract base class method implementations
+
+	void Uninitialize(void) {}
+
+	BError Initialize(void) { return BError(); }
+
+	BError UpdateConfiguration(UPDATECONFIG_ cfgMessage) { return BError(); }
+	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) {}
+
+	BError MakeCUDAModule(void) { return BError(); }
+
+	double UpdateField(void) { return 0.0; }
+
+	//-------------------Setters
+
+	BError Set_Accuracy(int near_distance_, double opening_angle_) { return BError(); }
+
+	//-------------------Getters
+
+	int Get_NearField_Distance(void) { return 0; }
+	double Get_Opening_Angle(void) { return 0.0; }
+	int Get_Tree_Nodes(void) { return 0; }
+};
+
+#endif
@@ -31,4 +31,162 @@ DifferentialEquation::~DifferentialEquation()
 	}
 	pmeshODECUDA = nullptr;
 #endif
-}
\ No newline at end of file
+}
+//---------------------------------------- ACTIVE SET RELAXATION
+
+//freeze non-empty cells with normalized torque |M x Heff| / Ms^2 below threshold, unless within halo cells of an above-threshold cell; frozen cells are marked as skip cells in M.
+//Cells already frozen are not re-examined (their effective field is incomplete) but are released if within the halo. Return number of active non-empty cells.
+int DifferentialEquation::ActiveSet_Update(double threshold, int halo)
+{
+	std::vector<char>& frozen = pMesh->activeset_frozen;
+
+	SZ3 n = pMesh->n;
+	int num_cells = n.dim();
+
+	if ((int)frozen.size() != num_cells) {
+
+		ActiveSet_Release();
+		if (!malloc_vector(frozen, num_cells, (char)0)) return pMesh->M.get_nonempty_cells();
+	}
+
+	if ((int)activeset_cells.size() != num_cells || (int)activeset_cells_aux.size() != num_cells) {
+
+		if (!malloc_vector(activeset_cells, num_cells) || !malloc_vector(activeset_cells_aux, num_cells)) {
+
+			ActiveSet_Release();
+			return pMesh->M.get_nonempty_cells();
+		}
+	}
+
+	bool afm = (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC);
+
+	//1. cells with torque above threshold are active (cells skipped for other algorithms, e.g. moving mesh ends, are not)
+#pragma omp parallel for
+	for (int idx = 0; idx < num_cells; idx++) {
+
+		activeset_cells[idx] = false;
+
+		if (pMesh->M.is_not_empty(idx) && !frozen[idx] && !pMesh->M.is_skipcell(idx)) {
+
+			double Mnorm = pMesh->M[idx].norm();
+			double torque = GetMagnitude(pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm);
+
+			if (afm) {
+
+				double Mnorm2 = pMesh->M2[idx].norm();
+				torque = maximum(torque, GetMagnitude(pMesh->M2[idx] ^ pMesh->Heff2[idx]) / (Mnorm2 * Mnorm2));
+			}
+
+			activeset_cells[idx] = (torque >= threshold);
+		}
+	}
+
+	//2. extend active region by the halo, along each axis in turn
+	auto extend_halo = [&](int n_axis, int stride) {
+
+		if (n_axis == 1 || !halo) return;
+
+#pragma omp parallel for
+		for (int idx = 0; idx < num_cells; idx++) {
+
+			int i = (idx / stride) % n_axis;
+
+			char active = activeset_cells[idx];
+
+			for (int k = 1; k <= halo && !active; k++) {
+
+				if (i - k >= 0 && activeset_cells[idx - k * stride]) active = true;
+				else if (i + k < n_axis && activeset_cells[idx + k * stride]) active = true;
+			}
+
+			activeset_cells_aux[idx] = active;
+		}
+
+		activeset_cells.swap(activeset_cells_aux);
+	};
+
+	extend_halo(n.x, 1);
+	extend_halo(n.y, n.x);
+	extend_halo(n.z, n.x * n.y);
+
+	//3. freeze inactive cells, release active ones
+	int active_cells = 0;
+
+#pragma omp parallel for reduction(+:active_cells)
+	for (int idx = 0; idx < num_cells; idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (activeset_cells[idx]) {
+
+				if (frozen[idx]) {
+
+					pMesh->M.set_skipcell(idx, false);
+					frozen[idx] = false;
+				}
+			}
+			else if (!frozen[idx] && !pMesh->M.is_skipcell(idx)) {
+
+				pMesh->M.set_skipcell(idx, true);
+				frozen[idx] = true;
+			}
+
+			if (!frozen[idx]) active_cells++;
+		}
+	}
+
+	return active_cells;
+}
+
+//unfreeze all cells in this mesh : if free_memory is false the frozen cells flags are kept allocated (all cleared) so the mesh remains marked as using active set relaxation
+void DifferentialEquation::ActiveSet_Release(bool free_memory)
+{
+	std::vector<char>& frozen = pMesh->activeset_frozen;
+
+	if (frozen.size() == pMesh->M.linear_size()) {
+
+#pragma omp parallel for
+		for (int idx = 0; idx < (int)frozen.size(); idx++) {
+
+			if (frozen[idx]) {
+
+				pMesh->M.set_skipcell(idx, false);
+				frozen[idx] = false;
+			}
+		}
+	}
+	else frozen.clear();
+
+	if (free_memory) {
+
+		frozen.clear();
+		frozen.shrink_to_fit();
+	}
+	else if (!frozen.size()) malloc_vector(frozen, pMesh->M.linear_size(), (char)0);
+}
+
+//---------------------------------------- BULK THERMAL VECs GENERATION
+
+//generate Gaussian deviates for given number of thermal VECs, for all stochastic cells, in one pass with the counter-based prng (current step)
+void DifferentialEquation::GenerateThermalDeviates(int num_vecs, int num_cells)
+{
+	if (thermal_deviates.size() != 3 * num_vecs * num_cells) thermal_deviates.resize(3 * num_vecs * num_cells);
+
+	prng.rand_gauss_fill(thermal_deviates.size(), 0, thermal_deviates.data());
+}
+
+//check if thermal_prefactors must be recalculated for given number of thermal VECs, resizing it if so
+bool DifferentialEquation::ThermalPrefactors_Outdated(int num_vecs, int num_cells)
+{
+	double Temperature = pMesh->GetBaseTemperature();
+
+	//with a temperature VEC the cell temperatures can change at any time
+	if (thermal_prefactors_valid && !pMesh->Temp.linear_size() && thermal_prefactors_temperature == Temperature && thermal_prefactors.size() == num_vecs * num_cells) return false;
+
+	if (thermal_prefactors.size() != num_vecs * num_cells) thermal_prefactors.resize(num_vecs * num_cells);
+
+	thermal_prefactors_valid = true;
+	thermal_prefactors_temperature = Temperature;
+
+	return true;
+}
@@ -44,17 +44,41 @@ protected:
 	OmpReduction<DBL3> dmdt_av_reduction;
 	OmpReduction<double> lte_reduction;
 
+	//SD (Barzilai-Borwein) and NCG sums packed in a DBL3 (2nd one for sub-lattice B), used only if deterministic reductions are enabled (otherwise an OpenMP reduction clause is used)
+	OmpReduction<DBL3> minimizer_reduction, minimizer_reduction2;
+
 	//Used to save starting magnetization - all evaluation methods do this, even when not needed by the method itself, so we can calculate dM/dt when needed.
 	VEC<DBL3> sM1;
 
 	//evalution scratch spaces
 	VEC<DBL3> sEval0, sEval1, sEval2, sEval3, sEval4, sEval5, sEval6;
 
+	//multi-rate stepping : magnetization at start and end of the micromagnetic time step, allocated only if enabled
+	VEC<DBL3> sM_mr_start, sM_mr_end;
+
+	//multi-rate stepping : effective field from the last micromagnetic time step evaluation, restored after every atomistic sub-step (which only computes coupling fields in micromagnetic meshes)
+	VEC<DBL3> sHeff_mr;
+
+	//active set relaxation : active cells scratch spaces used to extend the active region by the halo
+	std::vector<char> activeset_cells, activeset_cells_aux;
+
 	//Thermal field and torques, enabled only for the stochastic equations
 	VEC<DBL3> H_Thermal, Torque_Thermal;
 
-	//random number generator
-	BorisRand prng;
+	//thermal VECs have the same discretization as M (linked stochastic cellsize), so equations can index them using the M cell index directly
+	bool thermal_linked = false;
+
+	//bulk thermal VECs generation : Gaussian deviates for all stochastic cells (3 per cell for each thermal VEC, consecutive for each cell), generated in one pass
+	std::vector<double> thermal_deviates;
+
+	//thermal VECs prefactors for each stochastic cell (one per thermal VEC, consecutive for each cell) excluding the 1 / sqrt(deltaT) factor
+	//these are only recalculated when parameters or the temperature change (always recalculated if a temperature VEC is used)
+	std::vector<double> thermal_prefactors;
+	bool thermal_prefactors_valid = false;
+	double thermal_prefactors_temperature = 0.0;
+
+	//random number generator for thermal fields : counter-based, so results for a given seed do not depend on the number of threads
+	BorisCBRand prng;
 
 	Mesh *pMesh = nullptr;
 
@@ -177,6 +201,22 @@ protected:
 	virtual void RunRKDP54_Step5(void) = 0;
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	virtual void RunLSRK_Step0_withReductions(void) = 0;
+	virtual void RunLSRK_Step0(void) = 0;
+	virtual void RunLSRK_Step(void) = 0;
+	virtual void RunLSRK_Step4_withReductions(void) = 0;
+	virtual void RunLSRK_Step4(void) = 0;
+#endif
+
+#ifdef ODE_EVAL_COMPILATION_IMEX
+	//IMEX Euler evaluation of ODE : exchange treated implicitly, all other terms explicitly
+	//only implemented for ferromagnetic meshes (AllocateMemory refuses IMEX for antiferromagnetic meshes)
+	virtual void RunIMEX_withReductions(void) {}
+	virtual void RunIMEX(void) {}
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	virtual void RunSD_Start(void) = 0;
@@ -189,6 +229,19 @@ protected:
 	virtual void RunSD_Advance(void) = 0;
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	virtual void RunNCG_Reductions(void) = 0;
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	virtual void RunNCG_LineSearch(void) = 0;
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	virtual void RunNCG_Restart(void) = 0;
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	virtual void RunNCG_Direction_withReductions(void) = 0;
+	virtual void RunNCG_Direction(void) = 0;
+#endif
+
 	//---------------------------------------- OTHERS
 
 	//Restore magnetization after a failed step for adaptive time-step methods
@@ -200,12 +253,26 @@ protected:
 	//renormalize vectors to set magnetization length value (which could have a spatial variation)
 	virtual void RenormalizeMagnetization(void) = 0;
 
+	//multi-rate stepping : save magnetization at start and end of the micromagnetic time step, then set it by linear interpolation (fraction of step from 0 to 1) during the atomistic sub-steps
+	virtual void Multirate_Save_Start(void) = 0;
+	virtual void Multirate_Save_End(void) = 0;
+	virtual void Multirate_Interpolate(double fraction) = 0;
+
+	//multi-rate stepping : restore effective field saved by Multirate_Save_End
+	virtual void Multirate_Restore_Heff(void) = 0;
+
 	//---------------------------------------- OTHER CALCULATION METHODS
 
 	//called when using stochastic equations
 	virtual void GenerateThermalField(void) = 0;
 	virtual void GenerateThermalField_and_Torque(void) = 0;
 
+	//bulk thermal VECs generation : generate Gaussian deviates for given number of thermal VECs, for all stochastic cells
+	void GenerateThermalDeviates(int num_vecs, int num_cells);
+
+	//bulk thermal VECs generation : check if thermal_prefactors must be recalculated for given number of thermal VECs, resizing it if so
+	bool ThermalPrefactors_Outdated(int num_vecs, int num_cells);
+
 	//---------------------------------------- SET-UP METHODS
 
 	//allocate memory depending on set evaluation method - also cleans up previously allocated memory by calling CleanupMemory();
@@ -214,7 +281,7 @@ protected:
 	//deallocate memory before re-allocating it (depending on evaluation method previously allocated memory might not be used again, so need clean-up before)
 	virtual void CleanupMemory(void) = 0;
 
-	//---------------------------------------- EQUATIONS : DiffEq_Equations.cpp and DiffEq_SEquations.cpp
+	//---------------------------------------- EQUATIONS : DiffEqFM_Equations.h and DiffEqAFM_Equations.h
 
 	//Landau-Lifshitz-Gilbert equation
 	virtual DBL3 LLG(int idx) = 0;
@@ -262,6 +329,22 @@ public:  //public methods
 	//switch CUDA state on/off
 	virtual BError SwitchCUDAState(bool cudaState) = 0;
 
+	//---------------------------------------- ACTIVE SET RELAXATION : DiffEq.cpp
+
+	//freeze non-empty cells with normalized torque |M x Heff| / Ms^2 below threshold, unless within halo cells of an above-threshold cell; frozen cells are marked as skip cells in M.
+	//Cells already frozen are not re-examined (their effective field is incomplete) but are released if within the halo. Return number of active non-empty cells.
+	int ActiveSet_Update(double threshold, int halo);
+
+	//unfreeze all cells in this mesh : if free_memory is false the frozen cells flags are kept allocated (all cleared) so the mesh remains marked as using active set relaxation
+	void ActiveSet_Release(bool free_memory = true);
+
+	//---------------------------------------- BENCHMARKS
+
+	//time the set equation in a single fused pass over the mesh, as done by the evaluation methods : torque reduction, equation evaluation, Euler update and dm/dt reduction (result written to scratch space, magnetization not modified).
+	//generic = true : equation called through the function pointer for every cell, else the loop instantiated for the set equation is used.
+	//throughput set in cells per second per thread, averaged over given number of repeats. Must be called with the ODE memory allocated (mesh initialized).
+	virtual BError Benchmark_Equation(int repeats, bool generic, double& throughput) = 0;
+
 	//---------------------------------------- GETTERS
 
 	//return dM by dT - should only be used when evaluation sequence has ended (TimeStepSolved() == true)
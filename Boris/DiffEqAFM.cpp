@@ -4,6 +4,7 @@
 #ifdef MESH_COMPILATION_ANTIFERROMAGNETIC
 
 #include "Mesh_AntiFerromagnetic.h"
+#include "DiffEqAFM_Equations.h"
 
 DifferentialEquationAFM::DifferentialEquationAFM(AFMesh *pMesh) :
 	DifferentialEquation(pMesh)
@@ -69,6 +70,64 @@ void DifferentialEquationAFM::RenormalizeMagnetization(void)
 	}
 }
 
+//multi-rate stepping : save magnetization at start of the micromagnetic time step
+void DifferentialEquationAFM::Multirate_Save_Start(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		sM_mr_start[idx] = pMesh->M[idx];
+		sM_mr_start_2[idx] = pMesh->M2[idx];
+	}
+}
+
+//multi-rate stepping : save magnetization at end of the micromagnetic time step, and the effective field from its last evaluation
+void DifferentialEquationAFM::Multirate_Save_End(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		sM_mr_end[idx] = pMesh->M[idx];
+		sM_mr_end_2[idx] = pMesh->M2[idx];
+		sHeff_mr[idx] = pMesh->Heff[idx];
+		sHeff_mr_2[idx] = pMesh->Heff2[idx];
+	}
+}
+
+//multi-rate stepping : restore effective field saved by Multirate_Save_End
+void DifferentialEquationAFM::Multirate_Restore_Heff(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		pMesh->Heff[idx] = sHeff_mr[idx];
+		pMesh->Heff2[idx] = sHeff_mr_2[idx];
+	}
+}
+
+//multi-rate stepping : set magnetization by linear interpolation between start and end of the micromagnetic time step (fraction from 0 to 1)
+void DifferentialEquationAFM::Multirate_Interpolate(double fraction)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			pMesh->M[idx] = sM_mr_start[idx] + (sM_mr_end[idx] - sM_mr_start[idx]) * fraction;
+			pMesh->M2[idx] = sM_mr_start_2[idx] + (sM_mr_end_2[idx] - sM_mr_start_2[idx]) * fraction;
+
+			if (renormalize) {
+
+				DBL2 Ms_AFM = pMesh->Ms_AFM;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+
+				if (Ms_AFM.i) pMesh->M[idx].renormalize(Ms_AFM.i);
+				if (Ms_AFM.j) pMesh->M2[idx].renormalize(Ms_AFM.j);
+			}
+		}
+	}
+}
+
 //---------------------------------------- SET-UP METHODS
 
 BError DifferentialEquationAFM::AllocateMemory(void)
@@ -173,10 +232,43 @@ BError DifferentialEquationAFM::AllocateMemory(void)
 		if (!sEval6_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
 
+	case EVAL_LSRK4:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval0_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+	case EVAL_LSRK43:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval0_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+	//IMEX method is only implemented for ferromagnetic meshes
+	case EVAL_IMEX:
+		return error(BERROR_NOTAVAILABLE);
+
 	case EVAL_SD:
 		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		if (!sEval0_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
+
+	case EVAL_NCG:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval0_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+	}
+
+	//multi-rate stepping : micromagnetic magnetization at start and end of time step, used for interpolation during atomistic sub-steps
+	if (multirate_subcycles > 1) {
+
+		if (!sM_mr_start.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sM_mr_end.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sM_mr_start_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sM_mr_end_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sHeff_mr.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sHeff_mr_2.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 	}
 
 	//For stochastic equations must also allocate memory for thermal VECs
@@ -200,6 +292,10 @@ BError DifferentialEquationAFM::AllocateMemory(void)
 		break;
 	}
 
+	//seed the thermal field generator : if prng_seed > 0 the same sequence is generated every time, else use the system tick count
+	if (H_Thermal.linear_size()) prng.seed(pMesh->prng_seed == 0 ? GetSystemTickCount() : pMesh->prng_seed);
+	thermal_linked = (H_Thermal.linear_size() && H_Thermal.n == pMesh->n);
+
 	//----------------------- CUDA mirroring
 
 #if COMPILECUDA == 1
@@ -225,7 +321,10 @@ void DifferentialEquationAFM::CleanupMemory(void)
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKDP54 &&
 		evalMethod != EVAL_RKF56 &&
-		evalMethod != EVAL_SD) {
+		evalMethod != EVAL_LSRK4 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_SD &&
+		evalMethod != EVAL_NCG) {
 
 		sEval0.clear();
 		sEval0_2.clear();
@@ -237,7 +336,9 @@ void DifferentialEquationAFM::CleanupMemory(void)
 		evalMethod != EVAL_RKF45 &&
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKDP54 &&
-		evalMethod != EVAL_RKF56) {
+		evalMethod != EVAL_RKF56 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_NCG) {
 
 		sEval1.clear();
 		sEval1_2.clear();
@@ -279,6 +380,16 @@ void DifferentialEquationAFM::CleanupMemory(void)
 		sEval6_2.clear();
 	}
 
+	if (multirate_subcycles <= 1) {
+
+		sM_mr_start.clear();
+		sM_mr_end.clear();
+		sM_mr_start_2.clear();
+		sM_mr_end_2.clear();
+		sHeff_mr.clear();
+		sHeff_mr_2.clear();
+	}
+
 	//For thermal vecs only clear if not used for current set ODE
 	if (setODE != ODE_SLLG &&
 		setODE != ODE_SLLGSTT &&
@@ -311,6 +422,9 @@ BError DifferentialEquationAFM::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
 {
 	BError error(CLASS_STR(DifferentialEquationAFM));
 
+	//parameters, temperature or mesh may have changed : thermal VECs prefactors must be recalculated
+	thermal_prefactors_valid = false;
+
 	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_MESHCHANGE, UPDATECONFIG_ODE_SOLVER)) {
 
 		if (pMesh->link_stochastic) {
@@ -330,6 +444,12 @@ BError DifferentialEquationAFM::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
 		error = AllocateMemory();
 	}
 
+	//prng seed changed : restart the thermal field generator from the new seed at step 0 (also done when thermal VECs are allocated)
+	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_PRNG)) {
+
+		if (H_Thermal.linear_size()) prng.seed(pMesh->prng_seed == 0 ? GetSystemTickCount() : pMesh->prng_seed);
+	}
+
 	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_ODE_MOVEMESH)) {
 
 		/*
@@ -402,6 +522,56 @@ BError DifferentialEquationAFM::SwitchCUDAState(bool cudaState)
 	return error;
 }
 
+//---------------------------------------- BENCHMARKS
+
+BError DifferentialEquationAFM::Benchmark_Equation(int repeats, bool generic, double& throughput)
+{
+	BError error(__FUNCTION__);
+
+	throughput = 0.0;
+	if (!sM1.linear_size() || repeats < 1) return error(BERROR_INCORRECTACTION);
+
+	//updated magnetization written here (both sub-lattices)
+	std::vector<DBL3> M_new, M2_new;
+	if (!malloc_vector(M_new, pMesh->n.dim()) || !malloc_vector(M2_new, pMesh->n.dim())) return error(BERROR_OUTOFMEMORY_NCRIT);
+
+	auto euler_pass = [&](auto equation_rhs) {
+
+		mxh_av_reduction.new_average_reduction(pMesh->n.dim());
+		dmdt_av_reduction.new_average_reduction(pMesh->n.dim());
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+				double Mnorm = pMesh->M[idx].norm();
+				mxh_av_reduction.reduce_average((pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm), idx);
+
+				M_new[idx] = pMesh->M[idx] + equation_rhs(idx) * dT;
+				M2_new[idx] = pMesh->M2[idx] + Equation_Eval_2[omp_get_thread_num()] * dT;
+
+				dmdt_av_reduction.reduce_average((M_new[idx] - pMesh->M[idx]) / (dT * GAMMA * Mnorm * Mnorm), idx);
+			}
+		}
+	};
+
+	int eqkernel = (generic ? (int)EQKERNEL_GENERIC : equation_kernel);
+
+	//first pass not timed
+	Dispatch_Equation(euler_pass, eqkernel);
+
+	unsigned int start_ms = GetSystemTickCount();
+
+	for (int r = 0; r < repeats; r++) Dispatch_Equation(euler_pass, eqkernel);
+
+	double time_s = (double)(GetSystemTickCount() - start_ms) / 1000;
+
+	if (time_s > 0.0) throughput = (double)pMesh->M.get_nonempty_cells() * repeats / (time_s * omp_get_max_threads());
+
+	return error;
+}
+
 //---------------------------------------- GETTERS
 
 //return dM by dT - should only be used when evaluation sequence has ended (TimeStepSolved() == true)
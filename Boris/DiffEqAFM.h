@@ -30,6 +30,12 @@ private:
 	//evalution scratch spaces
 	VEC<DBL3> sEval0_2, sEval1_2, sEval2_2, sEval3_2, sEval4_2, sEval5_2, sEval6_2;
 
+	//multi-rate stepping : sub-lattice B magnetization at start and end of the micromagnetic time step
+	VEC<DBL3> sM_mr_start_2, sM_mr_end_2;
+
+	//multi-rate stepping : sub-lattice B effective field from the last micromagnetic time step evaluation
+	VEC<DBL3> sHeff_mr_2;
+
 	//Thermal field and torques, enabled only for the stochastic equations
 	VEC<DBL3> H_Thermal_2, Torque_Thermal_2;
 
@@ -147,6 +153,15 @@ public:
 	void RunRKDP54_Step5(void);
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	void RunLSRK_Step0_withReductions(void);
+	void RunLSRK_Step0(void);
+	void RunLSRK_Step(void);
+	void RunLSRK_Step4_withReductions(void);
+	void RunLSRK_Step4(void);
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	void RunSD_Start(void);
@@ -159,7 +174,20 @@ public:
 	void RunSD_Advance(void);
 #endif
 
-	//---------------------------------------- EQUATIONS : DiffEq_Equations.cpp and DiffEq_SEquations.cpp
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	void RunNCG_Reductions(void);
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	void RunNCG_LineSearch(void);
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	void RunNCG_Restart(void);
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	void RunNCG_Direction_withReductions(void);
+	void RunNCG_Direction(void);
+#endif
+
+	//---------------------------------------- EQUATIONS : DiffEqAFM_Equations.h
 
 	//Landau-Lifshitz-Gilbert equation
 	DBL3 LLG(int idx);
@@ -188,6 +216,10 @@ public:
 	//Stochastic Landau-Lifshitz-Bloch equation with Zhang-Li STT
 	DBL3 SLLBSTT(int idx);
 
+	//call kernel with an equation_rhs(idx) callable which evaluates the equation given by eqkernel (EQKERNEL_ value, the currently set equation by default)
+	//kernel is a generic lambda containing the evaluation method loops, thus instantiated for each equation with the equation inlined. EQKERNEL_GENERIC calls the equation through the function pointer.
+	template <typename Kernel> void Dispatch_Equation(Kernel kernel, int eqkernel = equation_kernel);
+
 	//---------------------------------------- OTHERS : DiffEqFM.cpp
 
 	void RestoreMagnetization(void);
@@ -198,6 +230,12 @@ public:
 	//renormalize vectors to set magnetization length value (which could have a spatial variation)
 	void RenormalizeMagnetization(void);
 
+	//multi-rate stepping : save magnetization at start and end of the micromagnetic time step, then set it by linear interpolation during the atomistic sub-steps
+	void Multirate_Save_Start(void);
+	void Multirate_Save_End(void);
+	void Multirate_Interpolate(double fraction);
+	void Multirate_Restore_Heff(void);
+
 	//---------------------------------------- OTHER CALCULATION METHODS : DiffEqFM_SEquations.cpp
 
 	//called when using stochastic equations
@@ -215,11 +253,16 @@ public:
 	//---------------------------------------- SET-UP METHODS
 
 	BError UpdateConfiguration(UPDATECONFIG_ cfgMessage);
-	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) {}
+	void UpdateConfiguration_Values(UPDATECONFIG_ cfgMessage) { thermal_prefactors_valid = false; }
 
 	//switch CUDA state on/off
 	BError SwitchCUDAState(bool cudaState);
 
+	//---------------------------------------- BENCHMARKS : DiffEqAFM.cpp
+
+	//time a fused pass with the set equation over the mesh (see DifferentialEquation::Benchmark_Equation)
+	BError Benchmark_Equation(int repeats, bool generic, double& throughput);
+
 	//---------------------------------------- GETTERS
 
 	//return dM by dT - should only be used when evaluation sequence has ended (TimeStepSolved() == true)
@@ -345,6 +388,15 @@ public:
 	void RunRKDP54_Step5(void) {}
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_LSRK
+	//LSRK4 and LSRK43 (same stages, LSRK43 also accumulates the embedded error)
+	void RunLSRK_Step0_withReductions(void) {}
+	void RunLSRK_Step0(void) {}
+	void RunLSRK_Step(void) {}
+	void RunLSRK_Step4_withReductions(void) {}
+	void RunLSRK_Step4(void) {}
+#endif
+
 #ifdef ODE_EVAL_COMPILATION_SD
 	//0. prime the SD solver
 	void RunSD_Start(void) {}
@@ -357,6 +409,19 @@ public:
 	void RunSD_Advance(void) {}
 #endif
 
+#ifdef ODE_EVAL_COMPILATION_NCG
+	//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities, with D the steepest descent direction at the current magnetization and d the previous search direction transported to it
+	//must reset the static ncg_... quantities before running these across all meshes
+	void RunNCG_Reductions(void) {}
+	//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+	void RunNCG_LineSearch(void) {}
+	//2b. line search failed (energy increased) : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+	void RunNCG_Restart(void) {}
+	//3. start new line search from the current magnetization : set new search direction (conjugation factor ncg_beta) and take the trial step dT along it
+	void RunNCG_Direction_withReductions(void) {}
+	void RunNCG_Direction(void) {}
+#endif
+
 	//---------------------------------------- EQUATIONS : DiffEq_Equations.cpp and DiffEq_SEquations.cpp
 
 	//Landau-Lifshitz-Gilbert equation
@@ -396,6 +461,12 @@ public:
 	//renormalize vectors to set magnetization length value (which could have a spatial variation)
 	void RenormalizeMagnetization(void) {}
 
+	//multi-rate stepping : save magnetization at start and end of the micromagnetic time step, then set it by linear interpolation during the atomistic sub-steps
+	void Multirate_Save_Start(void) {}
+	void Multirate_Save_End(void) {}
+	void Multirate_Interpolate(double fraction) {}
+	void Multirate_Restore_Heff(void) {}
+
 	//---------------------------------------- OTHER CALCULATION METHODS : DiffEqFM_SEquations.cpp
 
 	//called when using stochastic equations
@@ -418,6 +489,10 @@ public:
 	//switch CUDA state on/off
 	BError SwitchCUDAState(bool cudaState) { return BError(); }
 
+	//---------------------------------------- BENCHMARKS : DiffEqAFM.cpp
+
+	BError Benchmark_Equation(int repeats, bool generic, double& throughput) { return BError(); }
+
 	//---------------------------------------- GETTERS
 
 	//return dM by dT - should only be used when evaluation sequence has ended (TimeStepSolved() == true)
@@ -256,6 +256,19 @@ BError DifferentialEquationAFMCUDA::AllocateMemory(bool copy_from_cpu)
 		else if (copy_from_cpu) sEval6_2()->copy_from_cpuvec(dynamic_cast<DifferentialEquationAFM*>(pmeshODE)->sEval6_2);
 		break;
 
+	//low-storage RK methods are only available on the CPU
+	case EVAL_LSRK4:
+	case EVAL_LSRK43:
+		return error(BERROR_NOTAVAILABLE);
+
+	//IMEX method is only available on the CPU
+	case EVAL_IMEX:
+		return error(BERROR_NOTAVAILABLE);
+
+	//nonlinear conjugate gradient minimizer is only available on the CPU
+	case EVAL_NCG:
+		return error(BERROR_NOTAVAILABLE);
+
 	case EVAL_SD:
 		if (!sEval0()->resize((cuSZ3)pMesh->n)) return error(BERROR_OUTOFGPUMEMORY_CRIT);
 		else if (copy_from_cpu) sEval0()->copy_from_cpuvec(pmeshODE->sEval0);
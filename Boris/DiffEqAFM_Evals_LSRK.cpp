@@ -0,0 +1,252 @@
+#include "stdafx.h"
+#include "DiffEqAFM.h"
+
+#ifdef MESH_COMPILATION_ANTIFERROMAGNETIC
+#ifdef ODE_EVAL_COMPILATION_LSRK
+
+#include "Mesh_AntiFerromagnetic.h"
+#include "SuperMesh.h"
+#include "MeshParamsControl.h"
+#include "DiffEqAFM_Equations.h"
+
+//--------------------------------------------- LOW-STORAGE RUNGE KUTTA (2N storage, 4th order solution, 3rd order embedded error for LSRK43)
+
+//sEval0, sEval0_2 are the 2N registers (dM, dM2), sEval1 accumulates the error estimate for sub-lattice A (adaptive method only). Magnetization is advanced in place at every stage.
+
+void DifferentialEquationAFM::RunLSRK_Step0_withReductions(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		mxh_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization for later use
+				sM1[idx] = pMesh->M[idx];
+				sM1_2[idx] = pMesh->M2[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					//obtain maximum normalized torque term
+					double Mnorm = pMesh->M[idx].norm();
+					double _mxh = GetMagnitude(pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm);
+					mxh_reduction.reduce_max(_mxh);
+
+					//First evaluate RHS of set equation at the current time step
+					DBL3 rhs = equation_rhs(idx) * dT;
+					DBL3 rhs_2 = Equation_Eval_2[omp_get_thread_num()] * dT;
+
+					//first stage : lsrk_A[0] is zero so register is just set
+					sEval0[idx] = rhs;
+					sEval0_2[idx] = rhs_2;
+					if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+					pMesh->M[idx] += lsrk_B[0] * sEval0[idx];
+					pMesh->M2[idx] += lsrk_B[0] * sEval0_2[idx];
+				}
+			}
+		}
+
+		if (pMesh->grel.get0()) {
+
+			//only reduce for mxh if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+			mxh_reduction.maximum();
+		}
+		else {
+
+			mxh_reduction.max = 0.0;
+		}
+	});
+}
+
+void DifferentialEquationAFM::RunLSRK_Step0(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization for later use
+				sM1[idx] = pMesh->M[idx];
+				sM1_2[idx] = pMesh->M2[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					//First evaluate RHS of set equation at the current time step
+					DBL3 rhs = equation_rhs(idx) * dT;
+					DBL3 rhs_2 = Equation_Eval_2[omp_get_thread_num()] * dT;
+
+					//first stage : lsrk_A[0] is zero so register is just set
+					sEval0[idx] = rhs;
+					sEval0_2[idx] = rhs_2;
+					if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+					pMesh->M[idx] += lsrk_B[0] * sEval0[idx];
+					pMesh->M2[idx] += lsrk_B[0] * sEval0_2[idx];
+				}
+			}
+		}
+	});
+}
+
+void DifferentialEquationAFM::RunLSRK_Step(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		//intermediate stage coefficients
+		double A = lsrk_A[evalStep], B = lsrk_B[evalStep], E = lsrk_E[evalStep];
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+				DBL3 rhs = equation_rhs(idx) * dT;
+				DBL3 rhs_2 = Equation_Eval_2[omp_get_thread_num()] * dT;
+
+				sEval0[idx] = A * sEval0[idx] + rhs;
+				sEval0_2[idx] = A * sEval0_2[idx] + rhs_2;
+				if (adaptive) sEval1[idx] += E * rhs;
+
+				pMesh->M[idx] += B * sEval0[idx];
+				pMesh->M2[idx] += B * sEval0_2[idx];
+			}
+		}
+	});
+}
+
+void DifferentialEquationAFM::RunLSRK_Step4_withReductions(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		dmdt_reduction.new_minmax_reduction();
+		if (adaptive) lte_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					DBL3 rhs = equation_rhs(idx) * dT;
+					DBL3 rhs_2 = Equation_Eval_2[omp_get_thread_num()] * dT;
+
+					//last stage : 4th order evaluation
+					sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+					sEval0_2[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0_2[idx] + rhs_2;
+					pMesh->M[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+					pMesh->M2[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0_2[idx];
+
+					if (adaptive) {
+
+						//local truncation error (difference between 4th and 3rd order evaluations)
+						double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / pMesh->M[idx].norm();
+						lte_reduction.reduce_max(_lte);
+					}
+
+					if (renormalize) {
+
+						DBL2 Ms_AFM = pMesh->Ms_AFM;
+						pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+						pMesh->M[idx].renormalize(Ms_AFM.i);
+						pMesh->M2[idx].renormalize(Ms_AFM.j);
+					}
+
+					//obtained maximum dmdt term
+					double Mnorm = pMesh->M[idx].norm();
+					double _dmdt = GetMagnitude(pMesh->M[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * Mnorm);
+					dmdt_reduction.reduce_max(_dmdt);
+				}
+				else {
+
+					DBL2 Ms_AFM = pMesh->Ms_AFM;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+					pMesh->M[idx].renormalize(Ms_AFM.i);
+					pMesh->M2[idx].renormalize(Ms_AFM.j);
+				}
+			}
+		}
+
+		if (pMesh->grel.get0()) {
+
+			//only reduce for dmdt if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+			dmdt_reduction.maximum();
+		}
+		else {
+
+			dmdt_reduction.max = 0.0;
+		}
+
+		if (adaptive) lte_reduction.maximum();
+	});
+}
+
+void DifferentialEquationAFM::RunLSRK_Step4(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		if (adaptive) lte_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					DBL3 rhs = equation_rhs(idx) * dT;
+					DBL3 rhs_2 = Equation_Eval_2[omp_get_thread_num()] * dT;
+
+					//last stage : 4th order evaluation
+					sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+					sEval0_2[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0_2[idx] + rhs_2;
+					pMesh->M[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+					pMesh->M2[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0_2[idx];
+
+					if (adaptive) {
+
+						//local truncation error (difference between 4th and 3rd order evaluations)
+						double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / pMesh->M[idx].norm();
+						lte_reduction.reduce_max(_lte);
+					}
+
+					if (renormalize) {
+
+						DBL2 Ms_AFM = pMesh->Ms_AFM;
+						pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+						pMesh->M[idx].renormalize(Ms_AFM.i);
+						pMesh->M2[idx].renormalize(Ms_AFM.j);
+					}
+				}
+				else {
+
+					DBL2 Ms_AFM = pMesh->Ms_AFM;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+					pMesh->M[idx].renormalize(Ms_AFM.i);
+					pMesh->M2[idx].renormalize(Ms_AFM.j);
+				}
+			}
+		}
+
+		if (adaptive) lte_reduction.maximum();
+	});
+}
+
+#endif
+#endif
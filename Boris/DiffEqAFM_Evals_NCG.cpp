@@ -0,0 +1,253 @@
+#include "stdafx.h"
+#include "DiffEqAFM.h"
+
+#ifdef MESH_COMPILATION_ANTIFERROMAGNETIC
+#ifdef ODE_EVAL_COMPILATION_NCG
+
+#include "Mesh_AntiFerromagnetic.h"
+#include "SuperMesh.h"
+#include "MeshParamsControl.h"
+
+//Nonlinear conjugate gradient solver (Polak-Ribiere+) on the product of unit spheres.
+//The steepest descent direction is the tangential field D = (gamma/2) * grel * (H - (H.m)m), same scaling as for the SD solver so dT has the same meaning.
+//The previous search direction is transported to the current point by projection on the tangent plane, and magnetization is moved along the search direction followed by renormalization (retraction).
+//Line search uses the directional derivative to choose the step, and the total energy density to check the accepted step decreases the energy (else backtrack along the steepest descent direction).
+//Both sub-lattices are included in the same search direction.
+
+//sEval0, sEval0_2 : steepest descent direction at the line search start point, sEval1, sEval1_2 : search direction, sM1, sM1_2 : normalized magnetization at the line search start point
+
+//--------------------------------------------- Nonlinear Conjugate Gradient Solver
+
+//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities
+void DifferentialEquationAFM::RunNCG_Reductions(void)
+{
+	double _ncg_DD = 0.0;
+	double _ncg_DDprev = 0.0;
+	double _ncg_Ddir = 0.0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) minimizer_reduction.new_sum_reduction(pMesh->n.dim());
+
+#pragma omp parallel for reduction(+:_ncg_DD, _ncg_DDprev, _ncg_Ddir)
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			DBL2 Ms_AFM = pMesh->Ms_AFM;
+			DBL2 grel_AFM = pMesh->grel_AFM;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM, pMesh->grel_AFM, grel_AFM);
+
+			DBL3 m = pMesh->M[idx] / Ms_AFM.i;
+			DBL3 H = pMesh->Heff[idx];
+
+			DBL3 m2 = pMesh->M2[idx] / Ms_AFM.j;
+			DBL3 H2 = pMesh->Heff2[idx];
+
+			//steepest descent direction
+			DBL3 D = (GAMMA / 2) * grel_AFM.i * (H - (H * m) * m);
+			DBL3 D2 = (GAMMA / 2) * grel_AFM.i * (H2 - (H2 * m2) * m2);
+
+			//search direction transported to current point
+			DBL3 d = sEval1[idx] - (sEval1[idx] * m) * m;
+			DBL3 d2 = sEval1_2[idx] - (sEval1_2[idx] * m2) * m2;
+
+			if (deterministic) minimizer_reduction.reduce_sum(DBL3(D * D + D2 * D2, D * sEval0[idx] + D2 * sEval0_2[idx], D * d + D2 * d2), idx);
+			else {
+
+				_ncg_DD += D * D + D2 * D2;
+				_ncg_DDprev += D * sEval0[idx] + D2 * sEval0_2[idx];
+				_ncg_Ddir += D * d + D2 * d2;
+			}
+		}
+	}
+
+	if (deterministic) {
+
+		DBL3 sums = minimizer_reduction.sum();
+		_ncg_DD = sums.x;
+		_ncg_DDprev = sums.y;
+		_ncg_Ddir = sums.z;
+	}
+
+	//accumulate across all meshes -> remember these should have been set to zero before starting a run across all meshes
+	ncg_DD += _ncg_DD;
+	ncg_DDprev += _ncg_DDprev;
+	ncg_Ddir += _ncg_Ddir;
+}
+
+//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+void DifferentialEquationAFM::RunNCG_LineSearch(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			DBL2 Ms_AFM = pMesh->Ms_AFM;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+
+			pMesh->M[idx] = (sM1[idx] + dT * sEval1[idx]) * Ms_AFM.i;
+			pMesh->M2[idx] = (sM1_2[idx] + dT * sEval1_2[idx]) * Ms_AFM.j;
+
+			pMesh->M[idx].renormalize(Ms_AFM.i);
+			pMesh->M2[idx].renormalize(Ms_AFM.j);
+		}
+	}
+}
+
+//2b. line search failed : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+void DifferentialEquationAFM::RunNCG_Restart(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			DBL2 Ms_AFM = pMesh->Ms_AFM;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+
+			sEval1[idx] = sEval0[idx];
+			sEval1_2[idx] = sEval0_2[idx];
+
+			pMesh->M[idx] = (sM1[idx] + dT * sEval1[idx]) * Ms_AFM.i;
+			pMesh->M2[idx] = (sM1_2[idx] + dT * sEval1_2[idx]) * Ms_AFM.j;
+
+			pMesh->M[idx].renormalize(Ms_AFM.i);
+			pMesh->M2[idx].renormalize(Ms_AFM.j);
+		}
+	}
+}
+
+//3. start new line search from the current magnetization
+void DifferentialEquationAFM::RunNCG_Direction_withReductions(void)
+{
+	mxh_reduction.new_minmax_reduction();
+	if (calculate_dmdt) dmdt_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				DBL2 Ms_AFM = pMesh->Ms_AFM;
+				DBL2 grel_AFM = pMesh->grel_AFM;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM, pMesh->grel_AFM, grel_AFM);
+
+				DBL3 m = pMesh->M[idx] / Ms_AFM.i;
+				DBL3 H = pMesh->Heff[idx];
+
+				DBL3 m2 = pMesh->M2[idx] / Ms_AFM.j;
+				DBL3 H2 = pMesh->Heff2[idx];
+
+				//obtained maximum normalized torque term
+				if (IsNZ(grel_AFM.i)) {
+
+					double _mxh = GetMagnitude(m ^ H) / pMesh->M[idx].norm();
+					mxh_reduction.reduce_max(_mxh);
+				}
+
+				//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+				DBL3 D = (GAMMA / 2) * grel_AFM.i * (H - (H * m) * m);
+				DBL3 D2 = (GAMMA / 2) * grel_AFM.i * (H2 - (H2 * m2) * m2);
+
+				DBL3 d = D, d2 = D2;
+				if (ncg_beta) {
+
+					d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+					d2 += ncg_beta * (sEval1_2[idx] - (sEval1_2[idx] * m2) * m2);
+				}
+
+				sEval0[idx] = D;
+				sEval0_2[idx] = D2;
+				sEval1[idx] = d;
+				sEval1_2[idx] = d2;
+				sM1[idx] = m;
+				sM1_2[idx] = m2;
+
+				//trial step along search direction
+				pMesh->M[idx] = (m + dT * d) * Ms_AFM.i;
+				pMesh->M2[idx] = (m2 + dT * d2) * Ms_AFM.j;
+
+				pMesh->M[idx].renormalize(Ms_AFM.i);
+				pMesh->M2[idx].renormalize(Ms_AFM.j);
+
+				if (calculate_dmdt && IsNZ(grel_AFM.i)) {
+
+					//obtained maximum dmdt term
+					double _dmdt = GetMagnitude(pMesh->M[idx] / Ms_AFM.i - m) / (dT * GAMMA * grel_AFM.i * Ms_AFM.i);
+					dmdt_reduction.reduce_max(_dmdt);
+				}
+			}
+			else {
+
+				DBL2 Ms_AFM = pMesh->Ms_AFM;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+				pMesh->M[idx].renormalize(Ms_AFM.i);
+				pMesh->M2[idx].renormalize(Ms_AFM.j);
+			}
+		}
+	}
+
+	mxh_reduction.maximum();
+	if (calculate_dmdt) dmdt_reduction.maximum();
+}
+
+void DifferentialEquationAFM::RunNCG_Direction(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				DBL2 Ms_AFM = pMesh->Ms_AFM;
+				DBL2 grel_AFM = pMesh->grel_AFM;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM, pMesh->grel_AFM, grel_AFM);
+
+				DBL3 m = pMesh->M[idx] / Ms_AFM.i;
+				DBL3 H = pMesh->Heff[idx];
+
+				DBL3 m2 = pMesh->M2[idx] / Ms_AFM.j;
+				DBL3 H2 = pMesh->Heff2[idx];
+
+				//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+				DBL3 D = (GAMMA / 2) * grel_AFM.i * (H - (H * m) * m);
+				DBL3 D2 = (GAMMA / 2) * grel_AFM.i * (H2 - (H2 * m2) * m2);
+
+				DBL3 d = D, d2 = D2;
+				if (ncg_beta) {
+
+					d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+					d2 += ncg_beta * (sEval1_2[idx] - (sEval1_2[idx] * m2) * m2);
+				}
+
+				sEval0[idx] = D;
+				sEval0_2[idx] = D2;
+				sEval1[idx] = d;
+				sEval1_2[idx] = d2;
+				sM1[idx] = m;
+				sM1_2[idx] = m2;
+
+				//trial step along search direction
+				pMesh->M[idx] = (m + dT * d) * Ms_AFM.i;
+				pMesh->M2[idx] = (m2 + dT * d2) * Ms_AFM.j;
+
+				pMesh->M[idx].renormalize(Ms_AFM.i);
+				pMesh->M2[idx].renormalize(Ms_AFM.j);
+			}
+			else {
+
+				DBL2 Ms_AFM = pMesh->Ms_AFM;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms_AFM, Ms_AFM);
+				pMesh->M[idx].renormalize(Ms_AFM.i);
+				pMesh->M2[idx].renormalize(Ms_AFM.j);
+			}
+		}
+	}
+}
+
+#endif
+#endif
@@ -5,6 +5,7 @@
 
 #include "Mesh_Ferromagnetic.h"
 #include "MeshParamsControl.h"
+#include "DiffEqFM_Equations.h"
 
 DifferentialEquationFM::DifferentialEquationFM(FMesh *pMesh):
 	DifferentialEquation(pMesh)
@@ -59,6 +60,53 @@ void DifferentialEquationFM::RenormalizeMagnetization(void)
 	}
 }
 
+//multi-rate stepping : save magnetization at start of the micromagnetic time step
+void DifferentialEquationFM::Multirate_Save_Start(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++)
+		sM_mr_start[idx] = pMesh->M[idx];
+}
+
+//multi-rate stepping : save magnetization at end of the micromagnetic time step, and the effective field from its last evaluation
+void DifferentialEquationFM::Multirate_Save_End(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		sM_mr_end[idx] = pMesh->M[idx];
+		sHeff_mr[idx] = pMesh->Heff[idx];
+	}
+}
+
+//multi-rate stepping : restore effective field saved by Multirate_Save_End
+void DifferentialEquationFM::Multirate_Restore_Heff(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++)
+		pMesh->Heff[idx] = sHeff_mr[idx];
+}
+
+//multi-rate stepping : set magnetization by linear interpolation between start and end of the micromagnetic time step (fraction from 0 to 1)
+void DifferentialEquationFM::Multirate_Interpolate(double fraction)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			pMesh->M[idx] = sM_mr_start[idx] + (sM_mr_end[idx] - sM_mr_start[idx]) * fraction;
+
+			if (renormalize) {
+
+				double Ms = pMesh->Ms;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+				pMesh->M[idx].renormalize(Ms);
+			}
+		}
+	}
+}
+
 //---------------------------------------- SET-UP METHODS
 
 BError DifferentialEquationFM::AllocateMemory(void)
@@ -131,9 +179,39 @@ BError DifferentialEquationFM::AllocateMemory(void)
 		if (!sEval6.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
 
+	case EVAL_LSRK4:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+	case EVAL_LSRK43:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
 	case EVAL_SD:
 		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 		break;
+
+	case EVAL_NCG:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sEval1.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+
+#ifdef ODE_EVAL_COMPILATION_IMEX
+	case EVAL_IMEX:
+		if (!sEval0.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!imex_dM.resize(pMesh->h, pMesh->meshRect, pMesh->M)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!imex_diag.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		break;
+#endif
+	}
+
+	//multi-rate stepping : micromagnetic magnetization at start and end of time step, used for interpolation during atomistic sub-steps
+	if (multirate_subcycles > 1) {
+
+		if (!sM_mr_start.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sM_mr_end.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
+		if (!sHeff_mr.resize(pMesh->n)) return error(BERROR_OUTOFMEMORY_CRIT);
 	}
 
 	//For stochastic equations must also allocate memory for thermal VECs
@@ -154,6 +232,10 @@ BError DifferentialEquationFM::AllocateMemory(void)
 		break;
 	}
 
+	//seed the thermal field generator : if prng_seed > 0 the same sequence is generated every time, else use the system tick count
+	if (H_Thermal.linear_size()) prng.seed(pMesh->prng_seed == 0 ? GetSystemTickCount() : pMesh->prng_seed);
+	thermal_linked = (H_Thermal.linear_size() && H_Thermal.n == pMesh->n);
+
 	//----------------------- CUDA mirroring
 
 #if COMPILECUDA == 1
@@ -178,18 +260,32 @@ void DifferentialEquationFM::CleanupMemory(void)
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKDP54 &&
 		evalMethod != EVAL_RKF56 &&
-		evalMethod != EVAL_SD) {
+		evalMethod != EVAL_LSRK4 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_SD &&
+		evalMethod != EVAL_NCG &&
+		evalMethod != EVAL_IMEX) {
 
 		sEval0.clear();
 	}
 
+#ifdef ODE_EVAL_COMPILATION_IMEX
+	if (evalMethod != EVAL_IMEX) {
+
+		imex_dM.clear();
+		imex_diag.clear();
+	}
+#endif
+
 	if (evalMethod != EVAL_RK4 &&
 		evalMethod != EVAL_ABM &&
 		evalMethod != EVAL_RK23 &&
 		evalMethod != EVAL_RKF45 &&
 		evalMethod != EVAL_RKCK45 &&
 		evalMethod != EVAL_RKDP54 &&
-		evalMethod != EVAL_RKF56) {
+		evalMethod != EVAL_RKF56 &&
+		evalMethod != EVAL_LSRK43 &&
+		evalMethod != EVAL_NCG) {
 
 		sEval1.clear();
 	}
@@ -225,6 +321,13 @@ void DifferentialEquationFM::CleanupMemory(void)
 		sEval6.clear();
 	}
 
+	if (multirate_subcycles <= 1) {
+
+		sM_mr_start.clear();
+		sM_mr_end.clear();
+		sHeff_mr.clear();
+	}
+
 	//For thermal vecs only clear if not used for current set ODE
 	if (setODE != ODE_SLLG &&
 		setODE != ODE_SLLGSTT &&
@@ -254,6 +357,9 @@ BError DifferentialEquationFM::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
 {
 	BError error(CLASS_STR(DifferentialEquationFM));
 
+	//parameters, temperature or mesh may have changed : thermal VECs prefactors must be recalculated
+	thermal_prefactors_valid = false;
+
 	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_MESHCHANGE, UPDATECONFIG_ODE_SOLVER)) {
 
 		if (pMesh->link_stochastic) {
@@ -273,6 +379,20 @@ BError DifferentialEquationFM::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
 		error = AllocateMemory();
 	}
 
+	//prng seed changed : restart the thermal field generator from the new seed at step 0 (also done when thermal VECs are allocated)
+	if (ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_PRNG)) {
+
+		if (H_Thermal.linear_size()) prng.seed(pMesh->prng_seed == 0 ? GetSystemTickCount() : pMesh->prng_seed);
+	}
+
+#ifdef ODE_EVAL_COMPILATION_IMEX
+	//IMEX solver must have same shape as M (resizing with M as linked VEC also sets shape)
+	if (imex_dM.linear_size() && ucfg::check_cfgflags(cfgMessage, UPDATECONFIG_MESHSHAPECHANGE)) {
+
+		if (!imex_dM.resize(pMesh->h, pMesh->meshRect, pMesh->M)) error(BERROR_OUTOFMEMORY_CRIT);
+	}
+#endif
+
 	if (cfgMessage == UPDATECONFIG_PARAMVALUECHANGED_MLENGTH) RenormalizeMagnetization();
 
 	//----------------------- CUDA mirroring
@@ -315,6 +435,55 @@ BError DifferentialEquationFM::SwitchCUDAState(bool cudaState)
 	return error;
 }
 
+//---------------------------------------- BENCHMARKS
+
+BError DifferentialEquationFM::Benchmark_Equation(int repeats, bool generic, double& throughput)
+{
+	BError error(__FUNCTION__);
+
+	throughput = 0.0;
+	if (!sM1.linear_size() || repeats < 1) return error(BERROR_INCORRECTACTION);
+
+	//updated magnetization written here
+	std::vector<DBL3> M_new;
+	if (!malloc_vector(M_new, pMesh->n.dim())) return error(BERROR_OUTOFMEMORY_NCRIT);
+
+	auto euler_pass = [&](auto equation_rhs) {
+
+		mxh_av_reduction.new_average_reduction(pMesh->n.dim());
+		dmdt_av_reduction.new_average_reduction(pMesh->n.dim());
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+				double Mnorm = pMesh->M[idx].norm();
+				mxh_av_reduction.reduce_average((pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm), idx);
+
+				M_new[idx] = pMesh->M[idx] + equation_rhs(idx) * dT;
+
+				dmdt_av_reduction.reduce_average((M_new[idx] - pMesh->M[idx]) / (dT * GAMMA * Mnorm * Mnorm), idx);
+			}
+		}
+	};
+
+	int eqkernel = (generic ? (int)EQKERNEL_GENERIC : equation_kernel);
+
+	//first pass not timed
+	Dispatch_Equation(euler_pass, eqkernel);
+
+	unsigned int start_ms = GetSystemTickCount();
+
+	for (int r = 0; r < repeats; r++) Dispatch_Equation(euler_pass, eqkernel);
+
+	double time_s = (double)(GetSystemTickCount() - start_ms) / 1000;
+
+	if (time_s > 0.0) throughput = (double)pMesh->M.get_nonempty_cells() * repeats / (time_s * omp_get_max_threads());
+
+	return error;
+}
+
 //---------------------------------------- GETTERS
 
 //return dM by dT - should only be used when evaluation sequence has ended (TimeStepSolved() == true)
@@ -158,6 +158,19 @@ BError DifferentialEquationFMCUDA::AllocateMemory(bool copy_from_cpu)
 		else if (copy_from_cpu) sEval6()->copy_from_cpuvec(pmeshODE->sEval6);
 		break;
 
+	//low-storage RK methods are only available on the CPU
+	case EVAL_LSRK4:
+	case EVAL_LSRK43:
+		return error(BERROR_NOTAVAILABLE);
+
+	//IMEX method is only available on the CPU
+	case EVAL_IMEX:
+		return error(BERROR_NOTAVAILABLE);
+
+	//nonlinear conjugate gradient minimizer is only available on the CPU
+	case EVAL_NCG:
+		return error(BERROR_NOTAVAILABLE);
+
 	case EVAL_SD:
 		if (!sEval0()->resize((cuSZ3)pMesh->n)) return error(BERROR_OUTOFGPUMEMORY_CRIT);
 		else if (copy_from_cpu) sEval0()->copy_from_cpuvec(pmeshODE->sEval0);
@@ -0,0 +1,227 @@
+#include "stdafx.h"
+#include "DiffEqFM.h"
+
+#ifdef MESH_COMPILATION_FERROMAGNETIC
+#ifdef ODE_EVAL_COMPILATION_IMEX
+
+#include "Mesh_Ferromagnetic.h"
+#include "SuperMesh.h"
+#include "MeshParamsControl.h"
+#include "DiffEqFM_Equations.h"
+
+//--------------------------------------------- IMEX EULER
+
+//Implicit-explicit Euler with linearly implicit exchange stabilization :
+//(I - dT * sigma * delsq) dM = dT * rhs(M), M_next = M + dM, then renormalize.
+//rhs(M) is the full equation evaluated explicitly (exchange, demag and all other fields), so the method is consistent for any sigma, and first order.
+//The implicit term damps the high wavenumber exchange modes which limit the time step of explicit methods for cellsizes well below the exchange length.
+//For the LLG equation linearized about a uniform state the exchange term is M x (c * delsq M) + alpha * m x (M x (c * delsq M)), scaled by -gamma / (1 + alpha^2), with c = 2A / (mu0 Ms^2).
+//The explicit Euler step for this linear problem is unconditionally stable if sigma >= gamma * Ms * c / (2 * alpha) = gamma * A / (mu0 * Ms * alpha) (with grel included).
+//Accuracy : the implicit term adds an artificial exchange diffusion, with an error of order dT * sigma / l^2 relative to the magnetization change for features of length l.
+//Since sigma scales as 1 / alpha (alpha floored at IMEX_MINALPHA), at low damping the time step must be small enough for dT * sigma << l^2 to obtain accurate dynamics : the method is intended for relaxation or strongly damped dynamics.
+//For LLGStatic (no precession) alpha = 1 is used. The implicit system is solved with the VEC_VC SOR solver (homogeneous Neumann boundary conditions), starting from the previous solution.
+
+void DifferentialEquationFM::RunIMEX_Solve(void)
+{
+	//only exchange type modules make the equation stiff : if not set the implicit system is not needed.
+	if (!pMesh->IsModuleSet(MOD_EXCHANGE) && !pMesh->IsModuleSet(MOD_DMEXCHANGE) && !pMesh->IsModuleSet(MOD_IDMEXCHANGE) && !pMesh->IsModuleSet(MOD_VIDMEXCHANGE)) {
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			imex_dM[idx] = sEval0[idx];
+		}
+
+		return;
+	}
+
+	bool static_equation = (setODE == ODE_LLGSTATIC || setODE == ODE_LLGSTATICSA);
+
+	//lower limit for dT * sigma, so cells with no exchange stabilization (e.g. grel = 0) don't result in a division by zero : with this value imex_dM = sEval0 to within 1e-6 in these cells
+	double h_min = minimum(pMesh->h.x, pMesh->h.y, pMesh->h.z);
+	double dTsigma_min = 1e-6 * h_min * h_min;
+
+	//1. set 1 / (dT * sigma) in each cell
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			double Ms = pMesh->Ms;
+			double A = pMesh->A;
+			double alpha = pMesh->alpha;
+			double grel = pMesh->grel;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms, pMesh->A, A, pMesh->alpha, alpha, pMesh->grel, grel);
+
+			if (static_equation) alpha = 1.0;
+			else if (alpha < IMEX_MINALPHA) alpha = IMEX_MINALPHA;
+
+			double dTsigma = 0.0;
+			if (IsNZ(Ms)) dTsigma = dT * GAMMA * grel * A / (MU0 * Ms * alpha);
+			if (dTsigma < dTsigma_min) dTsigma = dTsigma_min;
+
+			imex_diag[idx] = 1.0 / dTsigma;
+		}
+		else imex_diag[idx] = 0.0;
+	}
+
+	//2. SOR relaxation parameter : optimal value for the red-black ordering using the Jacobi spectral radius of the constant coefficient system (with base parameter values)
+	double h_max_sq = maximum(pMesh->h.x, pMesh->h.y, pMesh->h.z);
+	h_max_sq *= h_max_sq;
+	double weights = 2 * h_max_sq * (1.0 / (pMesh->h.x * pMesh->h.x) + 1.0 / (pMesh->h.y * pMesh->h.y) + 1.0 / (pMesh->h.z * pMesh->h.z));
+
+	double alpha0 = (static_equation ? 1.0 : maximum(pMesh->alpha.get0(), IMEX_MINALPHA));
+	double dTsigma0 = dTsigma_min;
+	if (IsNZ(pMesh->Ms.get0())) dTsigma0 = maximum(dT * GAMMA * pMesh->grel.get0() * pMesh->A.get0() / (MU0 * pMesh->Ms.get0() * alpha0), dTsigma_min);
+
+	double rho = weights / (weights + h_max_sq / dTsigma0);
+	double relaxation_param = 2.0 / (1.0 + sqrt(1.0 - rho * rho));
+
+	//3. solve
+	for (int iter = 0; iter < IMEX_SOLVER_MAXITERS; iter++) {
+
+		DBL2 error = imex_dM.IteratePoisson_SOR<DifferentialEquationFM, double>(&DifferentialEquationFM::IMEX_Solve_RHS, &DifferentialEquationFM::IMEX_Solve_Diagonal, *this, relaxation_param);
+
+		if (error.j == 0.0 || error.i / error.j < IMEX_SOLVER_MAXERROR) break;
+	}
+}
+
+void DifferentialEquationFM::RunIMEX_withReductions(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		mxh_reduction.new_minmax_reduction();
+
+		//1. explicit change
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization
+				sM1[idx] = pMesh->M[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					//obtain maximum normalized torque term
+					double Mnorm = pMesh->M[idx].norm();
+					double _mxh = GetMagnitude(pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm);
+					mxh_reduction.reduce_max(_mxh);
+
+					sEval0[idx] = equation_rhs(idx) * dT;
+				}
+				else sEval0[idx] = DBL3();
+			}
+			else sEval0[idx] = DBL3();
+		}
+
+		if (pMesh->grel.get0()) {
+
+			//only reduce for mxh if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+			mxh_reduction.maximum();
+		}
+		else {
+
+			mxh_reduction.max = 0.0;
+		}
+	});
+
+	//2. implicit exchange stabilization
+	RunIMEX_Solve();
+
+	//3. new magnetization
+	dmdt_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				pMesh->M[idx] = sM1[idx] + imex_dM[idx];
+
+				if (renormalize) {
+
+					double Ms = pMesh->Ms;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+					pMesh->M[idx].renormalize(Ms);
+				}
+
+				//obtained maximum dmdt term
+				double Mnorm = pMesh->M[idx].norm();
+				double _dmdt = GetMagnitude(pMesh->M[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * Mnorm);
+				dmdt_reduction.reduce_max(_dmdt);
+			}
+			else {
+
+				double Ms = pMesh->Ms;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+				pMesh->M[idx].renormalize(Ms);
+			}
+		}
+	}
+
+	if (pMesh->grel.get0()) {
+
+		//only reduce for dmdt if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+		dmdt_reduction.maximum();
+	}
+	else {
+
+		dmdt_reduction.max = 0.0;
+	}
+}
+
+void DifferentialEquationFM::RunIMEX(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		//1. explicit change
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization
+				sM1[idx] = pMesh->M[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) sEval0[idx] = equation_rhs(idx) * dT;
+				else sEval0[idx] = DBL3();
+			}
+			else sEval0[idx] = DBL3();
+		}
+	});
+
+	//2. implicit exchange stabilization
+	RunIMEX_Solve();
+
+	//3. new magnetization
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				pMesh->M[idx] = sM1[idx] + imex_dM[idx];
+
+				if (renormalize) {
+
+					double Ms = pMesh->Ms;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+					pMesh->M[idx].renormalize(Ms);
+				}
+			}
+			else {
+
+				double Ms = pMesh->Ms;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+				pMesh->M[idx].renormalize(Ms);
+			}
+		}
+	}
+}
+
+#endif
+#endif
@@ -0,0 +1,231 @@
+#include "stdafx.h"
+#include "DiffEqFM.h"
+
+#ifdef MESH_COMPILATION_FERROMAGNETIC
+#ifdef ODE_EVAL_COMPILATION_LSRK
+
+#include "Mesh_Ferromagnetic.h"
+#include "SuperMesh.h"
+#include "MeshParamsControl.h"
+#include "DiffEqFM_Equations.h"
+
+//--------------------------------------------- LOW-STORAGE RUNGE KUTTA (2N storage, 4th order solution, 3rd order embedded error for LSRK43)
+
+//sEval0 is the 2N register (dM), sEval1 accumulates the error estimate (adaptive method only). Magnetization is advanced in place at every stage.
+
+void DifferentialEquationFM::RunLSRK_Step0_withReductions(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		mxh_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization for later use
+				sM1[idx] = pMesh->M[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					//obtain maximum normalized torque term
+					double Mnorm = pMesh->M[idx].norm();
+					double _mxh = GetMagnitude(pMesh->M[idx] ^ pMesh->Heff[idx]) / (Mnorm * Mnorm);
+					mxh_reduction.reduce_max(_mxh);
+
+					//First evaluate RHS of set equation at the current time step
+					DBL3 rhs = equation_rhs(idx) * dT;
+
+					//first stage : lsrk_A[0] is zero so register is just set
+					sEval0[idx] = rhs;
+					if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+					pMesh->M[idx] += lsrk_B[0] * sEval0[idx];
+				}
+			}
+		}
+
+		if (pMesh->grel.get0()) {
+
+			//only reduce for mxh if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+			mxh_reduction.maximum();
+		}
+		else {
+
+			mxh_reduction.max = 0.0;
+		}
+	});
+}
+
+void DifferentialEquationFM::RunLSRK_Step0(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				//Save current magnetization for later use
+				sM1[idx] = pMesh->M[idx];
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					//First evaluate RHS of set equation at the current time step
+					DBL3 rhs = equation_rhs(idx) * dT;
+
+					//first stage : lsrk_A[0] is zero so register is just set
+					sEval0[idx] = rhs;
+					if (adaptive) sEval1[idx] = lsrk_E[0] * rhs;
+
+					pMesh->M[idx] += lsrk_B[0] * sEval0[idx];
+				}
+			}
+		}
+	});
+}
+
+void DifferentialEquationFM::RunLSRK_Step(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		//intermediate stage coefficients
+		double A = lsrk_A[evalStep], B = lsrk_B[evalStep], E = lsrk_E[evalStep];
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+				DBL3 rhs = equation_rhs(idx) * dT;
+
+				sEval0[idx] = A * sEval0[idx] + rhs;
+				if (adaptive) sEval1[idx] += E * rhs;
+
+				pMesh->M[idx] += B * sEval0[idx];
+			}
+		}
+	});
+}
+
+void DifferentialEquationFM::RunLSRK_Step4_withReductions(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		dmdt_reduction.new_minmax_reduction();
+		if (adaptive) lte_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					DBL3 rhs = equation_rhs(idx) * dT;
+
+					//last stage : 4th order evaluation
+					sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+					pMesh->M[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+
+					if (adaptive) {
+
+						//local truncation error (difference between 4th and 3rd order evaluations)
+						double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / pMesh->M[idx].norm();
+						lte_reduction.reduce_max(_lte);
+					}
+
+					if (renormalize) {
+
+						double Ms = pMesh->Ms;
+						pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+						pMesh->M[idx].renormalize(Ms);
+					}
+
+					//obtained maximum dmdt term
+					double Mnorm = pMesh->M[idx].norm();
+					double _dmdt = GetMagnitude(pMesh->M[idx] - sM1[idx]) / (dT * GAMMA * Mnorm * Mnorm);
+					dmdt_reduction.reduce_max(_dmdt);
+				}
+				else {
+
+					double Ms = pMesh->Ms;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+					pMesh->M[idx].renormalize(Ms);
+				}
+			}
+		}
+
+		if (pMesh->grel.get0()) {
+
+			//only reduce for dmdt if grel is not zero (if it's zero this means magnetization dynamics are disabled in this mesh)
+			dmdt_reduction.maximum();
+		}
+		else {
+
+			dmdt_reduction.max = 0.0;
+		}
+
+		if (adaptive) lte_reduction.maximum();
+	});
+}
+
+void DifferentialEquationFM::RunLSRK_Step4(void)
+{
+	Dispatch_Equation([&](auto equation_rhs) {
+
+		bool adaptive = (evalMethod == EVAL_LSRK43);
+
+		if (adaptive) lte_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+			if (pMesh->M.is_not_empty(idx)) {
+
+				if (!pMesh->M.is_skipcell(idx)) {
+
+					DBL3 rhs = equation_rhs(idx) * dT;
+
+					//last stage : 4th order evaluation
+					sEval0[idx] = lsrk_A[LSRK_STAGES - 1] * sEval0[idx] + rhs;
+					pMesh->M[idx] += lsrk_B[LSRK_STAGES - 1] * sEval0[idx];
+
+					if (adaptive) {
+
+						//local truncation error (difference between 4th and 3rd order evaluations)
+						double _lte = GetMagnitude(sEval1[idx] + lsrk_E[LSRK_STAGES - 1] * rhs) / pMesh->M[idx].norm();
+						lte_reduction.reduce_max(_lte);
+					}
+
+					if (renormalize) {
+
+						double Ms = pMesh->Ms;
+						pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+						pMesh->M[idx].renormalize(Ms);
+					}
+				}
+				else {
+
+					double Ms = pMesh->Ms;
+					pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+					pMesh->M[idx].renormalize(Ms);
+				}
+			}
+		}
+
+		if (adaptive) lte_reduction.maximum();
+	});
+}
+
+#endif
+#endif
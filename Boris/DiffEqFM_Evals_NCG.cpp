@@ -0,0 +1,210 @@
+#include "stdafx.h"
+#include "DiffEqFM.h"
+
+#ifdef MESH_COMPILATION_FERROMAGNETIC
+#ifdef ODE_EVAL_COMPILATION_NCG
+
+#include "Mesh_Ferromagnetic.h"
+#include "SuperMesh.h"
+#include "MeshParamsControl.h"
+
+//Nonlinear conjugate gradient solver (Polak-Ribiere+) on the product of unit spheres.
+//The steepest descent direction is the tangential field D = (gamma/2) * grel * (H - (H.m)m), same scaling as for the SD solver so dT has the same meaning.
+//The previous search direction is transported to the current point by projection on the tangent plane, and magnetization is moved along the search direction followed by renormalization (retraction).
+//Line search uses the directional derivative to choose the step, and the total energy density to check the accepted step decreases the energy (else backtrack along the steepest descent direction).
+
+//sEval0 : steepest descent direction at the line search start point, sEval1 : search direction, sM1 : normalized magnetization at the line search start point
+
+//--------------------------------------------- Nonlinear Conjugate Gradient Solver
+
+//1. accumulate D.D, D.Dprev and D.d in the static ncg_... quantities
+void DifferentialEquationFM::RunNCG_Reductions(void)
+{
+	double _ncg_DD = 0.0;
+	double _ncg_DDprev = 0.0;
+	double _ncg_Ddir = 0.0;
+
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) minimizer_reduction.new_sum_reduction(pMesh->n.dim());
+
+#pragma omp parallel for reduction(+:_ncg_DD, _ncg_DDprev, _ncg_Ddir)
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			double Ms = pMesh->Ms;
+			double grel = pMesh->grel;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms, pMesh->grel, grel);
+
+			DBL3 m = pMesh->M[idx] / Ms;
+			DBL3 H = pMesh->Heff[idx];
+
+			//steepest descent direction
+			DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+			//search direction transported to current point
+			DBL3 d = sEval1[idx] - (sEval1[idx] * m) * m;
+
+			if (deterministic) minimizer_reduction.reduce_sum(DBL3(D * D, D * sEval0[idx], D * d), idx);
+			else {
+
+				_ncg_DD += D * D;
+				_ncg_DDprev += D * sEval0[idx];
+				_ncg_Ddir += D * d;
+			}
+		}
+	}
+
+	if (deterministic) {
+
+		DBL3 sums = minimizer_reduction.sum();
+		_ncg_DD = sums.x;
+		_ncg_DDprev = sums.y;
+		_ncg_Ddir = sums.z;
+	}
+
+	//accumulate across all meshes -> remember these should have been set to zero before starting a run across all meshes
+	ncg_DD += _ncg_DD;
+	ncg_DDprev += _ncg_DDprev;
+	ncg_Ddir += _ncg_Ddir;
+}
+
+//2. line search refinement : set magnetization at step dT along the search direction from the line search start point
+void DifferentialEquationFM::RunNCG_LineSearch(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			double Ms = pMesh->Ms;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+
+			pMesh->M[idx] = (sM1[idx] + dT * sEval1[idx]) * Ms;
+			pMesh->M[idx].renormalize(Ms);
+		}
+	}
+}
+
+//2b. line search failed : set steepest descent search direction at the line search start point, and set magnetization at step dT along it
+void DifferentialEquationFM::RunNCG_Restart(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx) && !pMesh->M.is_skipcell(idx)) {
+
+			double Ms = pMesh->Ms;
+			pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+
+			sEval1[idx] = sEval0[idx];
+
+			pMesh->M[idx] = (sM1[idx] + dT * sEval1[idx]) * Ms;
+			pMesh->M[idx].renormalize(Ms);
+		}
+	}
+}
+
+//3. start new line search from the current magnetization
+void DifferentialEquationFM::RunNCG_Direction_withReductions(void)
+{
+	mxh_reduction.new_minmax_reduction();
+	if (calculate_dmdt) dmdt_reduction.new_minmax_reduction();
+
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				double Ms = pMesh->Ms;
+				double grel = pMesh->grel;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms, pMesh->grel, grel);
+
+				DBL3 m = pMesh->M[idx] / Ms;
+				DBL3 H = pMesh->Heff[idx];
+
+				//obtained maximum normalized torque term
+				if (IsNZ(grel)) {
+
+					double _mxh = GetMagnitude(m ^ H) / pMesh->M[idx].norm();
+					mxh_reduction.reduce_max(_mxh);
+				}
+
+				//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+				DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+				DBL3 d = D;
+				if (ncg_beta) d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+
+				sEval0[idx] = D;
+				sEval1[idx] = d;
+				sM1[idx] = m;
+
+				//trial step along search direction
+				pMesh->M[idx] = (m + dT * d) * Ms;
+				pMesh->M[idx].renormalize(Ms);
+
+				if (calculate_dmdt && IsNZ(grel)) {
+
+					//obtained maximum dmdt term
+					double _dmdt = GetMagnitude(pMesh->M[idx] / Ms - m) / (dT * GAMMA * grel * Ms);
+					dmdt_reduction.reduce_max(_dmdt);
+				}
+			}
+			else {
+
+				double Ms = pMesh->Ms;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+				pMesh->M[idx].renormalize(Ms);
+			}
+		}
+	}
+
+	mxh_reduction.maximum();
+	if (calculate_dmdt) dmdt_reduction.maximum();
+}
+
+void DifferentialEquationFM::RunNCG_Direction(void)
+{
+#pragma omp parallel for
+	for (int idx = 0; idx < pMesh->n.dim(); idx++) {
+
+		if (pMesh->M.is_not_empty(idx)) {
+
+			if (!pMesh->M.is_skipcell(idx)) {
+
+				double Ms = pMesh->Ms;
+				double grel = pMesh->grel;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms, pMesh->grel, grel);
+
+				DBL3 m = pMesh->M[idx] / Ms;
+				DBL3 H = pMesh->Heff[idx];
+
+				//steepest descent direction, and new search direction (restart with steepest descent if ncg_beta is zero)
+				DBL3 D = (GAMMA / 2) * grel * (H - (H * m) * m);
+
+				DBL3 d = D;
+				if (ncg_beta) d += ncg_beta * (sEval1[idx] - (sEval1[idx] * m) * m);
+
+				sEval0[idx] = D;
+				sEval1[idx] = d;
+				sM1[idx] = m;
+
+				//trial step along search direction
+				pMesh->M[idx] = (m + dT * d) * Ms;
+				pMesh->M[idx].renormalize(Ms);
+			}
+			else {
+
+				double Ms = pMesh->Ms;
+				pMesh->update_parameters_mcoarse(idx, pMesh->Ms, Ms);
+				pMesh->M[idx].renormalize(Ms);
+			}
+		}
+	}
+}
+
+#endif
+#endif
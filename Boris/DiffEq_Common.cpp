@@ -9,6 +9,7 @@
 //-----------------------------------Collection of ferromagnetic meshes
 
 vector_lut<DifferentialEquation*> ODECommon::pODE;
+vector_lut<DifferentialEquation*> ODECommon::pODE_held;
 
 //-----------------------------------Equation and Evaluation method values
 
@@ -16,6 +17,8 @@ int ODECommon::setODE = ODE_LLG;
 
 Equation ODECommon::equation;
 
+int ODECommon::equation_kernel = EQKERNEL_GENERIC;
+
 //-----------------------------------Evaluation method modifiers
 
 bool ODECommon::renormalize = true;
@@ -30,6 +33,12 @@ double ODECommon::delta_m2_sq = 0.0;
 double ODECommon::delta_G2_sq = 0.0;
 double ODECommon::delta_m2_dot_delta_G2 = 0.0;
 
+//-----------------------------------Nonlinear Conjugate Gradient Solver
+
+double ODECommon::ncg_DD = 0.0;
+double ODECommon::ncg_DDprev = 0.0;
+double ODECommon::ncg_Ddir = 0.0;
+
 //-----------------------------------CUDA version
 
 #if COMPILECUDA == 1
@@ -49,7 +58,10 @@ ODECommon::ODECommon(bool called_from_derived) :
 			VINFO(dTspeedup), VINFO(time_speedup), VINFO(link_dTspeedup),
 			VINFO(err_high_fail), VINFO(err_high), VINFO(err_low), VINFO(dT_increase), VINFO(dT_min), VINFO(dT_max), VINFO(eval_method_order),
 			VINFO(use_evaluation_speedup),
-			VINFO(moving_mesh), VINFO(moving_mesh_antisymmetric), VINFO(moving_mesh_threshold), VINFO(moving_mesh_dwshift)
+			VINFO(moving_mesh), VINFO(moving_mesh_antisymmetric), VINFO(moving_mesh_threshold), VINFO(moving_mesh_dwshift),
+			VINFO(multirate_subcycles),
+			VINFO(astep_controller), VINFO(astep_kI), VINFO(astep_kP),
+			VINFO(activeset_threshold), VINFO(activeset_halo), VINFO(activeset_period)
 		}, {})
 {
 	//when a new ferromagnetic mesh is added this constructor is called with called_from_derived = true
@@ -81,15 +93,15 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	BError error(__FUNCTION__);
 
 	//use a function pointer to assign equation to solve
-	//this approach saves on having to write out the evaluation methods for every equation, with possible impact on performance due to equation evaluation not being manually inlined
-	//tests for typical problems show this has virtually no impact on performance! Maybe the compiler has inlined the code for all the different equations used? (could check this)
-	//Or maybe the overhead from function calls is just insignificant for typical problems
+	//this approach saves on having to write out the evaluation methods for every equation
+	//the evaluation methods don't call the equation through the function pointer for every cell however : their loops are instantiated for each equation (selected using equation_kernel) so the equation can be inlined in the loop.
 
 	switch (setODE_) {
 
 	case ODE_LLG:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLG;
+		equation_kernel = EQKERNEL_LLG;
 		renormalize = true;
 		solve_spin_current_mm = false;
 		break;
@@ -97,6 +109,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLGSTATIC:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLGStatic;
+		equation_kernel = EQKERNEL_LLGSTATIC;
 		renormalize = true;
 		solve_spin_current_mm = false;
 		break;
@@ -104,6 +117,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLGSTATICSA:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLGStatic;
+		equation_kernel = EQKERNEL_LLGSTATIC;
 		renormalize = true;
 		solve_spin_current_mm = true;
 		break;
@@ -111,6 +125,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLGSTT:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLGSTT;
+		equation_kernel = EQKERNEL_LLGSTT;
 		renormalize = true;
 		solve_spin_current_mm = false;
 		break;
@@ -118,6 +133,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLB:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLB;
+		equation_kernel = EQKERNEL_LLB;
 		renormalize = false;
 		solve_spin_current_mm = false;
 		break;
@@ -125,6 +141,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLBSTT:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLBSTT;
+		equation_kernel = EQKERNEL_LLBSTT;
 		renormalize = false;
 		solve_spin_current_mm = false;
 		break;
@@ -132,6 +149,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLG:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLG;
+		equation_kernel = EQKERNEL_SLLG;
 		renormalize = true;
 		solve_spin_current_mm = false;
 		break;
@@ -139,6 +157,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLGSTT:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLGSTT;
+		equation_kernel = EQKERNEL_SLLGSTT;
 		renormalize = true;
 		solve_spin_current_mm = false;
 		break;
@@ -146,6 +165,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLB:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLB;
+		equation_kernel = EQKERNEL_SLLB;
 		renormalize = false;
 		solve_spin_current_mm = false;
 		break;
@@ -153,6 +173,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLBSTT:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLBSTT;
+		equation_kernel = EQKERNEL_SLLBSTT;
 		renormalize = false;
 		solve_spin_current_mm = false;
 		break;
@@ -160,6 +181,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLGSA:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLG;
+		equation_kernel = EQKERNEL_LLG;
 		renormalize = true;
 		solve_spin_current_mm = true;
 		break;
@@ -167,6 +189,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLGSA:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLG;
+		equation_kernel = EQKERNEL_SLLG;
 		renormalize = true;
 		solve_spin_current_mm = true;
 		break;
@@ -174,6 +197,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_LLBSA:
 		setODE = setODE_;
 		equation = &DifferentialEquation::LLB;
+		equation_kernel = EQKERNEL_LLB;
 		renormalize = false;
 		solve_spin_current_mm = true;
 		break;
@@ -181,6 +205,7 @@ BError ODECommon::SetODE(ODE_ setODE_, EVAL_ evalMethod_, bool set_eval_method)
 	case ODE_SLLBSA:
 		setODE = setODE_;
 		equation = &DifferentialEquation::SLLB;
+		equation_kernel = EQKERNEL_SLLB;
 		renormalize = false;
 		solve_spin_current_mm = true;
 		break;
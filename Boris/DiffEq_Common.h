@@ -32,7 +32,10 @@ class ODECommon :
 	double, double, bool,
 	double, double, double, double, double, double, int,
 	int,
-	bool, bool, double, double>,
+	bool, bool, double, double,
+	int,
+	int, double, double,
+	double, int, int>,
 	std::tuple<>>,
 	public ODECommon_Base
 {
@@ -51,6 +54,9 @@ protected:
 	//When a ODE is deleted in a ferromagnetic mesh, DifferentialEquation destructor is called, and it erases the entry n this vector using the unique odeId previously generated.
 	static vector_lut<DifferentialEquation*> pODE;
 
+	//multi-rate stepping : solvers held while only the atomistic meshes are being advanced (swapped in and out of pODE)
+	static vector_lut<DifferentialEquation*> pODE_held;
+
 	//-----------------------------------Equation and Evaluation method values
 
 	//currently set evaluation method
@@ -59,6 +65,9 @@ protected:
 	//function pointer to equation to solve
 	static Equation equation;
 
+	//equation to solve as an EQKERNEL_ value : CPU evaluation methods use this to select the loop instantiated for the equation (see Dispatch_Equation in DiffEqFM_Equations.h and DiffEqAFM_Equations.h)
+	static int equation_kernel;
+
 	//-----------------------------------Evaluation method modifiers
 
 	//only renormalize M after solving for a time step for some equations. For LLB type equations must not renormalize.
@@ -74,6 +83,12 @@ protected:
 	static double delta_G_sq, delta_G2_sq;
 	static double delta_m_dot_delta_G, delta_m2_dot_delta_G2;
 
+	//-----------------------------------Nonlinear Conjugate Gradient Solver
+
+	//quantities accumulated across multiple meshes, with D the steepest descent direction at the current magnetization and d the previous search direction transported to the current magnetization:
+	//ncg_DD = D.D, ncg_DDprev = D.Dprev (Dprev is D at the previous line search start point, used for Polak-Ribiere beta), ncg_Ddir = D.d (the directional derivative along the search direction is -ncg_Ddir)
+	static double ncg_DD, ncg_DDprev, ncg_Ddir;
+
 	//-----------------------------------CUDA version
 
 #if COMPILECUDA == 1
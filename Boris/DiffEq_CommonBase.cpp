@@ -70,6 +70,18 @@ double ODECommon_Base::dT_min = RKF_MINDT;
 //order of evaluation method
 int ODECommon_Base::eval_method_order = 5;
 
+int ODECommon_Base::astep_controller = ASTEPCTRL_I;
+double ODECommon_Base::astep_kI = ASTEPCTRL_PI_KI;
+double ODECommon_Base::astep_kP = ASTEPCTRL_PI_KP;
+
+double ODECommon_Base::lte_last = 0.0;
+bool ODECommon_Base::astep_rejected_last = false;
+
+int ODECommon_Base::astep_accepted = 0;
+int ODECommon_Base::astep_rejected = 0;
+int ODECommon_Base::astep_evals_wasted = 0;
+int ODECommon_Base::astep_evals = 0;
+
 //-----------------------------------Special values
 
 bool ODECommon_Base::alternator = false;
@@ -78,6 +90,58 @@ bool ODECommon_Base::primed = false;
 
 int ODECommon_Base::sd_reset_consecutive_iters = 0;
 
+double ODECommon_Base::ncg_beta = 0.0;
+double ODECommon_Base::ncg_DD_last = 0.0;
+double ODECommon_Base::ncg_slope = 0.0;
+double ODECommon_Base::ncg_energy = 0.0;
+double ODECommon_Base::ncg_energy_start = 0.0;
+
+//Carpenter-Kennedy 2N-storage RK4 with 5 stages. E are the differences between the 4th order weights and those of an embedded 3rd order solution.
+const double ODECommon_Base::lsrk_A[LSRK_STAGES] = { 
+	0.0, 
+	-567301805773.0 / 1357537059087.0, 
+	-2404267990393.0 / 2016746695238.0, 
+	-3550918686646.0 / 2091501179385.0, 
+	-1275806237668.0 / 842570457699.0 };
+
+const double ODECommon_Base::lsrk_B[LSRK_STAGES] = { 
+	1432997174477.0 / 9575080441755.0, 
+	5161836677717.0 / 13612068292357.0, 
+	1720146321549.0 / 2090206949498.0, 
+	3134564353537.0 / 4481467310338.0, 
+	2277821191437.0 / 14882151754819.0 };
+
+const double ODECommon_Base::lsrk_C[LSRK_STAGES] = { 
+	0.0, 
+	1432997174477.0 / 9575080441755.0, 
+	2526269341429.0 / 6820363962896.0, 
+	2006345519317.0 / 3224310063776.0, 
+	2802321613138.0 / 2924317926251.0 };
+
+const double ODECommon_Base::lsrk_E[LSRK_STAGES] = { 
+	-0.16033435641008234, 
+	0.34474304234056707, 
+	-0.24407312659415953, 
+	0.054651527079573693, 
+	0.0050129135841011242 };
+
+//-----------------------------------Multi-rate stepping
+
+int ODECommon_Base::multirate_subcycles = 1;
+int ODECommon_Base::multirate_substep = 0;
+double ODECommon_Base::multirate_time = 0.0;
+
+//-----------------------------------Active set relaxation
+
+double ODECommon_Base::activeset_threshold = 0.0;
+int ODECommon_Base::activeset_halo = ACTIVESET_HALO;
+int ODECommon_Base::activeset_period = ACTIVESET_PERIOD;
+bool ODECommon_Base::activeset_stage = false;
+int ODECommon_Base::activeset_counter = 0;
+double ODECommon_Base::activeset_fraction = 1.0;
+bool ODECommon_Base::activeset_fullstep = true;
+bool ODECommon_Base::activeset_verify = false;
+
 //-----------------------------------Moving mesh data
 
 bool ODECommon_Base::moving_mesh = false;
@@ -133,6 +197,10 @@ BError ODECommon_Base::UpdateConfiguration(UPDATECONFIG_ cfgMessage)
 	evalStep = 0;
 	alternator = false;
 	primed = false;
+	multirate_substep = 0;
+
+	//mesh dimensions or shapes may have changed : frozen cells are re-built with the next time step
+	ActiveSet_Release();
 
 #if COMPILECUDA == 1
 	if (podeSolver->pODECUDA) podeSolver->pODECUDA->UpdateConfiguration(cfgMessage);
@@ -133,6 +133,20 @@ protected:
 	//order of evaluation method
 	static int eval_method_order;
 
+	//adaptive time step controller (ASTEPCTRL_ value), and PI controller gains
+	static int astep_controller;
+	static double astep_kI, astep_kP;
+
+	//error of last accepted step (PI controller), and was the last step rejected?
+	static double lte_last;
+	static bool astep_rejected_last;
+
+	//adaptive time step statistics : number of accepted and rejected steps, and number of field evaluations used in rejected steps
+	static int astep_accepted, astep_rejected, astep_evals_wasted;
+
+	//number of field evaluations (calls to Iterate) since the last adaptive time step decision
+	static int astep_evals;
+
 	//-----------------------------------Special evaluation values
 
 	//used to alternate between past equation evaluations (e.g. for ABM)
@@ -144,6 +158,53 @@ protected:
 	//when we have to reset steepest descent keep track of it, so we can increase the reset time if we have to reset every iteration: can get stuck otherwise
 	static int sd_reset_consecutive_iters;
 
+	//low-storage Runge-Kutta (Carpenter-Kennedy 2N, 5 stages) coefficients : register update (A), solution update (B), stage times (C), embedded error weights (E)
+	static const double lsrk_A[LSRK_STAGES], lsrk_B[LSRK_STAGES], lsrk_C[LSRK_STAGES], lsrk_E[LSRK_STAGES];
+
+	//nonlinear conjugate gradient : Polak-Ribiere conjugation factor for the current search direction, D.D at the current line search start point, and directional derivative (D.d) at the current line search start point
+	static double ncg_beta, ncg_DD_last, ncg_slope;
+
+	//nonlinear conjugate gradient : total energy density at the current evaluation (set before Iterate), and at the current line search start point
+	static double ncg_energy, ncg_energy_start;
+
+	//-----------------------------------Multi-rate stepping
+
+	//number of atomistic time steps per micromagnetic time step (1 : disabled, all meshes use the same time step)
+	//when enabled micromagnetic meshes are advanced with multirate_subcycles * dT, atomistic meshes with dT, and micromagnetic magnetization is interpolated in between
+	static int multirate_subcycles;
+
+	//current atomistic sub-step in the micromagnetic time step (0 : micromagnetic time step is due)
+	static int multirate_substep;
+
+	//time at the start of the current micromagnetic time step
+	static double multirate_time;
+
+	//-----------------------------------Active set relaxation
+
+	//normalized torque |M x Heff| / Ms^2 below which cells are frozen during relaxation stages (0 : disabled)
+	static double activeset_threshold;
+
+	//frozen cells within this number of cells of an active cell are kept active
+	static int activeset_halo;
+
+	//all frozen cells are re-examined with a full field evaluation every activeset_period iterations
+	static int activeset_period;
+
+	//is the current simulation stage a relaxation stage? (set by the simulation schedule)
+	static bool activeset_stage;
+
+	//iterations since the start of the stage with active set relaxation, used to schedule re-examinations
+	static int activeset_counter;
+
+	//fraction of non-empty micromagnetic cells currently active (1 if active set relaxation not in use)
+	static double activeset_fraction;
+
+	//was the last time step solved with no frozen cells, so mxh and dmdt were computed over the full mesh?
+	static bool activeset_fullstep;
+
+	//a stop condition was met with frozen cells : release all cells before the next time step so the stop condition is checked with a full field evaluation
+	static bool activeset_verify;
+
 	//-----------------------------------Moving mesh data
 
 	//use moving mesh algorithm?
@@ -174,6 +235,12 @@ private:
 	//this uses a 2 level error threshold -> above the high threshold fail, adjust step based on max_error / error ratio. Below the low error threshold increase step by a small constant factor.
 	bool SetAdaptiveTimeStep(void);
 
+	//----------------------------------- Multi-rate Stepping Helpers
+
+	//hold or release micromagnetic or atomistic ODE solvers : held solvers are removed from pODE so Iterate skips them
+	void Multirate_Hold_Micromagnetic(bool hold);
+	void Multirate_Hold_Atomistic(bool hold);
+
 protected:
 	
 	//----------------------------------- Runtime Iteration Helpers
@@ -249,8 +316,67 @@ public:
 
 	void SetAdaptiveTimeStepCtrl(double err_high_fail, double dT_increase, double dT_min, double dT_max);
 
+	//set adaptive time step controller type (ASTEPCTRL_ value) with gains (only used by PI controller)
+	void SetAdaptiveTimeStepController(int controller, double kI, double kP);
+
+	//reset accepted, rejected steps and wasted evaluations counters
+	void ResetAdaptiveTimeStepStats(void) { astep_accepted = 0; astep_rejected = 0; astep_evals_wasted = 0; }
+
 	void SetEvaluationSpeedup(int status) { if (status >= EVALSPEEDUP_NONE && status < EVALSPEEDUP_NUMENTRIES) use_evaluation_speedup = status; }
 
+	//nonlinear conjugate gradient : set total energy density computed for the current evaluation, before calling Iterate (used to check line search steps decrease the energy)
+	void NCG_Set_Energy(double energy_density) { ncg_energy = energy_density; }
+
+	//----------------------------------- Multi-rate Stepping : DiffEq_CommonBase_Multirate.cpp
+
+	//set number of atomistic time steps per micromagnetic time step (1 to disable)
+	void SetMultirateSubcycles(int subcycles);
+	int GetMultirateSubcycles(void) { return multirate_subcycles; }
+
+	//multi-rate stepping is used if enabled with both micromagnetic and atomistic meshes present, a fixed time step evaluation method, and no moving mesh
+	bool Multirate_Enabled(void);
+
+	//micromagnetic time step is due before the next atomistic time step
+	bool Multirate_SlowStep_Due(void) { return multirate_substep == 0; }
+
+	//start a new micromagnetic time step from the current magnetization (called when a run starts, as the magnetization could have been changed while stopped mid-cycle)
+	void Multirate_Restart(void) { multirate_substep = 0; }
+
+	//micromagnetic time step : atomistic solvers are held and the time step scaled up. Time and iteration counters are restored at the end, since these are advanced by the atomistic time steps.
+	void Multirate_Begin_SlowStep(void);
+	void Multirate_End_SlowStep(void);
+
+	//atomistic time step : micromagnetic solvers are held, and their magnetization is set by interpolation at the current evaluation time (call Multirate_Interpolate before each field evaluation)
+	void Multirate_Begin_FastStep(void);
+	void Multirate_Interpolate(void);
+	void Multirate_End_FastStep(void);
+
+	//----------------------------------- Active Set Relaxation : DiffEq_CommonBase_ActiveSet.cpp
+
+	//set active set relaxation parameters (threshold 0 to disable)
+	void SetActiveSet(double threshold, int halo, int period);
+	double GetActiveSetThreshold(void) { return activeset_threshold; }
+	int GetActiveSetHalo(void) { return activeset_halo; }
+	int GetActiveSetPeriod(void) { return activeset_period; }
+
+	//set by the simulation schedule : active set relaxation only applies during relaxation stages
+	void ActiveSet_SetStage(bool relax_stage);
+
+	//active set relaxation is used if enabled during a relaxation stage, without moving mesh
+	bool ActiveSet_Enabled(void);
+
+	//call before and after the time step : before releases all frozen cells when a re-examination is due, after updates frozen cells in all micromagnetic meshes
+	void ActiveSet_Begin_Step(void);
+	void ActiveSet_End_Step(void);
+
+	//unfreeze all cells in all micromagnetic meshes
+	void ActiveSet_Release(void);
+
+	//call before accepting a stop condition based on mxh or dmdt : return true if the last time step was solved over the full mesh, else request a full field evaluation for the next time step and return false
+	bool ActiveSet_Verify_Stop(void);
+
+	double Get_ActiveSet_Fraction(void) { return activeset_fraction; }
+
 	//----------------------------------- Moving Mesh Methods : DiffEq_CommonBase_MovingMesh.cpp
 
 	void SetMoveMeshTrigger(bool status, int meshId = -1);
@@ -286,6 +412,12 @@ public:
 	double Get_AStepRelErrCtrl(void) { return err_high_fail; }
 	DBL3 Get_AStepdTCtrl(void) { return DBL3(dT_increase, dT_min, dT_max); }
 
+	int Get_AStepController(void) { return astep_controller; }
+	DBL2 Get_AStepControllerGains(void) { return DBL2(astep_kI, astep_kP); }
+
+	//accepted steps, rejected steps, field evaluations wasted in rejected steps
+	INT3 Get_AStepStats(void) { return INT3(astep_accepted, astep_rejected, astep_evals_wasted); }
+
 	//----------------------------------- Status Getters
 
 	bool TimeStepSolved(void) { return available; }
@@ -0,0 +1,104 @@
+#include "stdafx.h"
+#include "DiffEq_CommonBase.h"
+
+#include "DiffEq_Common.h"
+#include "Atom_DiffEq_Common.h"
+
+#include "DiffEq.h"
+#include "Mesh.h"
+
+//----------------------------------- Active Set Relaxation
+
+//During relaxation stages most cells reach equilibrium long before the regions of interest (e.g. domain walls, vortex cores) do.
+//With active set relaxation, after every time step cells in micromagnetic meshes with normalized torque |M x Heff| / Ms^2 below activeset_threshold are frozen, unless within activeset_halo cells of an above-threshold cell.
+//Frozen cells are not evolved by the ODE solver, and local field modules (exchange, DMI, anisotropy) skip them. Non-local modules (e.g. demag) are still computed everywhere.
+//Every activeset_period iterations all cells are released before the time step, so their torques are re-examined with a full field evaluation.
+//Energy densities of frozen cells, as last computed while they were active, are still included in the energy of local field modules.
+//Stop conditions based on mxh or dmdt are only accepted once met for a time step solved with all cells released, as frozen cells do not contribute to these values.
+
+//set active set relaxation parameters (threshold 0 to disable)
+void ODECommon_Base::SetActiveSet(double threshold, int halo, int period)
+{
+	activeset_threshold = (threshold > 0.0 ? threshold : 0.0);
+	activeset_halo = (halo > 0 ? halo : 0);
+	activeset_period = (period > 1 ? period : 1);
+
+	ActiveSet_Release();
+}
+
+//set by the simulation schedule : active set relaxation only applies during relaxation stages
+void ODECommon_Base::ActiveSet_SetStage(bool relax_stage)
+{
+	if (activeset_stage && !relax_stage) ActiveSet_Release();
+
+	activeset_stage = relax_stage;
+}
+
+//active set relaxation is used if enabled during a relaxation stage, without moving mesh
+bool ODECommon_Base::ActiveSet_Enabled(void)
+{
+	if (activeset_threshold <= 0.0 || !activeset_stage) return false;
+
+	//the moving mesh algorithm shifts magnetization at the start of every time step, which would invalidate the frozen cells
+	if (moving_mesh) return false;
+
+	return podeSolver->pODE.size() > 0;
+}
+
+//release all frozen cells when a re-examination or a stop condition check is due, so the time step uses a full field evaluation
+void ODECommon_Base::ActiveSet_Begin_Step(void)
+{
+	if (activeset_verify || !(activeset_counter % activeset_period)) {
+
+		//keep frozen cells flags allocated : local field modules must cache cell energy densities during this time step
+		for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+			podeSolver->pODE[idx]->ActiveSet_Release(false);
+		}
+
+		activeset_fraction = 1.0;
+		activeset_verify = false;
+	}
+
+	activeset_fullstep = (activeset_fraction == 1.0);
+}
+
+//update frozen cells in all micromagnetic meshes after the time step has been solved
+void ODECommon_Base::ActiveSet_End_Step(void)
+{
+	int active_cells = 0, nonempty_cells = 0;
+
+	for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+		active_cells += podeSolver->pODE[idx]->ActiveSet_Update(activeset_threshold, activeset_halo);
+		nonempty_cells += podeSolver->pODE[idx]->pMesh->M.get_nonempty_cells();
+	}
+
+	activeset_fraction = (nonempty_cells ? (double)active_cells / nonempty_cells : 1.0);
+
+	activeset_counter++;
+}
+
+//unfreeze all cells in all micromagnetic meshes
+void ODECommon_Base::ActiveSet_Release(void)
+{
+	for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+		podeSolver->pODE[idx]->ActiveSet_Release();
+	}
+
+	activeset_counter = 0;
+	activeset_fraction = 1.0;
+	activeset_fullstep = true;
+	activeset_verify = false;
+}
+
+//call before accepting a stop condition based on mxh or dmdt : return true if the last time step was solved over the full mesh, else request a full field evaluation for the next time step and return false
+bool ODECommon_Base::ActiveSet_Verify_Stop(void)
+{
+	if (activeset_fullstep || !ActiveSet_Enabled()) return true;
+
+	activeset_verify = true;
+
+	return false;
+}
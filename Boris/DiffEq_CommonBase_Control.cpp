@@ -83,6 +83,16 @@ BError ODECommon_Base::SetEvaluationMethod(EVAL_ evalMethod_)
 	}
 	break;
 
+	case EVAL_NCG:
+	{
+		//starting trial step for the line search, after which the trial step is set from the previous accepted step
+		dT = NCG_DEFAULT_DT;
+		dT_min = NCG_MINDT;
+		dT_max = NCG_MAXDT;
+		eval_method_order = 1;
+	}
+	break;
+
 	default:
 	case EVAL_RKF45:
 	{
@@ -131,11 +141,41 @@ BError ODECommon_Base::SetEvaluationMethod(EVAL_ evalMethod_)
 		eval_method_order = 6;
 	}
 	break;
+
+	case EVAL_LSRK4:
+	{
+		dT = LSRK4_DEFAULT_DT;
+		eval_method_order = 4;
+	}
+	break;
+
+	case EVAL_IMEX:
+	{
+		dT = IMEX_DEFAULT_DT;
+		eval_method_order = 1;
+	}
+	break;
+
+	case EVAL_LSRK43:
+	{
+		dT = LSRK_DEFAULT_DT;
+
+		err_high_fail = LSRK_RELERRFAIL;
+		dT_increase = LSRK_DTINCREASE;
+		dT_max = LSRK_MAXDT;
+		dT_min = LSRK_MINDT;
+		eval_method_order = 3;
+	}
+	break;
 	}
 
 	//initial settings
 	dT_last = dT;
 
+	lte_last = 0.0;
+	astep_rejected_last = false;
+	astep_evals = 0;
+
 	mxh = 1;
 	dmdt = 1;
 
@@ -144,6 +184,7 @@ BError ODECommon_Base::SetEvaluationMethod(EVAL_ evalMethod_)
 
 	alternator = false;
 	primed = false;
+	multirate_substep = 0;
 
 	calculate_mxh = true;
 	calculate_dmdt = true;
@@ -177,12 +218,20 @@ void ODECommon_Base::Reset(void)
 
 	alternator = false;
 	primed = false;
+	multirate_substep = 0;
 
 	calculate_mxh = true;
 	calculate_dmdt = true;
 
 	moving_mesh_dwshift = 0.0;
 
+	lte_last = 0.0;
+	astep_rejected_last = false;
+	astep_evals = 0;
+	ResetAdaptiveTimeStepStats();
+
+	ActiveSet_Release();
+
 #if COMPILECUDA == 1
 	if (podeSolver->pODECUDA) podeSolver->pODECUDA->SyncODEValues();
 	if (patom_odeSolver->pODECUDA) patom_odeSolver->pODECUDA->SyncODEValues();
@@ -202,10 +251,17 @@ void ODECommon_Base::NewStage(void)
 
 	alternator = false;
 	primed = false;
+	multirate_substep = 0;
 
 	calculate_mxh = true;
 	calculate_dmdt = true;
 
+	lte_last = 0.0;
+	astep_rejected_last = false;
+	astep_evals = 0;
+
+	ActiveSet_Release();
+
 #if COMPILECUDA == 1
 	if (podeSolver->pODECUDA) podeSolver->pODECUDA->SyncODEValues();
 	if (patom_odeSolver->pODECUDA) patom_odeSolver->pODECUDA->SyncODEValues();
@@ -218,6 +274,9 @@ void ODECommon_Base::SetdT(double dT)
 
 	if (link_dTspeedup) dTspeedup = dT;
 
+	//start a new micromagnetic time step if using multi-rate stepping
+	multirate_substep = 0;
+
 #if COMPILECUDA == 1
 	if (podeSolver->pODECUDA) podeSolver->pODECUDA->SyncODEValues();
 	if (patom_odeSolver->pODECUDA) patom_odeSolver->pODECUDA->SyncODEValues();
@@ -263,3 +322,13 @@ void ODECommon_Base::SetAdaptiveTimeStepCtrl(double err_high_fail, double dT_inc
 	this->dT_min = dT_min;
 	this->dT_max = dT_max;
 }
+
+void ODECommon_Base::SetAdaptiveTimeStepController(int controller, double kI, double kP)
+{
+	if (controller >= ASTEPCTRL_I && controller < ASTEPCTRL_NUMENTRIES) astep_controller = controller;
+
+	astep_kI = kI;
+	astep_kP = kP;
+
+	lte_last = 0.0;
+}
@@ -14,11 +14,13 @@
 
 bool ODECommon_Base::SetAdaptiveTimeStep(void)
 {
+	//field evaluations used for this step attempt
+	int step_evals = astep_evals;
+	astep_evals = 0;
+
 	//fixed time step if limits same
 	if (dT_min == dT_max) return true;
 
-	//Integral controller adaptive time step.
-
 	if (lte > err_high_fail && dT > dT_min) {
 
 		//reject. The dT > dT_min check needed to stop solver getting stuck.
@@ -27,6 +29,10 @@ bool ODECommon_Base::SetAdaptiveTimeStep(void)
 		iteration--;
 		stageiteration--;
 
+		astep_rejected++;
+		astep_evals_wasted += step_evals;
+		astep_rejected_last = true;
+
 		//Use I controller only when rejecting
 		double c = pow(err_high_fail * 0.8 / lte, 1.0 / (eval_method_order + 1));
 
@@ -42,8 +48,18 @@ bool ODECommon_Base::SetAdaptiveTimeStep(void)
 	}
 	else if (lte > 0) {
 
-		double c = pow(err_high_fail * 0.8 / lte, 1.0 / (eval_method_order + 1));
+		double c = 1.0;
+
+		if (astep_controller == ASTEPCTRL_PI && lte_last > 0 && !astep_rejected_last) {
+
+			//PI controller : the proportional term uses the error change since the last accepted step, which damps time step oscillations when the step size is stability limited
+			c = pow(err_high_fail * 0.8 / lte, astep_kI / (eval_method_order + 1)) * pow(lte_last / lte, astep_kP / (eval_method_order + 1));
+		}
+		else c = pow(err_high_fail * 0.8 / lte, 1.0 / (eval_method_order + 1));
+
 		if (c > dT_increase) c = dT_increase;
+		//don't increase time step straight after a rejection
+		if (astep_rejected_last && c > 1.0) c = 1.0;
 		if (c < 0.01) c = 0.01;
 		dT *= c;
 
@@ -54,6 +70,10 @@ bool ODECommon_Base::SetAdaptiveTimeStep(void)
 		if (dT > dT_max) dT = dT_max;
 	}
 
+	lte_last = lte;
+	astep_rejected_last = false;
+	astep_accepted++;
+
 	//good, next step
 	return true;
 }
@@ -65,6 +85,9 @@ void ODECommon_Base::Iterate(void)
 	//save current dT value in case it changes (adaptive time step methods)
 	dT_last = dT;
 
+	//each call follows a field evaluation
+	astep_evals++;
+
 	switch (evalMethod) {
 
 	case EVAL_EULER:
@@ -119,6 +142,49 @@ void ODECommon_Base::Iterate(void)
 	}
 	break;
 
+	case EVAL_IMEX:
+	{
+#ifdef ODE_EVAL_COMPILATION_IMEX
+		//IMEX is only available for ferromagnetic meshes (refused in AllocateMemory for other mesh types)
+		if (calculate_mxh || calculate_dmdt) {
+
+			for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+				podeSolver->pODE[idx]->RunIMEX_withReductions();
+			}
+
+			if (calculate_mxh) {
+
+				calculate_mxh = false;
+				mxh = 0.0;
+				podeSolver->Set_mxh();
+				patom_odeSolver->Set_mxh();
+			}
+
+			if (calculate_dmdt) {
+
+				calculate_dmdt = false;
+				dmdt = 0.0;
+				podeSolver->Set_dmdt();
+				patom_odeSolver->Set_dmdt();
+			}
+		}
+		else {
+
+			for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+				podeSolver->pODE[idx]->RunIMEX();
+			}
+		}
+
+		time += dT;
+		stagetime += dT;
+		iteration++;
+		stageiteration++;
+#endif
+	}
+	break;
+
 	case EVAL_TEULER:
 	{
 #ifdef ODE_EVAL_COMPILATION_TEULER
@@ -1397,6 +1463,117 @@ void ODECommon_Base::Iterate(void)
 	}
 	break;
 
+	case EVAL_LSRK4:
+	case EVAL_LSRK43:
+	{
+#ifdef ODE_EVAL_COMPILATION_LSRK
+		//all LSRK stages advance the magnetization in place, so the step is only completed at the last stage
+		if (evalStep == 0) {
+
+			if (calculate_mxh) {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunLSRK_Step0_withReductions();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunLSRK_Step0_withReductions();
+				}
+
+				calculate_mxh = false;
+				mxh = 0.0;
+				podeSolver->Set_mxh();
+				patom_odeSolver->Set_mxh();
+			}
+			else {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunLSRK_Step0();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunLSRK_Step0();
+				}
+			}
+
+			available = false;
+			evalStep++;
+		}
+		else if (evalStep < LSRK_STAGES - 1) {
+
+			for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+				podeSolver->pODE[idx]->RunLSRK_Step();
+			}
+
+			for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+				patom_odeSolver->pODE[idx]->RunLSRK_Step();
+			}
+
+			evalStep++;
+		}
+		else {
+
+			if (calculate_dmdt) {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunLSRK_Step4_withReductions();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunLSRK_Step4_withReductions();
+				}
+
+				calculate_dmdt = false;
+				dmdt = 0.0;
+				podeSolver->Set_dmdt();
+				patom_odeSolver->Set_dmdt();
+			}
+			else {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunLSRK_Step4();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunLSRK_Step4();
+				}
+			}
+
+			evalStep = 0;
+			time += dT;
+			stagetime += dT;
+			iteration++;
+			stageiteration++;
+			available = true;
+
+			if (evalMethod == EVAL_LSRK43) {
+
+				dT_last = dT;
+				lte = 0.0;
+				podeSolver->Set_lte();
+				patom_odeSolver->Set_lte();
+
+				if (!SetAdaptiveTimeStep()) {
+
+					podeSolver->Restore();
+					patom_odeSolver->Restore();
+				}
+			}
+		}
+#endif
+	}
+	break;
+
 	case EVAL_SD:
 	{
 #ifdef ODE_EVAL_COMPILATION_SD
@@ -1529,6 +1706,168 @@ void ODECommon_Base::Iterate(void)
 #endif
 	}
 	break;
+
+	case EVAL_NCG:
+	{
+#ifdef ODE_EVAL_COMPILATION_NCG
+		//Each call to Iterate follows a field evaluation at the current magnetization. evalStep is used as follows:
+		//0 : start (or restart) with steepest descent direction
+		//1 : magnetization is at the trial point of the current line search
+		//2 : magnetization is at the refined point of the current line search (secant step)
+		//The line search is inexact : the trial point is accepted if the directional derivative has been sufficiently reduced, else one secant refinement is taken.
+		//The trial or refined point is only accepted if the total energy density has not increased : otherwise the line search is restarted from its start point along the steepest descent direction with a smaller step (down to dT_min, where the point is accepted).
+		//D.Dprev is computed without transporting Dprev : D is tangential at the current point, so this is the same as with Dprev projected on the tangent plane.
+
+		//1. accumulate D.D, D.Dprev, D.d across all meshes (D : steepest descent direction, d : current search direction)
+		podeSolver->ncg_DD = 0.0;
+		podeSolver->ncg_DDprev = 0.0;
+		podeSolver->ncg_Ddir = 0.0;
+
+		patom_odeSolver->ncg_DD = 0.0;
+		patom_odeSolver->ncg_DDprev = 0.0;
+		patom_odeSolver->ncg_Ddir = 0.0;
+
+		for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+			podeSolver->pODE[idx]->RunNCG_Reductions();
+		}
+
+		for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+			patom_odeSolver->pODE[idx]->RunNCG_Reductions();
+		}
+
+		double DD = podeSolver->ncg_DD + patom_odeSolver->ncg_DD;
+		double DDprev = podeSolver->ncg_DDprev + patom_odeSolver->ncg_DDprev;
+		double Ddir = podeSolver->ncg_Ddir + patom_odeSolver->ncg_Ddir;
+
+		//2. line search : at the start point the directional derivative is ncg_slope (> 0), at the trial point it is Ddir
+		if (evalStep != 0 && ncg_energy > ncg_energy_start + NCG_ENERGY_TOLERANCE * fabs(ncg_energy_start) && dT > dT_min) {
+
+			//energy increased : backtrack from the line search start point along the steepest descent direction
+			dT /= NCG_LINESEARCH_MAXCHANGE;
+			if (dT < dT_min) dT = dT_min;
+
+			ncg_beta = 0.0;
+			ncg_slope = ncg_DD_last;
+
+			for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+				podeSolver->pODE[idx]->RunNCG_Restart();
+			}
+
+			for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+				patom_odeSolver->pODE[idx]->RunNCG_Restart();
+			}
+
+			evalStep = 1;
+		}
+		else if (evalStep == 1 && fabs(Ddir) > NCG_LINESEARCH_CURVATURE * ncg_slope) {
+
+			//secant step for zero directional derivative, or extrapolate if no positive curvature along search direction
+			double dT_new = dT * NCG_LINESEARCH_MAXCHANGE;
+			if (ncg_slope - Ddir > 0.0) dT_new = dT * ncg_slope / (ncg_slope - Ddir);
+
+			if (dT_new > dT * NCG_LINESEARCH_MAXCHANGE) dT_new = dT * NCG_LINESEARCH_MAXCHANGE;
+			if (dT_new < dT / NCG_LINESEARCH_MAXCHANGE) dT_new = dT / NCG_LINESEARCH_MAXCHANGE;
+			if (dT_new < dT_min) dT_new = dT_min;
+			if (dT_new > dT_max) dT_new = dT_max;
+
+			dT = dT_new;
+
+			for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+				podeSolver->pODE[idx]->RunNCG_LineSearch();
+			}
+
+			for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+				patom_odeSolver->pODE[idx]->RunNCG_LineSearch();
+			}
+
+			evalStep = 2;
+		}
+		else {
+
+			//3. current point accepted : new search direction using Polak-Ribiere+ conjugation factor
+			double slope_last = ncg_slope;
+
+			ncg_beta = 0.0;
+			if (evalStep != 0 && ncg_DD_last > 0.0) ncg_beta = (DD - DDprev) / ncg_DD_last;
+			if (ncg_beta < 0.0) ncg_beta = 0.0;
+
+			ncg_slope = DD + ncg_beta * Ddir;
+
+			//restart with steepest descent if not a descent direction
+			if (ncg_slope <= 0.0) {
+
+				ncg_beta = 0.0;
+				ncg_slope = DD;
+			}
+
+			//initial trial step for the new line search : same first order change as for the last accepted step
+			if (evalStep != 0 && ncg_slope > 0.0) {
+
+				dT *= slope_last / ncg_slope;
+				if (dT < dT_min) dT = dT_min;
+				if (dT > dT_max) dT = dT_max;
+			}
+
+			ncg_DD_last = DD;
+			ncg_energy_start = ncg_energy;
+
+			if (calculate_mxh || calculate_dmdt) {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunNCG_Direction_withReductions();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunNCG_Direction_withReductions();
+				}
+
+				if (calculate_mxh) {
+
+					calculate_mxh = false;
+					mxh = 0.0;
+					podeSolver->Set_mxh();
+					patom_odeSolver->Set_mxh();
+				}
+
+				if (calculate_dmdt) {
+
+					calculate_dmdt = false;
+					dmdt = 0.0;
+					podeSolver->Set_dmdt();
+					patom_odeSolver->Set_dmdt();
+				}
+			}
+			else {
+
+				for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+					podeSolver->pODE[idx]->RunNCG_Direction();
+				}
+
+				for (int idx = 0; idx < patom_odeSolver->pODE.size(); idx++) {
+
+					patom_odeSolver->pODE[idx]->RunNCG_Direction();
+				}
+			}
+
+			evalStep = 1;
+		}
+
+		iteration++;
+		stageiteration++;
+		time += dT;
+		stagetime += dT;
+#endif
+	}
+	break;
 	}
 }
 
@@ -1606,6 +1945,18 @@ double ODECommon_Base::Get_EvalStep_Time(void)
 	}
 	break;
 
+	case EVAL_NCG:
+	{
+		return time;
+	}
+	break;
+
+	case EVAL_IMEX:
+	{
+		return time;
+	}
+	break;
+
 	case EVAL_RKF45:
 	{
 		return time + dT * evaltime_rkf45[evalStep];
@@ -1629,6 +1980,13 @@ double ODECommon_Base::Get_EvalStep_Time(void)
 		return time + dT * evaltime_rkdp54[evalStep];
 	}
 	break;
+
+	case EVAL_LSRK4:
+	case EVAL_LSRK43:
+	{
+		return time + dT * lsrk_C[evalStep];
+	}
+	break;
 	}
 
 	return time;
@@ -12,6 +12,9 @@
 
 void ODECommon_Base::IterateCUDA(void)
 {
+	//each call follows a field evaluation
+	astep_evals++;
+
 	switch (evalMethod) {
 
 	case EVAL_EULER:
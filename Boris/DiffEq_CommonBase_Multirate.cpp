@@ -0,0 +1,135 @@
+#include "stdafx.h"
+#include "DiffEq_CommonBase.h"
+
+#include "DiffEq_Common.h"
+#include "Atom_DiffEq_Common.h"
+
+#include "DiffEq.h"
+#include "Atom_DiffEq.h"
+
+//----------------------------------- Multi-rate Stepping
+
+//In multiscale simulations the atomistic meshes typically require a much smaller time step than the micromagnetic meshes.
+//With multi-rate stepping the micromagnetic meshes are advanced with a time step multirate_subcycles times larger than the atomistic meshes (slowest first) :
+//1. micromagnetic time step from t to t + multirate_subcycles * dT computed with the atomistic meshes held at time t
+//2. atomistic meshes then take multirate_subcycles time steps of dT, with the micromagnetic magnetization set by linear interpolation at each evaluation time,
+//so coupling fields from the micromagnetic meshes (demag, surface exchange, transport) follow the micromagnetic magnetization.
+//Micromagnetic effective fields are not computed during the atomistic sub-steps : after each one the effective field from the micromagnetic time step is restored in micromagnetic meshes.
+//Time and iteration counters are advanced by the atomistic time steps only.
+
+//set number of atomistic time steps per micromagnetic time step (1 to disable)
+void ODECommon_Base::SetMultirateSubcycles(int subcycles)
+{
+	if (subcycles < 1) subcycles = 1;
+
+	multirate_subcycles = subcycles;
+	multirate_substep = 0;
+}
+
+//multi-rate stepping is used if enabled with both micromagnetic and atomistic meshes present, a fixed time step evaluation method, and no moving mesh
+bool ODECommon_Base::Multirate_Enabled(void)
+{
+	if (multirate_subcycles <= 1) return false;
+
+	if (!podeSolver->pODE.size() || !patom_odeSolver->pODE.size()) return false;
+
+	//the moving mesh algorithm shifts magnetization at the start of every time step, which would invalidate the saved micromagnetic magnetization
+	if (moving_mesh) return false;
+
+	switch (evalMethod) {
+
+	case EVAL_EULER:
+	case EVAL_TEULER:
+	case EVAL_RK4:
+	case EVAL_LSRK4:
+		return true;
+	}
+
+	return false;
+}
+
+//hold or release micromagnetic ODE solvers : held solvers are removed from pODE so Iterate skips them
+void ODECommon_Base::Multirate_Hold_Micromagnetic(bool hold)
+{
+	if (hold == (podeSolver->pODE_held.size() > 0)) return;
+
+	std::swap(podeSolver->pODE, podeSolver->pODE_held);
+}
+
+//hold or release atomistic ODE solvers : held solvers are removed from pODE so Iterate skips them
+void ODECommon_Base::Multirate_Hold_Atomistic(bool hold)
+{
+	if (hold == (patom_odeSolver->pODE_held.size() > 0)) return;
+
+	std::swap(patom_odeSolver->pODE, patom_odeSolver->pODE_held);
+}
+
+void ODECommon_Base::Multirate_Begin_SlowStep(void)
+{
+	multirate_time = time;
+
+	Multirate_Hold_Atomistic(true);
+
+	for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+		podeSolver->pODE[idx]->Multirate_Save_Start();
+	}
+
+	dT *= multirate_subcycles;
+}
+
+void ODECommon_Base::Multirate_End_SlowStep(void)
+{
+	for (int idx = 0; idx < podeSolver->pODE.size(); idx++) {
+
+		podeSolver->pODE[idx]->Multirate_Save_End();
+	}
+
+	//undo counters advance by micromagnetic time step
+	time -= dT;
+	stagetime -= dT;
+	iteration--;
+	stageiteration--;
+
+	dT /= multirate_subcycles;
+	dT_last = dT;
+
+	Multirate_Hold_Atomistic(false);
+}
+
+void ODECommon_Base::Multirate_Begin_FastStep(void)
+{
+	Multirate_Hold_Micromagnetic(true);
+}
+
+//set micromagnetic magnetization by interpolation at the current evaluation time
+void ODECommon_Base::Multirate_Interpolate(void)
+{
+	double fraction = (Get_EvalStep_Time() - multirate_time) / (multirate_subcycles * dT);
+
+	for (int idx = 0; idx < podeSolver->pODE_held.size(); idx++) {
+
+		podeSolver->pODE_held[idx]->Multirate_Interpolate(fraction);
+	}
+}
+
+void ODECommon_Base::Multirate_End_FastStep(void)
+{
+	multirate_substep++;
+
+	//leave micromagnetic magnetization at the current time : end of micromagnetic time step if all sub-steps done, else interpolated value (so multi-rate stepping can be interrupted at any time)
+	double fraction = 1.0;
+
+	if (multirate_substep >= multirate_subcycles) multirate_substep = 0;
+	else fraction = (time - multirate_time) / (multirate_subcycles * dT);
+
+	for (int idx = 0; idx < podeSolver->pODE_held.size(); idx++) {
+
+		podeSolver->pODE_held[idx]->Multirate_Interpolate(fraction);
+
+		//the atomistic sub-step cleared micromagnetic effective fields, leaving only supermesh contributions
+		podeSolver->pODE_held[idx]->Multirate_Restore_Heff();
+	}
+
+	Multirate_Hold_Micromagnetic(false);
+}
@@ -62,11 +62,44 @@
 #define RKDP_MINDT	1e-15
 #define RKDP_DEFAULT_DT	0.5e-12
 
+//number of stages for low-storage Runge-Kutta methods
+#define LSRK_STAGES	5
+
+//default dT for fixed time step low-storage RK4
+#define LSRK4_DEFAULT_DT	0.5e-12
+
+//fixed parameters for LSRK43 adaptive time step
+#define LSRK_RELERRFAIL	1e-4
+#define LSRK_DTINCREASE	2
+#define LSRK_MAXDT	3e-12
+#define LSRK_MINDT	1e-15
+#define LSRK_DEFAULT_DT	0.5e-12
+
 //default dT -> for the SD solver this acts as the starting timestep and the value it resets to when needed
 #define SD_DEFAULT_DT	1e-15
 #define SD_MAXDT	1e-9
 #define SD_MINDT	SD_DEFAULT_DT
 
+//default dT for IMEX Euler (exchange treated implicitly, so time step not limited by exchange stiffness)
+#define IMEX_DEFAULT_DT	1e-13
+//stop iterating the linear solver for the implicit exchange system when the normalized change is below this
+#define IMEX_SOLVER_MAXERROR	1e-6
+//maximum number of linear solver iterations per time step
+#define IMEX_SOLVER_MAXITERS	500
+//damping values below this are clipped when calculating the exchange stabilization coefficient (it diverges as 1 / alpha)
+#define IMEX_MINALPHA	1e-3
+
+//nonlinear conjugate gradient minimizer : default dT is the starting trial step for the line search (same units as SD stepsize)
+#define NCG_DEFAULT_DT	1e-13
+#define NCG_MAXDT	1e-9
+#define NCG_MINDT	1e-15
+//line search accepts a step if the directional derivative has been reduced by this factor (in absolute value) relative to the start of the line search, else one secant refinement is taken
+#define NCG_LINESEARCH_CURVATURE	0.5
+//limit step change in a secant refinement to this multiplicative factor
+#define NCG_LINESEARCH_MAXCHANGE	4.0
+//a line search step is rejected if the total energy density increased by more than this relative amount (allows for rounding errors), and the search restarted from the line search start point along the steepest descent direction with a smaller step
+#define NCG_ENERGY_TOLERANCE	1e-12
+
 //difficult to simulate when temperature is very close to the Curie temperature due to numerical instability, especially with stochastic equations. instead use an epsilon approach (units of Kelvin).
 #define TCURIE_EPSILON	0.5
 
@@ -113,13 +146,47 @@ enum EVAL_ {
 	//Adaptive embedded error estimator, 5th order
 	EVAL_RKDP54 = 9, EVAL_RKF56 = 10,
 
+	//Low-storage (2N register) 4th order : fixed time step, and adaptive with embedded 3rd order error estimator
+	EVAL_LSRK4 = 11, EVAL_LSRK43 = 12,
+
+	//Implicit-explicit methods
+	EVAL_IMEX = 14,
+
 	//Energy minimizers
-	EVAL_SD = 6
+	EVAL_SD = 6, EVAL_NCG = 13
+
+}; //Current maximum : 14
+
+//Equation kernels for CPU evaluation methods : the evaluation loops are instantiated for each equation, so the equation can be inlined in the loop instead of being called through the equation function pointer for every cell.
+//Set together with the equation function pointer in SetODE. EQKERNEL_GENERIC calls the equation through the function pointer.
+enum EQKERNEL_ {
 
-}; //Current maximum : 10
+	EQKERNEL_GENERIC = 0,
+
+	EQKERNEL_LLG, EQKERNEL_LLGSTATIC, EQKERNEL_LLGSTT,
+
+	EQKERNEL_LLB, EQKERNEL_LLBSTT,
+
+	EQKERNEL_SLLG, EQKERNEL_SLLGSTT,
+
+	EQKERNEL_SLLB, EQKERNEL_SLLBSTT
+};
 
 //EVALSPEEDUP_NONE : evaluate all fields every step (default)
 //EVALSPEEDUP_STEP : use previously computed demag field
 //EVALSPEEDUP_LINEAR : linear interpolation using 2 previously computed demag fields
 //EVALSPEEDUP_QUADRATIC : quadratic (polynomial) interpolation using 3 previously computed demag fields
-enum EVALSPEEDUP_ { EVALSPEEDUP_NONE = 0, EVALSPEEDUP_STEP, EVALSPEEDUP_LINEAR, EVALSPEEDUP_QUADRATIC, EVALSPEEDUP_CUBIC, EVALSPEEDUP_QUARTIC, EVALSPEEDUP_QUINTIC, EVALSPEEDUP_NUMENTRIES };
\ No newline at end of file
+enum EVALSPEEDUP_ { EVALSPEEDUP_NONE = 0, EVALSPEEDUP_STEP, EVALSPEEDUP_LINEAR, EVALSPEEDUP_QUADRATIC, EVALSPEEDUP_CUBIC, EVALSPEEDUP_QUARTIC, EVALSPEEDUP_QUINTIC, EVALSPEEDUP_NUMENTRIES };
+
+//Adaptive time step controllers : the new time step is dT * c, with k = order + 1 :
+//ASTEPCTRL_I : integral controller (default), c = (0.8 * tol / err)^(1/k)
+//ASTEPCTRL_PI : proportional-integral controller (Gustafsson), c = (0.8 * tol / err)^(kI/k) * (err_last / err)^(kP/k), with err_last the error of the last accepted step. The integral controller is used straight after a rejected step.
+enum ASTEPCTRL_ { ASTEPCTRL_I = 0, ASTEPCTRL_PI, ASTEPCTRL_NUMENTRIES };
+
+//default PI controller gains
+#define ASTEPCTRL_PI_KI	0.3
+#define ASTEPCTRL_PI_KP	0.4
+
+//Active set relaxation defaults : halo (cells) kept active around above-threshold cells, and period (iterations) between re-examinations of all frozen cells
+#define ACTIVESET_HALO	2
+#define ACTIVESET_PERIOD	100
\ No newline at end of file
@@ -115,10 +115,16 @@ double Exch_6ngbr_Neu::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				double Ms = pMesh->Ms;
 				double A = pMesh->A;
@@ -147,12 +153,23 @@ double Exch_6ngbr_Neu::UpdateField(void)
 
 				pMesh->Heff[idx] += Hexch;
 
-				energy += pMesh->M[idx] * Hexch;
+				double cell_energy = pMesh->M[idx] * Hexch;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hexch;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * (pMesh->M[idx] * Hexch) / 2;
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -161,10 +178,16 @@ double Exch_6ngbr_Neu::UpdateField(void)
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
+		//active set relaxation : energy densities of active cells are cached so they can still be included for frozen cells
+		bool activeset = ActiveSet_EnergyCache(pMesh->is_activeset_used(), pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
-			if (pMesh->M.is_not_empty(idx)) {
+			if (pMesh->M.is_not_empty(idx) && !pMesh->is_activeset_frozen(idx)) {
 
 				DBL2 Ms_AFM = pMesh->Ms_AFM;
 				DBL2 A_AFM = pMesh->A_AFM;
@@ -185,14 +208,25 @@ double Exch_6ngbr_Neu::UpdateField(void)
 				pMesh->Heff[idx] += Hexch;
 				pMesh->Heff2[idx] += Hexch2;
 
-				energy += (pMesh->M[idx] * Hexch + pMesh->M2[idx] * Hexch2) / 2;
+				double cell_energy = (pMesh->M[idx] * Hexch + pMesh->M2[idx] * Hexch2) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
+				if (activeset) activeset_energy[idx] = cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hexch;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hexch2;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * (pMesh->M[idx] * Hexch) / 2;
 				if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * (pMesh->M2[idx] * Hexch2) / 2;
 			}
+			else if (activeset && pMesh->is_activeset_frozen(idx)) {
+
+				//frozen cell : energy density from the last evaluation while active
+				if (deterministic) energy_reduction.reduce_sum(activeset_energy[idx], idx);
+				else energy += activeset_energy[idx];
+			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
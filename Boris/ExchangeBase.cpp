@@ -77,6 +77,9 @@ void ExchangeBase::CalculateExchangeCoupling(
 
 		double energy_ = 0.0;
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) coupling_reduction.new_sum_reduction(box_sizes.dim());
+
 		//primary cells in this contact
 #pragma omp parallel for reduction (+:energy_)
 		for (int box_idx = 0; box_idx < box_sizes.dim(); box_idx++) {
@@ -98,9 +101,13 @@ void ExchangeBase::CalculateExchangeCoupling(
 			//stencil is used for weighted_average to obtain values in the secondary mesh : has size equal to primary cellsize area on interface with thickness set by secondary cellsize thickness
 			DBL3 stencil = h - mod(CMBNDcontacts[contact_idx].hshift_primary) + mod(CMBNDcontacts[contact_idx].hshift_secondary);
 
-			energy_ += calculate_coupling(cell1_idx, cell2_idx, relpos_m1, stencil, hshift_primary, Mesh_pri, Mesh_sec);
+			double cell_energy = calculate_coupling(cell1_idx, cell2_idx, relpos_m1, stencil, hshift_primary, Mesh_pri, Mesh_sec);
+			if (deterministic) coupling_reduction.reduce_sum(cell_energy, box_idx);
+			else energy_ += cell_energy;
 		}
 
+		if (deterministic) energy_ = coupling_reduction.sum();
+
 		energy += energy_;
 	}
 }
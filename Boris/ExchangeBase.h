@@ -31,6 +31,9 @@ private:
 	//vector of pointers to all ferromagnetic meshes - same ordering as pM
 	std::vector<Mesh*> pMeshes;
 
+	//energy reduction for coupled cells, used only if deterministic reductions are enabled (otherwise an OpenMP reduction clause is used)
+	OmpReduction<double> coupling_reduction;
+
 protected:
 
 protected:
@@ -0,0 +1,488 @@
+#include "stdafx.h"
+#include "KernelMultSIMD.h"
+
+//x86-64 only : intrinsics for the vectorized versions are compiled for their own target (the rest of the program is compiled without AVX), then selected at run-time
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define KERNELSIMD_COMPILED	1
+#define KERNELSIMD_TARGET_AVX2
+#define KERNELSIMD_TARGET_AVX512
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define KERNELSIMD_COMPILED	1
+#define KERNELSIMD_TARGET_AVX2		__attribute__((target("avx2,fma")))
+#define KERNELSIMD_TARGET_AVX512	__attribute__((target("avx512f,avx2,fma")))
+#else
+#define KERNELSIMD_COMPILED	0
+#endif
+
+int KernelMultSIMD::max_level = KERNELSIMD_AVX2;
+int KernelMultSIMD::level = minimum((int)KERNELSIMD_AVX2, KernelMultSIMD::Get_Supported_Level());
+
+//-------------------------- SETTINGS
+
+//highest instruction set supported by the CPU (and compiler)
+int KernelMultSIMD::Detect_Supported_Level(void)
+{
+#if KERNELSIMD_COMPILED == 1
+
+#if defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	int max_leaf = info[0];
+	if (max_leaf < 7) return KERNELSIMD_SCALAR;
+
+	//leaf 1 : ecx bit 12 FMA, bit 27 OSXSAVE, bit 28 AVX
+	__cpuid(info, 1);
+	bool fma = info[2] & (1 << 12);
+	bool osxsave = info[2] & (1 << 27);
+	bool avx = info[2] & (1 << 28);
+	if (!fma || !osxsave || !avx) return KERNELSIMD_SCALAR;
+
+	//OS must save the ymm registers (XCR0 bits 1, 2), and for AVX-512 also opmask and zmm registers (XCR0 bits 5, 6, 7)
+	unsigned long long xcr0 = _xgetbv(0);
+	if ((xcr0 & 0x6) != 0x6) return KERNELSIMD_SCALAR;
+
+	//leaf 7 : ebx bit 5 AVX2, bit 16 AVX512F
+	__cpuidex(info, 7, 0);
+	bool avx2 = info[1] & (1 << 5);
+	bool avx512f = info[1] & (1 << 16);
+
+	if (avx512f && (xcr0 & 0xe6) == 0xe6) return KERNELSIMD_AVX512;
+	else if (avx2) return KERNELSIMD_AVX2;
+	else return KERNELSIMD_SCALAR;
+#else
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f")) return KERNELSIMD_AVX512;
+	else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return KERNELSIMD_AVX2;
+	else return KERNELSIMD_SCALAR;
+#endif
+
+#else
+	return KERNELSIMD_SCALAR;
+#endif
+}
+
+//highest instruction set supported, detected once
+int KernelMultSIMD::Get_Supported_Level(void)
+{
+	static int supported_level = Detect_Supported_Level();
+
+	return supported_level;
+}
+
+//set highest instruction set allowed (KERNELSIMD_ enum) and update level in use
+void KernelMultSIMD::Set_Max_Level(int max_level_)
+{
+	if (max_level_ < KERNELSIMD_SCALAR || max_level_ >= KERNELSIMD_NUMENTRIES) return;
+
+	max_level = max_level_;
+	level = (max_level < Get_Supported_Level() ? max_level : Get_Supported_Level());
+}
+
+//name of given instruction set (KERNELSIMD_ enum)
+std::string KernelMultSIMD::Get_Level_Name(int level_)
+{
+	switch (level_) {
+
+	case KERNELSIMD_SCALAR: return "scalar";
+	case KERNELSIMD_AVX2: return "avx2";
+	case KERNELSIMD_AVX512: return "avx512";
+	}
+
+	return "";
+}
+
+//-------------------------- SCALAR VERSIONS
+
+static void Multiply_3D_Scalar(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const DBL3* Kodiag, int ker_stride, DBL3 sign, bool add)
+{
+	for (int p = 0; p < count; p++) {
+
+		ReIm3 FM = In[p * stride];
+
+		DBL3 Kd = Kdiag[p * ker_stride];
+		DBL3 Kod = Kodiag[p * ker_stride] & sign;
+
+		ReIm3 value;
+
+		value.x = (Kd.x * FM.x) + (Kod.x * FM.y) + (Kod.y * FM.z);
+		value.y = (Kod.x * FM.x) + (Kd.y * FM.y) + (Kod.z * FM.z);
+		value.z = (Kod.y * FM.x) + (Kod.z * FM.y) + (Kd.z * FM.z);
+
+		if (add) { Out[p * stride].x += value.x; Out[p * stride].y += value.y; Out[p * stride].z += value.z; }
+		else Out[p * stride] = value;
+	}
+}
+
+static void Multiply_2D_Scalar(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const double* Kxy, int ker_stride, double sign, bool add)
+{
+	for (int p = 0; p < count; p++) {
+
+		ReIm3 FM = In[p * stride];
+
+		DBL3 Kd = Kdiag[p * ker_stride];
+		double Kod = Kxy[p * ker_stride] * sign;
+
+		ReIm3 value;
+
+		value.x = (Kd.x * FM.x) + (Kod * FM.y);
+		value.y = (Kod * FM.x) + (Kd.y * FM.y);
+		value.z = (Kd.z * FM.z);
+
+		if (add) { Out[p * stride].x += value.x; Out[p * stride].y += value.y; Out[p * stride].z += value.z; }
+		else Out[p * stride] = value;
+	}
+}
+
+#if KERNELSIMD_COMPILED == 1
+
+//-------------------------- AVX2 VERSIONS
+
+//(Re, Im) pairs at a and b in low and high lanes
+KERNELSIMD_TARGET_AVX2 static inline __m256d load_pair(const double* a, const double* b)
+{
+	return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(a)), _mm_loadu_pd(b), 1);
+}
+
+//real values at a and b, each duplicated for a (Re, Im) pair
+KERNELSIMD_TARGET_AVX2 static inline __m256d load_pair_dup(const double* a, const double* b)
+{
+	return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loaddup_pd(a)), _mm_loaddup_pd(b), 1);
+}
+
+KERNELSIMD_TARGET_AVX2 static inline void store_pair(double* a, double* b, __m256d value)
+{
+	_mm_storeu_pd(a, _mm256_castpd256_pd128(value));
+	_mm_storeu_pd(b, _mm256_extractf128_pd(value, 1));
+}
+
+KERNELSIMD_TARGET_AVX2 static void Multiply_3D_AVX2(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const DBL3* Kodiag, int ker_stride, DBL3 sign, bool add)
+{
+	__m256d sxy = _mm256_set1_pd(sign.x);
+	__m256d sxz = _mm256_set1_pd(sign.y);
+	__m256d syz = _mm256_set1_pd(sign.z);
+
+	int p = 0;
+
+	for (; p + 1 < count; p += 2) {
+
+		const double* in_a = reinterpret_cast<const double*>(In + p * stride);
+		const double* in_b = reinterpret_cast<const double*>(In + (p + 1) * stride);
+		const double* kd_a = reinterpret_cast<const double*>(Kdiag + p * ker_stride);
+		const double* kd_b = reinterpret_cast<const double*>(Kdiag + (p + 1) * ker_stride);
+		const double* kod_a = reinterpret_cast<const double*>(Kodiag + p * ker_stride);
+		const double* kod_b = reinterpret_cast<const double*>(Kodiag + (p + 1) * ker_stride);
+
+		__m256d X = load_pair(in_a, in_b);
+		__m256d Y = load_pair(in_a + 2, in_b + 2);
+		__m256d Z = load_pair(in_a + 4, in_b + 4);
+
+		__m256d Kxx = load_pair_dup(kd_a, kd_b);
+		__m256d Kyy = load_pair_dup(kd_a + 1, kd_b + 1);
+		__m256d Kzz = load_pair_dup(kd_a + 2, kd_b + 2);
+		__m256d Kxy = _mm256_mul_pd(load_pair_dup(kod_a, kod_b), sxy);
+		__m256d Kxz = _mm256_mul_pd(load_pair_dup(kod_a + 1, kod_b + 1), sxz);
+		__m256d Kyz = _mm256_mul_pd(load_pair_dup(kod_a + 2, kod_b + 2), syz);
+
+		__m256d Ox = _mm256_fmadd_pd(Kxz, Z, _mm256_fmadd_pd(Kxy, Y, _mm256_mul_pd(Kxx, X)));
+		__m256d Oy = _mm256_fmadd_pd(Kyz, Z, _mm256_fmadd_pd(Kyy, Y, _mm256_mul_pd(Kxy, X)));
+		__m256d Oz = _mm256_fmadd_pd(Kzz, Z, _mm256_fmadd_pd(Kyz, Y, _mm256_mul_pd(Kxz, X)));
+
+		double* out_a = reinterpret_cast<double*>(Out + p * stride);
+		double* out_b = reinterpret_cast<double*>(Out + (p + 1) * stride);
+
+		if (add) {
+
+			Ox = _mm256_add_pd(Ox, load_pair(out_a, out_b));
+			Oy = _mm256_add_pd(Oy, load_pair(out_a + 2, out_b + 2));
+			Oz = _mm256_add_pd(Oz, load_pair(out_a + 4, out_b + 4));
+		}
+
+		store_pair(out_a, out_b, Ox);
+		store_pair(out_a + 2, out_b + 2, Oy);
+		store_pair(out_a + 4, out_b + 4, Oz);
+	}
+
+	//remaining point
+	if (p < count) Multiply_3D_Scalar(In + p * stride, Out + p * stride, count - p, stride, Kdiag + p * ker_stride, Kodiag + p * ker_stride, ker_stride, sign, add);
+}
+
+KERNELSIMD_TARGET_AVX2 static void Multiply_2D_AVX2(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const double* Kxy_, int ker_stride, double sign, bool add)
+{
+	__m256d sxy = _mm256_set1_pd(sign);
+
+	int p = 0;
+
+	for (; p + 1 < count; p += 2) {
+
+		const double* in_a = reinterpret_cast<const double*>(In + p * stride);
+		const double* in_b = reinterpret_cast<const double*>(In + (p + 1) * stride);
+		const double* kd_a = reinterpret_cast<const double*>(Kdiag + p * ker_stride);
+		const double* kd_b = reinterpret_cast<const double*>(Kdiag + (p + 1) * ker_stride);
+
+		__m256d X = load_pair(in_a, in_b);
+		__m256d Y = load_pair(in_a + 2, in_b + 2);
+		__m256d Z = load_pair(in_a + 4, in_b + 4);
+
+		__m256d Kxx = load_pair_dup(kd_a, kd_b);
+		__m256d Kyy = load_pair_dup(kd_a + 1, kd_b + 1);
+		__m256d Kzz = load_pair_dup(kd_a + 2, kd_b + 2);
+		__m256d Kxy = _mm256_mul_pd(load_pair_dup(Kxy_ + p * ker_stride, Kxy_ + (p + 1) * ker_stride), sxy);
+
+		__m256d Ox = _mm256_fmadd_pd(Kxy, Y, _mm256_mul_pd(Kxx, X));
+		__m256d Oy = _mm256_fmadd_pd(Kyy, Y, _mm256_mul_pd(Kxy, X));
+		__m256d Oz = _mm256_mul_pd(Kzz, Z);
+
+		double* out_a = reinterpret_cast<double*>(Out + p * stride);
+		double* out_b = reinterpret_cast<double*>(Out + (p + 1) * stride);
+
+		if (add) {
+
+			Ox = _mm256_add_pd(Ox, load_pair(out_a, out_b));
+			Oy = _mm256_add_pd(Oy, load_pair(out_a + 2, out_b + 2));
+			Oz = _mm256_add_pd(Oz, load_pair(out_a + 4, out_b + 4));
+		}
+
+		store_pair(out_a, out_b, Ox);
+		store_pair(out_a + 2, out_b + 2, Oy);
+		store_pair(out_a + 4, out_b + 4, Oz);
+	}
+
+	//remaining point
+	if (p < count) Multiply_2D_Scalar(In + p * stride, Out + p * stride, count - p, stride, Kdiag + p * ker_stride, Kxy_ + p * ker_stride, ker_stride, sign, add);
+}
+
+//-------------------------- AVX-512 VERSIONS
+
+//(Re, Im) pairs at a, b, c, d in consecutive 128-bit lanes
+KERNELSIMD_TARGET_AVX512 static inline __m512d load_quad(const double* a, const double* b, const double* c, const double* d)
+{
+	return _mm512_insertf64x4(_mm512_castpd256_pd512(load_pair(a, b)), load_pair(c, d), 1);
+}
+
+//real values at a, b, c, d, each duplicated for a (Re, Im) pair
+KERNELSIMD_TARGET_AVX512 static inline __m512d load_quad_dup(const double* a, const double* b, const double* c, const double* d)
+{
+	return _mm512_insertf64x4(_mm512_castpd256_pd512(load_pair_dup(a, b)), load_pair_dup(c, d), 1);
+}
+
+KERNELSIMD_TARGET_AVX512 static inline void store_quad(double* a, double* b, double* c, double* d, __m512d value)
+{
+	store_pair(a, b, _mm512_castpd512_pd256(value));
+	store_pair(c, d, _mm512_extractf64x4_pd(value, 1));
+}
+
+KERNELSIMD_TARGET_AVX512 static void Multiply_3D_AVX512(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const DBL3* Kodiag, int ker_stride, DBL3 sign, bool add)
+{
+	__m512d sxy = _mm512_set1_pd(sign.x);
+	__m512d sxz = _mm512_set1_pd(sign.y);
+	__m512d syz = _mm512_set1_pd(sign.z);
+
+	int p = 0;
+
+	for (; p + 3 < count; p += 4) {
+
+		const double* in[4];
+		const double* kd[4];
+		const double* kod[4];
+		double* out[4];
+
+		for (int q = 0; q < 4; q++) {
+
+			in[q] = reinterpret_cast<const double*>(In + (p + q) * stride);
+			kd[q] = reinterpret_cast<const double*>(Kdiag + (p + q) * ker_stride);
+			kod[q] = reinterpret_cast<const double*>(Kodiag + (p + q) * ker_stride);
+			out[q] = reinterpret_cast<double*>(Out + (p + q) * stride);
+		}
+
+		__m512d X = load_quad(in[0], in[1], in[2], in[3]);
+		__m512d Y = load_quad(in[0] + 2, in[1] + 2, in[2] + 2, in[3] + 2);
+		__m512d Z = load_quad(in[0] + 4, in[1] + 4, in[2] + 4, in[3] + 4);
+
+		__m512d Kxx = load_quad_dup(kd[0], kd[1], kd[2], kd[3]);
+		__m512d Kyy = load_quad_dup(kd[0] + 1, kd[1] + 1, kd[2] + 1, kd[3] + 1);
+		__m512d Kzz = load_quad_dup(kd[0] + 2, kd[1] + 2, kd[2] + 2, kd[3] + 2);
+		__m512d Kxy = _mm512_mul_pd(load_quad_dup(kod[0], kod[1], kod[2], kod[3]), sxy);
+		__m512d Kxz = _mm512_mul_pd(load_quad_dup(kod[0] + 1, kod[1] + 1, kod[2] + 1, kod[3] + 1), sxz);
+		__m512d Kyz = _mm512_mul_pd(load_quad_dup(kod[0] + 2, kod[1] + 2, kod[2] + 2, kod[3] + 2), syz);
+
+		__m512d Ox = _mm512_fmadd_pd(Kxz, Z, _mm512_fmadd_pd(Kxy, Y, _mm512_mul_pd(Kxx, X)));
+		__m512d Oy = _mm512_fmadd_pd(Kyz, Z, _mm512_fmadd_pd(Kyy, Y, _mm512_mul_pd(Kxy, X)));
+		__m512d Oz = _mm512_fmadd_pd(Kzz, Z, _mm512_fmadd_pd(Kyz, Y, _mm512_mul_pd(Kxz, X)));
+
+		if (add) {
+
+			Ox = _mm512_add_pd(Ox, load_quad(out[0], out[1], out[2], out[3]));
+			Oy = _mm512_add_pd(Oy, load_quad(out[0] + 2, out[1] + 2, out[2] + 2, out[3] + 2));
+			Oz = _mm512_add_pd(Oz, load_quad(out[0] + 4, out[1] + 4, out[2] + 4, out[3] + 4));
+		}
+
+		store_quad(out[0], out[1], out[2], out[3], Ox);
+		store_quad(out[0] + 2, out[1] + 2, out[2] + 2, out[3] + 2, Oy);
+		store_quad(out[0] + 4, out[1] + 4, out[2] + 4, out[3] + 4, Oz);
+	}
+
+	//remaining points
+	if (p < count) Multiply_3D_AVX2(In + p * stride, Out + p * stride, count - p, stride, Kdiag + p * ker_stride, Kodiag + p * ker_stride, ker_stride, sign, add);
+}
+
+KERNELSIMD_TARGET_AVX512 static void Multiply_2D_AVX512(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const double* Kxy_, int ker_stride, double sign, bool add)
+{
+	__m512d sxy = _mm512_set1_pd(sign);
+
+	int p = 0;
+
+	for (; p + 3 < count; p += 4) {
+
+		const double* in[4];
+		const double* kd[4];
+		const double* kod[4];
+		double* out[4];
+
+		for (int q = 0; q < 4; q++) {
+
+			in[q] = reinterpret_cast<const double*>(In + (p + q) * stride);
+			kd[q] = reinterpret_cast<const double*>(Kdiag + (p + q) * ker_stride);
+			kod[q] = Kxy_ + (p + q) * ker_stride;
+			out[q] = reinterpret_cast<double*>(Out + (p + q) * stride);
+		}
+
+		__m512d X = load_quad(in[0], in[1], in[2], in[3]);
+		__m512d Y = load_quad(in[0] + 2, in[1] + 2, in[2] + 2, in[3] + 2);
+		__m512d Z = load_quad(in[0] + 4, in[1] + 4, in[2] + 4, in[3] + 4);
+
+		__m512d Kxx = load_quad_dup(kd[0], kd[1], kd[2], kd[3]);
+		__m512d Kyy = load_quad_dup(kd[0] + 1, kd[1] + 1, kd[2] + 1, kd[3] + 1);
+		__m512d Kzz = load_quad_dup(kd[0] + 2, kd[1] + 2, kd[2] + 2, kd[3] + 2);
+		__m512d Kxy = _mm512_mul_pd(load_quad_dup(kod[0], kod[1], kod[2], kod[3]), sxy);
+
+		__m512d Ox = _mm512_fmadd_pd(Kxy, Y, _mm512_mul_pd(Kxx, X));
+		__m512d Oy = _mm512_fmadd_pd(Kyy, Y, _mm512_mul_pd(Kxy, X));
+		__m512d Oz = _mm512_mul_pd(Kzz, Z);
+
+		if (add) {
+
+			Ox = _mm512_add_pd(Ox, load_quad(out[0], out[1], out[2], out[3]));
+			Oy = _mm512_add_pd(Oy, load_quad(out[0] + 2, out[1] + 2, out[2] + 2, out[3] + 2));
+			Oz = _mm512_add_pd(Oz, load_quad(out[0] + 4, out[1] + 4, out[2] + 4, out[3] + 4));
+		}
+
+		store_quad(out[0], out[1], out[2], out[3], Ox);
+		store_quad(out[0] + 2, out[1] + 2, out[2] + 2, out[3] + 2, Oy);
+		store_quad(out[0] + 4, out[1] + 4, out[2] + 4, out[3] + 4, Oz);
+	}
+
+	//remaining points
+	if (p < count) Multiply_2D_AVX2(In + p * stride, Out + p * stride, count - p, stride, Kdiag + p * ker_stride, Kxy_ + p * ker_stride, ker_stride, sign, add);
+}
+
+#endif
+
+//-------------------------- MULTIPLICATION
+
+//3D : Out[p] = K[p] * In[p] for count points, where the off-diagonal kernel elements (Kxy, Kxz, Kyz) are multiplied by sign (this is how kernel symmetries are applied).
+//In and Out advance by stride (can be negative to run backwards along a line), kernels by ker_stride. In and Out can be the same (in-place). If add is true then add into Out instead of setting it.
+void KernelMultSIMD::Multiply_3D(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const DBL3* Kodiag, int ker_stride, DBL3 sign, bool add)
+{
+#if KERNELSIMD_COMPILED == 1
+	switch (level) {
+
+	case KERNELSIMD_AVX512:
+		Multiply_3D_AVX512(In, Out, count, stride, Kdiag, Kodiag, ker_stride, sign, add);
+		return;
+
+	case KERNELSIMD_AVX2:
+		Multiply_3D_AVX2(In, Out, count, stride, Kdiag, Kodiag, ker_stride, sign, add);
+		return;
+	}
+#endif
+
+	Multiply_3D_Scalar(In, Out, count, stride, Kdiag, Kodiag, ker_stride, sign, add);
+}
+
+//2D : as above but Kxz = Kyz = 0, with Kxy given as a separate array
+void KernelMultSIMD::Multiply_2D(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const double* Kxy, int ker_stride, double sign, bool add)
+{
+#if KERNELSIMD_COMPILED == 1
+	switch (level) {
+
+	case KERNELSIMD_AVX512:
+		Multiply_2D_AVX512(In, Out, count, stride, Kdiag, Kxy, ker_stride, sign, add);
+		return;
+
+	case KERNELSIMD_AVX2:
+		Multiply_2D_AVX2(In, Out, count, stride, Kdiag, Kxy, ker_stride, sign, add);
+		return;
+	}
+#endif
+
+	Multiply_2D_Scalar(In, Out, count, stride, Kdiag, Kxy, ker_stride, sign, add);
+}
+
+//-------------------------- BENCHMARK
+
+//time 3D multiplication of a line with given number of points (contiguous, single thread) for each supported instruction set, averaged over given number of repeats.
+//Throughput returned in complex multiply-adds per second (9 per point), indexed by KERNELSIMD_ enum, together with the maximum difference from the scalar result.
+BError KernelMultSIMD::Benchmark(int length, int repeats, std::vector<double>& throughput, std::vector<double>& max_difference)
+{
+	BError error(__FUNCTION__);
+
+	if (length < 1 || repeats < 1) return error(BERROR_INCORRECTVALUE);
+
+	std::vector<ReIm3> In(length), Out(length), Out_scalar(length);
+	std::vector<DBL3> Kdiag(length), Kodiag(length);
+
+	BorisRand prng(GetSystemTickCount());
+
+	for (int p = 0; p < length; p++) {
+
+		In[p] = ReIm3(DBL3(prng.rand(), prng.rand(), prng.rand()) - DBL3(0.5), DBL3(prng.rand(), prng.rand(), prng.rand()) - DBL3(0.5));
+		Kdiag[p] = DBL3(prng.rand(), prng.rand(), prng.rand()) - DBL3(0.5);
+		Kodiag[p] = DBL3(prng.rand(), prng.rand(), prng.rand()) - DBL3(0.5);
+	}
+
+	//use a sign pattern as for the upper half of a line
+	DBL3 sign = DBL3(1, -1, -1);
+
+	int level_set = level;
+
+	throughput.assign(KERNELSIMD_NUMENTRIES, 0.0);
+	max_difference.assign(KERNELSIMD_NUMENTRIES, 0.0);
+
+	for (int level_bench = KERNELSIMD_SCALAR; level_bench <= Get_Supported_Level(); level_bench++) {
+
+		level = level_bench;
+
+		//first pass not timed
+		Multiply_3D(In.data(), Out.data(), length, 1, Kdiag.data(), Kodiag.data(), 1, sign);
+
+		double start = omp_get_wtime();
+
+		for (int r = 0; r < repeats; r++) {
+
+			Multiply_3D(In.data(), Out.data(), length, 1, Kdiag.data(), Kodiag.data(), 1, sign);
+		}
+
+		double time = omp_get_wtime() - start;
+
+		if (time > 0.0) throughput[level_bench] = 9.0 * length * repeats / time;
+
+		if (level_bench == KERNELSIMD_SCALAR) Out_scalar = Out;
+		else {
+
+			for (int p = 0; p < length; p++) {
+
+				double difference = (Out[p] - Out_scalar[p]).norm().maxdim();
+				if (difference > max_difference[level_bench]) max_difference[level_bench] = difference;
+			}
+		}
+	}
+
+	level = level_set;
+
+	return error;
+}
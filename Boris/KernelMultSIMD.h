@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BorisLib.h"
+
+#include "ErrorHandler.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Multiplication of FFT-transformed inputs by real, symmetric demag kernels (Kdiag : Kxx, Kyy, Kzz; Kodiag : Kxy, Kxz, Kyz), used by DemagKernel and DemagKernelCollection.
+
+//Explicitly vectorized versions (AVX2 with FMA, AVX-512) are selected at run-time based on the CPU, with a scalar fallback.
+//AVX2 multiplies 2 points at a time, AVX-512 4 points at a time : each register holds the (Re, Im) pairs of one component for consecutive points, thus the real kernel values are duplicated in each pair.
+
+enum KERNELSIMD_ {
+
+	KERNELSIMD_SCALAR = 0,
+	KERNELSIMD_AVX2,
+	KERNELSIMD_AVX512,
+
+	KERNELSIMD_NUMENTRIES
+};
+
+class KernelMultSIMD {
+
+public:
+
+	//highest instruction set allowed (KERNELSIMD_ enum) - KERNELSIMD_AVX2 by default.
+	//The multiplication is limited by loads and shuffles rather than arithmetic, thus AVX-512 is not necessarily faster than AVX2 : use Benchmark to check.
+	static int max_level;
+
+	//instruction set in use : max_level limited to what the CPU supports
+	static int level;
+
+private:
+
+	//highest instruction set supported by the CPU (and compiler)
+	static int Detect_Supported_Level(void);
+
+public:
+
+	//-------------------------- SETTINGS
+
+	//highest instruction set supported, detected once
+	static int Get_Supported_Level(void);
+
+	//set highest instruction set allowed (KERNELSIMD_ enum) and update level in use
+	static void Set_Max_Level(int max_level_);
+
+	//name of given instruction set (KERNELSIMD_ enum)
+	static std::string Get_Level_Name(int level_);
+
+	//-------------------------- MULTIPLICATION
+
+	//3D : Out[p] = K[p] * In[p] for count points, where the off-diagonal kernel elements (Kxy, Kxz, Kyz) are multiplied by sign (this is how kernel symmetries are applied).
+	//In and Out advance by stride (can be negative to run backwards along a line), kernels by ker_stride. In and Out can be the same (in-place). If add is true then add into Out instead of setting it.
+	static void Multiply_3D(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const DBL3* Kodiag, int ker_stride, DBL3 sign, bool add = false);
+
+	//2D : as above but Kxz = Kyz = 0, with Kxy given as a separate array
+	static void Multiply_2D(const ReIm3* In, ReIm3* Out, int count, int stride, const DBL3* Kdiag, const double* Kxy, int ker_stride, double sign, bool add = false);
+
+	//-------------------------- BENCHMARK
+
+	//time 3D multiplication of a line with given number of points (contiguous, single thread) for each supported instruction set, averaged over given number of repeats.
+	//Throughput returned in complex multiply-adds per second (9 per point), indexed by KERNELSIMD_ enum, together with the maximum difference from the scalar result.
+	static BError Benchmark(int length, int repeats, std::vector<double>& throughput, std::vector<double>& max_difference);
+};
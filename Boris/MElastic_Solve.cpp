@@ -43,6 +43,9 @@ double MElastic::Calculate_MElastic_Field(void)
 
 	if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -93,7 +96,9 @@ double MElastic::Calculate_MElastic_Field(void)
 				pMesh->Heff[idx] += Hmel_1_A + Hmel_2_A;
 				pMesh->Heff2[idx] += Hmel_1_B + Hmel_2_B;
 
-				energy += pMesh->M[idx] * (Hmel_1_A + Hmel_2_A) / 2 + pMesh->M2[idx] * (Hmel_1_B + Hmel_2_B) / 2;
+				double cell_energy = pMesh->M[idx] * (Hmel_1_A + Hmel_2_A) / 2 + pMesh->M2[idx] * (Hmel_1_B + Hmel_2_B) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hmel_1_A + Hmel_2_A;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hmel_1_B + Hmel_2_B;
@@ -101,10 +106,15 @@ double MElastic::Calculate_MElastic_Field(void)
 				if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * pMesh->M2[idx] * (Hmel_1_B + Hmel_2_B) / 2;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -142,12 +152,16 @@ double MElastic::Calculate_MElastic_Field(void)
 
 				pMesh->Heff[idx] += Hmel_1 + Hmel_2;
 
-				energy += pMesh->M[idx] * (Hmel_1 + Hmel_2);
+				double cell_energy = pMesh->M[idx] * (Hmel_1 + Hmel_2);
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hmel_1 + Hmel_2;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * (Hmel_1 + Hmel_2) / 2;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	if (pMesh->M.get_nonempty_cells()) energy *= -MU0 / (2 * pMesh->M.get_nonempty_cells());
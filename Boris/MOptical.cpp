@@ -102,6 +102,9 @@ double MOptical::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -112,17 +115,24 @@ double MOptical::UpdateField(void)
 			pMesh->Heff[idx] += DBL3(0, 0, cHmo);
 			pMesh->Heff2[idx] += DBL3(0, 0, cHmo);
 
-			energy += (pMesh->M[idx] + pMesh->M2[idx]) * DBL3(0, 0, cHmo) / 2;
+			double cell_energy = (pMesh->M[idx] + pMesh->M2[idx]) * DBL3(0, 0, cHmo) / 2;
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = DBL3(0, 0, cHmo);
 			if (Module_Heff2.linear_size()) Module_Heff2[idx] = DBL3(0, 0, cHmo);
 			if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * DBL3(0, 0, cHmo);
 			if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * pMesh->M2[idx] * DBL3(0, 0, cHmo);
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -132,11 +142,15 @@ double MOptical::UpdateField(void)
 			//magneto-optical field along z direction only : spatial and time dependence set through the usual material parameter mechanism
 			pMesh->Heff[idx] += DBL3(0, 0, cHmo);
 
-			energy += pMesh->M[idx] * DBL3(0, 0, cHmo);
+			double cell_energy = pMesh->M[idx] * DBL3(0, 0, cHmo);
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = DBL3(0, 0, cHmo);
 			if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * DBL3(0, 0, cHmo);
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	if (pMesh->M.get_nonempty_cells()) energy *= -MU0 / pMesh->M.get_nonempty_cells();
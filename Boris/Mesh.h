@@ -48,6 +48,16 @@ public:
 	//Additional effective field used for antiferromagnetic meshes with 2 sub-lattice local approximation; exactly same dimensions as Heff
 	VEC<DBL3> Heff2;
 
+	//-----Active set relaxation (see DiffEq_CommonBase_ActiveSet.cpp)
+
+	//cells frozen during relaxation stages, since their torque is below threshold : not evolved by the ODE solver and skipped by local field modules. Empty if active set relaxation not in use.
+	std::vector<char> activeset_frozen;
+
+	//-----Ensemble runs (see SimEnsemble.cpp)
+
+	//starting magnetization state for all replicas. Empty if no ensemble run in progress.
+	std::vector<DBL3> ensemble_M, ensemble_M2;
+
 	//-----Electric conduction properties (Electron charge and spin Transport)
 
 	//In Meshbase
@@ -211,6 +221,12 @@ public:
 	BError Set_Magnetic_PBC(INT3 pbc_images);
 	INT3 Get_Magnetic_PBC(void) { return INT3(M.is_pbc_x(), M.is_pbc_y(), M.is_pbc_z()); }
 
+	//Ensemble runs : save current magnetization state as the starting state for all replicas, restore it before a new replica, or free memory at the end of the ensemble run
+	void Ensemble_SaveState(void);
+	void Ensemble_RestoreState(void);
+	void Ensemble_ClearState(void);
+	bool Ensemble_HasState(void) { return MeshBase::Ensemble_HasState() && ensemble_M.size() == M.linear_size() && ensemble_M2.size() == M2.linear_size(); }
+
 	//----------------------------------- MODULES CONTROL (implement MeshBase) : MeshModules.cpp
 
 	//Add module to list of set modules, also deleting any exclusive modules to this one
@@ -355,6 +371,12 @@ public:
 	bool iSHA_nonzero(void) { return IsNZ(iSHA.get0()); }
 	bool SHA_nonzero(void) { return IsNZ(SHA.get0()); }
 
+	//is this cell frozen by active set relaxation? (local field modules skip frozen cells)
+	bool is_activeset_frozen(int idx) const { return activeset_frozen.size() && activeset_frozen[idx]; }
+
+	//is active set relaxation in use for this mesh? (local field modules then cache cell energy densities, which are used for frozen cells)
+	bool is_activeset_used(void) const { return activeset_frozen.size(); }
+
 	//----------------------------------- VALUE GETTERS : MeshGetData.cpp
 
 	//------Specific to Mesh
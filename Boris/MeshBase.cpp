@@ -127,4 +127,83 @@ std::vector<MOD_> MeshBase::GetModulesIDs(void)
 	}
 
 	return set_modules;
+}
+
+//----------------------------------- ENSEMBLE RUNS
+
+//Ensemble runs : save current temperature, electrical potential and spin accumulation (if set) as the starting state for all replicas
+//Electrical potential and spin accumulation are recomputed at every step, but the iterative solvers start from the previous solution, so these are saved too.
+void MeshBase::Ensemble_SaveState(void)
+{
+#if COMPILECUDA == 1
+	if (pMeshBaseCUDA) {
+
+		if (V.linear_size()) pMeshBaseCUDA->V()->copy_to_cpuvec(V);
+		if (S.linear_size()) pMeshBaseCUDA->S()->copy_to_cpuvec(S);
+		if (Temp.linear_size()) pMeshBaseCUDA->Temp()->copy_to_cpuvec(Temp);
+		if (Temp_l.linear_size()) pMeshBaseCUDA->Temp_l()->copy_to_cpuvec(Temp_l);
+	}
+#endif
+
+	ensemble_V.resize(V.linear_size());
+	ensemble_S.resize(S.linear_size());
+	ensemble_Temp.resize(Temp.linear_size());
+	ensemble_Temp_l.resize(Temp_l.linear_size());
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_V.size(); idx++) ensemble_V[idx] = V[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_S.size(); idx++) ensemble_S[idx] = S[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_Temp.size(); idx++) ensemble_Temp[idx] = Temp[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_Temp_l.size(); idx++) ensemble_Temp_l[idx] = Temp_l[idx];
+}
+
+//Ensemble runs : restore starting temperature, electrical potential and spin accumulation before a new replica
+void MeshBase::Ensemble_RestoreState(void)
+{
+	//mesh could have been changed since the state was saved
+	if (!MeshBase::Ensemble_HasState()) return;
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_V.size(); idx++) V[idx] = ensemble_V[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_S.size(); idx++) S[idx] = ensemble_S[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_Temp.size(); idx++) Temp[idx] = ensemble_Temp[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_Temp_l.size(); idx++) Temp_l[idx] = ensemble_Temp_l[idx];
+
+#if COMPILECUDA == 1
+	if (pMeshBaseCUDA) {
+
+		if (V.linear_size()) pMeshBaseCUDA->V()->copy_from_cpuvec(V);
+		if (S.linear_size()) pMeshBaseCUDA->S()->copy_from_cpuvec(S);
+		if (Temp.linear_size()) pMeshBaseCUDA->Temp()->copy_from_cpuvec(Temp);
+		if (Temp_l.linear_size()) pMeshBaseCUDA->Temp_l()->copy_from_cpuvec(Temp_l);
+	}
+#endif
+}
+
+//Ensemble runs : free memory at the end of the ensemble run
+void MeshBase::Ensemble_ClearState(void)
+{
+	ensemble_V.clear(); ensemble_V.shrink_to_fit();
+	ensemble_S.clear(); ensemble_S.shrink_to_fit();
+	ensemble_Temp.clear(); ensemble_Temp.shrink_to_fit();
+	ensemble_Temp_l.clear(); ensemble_Temp_l.shrink_to_fit();
+}
+
+//Ensemble runs : is a starting state available to restore for this mesh?
+bool MeshBase::Ensemble_HasState(void)
+{
+	return ensemble_V.size() == V.linear_size() && ensemble_S.size() == S.linear_size() &&
+		ensemble_Temp.size() == Temp.linear_size() && ensemble_Temp_l.size() == Temp_l.linear_size();
 }
\ No newline at end of file
@@ -64,6 +64,12 @@ protected:
 	//auxiliary VEC for computations
 	VEC<DBL3> auxVEC;
 
+	//-----Ensemble runs (see SimEnsemble.cpp)
+
+	//starting temperature, electrical potential and spin accumulation for all replicas. Empty if no ensemble run in progress, or if not set in this mesh.
+	std::vector<double> ensemble_Temp, ensemble_Temp_l, ensemble_V;
+	std::vector<DBL3> ensemble_S;
+
 	//--------Mesh ID
 
 	//the type of mesh
@@ -131,6 +137,14 @@ protected:
 	//Constrained Monte-Carlo direction
 	DBL3 cmc_n = DBL3(1.0, 0.0, 0.0);
 
+	// Additional MONTE-CARLO moves (atomistic meshes, classic Monte-Carlo only)
+
+	//number of over-relaxation sweeps taken after every Metropolis step
+	int mc_overrelax = 0;
+
+	//take a Wolff-type cluster update after every Metropolis step?
+	bool mc_cluster = false;
+
 public:
 
 #if COMPILECUDA == 1
@@ -264,6 +278,15 @@ public:
 	virtual void Iterate_MonteCarloCUDA(double acceptance_rate) {}
 #endif
 
+	//Ensemble runs : save current temperature, electrical potential and spin accumulation (if set) as the starting state for all replicas, restore it before a new replica, or free memory at the end of the ensemble run.
+	//Magnetic mesh implementations extend these to also save the magnetization.
+	virtual void Ensemble_SaveState(void);
+	virtual void Ensemble_RestoreState(void);
+	virtual void Ensemble_ClearState(void);
+
+	//Ensemble runs : is a starting state available to restore for this mesh?
+	virtual bool Ensemble_HasState(void);
+
 	//----------------------------------- OTHER CONTROL METHODS
 
 	//used by move mesh algorithm : shift mesh quantities (e.g. magnetization) by the given shift (metric units) value within this mesh. The shift is along the x-axis direction only (+ve or -ve).
@@ -287,6 +310,9 @@ public:
 	void Set_MonteCarlo_Constrained(DBL3 cmc_n_);
 	DBL3 Get_MonteCarlo_Constrained_Direction(void) { return cmc_n; }
 
+	void Set_MonteCarlo_Moves(int overrelax, bool cluster) { mc_overrelax = (overrelax > 0 ? overrelax : 0); mc_cluster = cluster; }
+	INT2 Get_MonteCarlo_Moves(void) { return INT2(mc_overrelax, mc_cluster); }
+
 	//----------------------------------- MODULES indexing
 
 	//index by actual index in pMod
@@ -390,6 +416,7 @@ public:
 	virtual BError set_tensorial_anisotropy(std::vector<DBL4> Kt) { return BError(); }
 
 	DBL2 Get_MonteCarlo_Params(void) { return DBL2(mc_cone_angledeg, mc_acceptance_rate); }
+	void Set_MonteCarlo_ConeAngle(double cone_angledeg) { mc_cone_angledeg = cone_angledeg; }
 
 	//----------------------------------- DISPLAY-ASSOCIATED GET/SET METHODS
 
@@ -62,4 +62,59 @@ BError Mesh::Set_Magnetic_PBC(INT3 pbc_images)
 #endif
 
 	return error;
+}
+
+//Ensemble runs : save current magnetization state, as well as temperature, electrical potential and spin accumulation, as the starting state for all replicas
+void Mesh::Ensemble_SaveState(void)
+{
+	MeshBase::Ensemble_SaveState();
+
+#if COMPILECUDA == 1
+	if (pMeshCUDA) {
+
+		if (M.linear_size()) pMeshCUDA->M()->copy_to_cpuvec(M);
+		if (M2.linear_size()) pMeshCUDA->M2()->copy_to_cpuvec(M2);
+	}
+#endif
+
+	ensemble_M.resize(M.linear_size());
+	ensemble_M2.resize(M2.linear_size());
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M.size(); idx++) ensemble_M[idx] = M[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M2.size(); idx++) ensemble_M2[idx] = M2[idx];
+}
+
+//Ensemble runs : restore starting magnetization state, as well as temperature, electrical potential and spin accumulation, before a new replica
+void Mesh::Ensemble_RestoreState(void)
+{
+	MeshBase::Ensemble_RestoreState();
+
+	//mesh could have been changed since the state was saved
+	if (ensemble_M.size() != M.linear_size() || ensemble_M2.size() != M2.linear_size()) return;
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M.size(); idx++) M[idx] = ensemble_M[idx];
+
+#pragma omp parallel for
+	for (int idx = 0; idx < ensemble_M2.size(); idx++) M2[idx] = ensemble_M2[idx];
+
+#if COMPILECUDA == 1
+	if (pMeshCUDA) {
+
+		if (M.linear_size()) pMeshCUDA->M()->copy_from_cpuvec(M);
+		if (M2.linear_size()) pMeshCUDA->M2()->copy_from_cpuvec(M2);
+	}
+#endif
+}
+
+//Ensemble runs : free memory at the end of the ensemble run
+void Mesh::Ensemble_ClearState(void)
+{
+	MeshBase::Ensemble_ClearState();
+
+	ensemble_M.clear(); ensemble_M.shrink_to_fit();
+	ensemble_M2.clear(); ensemble_M2.shrink_to_fit();
 }
\ No newline at end of file
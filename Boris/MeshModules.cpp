@@ -28,6 +28,10 @@ BError Mesh::AddModule(MOD_ moduleID, bool force_add)
 		pMod.push_back(new Demag(this), MOD_DEMAG);
 		break;
 
+	case MOD_DEMAG_TREE:
+		pMod.push_back(new DemagTree(this), MOD_DEMAG_TREE);
+		break;
+
 	//individual mesh demag module used by SDemag super-mesh module - not available in the console, but added when SDemag module is enabled
 	case MOD_SDEMAG_DEMAG:
 		//there's the option of excluding this mesh from multilayered demag convolution
@@ -28,7 +28,7 @@ DBL3 AFMesh::Average_dmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -39,7 +39,7 @@ DBL3 AFMesh::Average_dmdt(Rect avRect)
 
 				if (M.is_not_empty(idx)) {
 
-					reduction.reduce_average(meshODE.dMdt(idx) / M[idx].norm());
+					reduction.reduce_average(meshODE.dMdt(idx) / M[idx].norm(), idx);
 				}
 			}
 		}
@@ -58,7 +58,7 @@ DBL3 AFMesh::Average_dmdt2(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -69,7 +69,7 @@ DBL3 AFMesh::Average_dmdt2(Rect avRect)
 
 				if (M2.is_not_empty(idx)) {
 
-					reduction.reduce_average(meshODE.dMdt2(idx) / M2[idx].norm());
+					reduction.reduce_average(meshODE.dMdt2(idx) / M2[idx].norm(), idx);
 				}
 			}
 		}
@@ -89,7 +89,7 @@ DBL3 AFMesh::Average_mxdmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -101,7 +101,7 @@ DBL3 AFMesh::Average_mxdmdt(Rect avRect)
 				if (M.is_not_empty(idx)) {
 
 					double norm = M[idx].norm();
-					reduction.reduce_average((M[idx] / norm) ^ (meshODE.dMdt(idx) / norm));
+					reduction.reduce_average((M[idx] / norm) ^ (meshODE.dMdt(idx) / norm), idx);
 				}
 			}
 		}
@@ -121,7 +121,7 @@ DBL3 AFMesh::Average_mxdmdt2(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -133,7 +133,7 @@ DBL3 AFMesh::Average_mxdmdt2(Rect avRect)
 				if (M2.is_not_empty(idx)) {
 
 					double norm = M2[idx].norm();
-					reduction.reduce_average((M2[idx] / norm) ^ (meshODE.dMdt2(idx) / norm));
+					reduction.reduce_average((M2[idx] / norm) ^ (meshODE.dMdt2(idx) / norm), idx);
 				}
 			}
 		}
@@ -153,7 +153,7 @@ DBL3 AFMesh::Average_mxdm2dt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -166,7 +166,7 @@ DBL3 AFMesh::Average_mxdm2dt(Rect avRect)
 
 					double normA = M[idx].norm();
 					double normB = M2[idx].norm();
-					reduction.reduce_average((M[idx] / normA) ^ (meshODE.dMdt2(idx) / normB));
+					reduction.reduce_average((M[idx] / normA) ^ (meshODE.dMdt2(idx) / normB), idx);
 				}
 			}
 		}
@@ -185,7 +185,7 @@ DBL3 AFMesh::Average_m2xdmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -198,7 +198,7 @@ DBL3 AFMesh::Average_m2xdmdt(Rect avRect)
 
 					double normA = M[idx].norm();
 					double normB = M2[idx].norm();
-					reduction.reduce_average((M2[idx] / normB) ^ (meshODE.dMdt(idx) / normA));
+					reduction.reduce_average((M2[idx] / normB) ^ (meshODE.dMdt(idx) / normA), idx);
 				}
 			}
 		}
@@ -21,6 +21,7 @@
 #include "SurfExchange_AFM.h"
 #include "Demag.h"
 #include "Demag_N.h"
+#include "DemagTree.h"
 #include "SDemag_Demag.h"
 #include "StrayField_Mesh.h"
 #include "Zeeman.h"
@@ -293,10 +294,8 @@ public:
 
 	//----------------------------------- GETTERS
 
-#if COMPILECUDA == 1
 	//get reference to stored differential equation object (meshODE)
 	DifferentialEquationFM& Get_DifferentialEquation(void) { return meshODE; }
-#endif
 };
 
 #else
@@ -344,10 +343,8 @@ public:
 
 	//----------------------------------- GETTERS
 
-#if COMPILECUDA == 1
 	//get reference to stored differential equation object (meshODE)
 	DifferentialEquationFM& Get_DifferentialEquation(void) { return meshODE; }
-#endif
 };
 
 #endif
\ No newline at end of file
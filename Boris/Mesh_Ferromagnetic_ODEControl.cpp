@@ -28,7 +28,7 @@ DBL3 FMesh::Average_dmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -39,7 +39,7 @@ DBL3 FMesh::Average_dmdt(Rect avRect)
 
 				if (M.is_not_empty(idx)) {
 
-					reduction.reduce_average(meshODE.dMdt(idx) / M[idx].norm());
+					reduction.reduce_average(meshODE.dMdt(idx) / M[idx].norm(), idx);
 				}
 			}
 		}
@@ -59,7 +59,7 @@ DBL3 FMesh::Average_mxdmdt(Rect avRect)
 #endif
 
 	OmpReduction<DBL3> reduction;
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -71,7 +71,7 @@ DBL3 FMesh::Average_mxdmdt(Rect avRect)
 				if (M.is_not_empty(idx)) {
 
 					double norm = M[idx].norm();
-					reduction.reduce_average((M[idx] / norm) ^ (meshODE.dMdt(idx) / norm));
+					reduction.reduce_average((M[idx] / norm) ^ (meshODE.dMdt(idx) / norm), idx);
 				}
 			}
 		}
@@ -106,7 +106,7 @@ DBL3 Modules::CalculateTorque(VEC_VC<DBL3>& M, Rect& avRect)
 
 	Box box = M.box_from_rect_max(avRect + M.rect.s);
 
-	reduction.new_average_reduction();
+	reduction.new_average_reduction(M.n.dim());
 
 	for (int k = box.s.k; k < box.e.k; k++) {
 #pragma omp parallel for
@@ -114,7 +114,7 @@ DBL3 Modules::CalculateTorque(VEC_VC<DBL3>& M, Rect& avRect)
 			for (int i = box.s.i; i < box.e.i; i++) {
 
 				int idx = i + j * M.n.x + k * M.n.x*M.n.y;
-				if (M.is_not_empty(idx)) reduction.reduce_average(M[idx] ^ Module_Heff[idx]);
+				if (M.is_not_empty(idx)) reduction.reduce_average(M[idx] ^ Module_Heff[idx], idx);
 			}
 		}
 	}
@@ -122,6 +122,20 @@ DBL3 Modules::CalculateTorque(VEC_VC<DBL3>& M, Rect& avRect)
 	return reduction.average();
 }
 
+//size activeset_energy to num_cells if active set relaxation is in use, else free it. Return true if activeset_energy is to be used.
+bool Modules::ActiveSet_EnergyCache(bool activeset, int num_cells)
+{
+	if (activeset && malloc_vector(activeset_energy, num_cells)) return true;
+
+	if (activeset_energy.size()) {
+
+		activeset_energy.clear();
+		activeset_energy.shrink_to_fit();
+	}
+
+	return false;
+}
+
 //-------------------------- Energy density calculation
 
 //Get energy density averaged over the entire mesh during the UpdateField call
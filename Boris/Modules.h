@@ -29,6 +29,12 @@ protected:
 	//energy value for this effective field term
 	double energy = 0.0;
 
+	//energy reduction for UpdateField, used only if deterministic reductions are enabled (otherwise an OpenMP reduction clause is used)
+	OmpReduction<double> energy_reduction;
+
+	//active set relaxation : energy density of each cell computed while active, added to the energy sum for cells which are frozen. Empty if active set relaxation not in use.
+	std::vector<double> activeset_energy;
+
 	//The CUDA version of this module (ModulesCUDA is the interface and when CUDA is switched on an implementation is created depending on module type)
 #if COMPILECUDA == 1
 	ModulesCUDA* pModuleCUDA = nullptr;
@@ -50,6 +56,9 @@ protected:
 	//return cross product of M with Module_Heff, averaged in given rect (relative)
 	DBL3 CalculateTorque(VEC_VC<DBL3>& M, Rect& avRect);
 
+	//size activeset_energy to num_cells if active set relaxation is in use, else free it. Return true if activeset_energy is to be used.
+	bool ActiveSet_EnergyCache(bool activeset, int num_cells);
+
 public:
 
 	//-------------------------- Constructor and Destructor
@@ -7,7 +7,7 @@ enum MOD_ {
 	MOD_ALL = -1, MOD_ERROR = 0,
 
 	//demag
-	MOD_DEMAG_N = 1, MOD_DEMAG = 2, MODS_SDEMAG = 3, MOD_SDEMAG_DEMAG = 19,
+	MOD_DEMAG_N = 1, MOD_DEMAG = 2, MODS_SDEMAG = 3, MOD_SDEMAG_DEMAG = 19, MOD_DEMAG_TREE = 30,
 
 	//exchange
 	MOD_EXCHANGE = 4, MOD_DMEXCHANGE = 5, MOD_IDMEXCHANGE = 6, MOD_VIDMEXCHANGE = 26, MOD_SURFEXCHANGE = 7,
@@ -39,4 +39,4 @@ enum MOD_ {
 	//atomistic dipole-dipole
 	MOD_ATOM_DIPOLEDIPOLE = 22
 }; 
-//highest integer : 29
+//highest integer : 30
@@ -357,6 +357,9 @@ double Roughness::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -369,16 +372,23 @@ double Roughness::UpdateField(void)
 
 				pMesh->Heff[idx] += Hrough;
 
-				energy += Hrough * pMesh->M[idx];
+				double cell_energy = Hrough * pMesh->M[idx];
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hrough;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hrough / 2;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -392,7 +402,9 @@ double Roughness::UpdateField(void)
 				pMesh->Heff[idx] += Hrough;
 				pMesh->Heff2[idx] += Hrough;
 
-				energy += Hrough * (pMesh->M[idx] + pMesh->M2[idx]) / 2;
+				double cell_energy = Hrough * (pMesh->M[idx] + pMesh->M2[idx]) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hrough;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hrough;
@@ -400,6 +412,8 @@ double Roughness::UpdateField(void)
 				if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * pMesh->M2[idx] * Hrough / 2;
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	//average energy density
@@ -616,6 +616,28 @@ BError SDemag::Initialize_Mesh_Transfer(void)
 	return error;
 }
 
+//run forward ffts, kernel multiplications and inverse ffts for each mesh as single-threaded tasks? (see ConvolutionData::multiconv_tasks)
+//For the output stage (inverse ffts) also require each SDemag_Demag module to be in a different mesh (not the case with 2D layering), since outputs are added into the mesh effective fields.
+bool SDemag::Use_MultiConv_Tasks(bool output_stage)
+{
+	if (ConvolutionData::profiling || pSDemag_Demag.size() < 2) return false;
+
+	if (ConvolutionData::multiconv_tasks == MULTICONVTASKS_DISABLED) return false;
+	if (ConvolutionData::multiconv_tasks == MULTICONVTASKS_AUTO && (int)pSDemag_Demag.size() < omp_get_max_threads()) return false;
+
+	if (output_stage) {
+
+		for (int idx = 0; idx < pSDemag_Demag.size(); idx++) {
+			for (int idx2 = idx + 1; idx2 < pSDemag_Demag.size(); idx2++) {
+
+				if (pSDemag_Demag[idx]->pMeshBase == pSDemag_Demag[idx2]->pMeshBase) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 void SDemag::UninitializeAll(void)
 {
 	Uninitialize();
@@ -787,8 +809,11 @@ double SDemag::UpdateField(void)
 
 	else {
 
-		//Forward FFT for all ferromagnetic meshes
-		for (int idx = 0; idx < pSDemag_Demag.size(); idx++) {
+		//run each stage for all meshes as independent single-threaded tasks? Nested parallel regions (i.e. those inside each task) then run on the calling thread only.
+		bool multiconv_tasks = Use_MultiConv_Tasks(false);
+
+		//Forward FFT for given ferromagnetic mesh
+		auto forward_fft = [&](int idx) -> void {
 
 			///////////////////////////////////////////////////////////////////////////////////////////////
 			//////////////////////////////////// ANTIFERROMAGNETIC MESH ///////////////////////////////////
@@ -830,12 +855,31 @@ double SDemag::UpdateField(void)
 					pSDemag_Demag[idx]->ForwardFFT(pSDemag_Demag[idx]->pMesh->M);
 				}
 			}
+		};
+
+		//Forward FFT for all ferromagnetic meshes
+		if (multiconv_tasks) {
+
+#pragma omp parallel for schedule(dynamic)
+			for (int idx = 0; idx < (int)pSDemag_Demag.size(); idx++) forward_fft(idx);
+		}
+		else {
+
+			for (int idx = 0; idx < (int)pSDemag_Demag.size(); idx++) forward_fft(idx);
 		}
 
 		//Kernel multiplications for multiple inputs. Reverse loop ordering improves cache use at both ends.
-		for (int idx = pSDemag_Demag.size() - 1; idx >= 0; idx--) {
+		if (multiconv_tasks) {
 
-			pSDemag_Demag[idx]->KernelMultiplication_MultipleInputs(FFT_Spaces_Input);
+#pragma omp parallel for schedule(dynamic)
+			for (int idx = (int)pSDemag_Demag.size() - 1; idx >= 0; idx--) pSDemag_Demag[idx]->KernelMultiplication_MultipleInputs(FFT_Spaces_Input);
+		}
+		else {
+
+			for (int idx = pSDemag_Demag.size() - 1; idx >= 0; idx--) {
+
+				pSDemag_Demag[idx]->KernelMultiplication_MultipleInputs(FFT_Spaces_Input);
+			}
 		}
 
 		///////////////////////////////////////////////////////////////////////////////////////////////
@@ -848,8 +892,8 @@ double SDemag::UpdateField(void)
 
 			energy = 0;
 
-			//Inverse FFT
-			for (int idx = 0; idx < pSDemag_Demag.size(); idx++) {
+			//Inverse FFT for given ferromagnetic mesh
+			auto inverse_fft = [&](int idx) -> void {
 
 				///////////////////////////////////////////////////////////////////////////////////////////////
 				//////////////////////////////////// ANTIFERROMAGNETIC MESH ///////////////////////////////////
@@ -925,8 +969,22 @@ double SDemag::UpdateField(void)
 						}
 					}
 				}
+			};
+
+			//Inverse FFT for all ferromagnetic meshes
+			if (Use_MultiConv_Tasks(true)) {
+
+#pragma omp parallel for schedule(dynamic)
+				for (int idx = 0; idx < (int)pSDemag_Demag.size(); idx++) inverse_fft(idx);
+			}
+			else {
+
+				for (int idx = 0; idx < (int)pSDemag_Demag.size(); idx++) inverse_fft(idx);
+			}
+
+			//build total energy
+			for (int idx = 0; idx < pSDemag_Demag.size(); idx++) {
 
-				//build total energy
 				energy += pSDemag_Demag[idx]->energy * pSDemag_Demag[idx]->energy_density_weight;
 			}
 		}
@@ -129,6 +129,10 @@ private:
 	//initialize transfer object for supermesh convolution
 	BError Initialize_Mesh_Transfer(void);
 
+	//run forward ffts, kernel multiplications and inverse ffts for each mesh as single-threaded tasks? (see ConvolutionData::multiconv_tasks)
+	//For the output stage (inverse ffts) also require each SDemag_Demag module to be in a different mesh.
+	bool Use_MultiConv_Tasks(bool output_stage);
+
 	//Set PBC settings for M in all meshes
 	BError Set_Magnetic_PBC(void);
 
@@ -156,6 +156,12 @@ void Simulation::PrepareRunSimulation(void)
 	//show any warnings, and continue
 	if (error.warning_set()) err_hndl.show_error(error, true);
 
+	//keep any new FFTW plans made during initialization for subsequent runs
+	ConvolutionData::Save_FFTW_Wisdom();
+
+	//if stopped during multi-rate stepping the saved micromagnetic states are stale : resume with a micromagnetic time step
+	SMesh.Multirate_Restart();
+
 	//set initial stage values if at the beginning (stage = 0, step = 0, and stageiteration = 0)
 	if (Check_and_GetStageStep() == INT2()) {
 
@@ -163,6 +169,8 @@ void Simulation::PrepareRunSimulation(void)
 
 			SetSimulationStageValue();
 			appendToDataFile = false;
+
+			Ensemble_Begin();
 		}
 	}
 
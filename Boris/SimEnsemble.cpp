@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "Simulation.h"
+
+//----------------------------------- Ensemble Runs
+
+//Switching probability statistics require many replicas of the same stochastic simulation, differing only in the random number sequence used.
+//Instead of launching a separate process for each replica (each recomputing demag kernels, FFT plans, material tables), the simulation schedule is run ensemble_replicas times in this process.
+//The magnetization state at the start of the schedule is saved (together with temperature, electrical potential and spin accumulation if set), and at the end of the schedule it is restored, the ODE solver reset, and the schedule restarted for the next replica.
+//The elastodynamics solver state (velocity and stress) is not saved, so ensemble runs are not available when it is enabled.
+//Modules are not re-initialized between replicas, so demag kernels and FFT plans are reused. The random number generators are not re-seeded, so each replica continues with a new sequence.
+//Each replica saves data to its own data file : savedataFile with _r<replica> appended to the file name (before the termination).
+
+//set number of replicas for ensemble runs (0 or 1 to disable)
+void Simulation::SetEnsembleReplicas(int replicas)
+{
+	ensemble_replicas = (replicas > 1 ? replicas : 0);
+	ensemble_replica = 0;
+
+	if (!ensemble_replicas) {
+
+		for (int idx = 0; idx < SMesh.size(); idx++) SMesh[idx]->Ensemble_ClearState();
+	}
+}
+
+//ensemble runs are not available with the elastodynamics solver enabled (velocity and stress held by the elastic modules are not saved for the replicas)
+bool Simulation::Ensemble_Available(void)
+{
+	return !(SMesh.IsSuperMeshModuleSet(MODS_SMELASTIC) && SMesh.CallModuleMethod(&SMElastic::get_el_dT) > 0.0);
+}
+
+//called by PrepareRunSimulation when starting from the beginning of the schedule : save the starting state for all replicas
+void Simulation::Ensemble_Begin(void)
+{
+	ensemble_replica = 0;
+
+	if (ensemble_replicas < 2) return;
+
+	if (!Ensemble_Available()) {
+
+		BD.DisplayConsoleError("Ensemble runs are not available with the elastodynamics solver enabled : only a single replica will be run.");
+		return;
+	}
+
+	for (int idx = 0; idx < SMesh.size(); idx++) SMesh[idx]->Ensemble_SaveState();
+}
+
+//called when the schedule reaches the end : if running an ensemble start the next replica and return true, else return false (simulation must be stopped)
+bool Simulation::Ensemble_NextReplica(void)
+{
+	if (ensemble_replicas < 2 || single_stage_run || !Ensemble_Available()) return false;
+
+	if (ensemble_replica >= ensemble_replicas - 1) {
+
+		//ensemble finished : free memory used for the starting state
+		for (int idx = 0; idx < SMesh.size(); idx++) SMesh[idx]->Ensemble_ClearState();
+
+		return false;
+	}
+
+	//the starting state is saved only when the ensemble run starts from the beginning of the schedule, and is not saved with the simulation file : never continue from the end state of the previous replica
+	for (int idx = 0; idx < SMesh.size(); idx++) {
+
+		if (!SMesh[idx]->Ensemble_HasState()) {
+
+			for (int idx_clear = 0; idx_clear < SMesh.size(); idx_clear++) SMesh[idx_clear]->Ensemble_ClearState();
+
+			BD.DisplayConsoleError("Ensemble run stopped : starting state not available. Start the ensemble run from the beginning of the simulation schedule, and don't change meshes during the run.");
+
+			return false;
+		}
+	}
+
+	//flush data for the current replica to its own file, before changing replica index (wait for any asynchronous flush to finish first)
+	while (is_thread_running(THREAD_DISKACCESS)) {}
+	if (savedata_diskbuffer_position) SaveData_DiskBufferFlush(&savedata_diskbuffer, &savedata_diskbuffer_position);
+
+	ensemble_replica++;
+
+	//new data file for next replica
+	appendToDataFile = false;
+
+	//restore starting state and restart schedule
+	for (int idx = 0; idx < SMesh.size(); idx++) SMesh[idx]->Ensemble_RestoreState();
+
+	stage_step = INT2();
+	SMesh.ResetODE();
+	SetSimulationStageValue();
+
+	BD.DisplayConsoleMessage("Ensemble replica " + ToString(ensemble_replica) + " of " + ToString(ensemble_replicas) + " started.");
+
+	return true;
+}
+
+//data file name for current replica (savedataFile if ensemble runs disabled)
+std::string Simulation::GetEnsembleDataFile(void)
+{
+	if (ensemble_replicas < 2) return savedataFile;
+
+	std::string termination = GetFileTermination(savedataFile);
+
+	return savedataFile.substr(0, savedataFile.length() - termination.length()) + "_r" + ToString(ensemble_replica) + termination;
+}
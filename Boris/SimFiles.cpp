@@ -7,6 +7,9 @@ BError Simulation::SaveSimulation(std::string fileName)
 
 	StopSimulation();
 
+	//cells frozen by active set relaxation are marked as skip cells in M, which are saved, but the list of frozen cells is not : release them first so they are not stuck after loading
+	SMesh.ActiveSet_Release();
+
 	if (GetFileTermination(fileName) != ".bsm")
 		fileName += ".bsm";
 
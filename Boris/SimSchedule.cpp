@@ -615,12 +615,13 @@ void Simulation::CheckSimulationSchedule(void)
 
 	case STOP_MXH:
 
-		if( SMesh.Get_mxh() <= (double)simStages[ stage_step.major ].get_stopvalue() ) AdvanceSimulationSchedule();
+		//with active set relaxation mxh only includes active cells : the stop condition must also be met with a full field evaluation
+		if( SMesh.Get_mxh() <= (double)simStages[ stage_step.major ].get_stopvalue() && SMesh.ActiveSet_Verify_Stop() ) AdvanceSimulationSchedule();
 		break;
 
 	case STOP_DMDT:
 
-		if (SMesh.Get_dmdt() <= (double)simStages[stage_step.major].get_stopvalue()) AdvanceSimulationSchedule();
+		if (SMesh.Get_dmdt() <= (double)simStages[stage_step.major].get_stopvalue() && SMesh.ActiveSet_Verify_Stop()) AdvanceSimulationSchedule();
 		break;
 
 	case STOP_TIME:
@@ -635,14 +636,14 @@ void Simulation::CheckSimulationSchedule(void)
 	case STOP_MXH_ITER:
 	{
 		DBL2 stop = simStages[stage_step.major].get_stopvalue();
-		if (SMesh.Get_mxh() <= stop.i || SMesh.GetStageIteration() >= stop.j) AdvanceSimulationSchedule();
+		if ((SMesh.Get_mxh() <= stop.i && SMesh.ActiveSet_Verify_Stop()) || SMesh.GetStageIteration() >= stop.j) AdvanceSimulationSchedule();
 	}
 	break;
 
 	case STOP_DMDT_ITER: 
 	{
 		DBL2 stop = simStages[stage_step.major].get_stopvalue();
-		if (SMesh.Get_dmdt() <= stop.i || SMesh.GetStageIteration() >= stop.j) AdvanceSimulationSchedule();
+		if ((SMesh.Get_dmdt() <= stop.i && SMesh.ActiveSet_Verify_Stop()) || SMesh.GetStageIteration() >= stop.j) AdvanceSimulationSchedule();
 	}
 	break;
 	}
@@ -740,7 +741,8 @@ void Simulation::AdvanceSimulationSchedule(void)
 
 				SetSimulationStageValue();
 			}
-			else {
+			//at the end : if running an ensemble, the schedule is restarted for the next replica
+			else if (!Ensemble_NextReplica()) {
 
 				//schedule reached end: stop simulation. Note, since this routine is called from Simulate routine, which runs on the THREAD_LOOP thread, cannot stop THREAD_LOOP from within it: stop it from another thread.
 				//use a dedicated thread id to stop loop, since we need to be sure it's not blocking (alternatively could configure it with set_nonblocking_thread). Better to use dedicated thread just to make sure we don't have to wait for some other thread to finish.
@@ -762,6 +764,9 @@ void Simulation::SetSimulationStageValue(int stage_index)
 	int stage = (stage_index >= 0 ? stage_index : stage_step.major);
 	int step = (stage_index >= 0 ? 0 : stage_step.minor);
 
+	//active set relaxation only applies during relaxation stages
+	if (stage_index < 0) SMesh.ActiveSet_SetStage(simStages[stage].stage_type() == SS_RELAX);
+
 	//assume stage_step is correct (if called from AdvanceSimulationSchedule it will be. could also be called directly at the start of a simulation with stage_step reset, so it's also correct).
 
 	switch(simStages[stage].stage_type()) {
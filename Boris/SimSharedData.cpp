@@ -52,6 +52,9 @@ int SimulationSharedData::cudaDeviceSelect = 0;
 INT2 SimulationSharedData::stage_step = INT2();
 bool SimulationSharedData::single_stage_run = false;
 
+int SimulationSharedData::ensemble_replicas = 0;
+int SimulationSharedData::ensemble_replica = 0;
+
 size_t SimulationSharedData::gpuMemFree_MB = 0;
 size_t SimulationSharedData::gpuMemTotal_MB = 0;
 size_t SimulationSharedData::cpuMemFree_MB = 0;
@@ -175,7 +178,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 
 		//specify forbidden module combinations - each set is an exclusive modules set, i.e. only one of each can be active at any one time
 		//also specify non-exclusive modules (i.e. entries in exclusiveModules with only one entry per set)
-		exclusiveModules.storeset(MOD_DEMAG_N, MOD_DEMAG, MOD_SDEMAG_DEMAG, MOD_ATOM_DIPOLEDIPOLE);
+		exclusiveModules.storeset(MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE, MOD_SDEMAG_DEMAG, MOD_ATOM_DIPOLEDIPOLE);
 		exclusiveModules.storeset(MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE, MOD_VIDMEXCHANGE);
 		exclusiveModules.storeset(MOD_SURFEXCHANGE);
 		exclusiveModules.storeset(MOD_ANIUNI, MOD_ANICUBI, MOD_ANIBI, MOD_ANITENS);
@@ -192,7 +195,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 		//--------------
 
 		//for some supermesh modules, specify a number of modules which run on individual meshes, which should not run if the supermesh version is active
-		superMeshExclusiveModules.storeset(MODS_SDEMAG, MOD_DEMAG_N, MOD_DEMAG);
+		superMeshExclusiveModules.storeset(MODS_SDEMAG, MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE);
 		superMeshExclusiveModules.storeset(MODS_STRAYFIELD, MOD_STRAYFIELD_MESH);
 
 		//this is the opposite of above: if a module in a superMeshCompanionModules set is active, then all the other ones must be active too
@@ -207,7 +210,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 
 		//FERROMAGNETIC
 		modules_for_meshtype.push_back(make_vector(
-			MOD_DEMAG_N, MOD_DEMAG, MOD_SDEMAG_DEMAG,
+			MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE, MOD_SDEMAG_DEMAG,
 			MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE, MOD_VIDMEXCHANGE, MOD_SURFEXCHANGE,
 			MOD_ZEEMAN, MOD_MOPTICAL, MOD_MELASTIC, MOD_ROUGHNESS,
 			MOD_ANIUNI, MOD_ANICUBI, MOD_ANIBI, MOD_ANITENS, 
@@ -217,7 +220,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 			MOD_STRAYFIELD_MESH), MESH_FERROMAGNETIC);
 
 		displaymodules_for_meshtype.push_back(make_vector(
-			MOD_DEMAG_N, MOD_DEMAG, MOD_SDEMAG_DEMAG,
+			MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE, MOD_SDEMAG_DEMAG,
 			MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE, MOD_VIDMEXCHANGE, MOD_SURFEXCHANGE,
 			MOD_ZEEMAN, MOD_MOPTICAL, MOD_MELASTIC, MOD_ROUGHNESS,
 			MOD_ANIUNI, MOD_ANICUBI, MOD_ANIBI, MOD_ANITENS,
@@ -226,7 +229,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 
 		//ANTIFERROMAGNETIC
 		modules_for_meshtype.push_back(make_vector(
-			MOD_DEMAG_N, MOD_DEMAG, MOD_SDEMAG_DEMAG,
+			MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE, MOD_SDEMAG_DEMAG,
 			MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE, MOD_VIDMEXCHANGE, MOD_SURFEXCHANGE,
 			MOD_ZEEMAN, MOD_MOPTICAL, MOD_MELASTIC,
 			MOD_ANIUNI, MOD_ANICUBI, MOD_ANIBI, MOD_ANITENS,
@@ -236,7 +239,7 @@ SimulationSharedData::SimulationSharedData(bool called_from_Simulation)
 			MOD_STRAYFIELD_MESH), MESH_ANTIFERROMAGNETIC);
 
 		displaymodules_for_meshtype.push_back(make_vector(
-			MOD_DEMAG_N, MOD_DEMAG, MOD_SDEMAG_DEMAG,
+			MOD_DEMAG_N, MOD_DEMAG, MOD_DEMAG_TREE, MOD_SDEMAG_DEMAG,
 			MOD_EXCHANGE, MOD_DMEXCHANGE, MOD_IDMEXCHANGE, MOD_VIDMEXCHANGE, MOD_SURFEXCHANGE,
 			MOD_ZEEMAN, MOD_MOPTICAL, MOD_MELASTIC,
 			MOD_ANIUNI, MOD_ANICUBI, MOD_ANIBI, MOD_ANITENS,
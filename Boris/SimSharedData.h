@@ -112,6 +112,10 @@ public:
 	//run a single simulation stage? (default is false, but CMD_RUNSTAGE can set this true, and when simulation stops this flag is set back to false)
 	static bool single_stage_run;
 
+	//ensemble runs (see SimEnsemble.cpp) : number of replicas of the simulation schedule to run (0 or 1 : ensemble runs disabled), and index of replica currently running
+	static int ensemble_replicas;
+	static int ensemble_replica;
+
 	//constants defined by user at runtime to be used with TEquation objects; the key is the user constant name
 	static vector_key<double> userConstants;
 
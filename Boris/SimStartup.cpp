@@ -1,7 +1,7 @@
 #include "stdafx.h"
 #include "Simulation.h"
 
-//save/load flags: start_check_updates, start_scriptserver, log_errors
+//save/load flags: start_check_updates, start_scriptserver, log_errors, OmpThreads, fftw_planner, demagkernelcache, ffttiling, fftsingleprecision, fftpadding, kernelsimd, demagasymptotic, multiconvtasks
 void Simulation::Load_Startup_Flags(void)
 {
 	char line[FILEROWCHARS];
@@ -55,6 +55,54 @@ void Simulation::Load_Startup_Flags(void)
 				if (bdin.getline(line, FILEROWCHARS)) OmpThreads = ToNum(std::string(line));
 				if (OmpThreads == 0 || OmpThreads > omp_get_num_procs()) OmpThreads = omp_get_num_procs();
 			}
+
+			//FFTW planner rigor
+			if (std::string(line) == "fftw_planner") {
+
+				if (bdin.getline(line, FILEROWCHARS)) ConvolutionData::Set_FFTW_Planner(ToNum(std::string(line)));
+			}
+
+			//Demag kernels store
+			if (std::string(line) == "demagkernelcache") {
+
+				if (bdin.getline(line, FILEROWCHARS)) DemagKernelCache::enabled = ToNum(std::string(line));
+			}
+
+			//Tiled y and z ffts
+			if (std::string(line) == "ffttiling") {
+
+				if (bdin.getline(line, FILEROWCHARS)) ConvolutionData::fft_tiling = ToNum(std::string(line));
+			}
+
+			//Single precision ffts
+			if (std::string(line) == "fftsingleprecision") {
+
+				if (bdin.getline(line, FILEROWCHARS)) ConvolutionData::fft_single_precision = ToNum(std::string(line));
+			}
+
+			//Fast fft padding
+			if (std::string(line) == "fftpadding") {
+
+				if (bdin.getline(line, FILEROWCHARS)) ConvolutionData::fft_fast_padding = ToNum(std::string(line));
+			}
+
+			//Kernel multiplication instruction set
+			if (std::string(line) == "kernelsimd") {
+
+				if (bdin.getline(line, FILEROWCHARS)) KernelMultSIMD::Set_Max_Level(ToNum(std::string(line)));
+			}
+
+			//Demag tensor asymptotic expansions distance
+			if (std::string(line) == "demagasymptotic") {
+
+				if (bdin.getline(line, FILEROWCHARS)) DemagTFuncSettings::asymptotic_distance = ToNum(std::string(line));
+			}
+
+			//Multi-layered convolution scheduling
+			if (std::string(line) == "multiconvtasks") {
+
+				if (bdin.getline(line, FILEROWCHARS)) ConvolutionData::multiconv_tasks = ToNum(std::string(line));
+			}
 		}
 
 		bdin.close();
@@ -98,6 +146,38 @@ void Simulation::Save_Startup_Flags(void)
 		if (OmpThreads == omp_get_num_procs()) bdout << 0 << std::endl;
 		else bdout << OmpThreads << std::endl;
 
+		//FFTW planner rigor
+		bdout << "fftw_planner" << std::endl;
+		bdout << ConvolutionData::fftw_planner << std::endl;
+
+		//Demag kernels store
+		bdout << "demagkernelcache" << std::endl;
+		bdout << DemagKernelCache::enabled << std::endl;
+
+		//Tiled y and z ffts
+		bdout << "ffttiling" << std::endl;
+		bdout << ConvolutionData::fft_tiling << std::endl;
+
+		//Single precision ffts
+		bdout << "fftsingleprecision" << std::endl;
+		bdout << ConvolutionData::fft_single_precision << std::endl;
+
+		//Fast fft padding
+		bdout << "fftpadding" << std::endl;
+		bdout << ConvolutionData::fft_fast_padding << std::endl;
+
+		//Kernel multiplication instruction set
+		bdout << "kernelsimd" << std::endl;
+		bdout << KernelMultSIMD::max_level << std::endl;
+
+		//Demag tensor asymptotic expansions distance
+		bdout << "demagasymptotic" << std::endl;
+		bdout << DemagTFuncSettings::asymptotic_distance << std::endl;
+
+		//Multi-layered convolution scheduling
+		bdout << "multiconvtasks" << std::endl;
+		bdout << ConvolutionData::multiconv_tasks << std::endl;
+
 		bdout.close();
 	}
 }
\ No newline at end of file
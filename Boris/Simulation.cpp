@@ -18,7 +18,7 @@ Simulation::Simulation(
 			VINFO(BD),
 			VINFO(directory), VINFO(savedataFile), VINFO(imageSaveFileBase), VINFO(currentSimulationFile), VINFO(appendToDataFile), VINFO(saveDataFlag), VINFO(saveImageFlag), VINFO(dataprecision), VINFO(savedata_diskbuffer_size),
 			VINFO(saveDataList), VINFO(dataBoxList),
-			VINFO(stage_step),
+			VINFO(stage_step), VINFO(ensemble_replicas), VINFO(ensemble_replica),
 			VINFO(simStages), VINFO(iterUpdate), VINFO(autocomplete),
 			VINFO(SMesh),
 			VINFO(cudaEnabled), VINFO(cudaDeviceSelect),
@@ -46,7 +46,7 @@ Simulation::Simulation(
 			VINFO(BD),
 			VINFO(directory), VINFO(savedataFile), VINFO(imageSaveFileBase), VINFO(currentSimulationFile), VINFO(appendToDataFile), VINFO(saveDataFlag), VINFO(saveImageFlag), VINFO(dataprecision), VINFO(savedata_diskbuffer_size),
 			VINFO(saveDataList), VINFO(dataBoxList),
-			VINFO(stage_step),
+			VINFO(stage_step), VINFO(ensemble_replicas), VINFO(ensemble_replica),
 			VINFO(simStages), VINFO(iterUpdate), VINFO(autocomplete),
 			VINFO(SMesh),
 			VINFO(cudaEnabled), VINFO(cudaDeviceSelect),
@@ -147,6 +147,12 @@ Simulation::Simulation(
 	commands[CMD_SETSCHEDULESTAGE].limits = { { int(0), Any() } };
 	commands[CMD_SETSCHEDULESTAGE].descr = "[tc0,0.5,0.5,1/tc]Set stage value, but do not run simulation. Must be a valid stage number.";
 	commands[CMD_SETSCHEDULESTAGE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>stage</i>";
+
+	commands.insert(CMD_ENSEMBLE, CommandSpecifier(CMD_ENSEMBLE), "ensemble");
+	commands[CMD_ENSEMBLE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>ensemble</b> <i>replicas</i>";
+	commands[CMD_ENSEMBLE].limits = { { int(0), Any() } };
+	commands[CMD_ENSEMBLE].descr = "[tc0,0.5,0.5,1/tc]Set ensemble runs with given number of replicas (0 or 1 to disable). When the simulation is started from the beginning of the schedule, the magnetization state is saved (together with temperature, electrical potential and spin accumulation if computed), and every time the schedule finishes it is restored, the ODE solver reset, and the schedule run again for the next replica. Modules are not re-initialized between replicas (demag kernels and FFT plans are reused), and random number generators are not re-seeded, so each replica of a stochastic simulation follows a different sequence. Each replica saves data to its own file : the output data file name with _r<i>replica</i> appended. The current replica is available as the replica data output. The starting state is not saved with the simulation file : if it is not available when a replica finishes (e.g. ensemble set part-way through the schedule, or simulation reloaded) the ensemble run is stopped. Ensemble runs are not available with the elastodynamics solver enabled.";
+	commands[CMD_ENSEMBLE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>replicas replica</i> - number of replicas and replica currently running.";
 	
 	commands.insert(CMD_NEXTSTAGE, CommandSpecifier(CMD_NEXTSTAGE), "nextstage");
 	commands[CMD_NEXTSTAGE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>nextstage</b>";
@@ -544,6 +550,66 @@ Simulation::Simulation(
 	commands[CMD_GPUKERNELS].descr = "[tc0,0.5,0.5,1/tc]When in CUDA mode calculate demagnetization kernels initialization on the GPU (1) or on the CPU (0).";
 	commands[CMD_GPUKERNELS].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
 
+	commands.insert(CMD_FFTWPLANNER, CommandSpecifier(CMD_FFTWPLANNER), "fftwplanner");
+	commands[CMD_FFTWPLANNER].usage = "[tc0,0.5,0,1/tc]USAGE : <b>fftwplanner</b> <i>level</i>";
+	commands[CMD_FFTWPLANNER].descr = "[tc0,0.5,0.5,1/tc]Set planning rigor for FFTW plans used by convolution and kernel calculations on the CPU: 0 (estimate), 1 (measure), 2 (patient - default), 3 (exhaustive). Plans are kept in a wisdom file in the Boris Data directory, so planning is only done once for given FFT dimensions. Takes effect next time plans are made.";
+	commands[CMD_FFTWPLANNER].limits = { { int(FFTWPLANNER_ESTIMATE), int(FFTWPLANNER_NUMENTRIES) - 1 } };
+	commands[CMD_FFTWPLANNER].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>level</i>";
+
+	commands.insert(CMD_DEMAGKERNELCACHE, CommandSpecifier(CMD_DEMAGKERNELCACHE), "demagkernelcache");
+	commands[CMD_DEMAGKERNELCACHE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>demagkernelcache</b> <i>status</i>";
+	commands[CMD_DEMAGKERNELCACHE].descr = "[tc0,0.5,0.5,1/tc]Enable (1) or disable (0 - default) storing computed demagnetization kernels (CPU kernel calculation) in the Boris Data directory. When enabled, kernels for a discretisation already computed (same n, h, N, pbc images, shifts and cellsizes) are loaded from file instead of being recomputed.";
+	commands[CMD_DEMAGKERNELCACHE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
+
+	commands.insert(CMD_FFTTILING, CommandSpecifier(CMD_FFTTILING), "ffttiling");
+	commands[CMD_FFTTILING].usage = "[tc0,0.5,0,1/tc]USAGE : <b>ffttiling</b> <i>status</i>";
+	commands[CMD_FFTTILING].descr = "[tc0,0.5,0.5,1/tc]Enable (1) or disable (0 - default) tiled y and z direction FFTs for 3D CPU convolutions which don't embed the kernel multiplication (e.g. multilayered convolution). When enabled, blocks of consecutive lines are copied to contiguous buffers and transformed with a single batched FFT, instead of one line at a time. Use <b>benchffttiling</b> to compare both methods.";
+	commands[CMD_FFTTILING].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
+
+	commands.insert(CMD_CONVPROFILING, CommandSpecifier(CMD_CONVPROFILING), "convprofiling");
+	commands[CMD_CONVPROFILING].usage = "[tc0,0.5,0,1/tc]USAGE : <b>convprofiling</b> <i>status</i>";
+	commands[CMD_CONVPROFILING].descr = "[tc0,0.5,0.5,1/tc]Enable (1) or disable (0 - default) profiling of CPU convolutions (demag, Oersted, etc.). Setting the status also resets the profile. Each convolution runs in a single parallel region with a barrier at the end of each stage : when enabled the number of parallel regions and barriers, and time spent in each stage (x, y, z ffts, kernel multiplication, z, y, x iffts) are accumulated. Call without parameters to show the profile.";
+	commands[CMD_CONVPROFILING].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status regions barriers time_total time_fftx time_ffty time_fftz time_mult time_ifftz time_iffty time_ifftx</i> - times in ms.";
+
+	commands.insert(CMD_FFTSINGLEPRECISION, CommandSpecifier(CMD_FFTSINGLEPRECISION), "fftsingleprecision");
+	commands[CMD_FFTSINGLEPRECISION].usage = "[tc0,0.5,0,1/tc]USAGE : <b>fftsingleprecision</b> <i>status</i>";
+	commands[CMD_FFTSINGLEPRECISION].descr = "[tc0,0.5,0.5,1/tc]Enable (1) or disable (0 - default) single precision FFTs for CPU convolutions with embedded kernel multiplication (demag, supermesh demag, atomistic dipole-dipole). FFT scratch spaces and FFTs are in single precision, whilst kernels, kernel multiplication, output fields and energies remain in double precision. Convolutions are reconfigured when the status changes. Use <b>fftprecisioncheck</b> to check the accuracy.";
+	commands[CMD_FFTSINGLEPRECISION].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
+
+	commands.insert(CMD_FFTPRECISIONCHECK, CommandSpecifier(CMD_FFTPRECISIONCHECK), "fftprecisioncheck");
+	commands[CMD_FFTPRECISIONCHECK].usage = "[tc0,0.5,0,1/tc]USAGE : <b>fftprecisioncheck</b> <i>(meshname)</i>";
+	commands[CMD_FFTPRECISIONCHECK].descr = "[tc0,0.5,0.5,1/tc]Compute the demag field for the current magnetization in the focused mesh (or meshname if given) using both double and single precision CPU FFTs, and show the maximum field difference relative to the maximum demag field, and the relative demag energy difference. Mesh must have the demag module enabled, and CUDA must be off.";
+	commands[CMD_FFTPRECISIONCHECK].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>field_error energy_error</i>";
+
+	commands.insert(CMD_FFTPADDING, CommandSpecifier(CMD_FFTPADDING), "fftpadding");
+	commands[CMD_FFTPADDING].usage = "[tc0,0.5,0,1/tc]USAGE : <b>fftpadding</b> <i>status</i>";
+	commands[CMD_FFTPADDING].descr = "[tc0,0.5,0.5,1/tc]Enable (1 - default) or disable (0) fast padding for CPU demag convolutions without pbc : zero-padded FFT lengths are the smallest 2<sup>a</sup>3<sup>b</sup>5<sup>c</sup>7<sup>d</sup> values not less than 2n - 1, instead of 2n which can have large prime factors. Kernels are computed to match. Convolutions are reconfigured when the status changes. Call without parameters to show the FFT dimensions used for each mesh with demag, with and without fast padding, and the expected FFT speedup (estimated by timing FFTs of both lengths).";
+	commands[CMD_FFTPADDING].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
+
+	commands.insert(CMD_KERNELSIMD, CommandSpecifier(CMD_KERNELSIMD), "kernelsimd");
+	commands[CMD_KERNELSIMD].usage = "[tc0,0.5,0,1/tc]USAGE : <b>kernelsimd</b> <i>level</i>";
+	commands[CMD_KERNELSIMD].descr = "[tc0,0.5,0.5,1/tc]Set highest instruction set allowed for CPU demag kernel multiplications (single mesh and supermesh demag): 0 (scalar), 1 (AVX2 with FMA - default), 2 (AVX-512). The instruction set used is limited to what the CPU supports, detected at run-time. Use <b>benchkernelsimd</b> to compare them. Call without parameters to show the instruction sets allowed, in use, and supported.";
+	commands[CMD_KERNELSIMD].limits = { { int(KERNELSIMD_SCALAR), int(KERNELSIMD_NUMENTRIES) - 1 } };
+	commands[CMD_KERNELSIMD].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>level</i> - instruction set in use.";
+
+	commands.insert(CMD_DEMAGASYMPTOTIC, CommandSpecifier(CMD_DEMAGASYMPTOTIC), "demagasymptotic");
+	commands[CMD_DEMAGASYMPTOTIC].usage = "[tc0,0.5,0,1/tc]USAGE : <b>demagasymptotic</b> <i>distance</i>";
+	commands[CMD_DEMAGASYMPTOTIC].descr = "[tc0,0.5,0.5,1/tc]Set distance (in cells) from which demag tensor elements are computed using asymptotic expansions instead of the exact Newell equations : 40 by default, -1 or 0 to disable. Applies to all demag kernels (CPU and GPU). Shorter distances speed up kernel computation for very large meshes. Too short a distance loses accuracy in the asymptotic expansions, whilst too long a distance loses accuracy in the exact equations due to cancellation errors, the best distance depending on the cellsize ratios. Demag convolutions are reconfigured when the distance changes. Call without parameters to show the distance and the estimated relative error of the asymptotic expansions at this distance, for the cellsize of each mesh with demag (and supermesh demag).";
+	commands[CMD_DEMAGASYMPTOTIC].limits = { { int(-1), Any() } };
+	commands[CMD_DEMAGASYMPTOTIC].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>distance</i>";
+
+	commands.insert(CMD_MULTICONVTASKS, CommandSpecifier(CMD_MULTICONVTASKS), "multiconvtasks");
+	commands[CMD_MULTICONVTASKS].usage = "[tc0,0.5,0,1/tc]USAGE : <b>multiconvtasks</b> <i>mode</i>";
+	commands[CMD_MULTICONVTASKS].descr = "[tc0,0.5,0.5,1/tc]Set scheduling of multi-layered demag convolution on the CPU : 0 (disabled), 1 (auto - default), 2 (always). When enabled the forward FFT, kernel multiplication and inverse FFT of each mesh are independent tasks, each run by a single thread, with tasks for different meshes running concurrently. This avoids synchronization overhead when there are many thin layers, each with little work per stage. In auto mode tasks are only used if there are at least as many meshes as threads. Not used when convolution profiling is enabled.";
+	commands[CMD_MULTICONVTASKS].limits = { { int(MULTICONVTASKS_DISABLED), int(MULTICONVTASKS_NUMENTRIES) - 1 } };
+	commands[CMD_MULTICONVTASKS].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>mode</i>";
+
+	commands.insert(CMD_DEMAGTREE, CommandSpecifier(CMD_DEMAGTREE), "demagtree");
+	commands[CMD_DEMAGTREE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>demagtree</b> <i>(meshname) near_distance opening_angle</i>";
+	commands[CMD_DEMAGTREE].descr = "[tc0,0.5,0.5,1/tc]Set accuracy of the demag_tree module in given mesh (focused mesh if not specified). The demag_tree module computes the demag field on non-empty cells only, so memory and computation time scale with the number of non-empty cells rather than the mesh rectangle - use it instead of the demag module for sparse geometries (CPU only). Source cells up to near_distance cells away (along each axis, default 4) use the exact demag tensor, whilst further clusters of cells use multipole expansions if cluster radius / distance is below opening_angle (0 to 1, default 0.5). Larger near_distance and smaller opening_angle are more accurate but slower : with default settings the field error is typically of order 0.1% of the largest demag field, around 0.01% for near_distance 8. Call without parameters to show settings for all meshes with the demag_tree module.";
+	commands[CMD_DEMAGTREE].limits = { { Any(), Any() }, { int(1), Any() }, { double(0.0), double(1.0) } };
+	commands[CMD_DEMAGTREE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>near_distance opening_angle</i>";
+
 	commands.insert(CMD_ODE, CommandSpecifier(CMD_ODE), "ode");
 	commands[CMD_ODE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>ode</b>";
 	commands[CMD_ODE].descr = "[tc0,0.5,0.5,1/tc]Show interactive list of available and currently set ODEs and evaluation methods.";
@@ -560,7 +626,7 @@ Simulation::Simulation(
 
 	commands.insert(CMD_SETODEEVAL, CommandSpecifier(CMD_SETODEEVAL), "setodeeval");
 	commands[CMD_SETODEEVAL].usage = "[tc0,0.5,0,1/tc]USAGE : <b>setodeeval</b> <i>evaluation</i>";
-	commands[CMD_SETODEEVAL].descr = "[tc0,0.5,0.5,1/tc]Set differential equation method used to solve it (same method is applied to micromagnetic and atomistic meshes).";
+	commands[CMD_SETODEEVAL].descr = "[tc0,0.5,0.5,1/tc]Set differential equation method used to solve it (same method is applied to micromagnetic and atomistic meshes). IMEX (ferromagnetic meshes only) is first order, and is stable for any time step since it adds an implicit exchange diffusion with coefficient sigma = gamma * A / (mu0 * Ms * alpha), with alpha limited to at least 1e-3 (alpha = 1 for LLGStatic). This adds an error which grows with dT * sigma / l^2 for magnetization features of length l, so at low damping sigma is large and accurate dynamics need dT * sigma well below l^2 : IMEX is best suited to relaxation or strongly damped dynamics, otherwise check results do not change when reducing dT.";
 
 	commands.insert(CMD_SETATOMODE, CommandSpecifier(CMD_SETATOMODE), "setatomode");
 	commands[CMD_SETATOMODE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>setatomode</b> <i>equation evaluation</i>";
@@ -583,6 +649,15 @@ Simulation::Simulation(
 	commands[CMD_ASTEPCTRL].descr = "[tc0,0.5,0.5,1/tc]Set parameters for adaptive time step control: err_fail - repeat step above this (the tolerance), dT_incr - limit multiplicative increase in dT using this, dT_min, dT_max - dT bounds.";
 	commands[CMD_ASTEPCTRL].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>err_fail dT_incr dT_min dT_max</i>";
 
+	commands.insert(CMD_ASTEPCONTROLLER, CommandSpecifier(CMD_ASTEPCONTROLLER), "astepcontroller");
+	commands[CMD_ASTEPCONTROLLER].usage = "[tc0,0.5,0,1/tc]USAGE : <b>astepcontroller</b> <i>type (kI kP)</i>";
+	commands[CMD_ASTEPCONTROLLER].limits = { 
+		{int(ASTEPCTRL_I), int(ASTEPCTRL_NUMENTRIES) - 1},
+		{double(0.0), double(1.0)},
+		{double(0.0), double(1.0)} };
+	commands[CMD_ASTEPCONTROLLER].descr = "[tc0,0.5,0.5,1/tc]Set adaptive time step controller type: 0 (integral controller, default), 1 (PI controller). For the PI controller the integral and proportional gains kI and kP can also be set (default 0.3 and 0.4). The PI controller damps time step oscillations, reducing the number of rejected steps. Use the astepstats data output to monitor accepted and rejected steps, and field evaluations wasted in rejected steps.";
+	commands[CMD_ASTEPCONTROLLER].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>type kI kP</i>";
+
 	commands.insert(CMD_SHOWDATA, CommandSpecifier(CMD_SHOWDATA), "showdata");
 	commands[CMD_SHOWDATA].usage = "[tc0,0.5,0,1/tc]USAGE : <b>showdata</b> <i>(meshname) dataname (rectangle)</i>";
 	commands[CMD_SHOWDATA].descr = "[tc0,0.5,0.5,1/tc]Show value(s) for dataname. If applicable specify meshname and rectangle (m) in mesh. If not specified and required, focused mesh is used with entire mesh rectangle.";
@@ -1213,6 +1288,18 @@ Simulation::Simulation(
 	commands[CMD_LINKDTSPEEDUP].limits = { { int(0), int(1) } };
 	commands[CMD_LINKDTSPEEDUP].descr = "[tc0,0.5,0.5,1/tc]Links speedup time-step to ODE time-step if set, else speedup time-step is independently controlled.";
 
+	commands.insert(CMD_MULTIRATE, CommandSpecifier(CMD_MULTIRATE), "multirate");
+	commands[CMD_MULTIRATE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>multirate</b> <i>subcycles</i>";
+	commands[CMD_MULTIRATE].limits = { { int(1), Any() } };
+	commands[CMD_MULTIRATE].descr = "[tc0,0.5,0.5,1/tc]Set multi-rate stepping for multiscale simulations : micromagnetic meshes are advanced with a time-step <i>subcycles</i> times larger than atomistic meshes, which take the set ODE time-step. In between, micromagnetic magnetization is linearly interpolated so coupling fields to atomistic meshes follow it. Applies to fixed time-step evaluation methods (Euler, TEuler, RK4, LSRK4) without moving mesh or heat equation, CPU computations only. Set 1 to disable (default).";
+	commands[CMD_MULTIRATE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>subcycles</i>";
+
+	commands.insert(CMD_ACTIVESET, CommandSpecifier(CMD_ACTIVESET), "activeset");
+	commands[CMD_ACTIVESET].usage = "[tc0,0.5,0,1/tc]USAGE : <b>activeset</b> <i>threshold (halo period)</i>";
+	commands[CMD_ACTIVESET].limits = { { double(0.0), Any() }, { int(0), Any() }, { int(1), Any() } };
+	commands[CMD_ACTIVESET].descr = "[tc0,0.5,0.5,1/tc]Set active set relaxation for micromagnetic meshes during Relax stages : after every time step cells with normalized torque |mxh| below <i>threshold</i> are frozen, unless within <i>halo</i> cells of an above-threshold cell (default 2). Frozen cells are not evolved by the ODE solver and are skipped by exchange, DMI and anisotropy modules, which use their energy densities from when they were last active. Zeeman, demag and all other modules are still computed over the whole mesh, so the speedup is only significant when exchange, DMI and anisotropy dominate the computation time. All frozen cells are re-examined with a full field evaluation every <i>period</i> iterations (default 100). Stop conditions based on mxh or dmdt are only accepted once also met with all cells released. Monitor the active cells fraction with the activefrac data output. CPU computations only. Set threshold to 0 to disable (default).";
+	commands[CMD_ACTIVESET].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>threshold halo period</i>";
+
 	commands.insert(CMD_CUDA, CommandSpecifier(CMD_CUDA), "cuda");
 	commands[CMD_CUDA].usage = "[tc0,0.5,0,1/tc]USAGE : <b>cuda</b> <i>status</i>";
 	commands[CMD_CUDA].descr = "[tc0,0.5,0.5,1/tc]Switch CUDA GPU computations on/off.";
@@ -1272,6 +1359,24 @@ Simulation::Simulation(
 	commands[CMD_BENCHTIME].descr = "[tc0,0.5,0.5,1/tc]Show the last simulation duration time in ms, between start and stop; used for performance becnhmarking.";
 	commands[CMD_BENCHTIME].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>value</i>";
 
+	commands.insert(CMD_BENCHFFTTILING, CommandSpecifier(CMD_BENCHFFTTILING), "benchffttiling");
+	commands[CMD_BENCHFFTTILING].usage = "[tc0,0.5,0,1/tc]USAGE : <b>benchffttiling</b> <i>n (repeats)</i>";
+	commands[CMD_BENCHFFTTILING].limits = { { INT3(1, 1, 2), Any() }, { int(1), Any() } };
+	commands[CMD_BENCHFFTTILING].descr = "[tc0,0.5,0.5,1/tc]Benchmark y and z direction FFTs and IFFTs for a 3D CPU convolution (kernel multiplication not embedded) with n number of cells (e.g. 256 256 256 or 1024 1024 4), done one line at a time and tiled (see <b>ffttiling</b>). Times are averaged over given number of repeats (10 by default). Note, this allocates the full FFT scratch spaces for the given n.";
+	commands[CMD_BENCHFFTTILING].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>time_lines time_tiles</i> - average times in ms.";
+
+	commands.insert(CMD_BENCHKERNELSIMD, CommandSpecifier(CMD_BENCHKERNELSIMD), "benchkernelsimd");
+	commands[CMD_BENCHKERNELSIMD].usage = "[tc0,0.5,0,1/tc]USAGE : <b>benchkernelsimd</b> <i>(length (repeats))</i>";
+	commands[CMD_BENCHKERNELSIMD].limits = { { int(1), Any() }, { int(1), Any() } };
+	commands[CMD_BENCHKERNELSIMD].descr = "[tc0,0.5,0.5,1/tc]Benchmark 3D demag kernel multiplication on a single thread, for a line with given number of points (1024 by default), with each instruction set supported by the CPU (see <b>kernelsimd</b>). Times are averaged over given number of repeats (1000 by default). Shows throughput in complex multiply-adds per second (9 per point), and maximum difference from the scalar result.";
+	commands[CMD_BENCHKERNELSIMD].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>scalar avx2 avx512</i> - throughput in complex multiply-adds per second, 0 if not supported.";
+
+	commands.insert(CMD_BENCHODE, CommandSpecifier(CMD_BENCHODE), "benchode");
+	commands[CMD_BENCHODE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>benchode</b> <i>(meshname) (repeats)</i>";
+	commands[CMD_BENCHODE].limits = { { Any(), Any() }, { int(1), Any() } };
+	commands[CMD_BENCHODE].descr = "[tc0,0.5,0.5,1/tc]Benchmark CPU evaluation of the set equation in given ferromagnetic or antiferromagnetic mesh (focused mesh if not specified), using a single fused pass over the mesh as done by the evaluation methods (torque reduction, equation, Euler update and dm/dt reduction - magnetization is not modified). The pass is timed with the equation called through a function pointer for every cell, then with the loop instantiated for the set equation (as used by all CPU evaluation methods), then again with deterministic reductions (see deterministic command). Times are averaged over given number of repeats (100 by default). Shows throughput in cells per second per thread.";
+	commands[CMD_BENCHODE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>generic specialised deterministic</i> - throughput in cells per second per thread.";
+
 	commands.insert(CMD_MATERIALSDATABASE, CommandSpecifier(CMD_MATERIALSDATABASE), "materialsdatabase");
 	commands[CMD_MATERIALSDATABASE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>materialsdatabase</b> <i>(mdbname)</i>";
 	commands[CMD_MATERIALSDATABASE].descr = "[tc0,0.5,0.5,1/tc]Switch materials database in use. This setting is not saved by savesim, so using loadsim doesn't affect this setting; default mdb set on program start.";
@@ -1420,6 +1525,12 @@ Simulation::Simulation(
 	commands[CMD_THREADS].limits = { { int(0), Any(omp_get_num_procs()) } };
 	commands[CMD_THREADS].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>num_threads</i>";
 
+	commands.insert(CMD_DETERMINISTIC, CommandSpecifier(CMD_DETERMINISTIC), "deterministic");
+	commands[CMD_DETERMINISTIC].usage = "[tc0,0.5,0,1/tc]USAGE : <b>deterministic</b> <i>status</i>";
+	commands[CMD_DETERMINISTIC].limits = { { int(0), int(1) } };
+	commands[CMD_DETERMINISTIC].descr = "[tc0,0.5,0.5,1/tc]Set deterministic reductions for cuda 0 computations (0: off (default), 1: on). When on, the following are bitwise reproducible independent of the number of threads : energy sums of all effective field modules (including the demag convolution energy), torque (mxh) and dm/dt averages computed by the evaluation methods, and the SD (Barzilai-Borwein) and NCG solver sums. Values are stored per cell (per line for the demag convolution), summed in fixed-size chunks, and chunks combined in a fixed order. Not covered : data outputs and data processing (averages, histograms, domain wall fits), transport currents, Monte Carlo, GNEB and parallel tempering reductions. This has a small computational overhead - use the benchode command to measure it.";
+	commands[CMD_DETERMINISTIC].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>status</i>";
+
 	commands.insert(CMD_SERVERPORT, CommandSpecifier(CMD_SERVERPORT), "serverport");
 	commands[CMD_SERVERPORT].usage = "[tc0,0.5,0,1/tc]USAGE : <b>serverport</b> <i>port</i>";
 	commands[CMD_SERVERPORT].descr = "[tc0,0.5,0.5,1/tc]Set script server port.";
@@ -1493,6 +1604,12 @@ Simulation::Simulation(
 	commands[CMD_MCCONSTRAIN].descr = "[tc0,0.5,0.5,1/tc]Set value 0 to revert to classic Monte-Carlo Metropolis for ASD. Set a unit vector direction value (x y z) to switch to constrained Monte Carlo as described in PRB 82, 054415 (2010). If meshname not specified setting is applied to all atomistic meshes.";
 	commands[CMD_MCCONSTRAIN].limits = { {Any(), Any()}, { DBL3(), Any() } };
 
+	commands.insert(CMD_MCMOVES, CommandSpecifier(CMD_MCMOVES), "mcmoves");
+	commands[CMD_MCMOVES].usage = "[tc0,0.5,0,1/tc]USAGE : <b>mcmoves</b> <i>(meshname) overrelax cluster</i>";
+	commands[CMD_MCMOVES].descr = "[tc0,0.5,0.5,1/tc]Set additional Monte-Carlo moves taken after every Metropolis step, for classic Monte-Carlo in atomistic meshes (CPU only). overrelax: number of over-relaxation sweeps, where spins are reflected about their exchange and DMI local field (0 to disable). cluster: 1 to enable Wolff-type cluster updates, for meshes without DMI or dipolar interactions (ignored otherwise). If meshname not specified setting is applied to all atomistic meshes.";
+	commands[CMD_MCMOVES].limits = { {Any(), Any()}, { int(0), Any() }, { int(0), int(1) } };
+	commands[CMD_MCMOVES].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>overrelax cluster</i> for given mesh (focused mesh if not specified).";
+
 	commands.insert(CMD_MCDISABLE, CommandSpecifier(CMD_MCDISABLE), "mcdisable");
 	commands[CMD_MCDISABLE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>mcdisable</b> <i>(meshname) status</i>";
 	commands[CMD_MCDISABLE].descr = "[tc0,0.5,0.5,1/tc]Disable or enable Monte Carlo algorithm for given mesh (focused mesh if not specified).";
@@ -1510,9 +1627,48 @@ Simulation::Simulation(
 	commands[CMD_MCCONEANGLELIMITS].limits = { {DBL2(), DBL2(180, 180)} };
 	commands[CMD_MCCONEANGLELIMITS].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>min_angle max_angle</i>";
 
+	commands.insert(CMD_PARALLELTEMPERING, CommandSpecifier(CMD_PARALLELTEMPERING), "paralleltempering");
+	commands[CMD_PARALLELTEMPERING].usage = "[tc0,0.5,0,1/tc]USAGE : <b>paralleltempering</b> <i>Tmin Tmax replicas</i>";
+	commands[CMD_PARALLELTEMPERING].limits = { { double(0.0), Any() }, { double(0.0), Any() }, { int(0), Any() } };
+	commands[CMD_PARALLELTEMPERING].descr = "[tc0,0.5,0.5,1/tc]Enable parallel tempering (replica exchange) for Monte Carlo stages, with given number of replicas at temperatures geometrically spaced between Tmin and Tmax (K). Set replicas to 0 to disable. On every Monte Carlo step each replica is iterated at its temperature with the Monte Carlo algorithm set for each mesh, after which configurations at neighboring temperatures are swapped using the Metropolis criterion. At the end of every step meshes hold the configuration at Tmin, and the base temperature of each mesh is restored. Not available if a base temperature equation or temperature dependent parameters are set in meshes taking part in Monte Carlo, since the swap criterion requires the energy to be independent of temperature. Thermodynamic averages and swap statistics are reset (see paralleltemperingdata); replicas are kept if the number of replicas does not change. CPU computations only : simulations cannot be run with CUDA enabled while parallel tempering is enabled.";
+	commands[CMD_PARALLELTEMPERING].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>Tmin Tmax replicas</i>";
+
+	commands.insert(CMD_PARALLELTEMPERINGDATA, CommandSpecifier(CMD_PARALLELTEMPERINGDATA), "paralleltemperingdata");
+	commands[CMD_PARALLELTEMPERINGDATA].usage = "[tc0,0.5,0,1/tc]USAGE : <b>paralleltemperingdata</b> <i>dp_T dp_E dp_C dp_M dp_swap</i>";
+	commands[CMD_PARALLELTEMPERINGDATA].limits = { { int(0), int(MAX_ARRAYS - 1) }, { int(0), int(MAX_ARRAYS - 1) }, { int(0), int(MAX_ARRAYS - 1) }, { int(0), int(MAX_ARRAYS - 1) }, { int(0), int(MAX_ARRAYS - 1) } };
+	commands[CMD_PARALLELTEMPERINGDATA].descr = "[tc0,0.5,0.5,1/tc]Get per-temperature data from parallel tempering, averaged over Monte Carlo steps since the last reset : temperature (K) in dp_T, average total energy (J) in dp_E, heat capacity (J/K) from energy fluctuations in dp_C, average normalized magnetization length in dp_M, and swap acceptance rate with the next temperature in dp_swap.";
+
+	commands.insert(CMD_GNEB, CommandSpecifier(CMD_GNEB), "gneb");
+	commands[CMD_GNEB].usage = "[tc0,0.5,0,1/tc]USAGE : <b>gneb</b> <i>images iterations</i>";
+	commands[CMD_GNEB].limits = { { int(3), Any() }, { int(0), Any() } };
+	commands[CMD_GNEB].descr = "[tc0,0.5,0.5,1/tc]Find the minimum energy path and energy barrier between the initial and final states (set with gnebendpoint) using the geodesic nudged elastic band method, for all ferromagnetic meshes. The chain with given number of images (including the endpoints) is built by geodesic interpolation between the endpoints, unless a chain with the same number of images already exists, in which case its relaxation is continued. The chain is relaxed for up to given number of iterations, or until the maximum residual torque field falls below the set tolerance (see gnebsettings). The magnetization is restored afterwards - use gnebimage to load an image. CPU computations only.";
+	commands[CMD_GNEB].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>barrier image residual converged</i> - energy barrier (J), index of highest energy image, maximum residual torque field (A/m), 1 if converged.";
+
+	commands.insert(CMD_GNEBENDPOINT, CommandSpecifier(CMD_GNEBENDPOINT), "gnebendpoint");
+	commands[CMD_GNEBENDPOINT].usage = "[tc0,0.5,0,1/tc]USAGE : <b>gnebendpoint</b> <i>endpoint</i>";
+	commands[CMD_GNEBENDPOINT].limits = { { int(0), int(1) } };
+	commands[CMD_GNEBENDPOINT].descr = "[tc0,0.5,0.5,1/tc]Set current magnetization in all ferromagnetic meshes as the initial (endpoint = 0) or final (endpoint = 1) state for the geodesic nudged elastic band method. Any existing chain of images is cleared. Both states should be relaxed before being set.";
+
+	commands.insert(CMD_GNEBSETTINGS, CommandSpecifier(CMD_GNEBSETTINGS), "gnebsettings");
+	commands[CMD_GNEBSETTINGS].usage = "[tc0,0.5,0,1/tc]USAGE : <b>gnebsettings</b> <i>spring climbing step tolerance</i>";
+	commands[CMD_GNEBSETTINGS].limits = { { double(0.0), Any() }, { int(0), int(1) }, { double(1e-6), double(1.0) }, { double(1e-6), Any() } };
+	commands[CMD_GNEBSETTINGS].descr = "[tc0,0.5,0.5,1/tc]Set geodesic nudged elastic band settings : spring constant between images (J, default 1e-20), climbing image enabled (default 1), maximum rotation of magnetization in any cell per iteration (rad, default 0.05), convergence tolerance on the maximum residual torque field (A/m, default 10).";
+	commands[CMD_GNEBSETTINGS].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>spring climbing step tolerance</i>";
+
+	commands.insert(CMD_GNEBIMAGE, CommandSpecifier(CMD_GNEBIMAGE), "gnebimage");
+	commands[CMD_GNEBIMAGE].usage = "[tc0,0.5,0,1/tc]USAGE : <b>gnebimage</b> <i>index</i>";
+	commands[CMD_GNEBIMAGE].limits = { { int(0), Any() } };
+	commands[CMD_GNEBIMAGE].descr = "[tc0,0.5,0.5,1/tc]Set magnetization in all ferromagnetic meshes from image with given index in the geodesic nudged elastic band chain (0 is the initial state), and update effective fields.";
+	commands[CMD_GNEBIMAGE].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>images</i> - number of images in the chain.";
+
+	commands.insert(CMD_GNEBMEP, CommandSpecifier(CMD_GNEBMEP), "gnebmep");
+	commands[CMD_GNEBMEP].usage = "[tc0,0.5,0,1/tc]USAGE : <b>gnebmep</b> <i>dp_coord dp_energy</i>";
+	commands[CMD_GNEBMEP].limits = { { int(0), int(MAX_ARRAYS - 1) }, { int(0), int(MAX_ARRAYS - 1) } };
+	commands[CMD_GNEBMEP].descr = "[tc0,0.5,0.5,1/tc]Get minimum energy path from the last geodesic nudged elastic band run : reaction coordinate (cumulative geodesic distance along the chain) in dp_coord, and energy of each image relative to the initial state (J) in dp_energy.";
+
 	commands.insert(CMD_PRNGSEED, CommandSpecifier(CMD_PRNGSEED), "prngseed");
 	commands[CMD_PRNGSEED].usage = "[tc0,0.5,0,1/tc]USAGE : <b>prngseed</b> <i>(meshname) seed</i>";
-	commands[CMD_PRNGSEED].descr = "[tc0,0.5,0.5,1/tc]Set PRNG seed, for computations with stochasticity, in given mesh (all meshes if name not given). If seed = 0 then system tick count is used as seed (default behavior), otherwise the fixed set value is used. NOTE: seed values > 0 only take effect for computations with cuda 1.";
+	commands[CMD_PRNGSEED].descr = "[tc0,0.5,0.5,1/tc]Set PRNG seed, for computations with stochasticity, in given mesh (all meshes if name not given). If seed = 0 then system tick count is used as seed (default behavior), otherwise the fixed set value is used. Random numbers for thermal fields are counter-based (keyed by seed, time step and cell index), so with a seed value > 0 the same thermal fields are generated irrespective of the number of threads used.";
 	commands[CMD_PRNGSEED].limits = { {Any(), Any()}, {int(0), Any()} };
 	commands[CMD_PRNGSEED].return_descr = "[tc0,0.5,0,1/tc]Script return values: <i>seed</i>";
 
@@ -2026,6 +2182,11 @@ Simulation::Simulation(
 	dataDescriptor.push_back("heat_dT", DatumSpecifier("heat dT : ", 1, "s"), DATA_HEATDT);
 	dataDescriptor.push_back("mxh", DatumSpecifier("|mxh| : ", 1), DATA_MXH);
 	dataDescriptor.push_back("dmdt", DatumSpecifier("|dm/dt| : ", 1), DATA_DMDT);
+	dataDescriptor.push_back("astepstats", DatumSpecifier("Accepted, Rejected, Wasted : ", 3), DATA_ASTEPSTATS);
+	dataDescriptor.push_back("activefrac", DatumSpecifier("Active fraction : ", 1), DATA_ACTIVEFRACTION);
+	dataDescriptor.push_back("replica", DatumSpecifier("Ensemble replica : ", 1), DATA_REPLICA);
+	dataDescriptor.push_back("gnebbarrier", DatumSpecifier("GNEB barrier : ", 1, "J"), DATA_GNEBBARRIER);
+	dataDescriptor.push_back("ptswaprate", DatumSpecifier("PT swap rate : ", 1), DATA_PTSWAPRATE);
 	dataDescriptor.push_back("Ha", DatumSpecifier("Applied Field : ", 3, "A/m", false), DATA_HA);
 	dataDescriptor.push_back("<M>", DatumSpecifier("<M> : ", 3, "A/m", false, false), DATA_AVM);
 	dataDescriptor.push_back("<M>th", DatumSpecifier("<M>th : ", 3, "A/m", false, false), DATA_THAVM);
@@ -2098,6 +2259,7 @@ Simulation::Simulation(
 	//Modules
 	moduleHandles.push_back("demag_N", MOD_DEMAG_N);
 	moduleHandles.push_back("demag", MOD_DEMAG);
+	moduleHandles.push_back("demag_tree", MOD_DEMAG_TREE);
 	moduleHandles.push_back("exchange", MOD_EXCHANGE);
 	moduleHandles.push_back("DMexchange", MOD_DMEXCHANGE);
 	moduleHandles.push_back("iDMexchange", MOD_IDMEXCHANGE);
@@ -2166,17 +2328,21 @@ Simulation::Simulation(
 	odeEvalHandles.push_back("RKF56", EVAL_RKF56);
 	odeEvalHandles.push_back("RKCK45", EVAL_RKCK45);
 	odeEvalHandles.push_back("RKDP54", EVAL_RKDP54);
+	odeEvalHandles.push_back("LSRK4", EVAL_LSRK4);
+	odeEvalHandles.push_back("LSRK43", EVAL_LSRK43);
+	odeEvalHandles.push_back("IMEX", EVAL_IMEX);
 	odeEvalHandles.push_back("SDesc", EVAL_SD);
+	odeEvalHandles.push_back("NCG", EVAL_NCG);
 
 	//Allowed evaluation methods for given ODE
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLG);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_SD), ODE_LLGSTATIC);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_SD), ODE_LLGSTATICSA);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLGSTT);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLB);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLBSTT);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLGSA);
-	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54), ODE_LLBSA);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43, EVAL_IMEX), ODE_LLG);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43, EVAL_IMEX, EVAL_SD, EVAL_NCG), ODE_LLGSTATIC);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43, EVAL_IMEX, EVAL_SD, EVAL_NCG), ODE_LLGSTATICSA);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43, EVAL_IMEX), ODE_LLGSTT);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43), ODE_LLB);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43), ODE_LLBSTT);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43, EVAL_IMEX), ODE_LLGSA);
+	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4, EVAL_ABM, EVAL_RK23, EVAL_RKF45, EVAL_RKF56, EVAL_RKCK45, EVAL_RKDP54, EVAL_LSRK4, EVAL_LSRK43), ODE_LLBSA);
 	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4), ODE_SLLG);
 	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4), ODE_SLLGSTT);
 	odeAllowedEvals.push_back(make_vector(EVAL_EULER, EVAL_TEULER, EVAL_AHEUN, EVAL_RK4), ODE_SLLB);
@@ -2287,6 +2453,12 @@ Simulation::Simulation(
 	//Load options for startup first
 	Load_Startup_Flags();
 
+	//load any FFTW plans saved by previous runs
+	ConvolutionData::Set_FFTW_Wisdom_Directory(GetUserDocumentsPath() + boris_data_directory);
+
+	//stored demag kernels are kept in same directory
+	DemagKernelCache::directory = GetUserDocumentsPath() + boris_data_directory;
+
 	//---------------------------------------------------------------- SERVER START
 
 	server_port = server_port_;
@@ -2367,5 +2539,7 @@ Simulation::~Simulation()
 
 	Stop_All_Threads();
 
+	ConvolutionData::Save_FFTW_Wisdom();
+
 	BD.DisplayConsoleMessage("All threads stopped. Clean-up...");
 }
@@ -55,6 +55,10 @@
 #include "Atom_Mesh.h"
 #include "SuperMesh.h"
 
+#include "ConvolutionData.h"
+#include "DemagKernelCache.h"
+#include "KernelMultSIMD.h"
+
 
 #if COMPILECUDA == 1
 #include "BorisCUDALib.h"
@@ -69,7 +73,7 @@ class Simulation :
 	BorisDisplay, 
 	std::string, std::string, std::string, std::string, bool, bool, bool, int, int,
 	vector_lut<DatumConfig>, vector_lut<DatumConfig>, 
-	INT2, 
+	INT2, int, int,
 	vector_lut<StageConfig>, int, bool, 
 	SuperMesh, 
 	bool, int, 
@@ -410,6 +414,23 @@ private:
 	//stop and reset simulation back to starting point
 	void ResetSimulation(void);
 
+	//-------------------------------------Ensemble runs : SimEnsemble.cpp
+
+	//set number of replicas for ensemble runs (0 or 1 to disable)
+	void SetEnsembleReplicas(int replicas);
+
+	//ensemble runs are not available with the elastodynamics solver enabled (velocity and stress held by the elastic modules are not saved for the replicas)
+	bool Ensemble_Available(void);
+
+	//called by PrepareRunSimulation when starting from the beginning of the schedule : save the starting state for all replicas
+	void Ensemble_Begin(void);
+
+	//called when the schedule reaches the end : if running an ensemble start the next replica and return true, else return false (simulation must be stopped)
+	bool Ensemble_NextReplica(void);
+
+	//data file name for current replica (savedataFile if ensemble runs disabled)
+	std::string GetEnsembleDataFile(void);
+
 	//main simulation method - computes a single complete iteration (a full ode time-step)
 	void Simulate(void);
 	//a dummy function which does no work, to keep THREAD_LOOP busy when needed
@@ -672,6 +693,18 @@ private:
 
 	void Print_GPUKernels_Config(void);
 
+	void Print_FFTW_Planner(void);
+
+	void Print_Convolution_Profile(void);
+
+	void Print_FFT_Padding(void);
+
+	void Print_Kernel_SIMD(void);
+
+	void Print_Demag_Asymptotic(void);
+
+	void Print_DemagTree_Config(void);
+
 	//---------------------------------------------------- MATERIALS DATABASE
 
 	void Print_MaterialsDatabase(void);
@@ -150,6 +150,36 @@ Any Simulation::GetDataValue(DatumConfig dConfig)
 	}
 	break;
 
+	case DATA_ASTEPSTATS:
+	{
+		return Any(SMesh.Get_AStepStats());
+	}
+	break;
+
+	case DATA_ACTIVEFRACTION:
+	{
+		return Any(SMesh.Get_ActiveSet_Fraction());
+	}
+	break;
+
+	case DATA_REPLICA:
+	{
+		return Any(ensemble_replica);
+	}
+	break;
+
+	case DATA_GNEBBARRIER:
+	{
+		return Any(SMesh.GNEB_Get_Barrier().x);
+	}
+	break;
+
+	case DATA_PTSWAPRATE:
+	{
+		return Any(SMesh.ParallelTempering_Get_SwapRate());
+	}
+	break;
+
 	case DATA_AVM:
 	{
 		if (!SMesh[dConfig.meshName]->is_atomistic()) {
@@ -702,12 +732,15 @@ void Simulation::SaveData_DiskBufferFlush(std::vector<std::string>* pdiskbuffer,
 
 			std::ofstream bdout;
 
+			//each replica in an ensemble run has its own data file
+			std::string dataFile = GetEnsembleDataFile();
+
 			//append to file or make a new one ?
-			if (appendToDataFile) bdout.open((directory + savedataFile).c_str(), std::ios::out | std::ios::app);
+			if (appendToDataFile) bdout.open((directory + dataFile).c_str(), std::ios::out | std::ios::app);
 			else {
 
 				//Create new file
-				bdout.open((directory + savedataFile).c_str(), std::ios::out);
+				bdout.open((directory + dataFile).c_str(), std::ios::out);
 				appendToDataFile = true;
 
 				//Append header
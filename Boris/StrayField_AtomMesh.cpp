@@ -93,6 +93,9 @@ double StrayField_AtomMesh::UpdateField(void)
 
 	double energy = 0;
 
+	bool deterministic = OmpReduction_Deterministic();
+	if (deterministic) energy_reduction.new_sum_reduction(paMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 	for (int idx = 0; idx < paMesh->n.dim(); idx++) {
 
@@ -101,13 +104,17 @@ double StrayField_AtomMesh::UpdateField(void)
 			DBL3 Hstray = strayField[idx];
 
 			paMesh->Heff1[idx] += Hstray;
-			energy += -MUB_MU0 * paMesh->M1[idx] * Hstray;
+			double cell_energy = -MUB_MU0 * paMesh->M1[idx] * Hstray;
+			if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+			else energy += cell_energy;
 
 			if (Module_Heff.linear_size()) Module_Heff[idx] = Hstray;
 			if (Module_energy.linear_size()) Module_energy[idx] = -MUB_MU0 * (paMesh->M1[idx] * Hstray) / paMesh->M1.h.dim();
 		}
 	}
 
+	if (deterministic) energy = energy_reduction.sum();
+
 	//convert to energy density and return
 	if (non_empty_volume) this->energy = energy / non_empty_volume;
 	else this->energy = 0.0;
@@ -98,6 +98,9 @@ double StrayField_Mesh::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -106,12 +109,16 @@ double StrayField_Mesh::UpdateField(void)
 				DBL3 Hstray = strayField[idx];
 
 				pMesh->Heff[idx] += Hstray;
-				energy += pMesh->M[idx] * Hstray;
+				double cell_energy = pMesh->M[idx] * Hstray;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hstray;
 				if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * (pMesh->M[idx] * Hstray);
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -120,6 +127,9 @@ double StrayField_Mesh::UpdateField(void)
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 		for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -130,7 +140,9 @@ double StrayField_Mesh::UpdateField(void)
 				pMesh->Heff[idx] += Hstray;
 				pMesh->Heff2[idx] += Hstray;
 
-				energy += (pMesh->M[idx] * Hstray + pMesh->M2[idx] * Hstray) / 2;
+				double cell_energy = (pMesh->M[idx] * Hstray + pMesh->M2[idx] * Hstray) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[idx] = Hstray;
 				if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hstray;
@@ -138,6 +150,8 @@ double StrayField_Mesh::UpdateField(void)
 				if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * (pMesh->M2[idx] * Hstray);
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
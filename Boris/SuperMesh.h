@@ -198,6 +198,63 @@ public:
 	//this vector is calculated at initialization and has same size as pMesh vector
 	std::vector<double> energy_density_weights;
 
+	//with multi-rate stepping micromagnetic meshes are only updated on their own time steps : keep their contribution to the total energy density here, together with super-mesh modules contribution
+	double multirate_energy_density = 0.0;
+
+	//-----Geodesic nudged elastic band (see SuperMeshGNEB.cpp)
+
+	//indexes in pMesh of ferromagnetic meshes included in the chain of images
+	std::vector<int> gneb_meshes;
+
+	//initial (0) and final (1) states : magnetization in each included mesh (empty if not set)
+	std::vector<std::vector<DBL3>> gneb_endpoints[2];
+
+	//chain of images : gneb_images[image][included mesh][cell] is the magnetization direction (unit vector, zero for empty cells)
+	std::vector<std::vector<std::vector<DBL3>>> gneb_images;
+
+	//energy of each image (J), and reaction coordinate (cumulative geodesic distance along chain)
+	std::vector<double> gneb_energies, gneb_coordinate;
+
+	//spring constant between images (J), climbing image enabled, maximum rotation in any cell per iteration (rad), convergence tolerance on residual torque field (A/m)
+	double gneb_spring = GNEB_SPRING;
+	bool gneb_climbing = true;
+	double gneb_step = GNEB_STEP;
+	double gneb_tolerance = GNEB_TOLERANCE;
+
+	//maximum residual torque field in the chain after the last run (A/m)
+	double gneb_residual = 0.0;
+
+	//-----Parallel tempering (see SuperMeshParallelTempering.cpp)
+
+	//temperature ladder (K), in increasing order : parallel tempering enabled if it has at least 2 temperatures
+	std::vector<double> pt_temperatures;
+
+	//replica at each temperature : pt_states[temperature][included magnetization vector][cell]
+	std::vector<std::vector<std::vector<DBL3>>> pt_states;
+
+	//module effective fields computed for the replica at each temperature after its last Monte Carlo step, so they don't have to be recomputed before its next step : pt_module_fields[temperature][module field][cell]
+	//empty if not available (e.g. after modules are initialized)
+	std::vector<std::vector<std::vector<DBL3>>> pt_module_fields;
+
+	//Monte Carlo cone angle at each temperature for each mesh (indexed as pMesh)
+	std::vector<std::vector<double>> pt_cone_angles;
+
+	//total energy (J) and normalized magnetization length of replica at each temperature after the last step
+	std::vector<double> pt_energy, pt_magnetization;
+
+	//sums for thermodynamic averages at each temperature, and number of samples
+	std::vector<double> pt_E_sum, pt_E2_sum, pt_M_sum;
+	int pt_samples = 0;
+
+	//swap attempts and accepted swaps between temperatures r and r + 1 (indexed by r)
+	std::vector<int> pt_swap_attempts, pt_swap_accepted;
+
+	//swap even (0) or odd (1) pairs on next step
+	int pt_swap_parity = 0;
+
+	//random number generator used for swap attempts
+	BorisRand pt_prng = BorisRand(GetSystemTickCount());
+
 public:
 
 	//name of super-mesh for use in console (e.g. addmodule supermesh sdemag). It is also a reserved name : no other module can be named with this handle
@@ -205,6 +262,15 @@ public:
 
 private:
 
+	//advance simulation by an atomistic time step, with the micromagnetic meshes advanced using a larger time step when due (multi-rate stepping)
+	void AdvanceTime_Multirate(void);
+
+	//GNEB : set magnetization in included meshes from given image, update effective fields and return total energy (J)
+	double GNEB_ComputeImage(std::vector<std::vector<DBL3>>& image);
+
+	//GNEB : build chain of images with given number of images by geodesic interpolation between initial and final states
+	void GNEB_InitializeChain(int images);
+
 public:
 
 	//--------------------------------------------------------- CTOR/DTOR
@@ -318,6 +384,30 @@ public:
 	//set parameters for adaptive time step control
 	void SetAdaptiveTimeStepCtrl(double err_fail, double dT_incr, double dT_min, double dT_max);
 
+	//set adaptive time step controller type (ASTEPCTRL_ value) and PI controller gains
+	void SetAdaptiveTimeStepController(int controller, double kI, double kP);
+
+	//reset adaptive time step statistics (accepted and rejected steps, wasted field evaluations)
+	void ResetAdaptiveTimeStepStats(void);
+
+	//set number of atomistic time steps per micromagnetic time step for multi-rate stepping (1 to disable)
+	BError SetMultirateSubcycles(int subcycles);
+	int GetMultirateSubcycles(void);
+	void Multirate_Restart(void) { odeSolver.Multirate_Restart(); }
+
+	//set active set relaxation parameters : torque threshold below which cells are frozen during relaxation stages (0 to disable), halo of cells kept active, re-examination period
+	void SetActiveSet(double threshold, int halo, int period);
+	DBL3 GetActiveSet(void);
+
+	//called by the simulation schedule : active set relaxation only applies during relaxation stages
+	void ActiveSet_SetStage(bool relax_stage);
+
+	//unfreeze all cells frozen by active set relaxation (e.g. before saving, since frozen cells are marked as skip cells in M)
+	void ActiveSet_Release(void);
+
+	//call before accepting a stop condition based on mxh or dmdt : true if the last time step was solved over the full mesh, else all cells are released for the next time step
+	bool ActiveSet_Verify_Stop(void);
+
 	void SetStochTimeStep(double dTstoch);
 	double GetStochTimeStep(void);
 	void SetLink_dTstoch(bool flag);
@@ -373,6 +463,15 @@ public:
 	double Get_AStepRelErrCtrl(void);
 	DBL3 Get_AStepdTCtrl(void);
 
+	int Get_AStepController(void);
+	DBL2 Get_AStepControllerGains(void);
+
+	//accepted steps, rejected steps, field evaluations wasted in rejected steps
+	INT3 Get_AStepStats(void);
+
+	//fraction of non-empty micromagnetic cells not frozen by active set relaxation
+	double Get_ActiveSet_Fraction(void);
+
 	bool IsMovingMeshSet(void);
 	int GetId_of_MoveMeshTrigger(void);
 	double Get_dwshift(void);
@@ -396,6 +495,9 @@ public:
 	//Disable/enable MC iteration in named mesh
 	BError Set_MonteCarlo_Disabled(bool status, std::string meshName);
 
+	//set number of over-relaxation sweeps and enable/disable cluster updates taken after every Metropolis step in given mesh - all if meshName is the supermesh handle
+	BError Set_MonteCarlo_Moves(int overrelax, bool cluster, std::string meshName);
+
 	void Set_MonteCarlo_ComputeFields(bool status) { computefields_if_MC = status; }
 	bool Get_MonteCarlo_ComputeFields(void) { return computefields_if_MC || force_computefields_if_MC; }
 
@@ -404,6 +506,70 @@ public:
 	void Set_MonteCarlo_ConeAngleLimits(DBL2 cone_angle_minmax_) { cone_angle_minmax = cone_angle_minmax_; }
 	DBL2 Get_MonteCarlo_ConeAngleLimits(void) { return cone_angle_minmax; }
 
+	//--------------------------------------------------------- PARALLEL TEMPERING : SuperMeshParallelTempering.cpp
+
+private:
+
+	//magnetization vectors in meshes taking part in Monte Carlo
+	void ParallelTempering_GetFields(std::vector<VEC_VC<DBL3>*>& fields);
+
+	//check parallel tempering can be used with the current configuration : energy of a configuration must not depend on temperature
+	BError ParallelTempering_CheckConfig(void);
+
+	//module effective fields in meshes taking part in Monte Carlo (only those which have been allocated, e.g. demag fields used to compute energy changes)
+	void ParallelTempering_GetModuleFields(std::vector<VEC<DBL3>*>& module_fields);
+
+	//update effective fields for the configuration currently in the meshes, returning the total energy (J)
+	double ParallelTempering_UpdateFields(void);
+
+	//total energy (J) and normalized magnetization length for the configuration currently in the meshes, also updating effective fields
+	DBL2 ParallelTempering_Measure(std::vector<VEC_VC<DBL3>*>& fields);
+
+	//Take a parallel tempering Monte Carlo step : one Metropolis step for each replica, followed by swap attempts between neighboring temperatures
+	void Iterate_MonteCarlo_ParallelTempering(double acceptance_rate);
+
+public:
+
+	//set temperature ladder with given number of replicas between Tmin and Tmax (K); replicas < 2 disables parallel tempering. Averages and swap statistics are reset.
+	BError ParallelTempering_Set(double Tmin, double Tmax, int replicas);
+
+	bool ParallelTempering_Enabled(void) { return pt_temperatures.size() > 1; }
+
+	//Tmin, Tmax (K), number of replicas
+	DBL3 ParallelTempering_Get_Settings(void) { return (ParallelTempering_Enabled() ? DBL3(pt_temperatures.front(), pt_temperatures.back(), pt_temperatures.size()) : DBL3()); }
+
+	//reset thermodynamic averages and swap statistics
+	void ParallelTempering_ResetStatistics(void);
+
+	//per-temperature data accumulated since the last reset : temperature (K), average energy (J), heat capacity (J/K), average normalized magnetization length, and swap acceptance rate with the next temperature
+	void ParallelTempering_Get_Data(std::vector<double>& temperature, std::vector<double>& energy, std::vector<double>& heat_capacity, std::vector<double>& magnetization, std::vector<double>& swap_rate);
+
+	//swap acceptance rate over all neighboring temperature pairs since the last reset
+	double ParallelTempering_Get_SwapRate(void);
+
+	//--------------------------------------------------------- GEODESIC NUDGED ELASTIC BAND : SuperMeshGNEB.cpp
+
+	//set current magnetization in all ferromagnetic meshes as the initial (endpoint = 0) or final (endpoint = 1) state. Any existing chain of images is cleared.
+	BError GNEB_SetEndpoint(int endpoint);
+
+	//spring constant (J), climbing image, maximum rotation per iteration (rad), convergence tolerance (A/m)
+	void GNEB_SetSettings(double spring, bool climbing, double step, double tolerance);
+	DBL4 GNEB_GetSettings(void) { return DBL4(gneb_spring, gneb_climbing, gneb_step, gneb_tolerance); }
+
+	//relax chain with given number of images for up to given number of iterations (chain built from endpoints if not available with this number of images). Magnetization is restored afterwards.
+	BError GNEB_Run(int images, int iterations, bool& converged);
+
+	//set magnetization from given image of the chain
+	BError GNEB_LoadImage(int image);
+
+	//minimum energy path : reaction coordinate and energy relative to the initial state (J) for each image
+	void GNEB_Get_MEP(std::vector<double>& coordinate, std::vector<double>& energy);
+
+	//energy barrier (J), index of highest energy image, maximum residual torque field (A/m)
+	DBL3 GNEB_Get_Barrier(void);
+
+	int GNEB_Get_Images(void) { return gneb_images.size(); }
+
 	//--------------------------------------------------------- MESH HANDLING - COMPONENTS : SuperMeshMeshes.cpp
 
 	//Add a new mesh of given type, name and dimensions
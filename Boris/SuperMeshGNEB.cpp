@@ -0,0 +1,430 @@
+#include "stdafx.h"
+#include "SuperMesh.h"
+
+//--------------------------------------------------------- GEODESIC NUDGED ELASTIC BAND
+
+//The geodesic nudged elastic band method (Bessarab et al., Comput. Phys. Commun. 196, 335 (2015)) finds the minimum energy path between two stable states, and the energy barrier between them.
+//A chain of images of the magnetization in all ferromagnetic meshes connects the initial and final states. For each image the effective field is computed with the usual modules (UpdateModules and supermesh modules),
+//and each image is relaxed using the force projected perpendicular to the path tangent, together with a spring force along the tangent keeping images evenly spaced (distances measured as geodesic distances on the unit sphere).
+//With climbing image enabled, the highest energy image does not feel spring forces but instead climbs up along the path tangent, so it converges to the saddle point.
+//Images share the meshes and modules (kernels, FFT plans, etc.), so they are computed one after another, each using all available threads.
+//CPU computations only.
+
+//geodesic distance between two unit vectors
+inline double GNEB_Angle(const DBL3& a, const DBL3& b) { return atan2((a ^ b).norm(), a * b); }
+
+//set current magnetization in all ferromagnetic meshes as the initial (endpoint = 0) or final (endpoint = 1) state. Any existing chain of images is cleared.
+BError SuperMesh::GNEB_SetEndpoint(int endpoint)
+{
+	BError error(__FUNCTION__);
+
+#if COMPILECUDA == 1
+	if (pSMeshCUDA) return error(BERROR_INCORRECTACTION);
+#endif
+
+	if (endpoint < 0 || endpoint > 1) return error(BERROR_INCORRECTVALUE);
+
+	std::vector<int> meshes;
+
+	for (int idx = 0; idx < pMesh.size(); idx++) {
+
+		if (pMesh[idx]->GetMeshType() == MESH_FERROMAGNETIC) meshes.push_back(idx);
+	}
+
+	if (!meshes.size()) return error(BERROR_INCORRECTACTION);
+
+	//included meshes changed : other endpoint no longer valid
+	if (meshes != gneb_meshes) {
+
+		gneb_meshes = meshes;
+		gneb_endpoints[1 - endpoint].clear();
+	}
+
+	gneb_endpoints[endpoint].resize(gneb_meshes.size());
+
+	for (int m = 0; m < gneb_meshes.size(); m++) {
+
+		VEC_VC<DBL3>& M = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M;
+
+		gneb_endpoints[endpoint][m].resize(M.linear_size());
+
+#pragma omp parallel for
+		for (int idx = 0; idx < M.linear_size(); idx++) {
+
+			gneb_endpoints[endpoint][m][idx] = (M.is_not_empty(idx) ? M[idx] : DBL3());
+		}
+	}
+
+	gneb_images.clear();
+	gneb_energies.clear();
+	gneb_coordinate.clear();
+	gneb_residual = 0.0;
+
+	return error;
+}
+
+void SuperMesh::GNEB_SetSettings(double spring, bool climbing, double step, double tolerance)
+{
+	gneb_spring = (spring >= 0.0 ? spring : 0.0);
+	gneb_climbing = climbing;
+	if (step > 0.0) gneb_step = step;
+	if (tolerance > 0.0) gneb_tolerance = tolerance;
+}
+
+//build chain of images with given number of images by geodesic interpolation between initial and final states
+void SuperMesh::GNEB_InitializeChain(int images)
+{
+	gneb_images.assign(images, std::vector<std::vector<DBL3>>(gneb_meshes.size()));
+
+	for (int m = 0; m < gneb_meshes.size(); m++) {
+
+		for (int i = 0; i < images; i++) gneb_images[i][m].assign(gneb_endpoints[0][m].size(), DBL3());
+
+#pragma omp parallel for
+		for (int idx = 0; idx < gneb_endpoints[0][m].size(); idx++) {
+
+			if (gneb_endpoints[0][m][idx].IsNull() || gneb_endpoints[1][m][idx].IsNull()) continue;
+
+			DBL3 a = gneb_endpoints[0][m][idx].normalized();
+			DBL3 b = gneb_endpoints[1][m][idx].normalized();
+
+			//rotate a towards b about their common normal (if anti-parallel any normal to a will do)
+			double theta = GNEB_Angle(a, b);
+			DBL3 axis = a ^ b;
+
+			if (axis.norm() < 1e-10) {
+
+				axis = a ^ DBL3(1, 0, 0);
+				if (axis.norm() < 1e-6) axis = a ^ DBL3(0, 1, 0);
+			}
+
+			axis = axis.normalized();
+
+			for (int i = 0; i < images; i++) {
+
+				double angle = theta * i / (images - 1);
+				gneb_images[i][m][idx] = a * cos(angle) + (axis ^ a) * sin(angle);
+			}
+
+			//endpoints exact
+			gneb_images[0][m][idx] = a;
+			gneb_images[images - 1][m][idx] = b;
+		}
+	}
+
+	gneb_energies.assign(images, 0.0);
+	gneb_coordinate.assign(images, 0.0);
+}
+
+//set magnetization in included meshes from given image, update effective fields and return total energy (J)
+double SuperMesh::GNEB_ComputeImage(std::vector<std::vector<DBL3>>& image)
+{
+	for (int m = 0; m < gneb_meshes.size(); m++) {
+
+		VEC_VC<DBL3>& M = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M;
+
+#pragma omp parallel for
+		for (int idx = 0; idx < M.linear_size(); idx++) {
+
+			if (M.is_not_empty(idx)) M[idx] = image[m][idx] * gneb_endpoints[0][m][idx].norm();
+		}
+	}
+
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+		pMesh[idx]->PrepareNewIteration();
+	}
+
+	//energy densities returned by meshes are averages over their non-empty magnetic volume, and supermesh modules return averages over all non-empty magnetic volume
+	double energy = 0.0, total_volume = 0.0;
+
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+		double volume = pMesh[idx]->Get_NonEmpty_Magnetic_Volume();
+
+		energy += pMesh[idx]->UpdateModules() * volume;
+		total_volume += volume;
+	}
+
+	for (int idx = 0; idx < (int)pSMod.size(); idx++) {
+
+		energy += pSMod[idx]->UpdateField() * total_volume;
+	}
+
+	return energy;
+}
+
+//relax chain with given number of images for up to given number of iterations (chain built from endpoints if not available with this number of images). Magnetization is restored afterwards.
+BError SuperMesh::GNEB_Run(int images, int iterations, bool& converged)
+{
+	BError error(__FUNCTION__);
+
+	converged = false;
+
+#if COMPILECUDA == 1
+	if (pSMeshCUDA) return error(BERROR_INCORRECTACTION);
+#endif
+
+	if (images < 3 || !gneb_endpoints[0].size() || !gneb_endpoints[1].size()) return error(BERROR_INCORRECTACTION);
+
+	//meshes must not have changed since endpoints were set
+	for (int m = 0; m < gneb_meshes.size(); m++) {
+
+		if (gneb_meshes[m] >= pMesh.size() || pMesh[gneb_meshes[m]]->GetMeshType() != MESH_FERROMAGNETIC) return error(BERROR_INCORRECTCONFIG);
+
+		int cells = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M.linear_size();
+		if (gneb_endpoints[0][m].size() != cells || gneb_endpoints[1][m].size() != cells) return error(BERROR_INCORRECTCONFIG);
+	}
+
+	error = InitializeAllModules();
+	if (error) return error;
+
+	//all cells must be evaluated
+	odeSolver.ActiveSet_Release();
+
+	if (gneb_images.size() != images) GNEB_InitializeChain(images);
+
+	int num_meshes = gneb_meshes.size();
+
+	//save magnetization to restore at the end, and get per-cell force scaling mu0 * |M| * V, converting effective field to energy gradient (J)
+	std::vector<std::vector<DBL3>> M_saved(num_meshes);
+	std::vector<std::vector<double>> weights(num_meshes);
+
+	for (int m = 0; m < num_meshes; m++) {
+
+		VEC_VC<DBL3>& M = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M;
+
+		M_saved[m].resize(M.linear_size());
+		weights[m].resize(M.linear_size());
+
+		double volume = M.h.dim();
+
+#pragma omp parallel for
+		for (int idx = 0; idx < M.linear_size(); idx++) {
+
+			M_saved[m][idx] = M[idx];
+			weights[m][idx] = MU0 * gneb_endpoints[0][m][idx].norm() * volume;
+		}
+	}
+
+	//forces on images : first energy gradient perpendicular to magnetization (J), then total GNEB force converted to torque field (A/m). Endpoints have no forces.
+	std::vector<std::vector<std::vector<DBL3>>> forces(images, std::vector<std::vector<DBL3>>(num_meshes));
+	std::vector<std::vector<DBL3>> tangent(num_meshes);
+
+	for (int m = 0; m < num_meshes; m++) {
+
+		for (int i = 0; i < images; i++) forces[i][m].assign(weights[m].size(), DBL3());
+		tangent[m].assign(weights[m].size(), DBL3());
+	}
+
+	//geodesic distances between consecutive images
+	std::vector<double> distances(images - 1, 0.0);
+
+	double step = gneb_step, residual_previous = 0.0;
+
+	for (int iter = 0; ; iter++) {
+
+		//1. energies and perpendicular energy gradients for all images (endpoints fixed so only needed once)
+		for (int i = 0; i < images; i++) {
+
+			if (iter && (i == 0 || i == images - 1)) continue;
+
+			gneb_energies[i] = GNEB_ComputeImage(gneb_images[i]);
+
+			for (int m = 0; m < num_meshes; m++) {
+
+				VEC<DBL3>& Heff = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->Heff;
+
+#pragma omp parallel for
+				for (int idx = 0; idx < Heff.linear_size(); idx++) {
+
+					DBL3 mval = gneb_images[i][m][idx];
+					DBL3 f = Heff[idx] * weights[m][idx];
+
+					forces[i][m][idx] = f - mval * (f * mval);
+				}
+			}
+		}
+
+		//2. geodesic distances along chain and reaction coordinate
+		for (int i = 0; i < images - 1; i++) {
+
+			double distance_sq = 0.0;
+
+			for (int m = 0; m < num_meshes; m++) {
+
+#pragma omp parallel for reduction(+:distance_sq)
+				for (int idx = 0; idx < weights[m].size(); idx++) {
+
+					double angle = GNEB_Angle(gneb_images[i][m][idx], gneb_images[i + 1][m][idx]);
+					distance_sq += angle * angle;
+				}
+			}
+
+			distances[i] = sqrt(distance_sq);
+			gneb_coordinate[i + 1] = gneb_coordinate[i] + distances[i];
+		}
+
+		//3. climbing image is the highest energy intermediate image
+		int climbing_image = -1;
+
+		if (gneb_climbing) {
+
+			climbing_image = 1;
+			for (int i = 2; i < images - 1; i++) if (gneb_energies[i] > gneb_energies[climbing_image]) climbing_image = i;
+		}
+
+		//4. GNEB forces on intermediate images
+		double residual = 0.0;
+
+		for (int i = 1; i < images - 1; i++) {
+
+			double E_prev = gneb_energies[i - 1], E = gneb_energies[i], E_next = gneb_energies[i + 1];
+
+			//improved tangent (Henkelman and Jonsson) : use higher energy neighbour, or energy-weighted combination at extrema
+			double w_next = 0.0, w_prev = 0.0;
+
+			if (E_next > E && E > E_prev) w_next = 1.0;
+			else if (E_next < E && E < E_prev) w_prev = 1.0;
+			else {
+
+				double dE_max = maximum(fabs(E_next - E), fabs(E_prev - E));
+				double dE_min = minimum(fabs(E_next - E), fabs(E_prev - E));
+
+				if (E_next > E_prev) { w_next = dE_max; w_prev = dE_min; }
+				else { w_next = dE_min; w_prev = dE_max; }
+			}
+
+			//tangent projected on tangent space of image, together with its norm and projection of gradient force on it
+			double tangent_sq = 0.0, force_dot_tangent = 0.0;
+
+			for (int m = 0; m < num_meshes; m++) {
+
+#pragma omp parallel for reduction(+:tangent_sq, force_dot_tangent)
+				for (int idx = 0; idx < weights[m].size(); idx++) {
+
+					DBL3 mval = gneb_images[i][m][idx];
+					DBL3 t = (gneb_images[i + 1][m][idx] - mval) * w_next + (mval - gneb_images[i - 1][m][idx]) * w_prev;
+
+					t -= mval * (t * mval);
+
+					tangent[m][idx] = t;
+					tangent_sq += t * t;
+					force_dot_tangent += forces[i][m][idx] * t;
+				}
+			}
+
+			double tangent_norm = sqrt(tangent_sq);
+			if (tangent_norm > 0.0) force_dot_tangent /= tangent_norm;
+			else tangent_norm = 1.0;
+
+			//force along tangent : spring force, or for climbing image inverted gradient force component along the tangent
+			double tangential;
+			if (i == climbing_image) tangential = -2.0 * force_dot_tangent;
+			else tangential = gneb_spring * (distances[i] - distances[i - 1]) - force_dot_tangent;
+
+			double residual_image = 0.0;
+
+			for (int m = 0; m < num_meshes; m++) {
+
+#pragma omp parallel for reduction(max:residual_image)
+				for (int idx = 0; idx < weights[m].size(); idx++) {
+
+					if (weights[m][idx] <= 0.0) continue;
+
+					DBL3 F = forces[i][m][idx] + tangent[m][idx] * (tangential / tangent_norm);
+
+					//convert to torque field (A/m)
+					forces[i][m][idx] = F / weights[m][idx];
+
+					double F_norm = forces[i][m][idx].norm();
+					if (F_norm > residual_image) residual_image = F_norm;
+				}
+			}
+
+			residual = maximum(residual, residual_image);
+		}
+
+		gneb_residual = residual;
+
+		if (residual < gneb_tolerance) { converged = true; break; }
+		if (iter >= iterations) break;
+
+		//5. step control : halve step if the residual increased, else grow it back towards the set maximum rotation
+		if (iter && residual > residual_previous) step *= 0.5;
+		else step = minimum(step * 1.1, gneb_step);
+
+		residual_previous = residual;
+
+		//6. move intermediate images along forces, with maximum rotation in any cell equal to step
+		double scaling = step / residual;
+
+		for (int i = 1; i < images - 1; i++) {
+
+			for (int m = 0; m < num_meshes; m++) {
+
+#pragma omp parallel for
+				for (int idx = 0; idx < weights[m].size(); idx++) {
+
+					if (weights[m][idx] <= 0.0) continue;
+
+					gneb_images[i][m][idx] = (gneb_images[i][m][idx] + forces[i][m][idx] * scaling).normalized();
+				}
+			}
+		}
+	}
+
+	//restore magnetization
+	for (int m = 0; m < num_meshes; m++) {
+
+		VEC_VC<DBL3>& M = dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M;
+
+#pragma omp parallel for
+		for (int idx = 0; idx < M.linear_size(); idx++) M[idx] = M_saved[m][idx];
+	}
+
+	ComputeFields();
+
+	return error;
+}
+
+//set magnetization from given image of the chain
+BError SuperMesh::GNEB_LoadImage(int image)
+{
+	BError error(__FUNCTION__);
+
+	if (image < 0 || image >= gneb_images.size()) return error(BERROR_INCORRECTVALUE);
+
+	for (int m = 0; m < gneb_meshes.size(); m++) {
+
+		if (gneb_meshes[m] >= pMesh.size() || pMesh[gneb_meshes[m]]->GetMeshType() != MESH_FERROMAGNETIC) return error(BERROR_INCORRECTCONFIG);
+		if (dynamic_cast<Mesh*>(pMesh[gneb_meshes[m]])->M.linear_size() != gneb_images[image][m].size()) return error(BERROR_INCORRECTCONFIG);
+	}
+
+	error = InitializeAllModules();
+	if (error) return error;
+
+	GNEB_ComputeImage(gneb_images[image]);
+
+	return error;
+}
+
+//minimum energy path : reaction coordinate and energy relative to the initial state (J) for each image
+void SuperMesh::GNEB_Get_MEP(std::vector<double>& coordinate, std::vector<double>& energy)
+{
+	coordinate = gneb_coordinate;
+	energy = gneb_energies;
+
+	for (int i = 0; i < energy.size(); i++) energy[i] -= gneb_energies[0];
+}
+
+//energy barrier (J), index of highest energy image, maximum residual torque field (A/m)
+DBL3 SuperMesh::GNEB_Get_Barrier(void)
+{
+	if (!gneb_energies.size()) return DBL3();
+
+	int max_image = 0;
+	for (int i = 1; i < gneb_energies.size(); i++) if (gneb_energies[i] > gneb_energies[max_image]) max_image = i;
+
+	return DBL3(gneb_energies[max_image] - gneb_energies[0], max_image, gneb_residual);
+}
@@ -78,6 +78,65 @@ void SuperMesh::SetAdaptiveTimeStepCtrl(double err_fail, double dT_incr, double
 	odeSolver.SetAdaptiveTimeStepCtrl(err_fail, dT_incr, dT_min, dT_max); 
 }
 
+//set adaptive time step controller type (ASTEPCTRL_ value) and PI controller gains
+void SuperMesh::SetAdaptiveTimeStepController(int controller, double kI, double kP)
+{
+	odeSolver.SetAdaptiveTimeStepController(controller, kI, kP);
+}
+
+//reset adaptive time step statistics (accepted and rejected steps, wasted field evaluations)
+void SuperMesh::ResetAdaptiveTimeStepStats(void)
+{
+	odeSolver.ResetAdaptiveTimeStepStats();
+}
+
+//set active set relaxation parameters : torque threshold below which cells are frozen during relaxation stages (0 to disable), halo of cells kept active, re-examination period
+void SuperMesh::SetActiveSet(double threshold, int halo, int period)
+{
+	odeSolver.SetActiveSet(threshold, halo, period);
+}
+
+DBL3 SuperMesh::GetActiveSet(void)
+{
+	return DBL3(odeSolver.GetActiveSetThreshold(), odeSolver.GetActiveSetHalo(), odeSolver.GetActiveSetPeriod());
+}
+
+//called by the simulation schedule : active set relaxation only applies during relaxation stages
+void SuperMesh::ActiveSet_SetStage(bool relax_stage)
+{
+	odeSolver.ActiveSet_SetStage(relax_stage);
+}
+
+//unfreeze all cells frozen by active set relaxation (e.g. before saving, since frozen cells are marked as skip cells in M)
+void SuperMesh::ActiveSet_Release(void)
+{
+	odeSolver.ActiveSet_Release();
+}
+
+//call before accepting a stop condition based on mxh or dmdt : true if the last time step was solved over the full mesh, else all cells are released for the next time step
+bool SuperMesh::ActiveSet_Verify_Stop(void)
+{
+	return odeSolver.ActiveSet_Verify_Stop();
+}
+
+//set number of atomistic time steps per micromagnetic time step for multi-rate stepping (1 to disable)
+BError SuperMesh::SetMultirateSubcycles(int subcycles)
+{
+	BError error(__FUNCTION__);
+
+	odeSolver.SetMultirateSubcycles(subcycles);
+
+	//micromagnetic ODE memory depends on this setting
+	error = UpdateConfiguration(UPDATECONFIG_ODE_SOLVER);
+
+	return error;
+}
+
+int SuperMesh::GetMultirateSubcycles(void)
+{
+	return odeSolver.GetMultirateSubcycles();
+}
+
 void SuperMesh::SetStochTimeStep(double dTstoch) 
 { 
 	odeSolver.SetStochTimeStep(dTstoch);
@@ -253,6 +312,26 @@ DBL3 SuperMesh::Get_AStepdTCtrl(void)
 	return odeSolver.Get_AStepdTCtrl();
 }
 
+int SuperMesh::Get_AStepController(void)
+{
+	return odeSolver.Get_AStepController();
+}
+
+DBL2 SuperMesh::Get_AStepControllerGains(void)
+{
+	return odeSolver.Get_AStepControllerGains();
+}
+
+INT3 SuperMesh::Get_AStepStats(void)
+{
+	return odeSolver.Get_AStepStats();
+}
+
+double SuperMesh::Get_ActiveSet_Fraction(void)
+{
+	return odeSolver.Get_ActiveSet_Fraction();
+}
+
 bool SuperMesh::IsMovingMeshSet(void) 
 { 
 	return odeSolver.IsMovingMeshSet();
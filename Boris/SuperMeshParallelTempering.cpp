@@ -0,0 +1,412 @@
+#include "stdafx.h"
+#include "SuperMesh.h"
+
+//--------------------------------------------------------- PARALLEL TEMPERING
+
+//With parallel tempering (replica exchange Monte Carlo) a number of replicas of the magnetization are simulated at a ladder of temperatures between Tmin and Tmax (geometric spacing).
+//On every Monte Carlo step each replica is loaded in turn into the meshes taking part in Monte Carlo (ferromagnetic, antiferromagnetic and atomistic meshes with Monte Carlo not disabled), the base temperature set,
+//effective fields restored if required by modules using them for energy changes (e.g. demag), and one Metropolis step taken using the usual algorithm set for each mesh, after which the total energy of the replica is computed.
+//Computing the energy also computes the module effective fields for the new configuration : these are kept with the replica (and exchanged with it) so they are only recomputed once per replica on every step. Configurations at neighboring temperatures are then swapped with probability
+//min(1, exp((1/kTi - 1/kTj)(Ei - Ej))), alternating between even and odd pairs, so configurations trapped at low temperatures can escape through the high temperature replicas.
+//This criterion only satisfies detailed balance if the energy doesn't depend on temperature, thus parallel tempering is not available if meshes taking part in Monte Carlo have temperature dependent parameters (or a base temperature equation).
+//Replicas share the meshes and modules, so they are computed one after another, each using all available threads. The adaptive cone angle is kept separately for each temperature.
+//At the end of every step the meshes hold the configuration at Tmin, and the base temperature of each mesh is restored.
+//CPU computations only.
+
+//magnetization vectors in meshes taking part in Monte Carlo
+void SuperMesh::ParallelTempering_GetFields(std::vector<VEC_VC<DBL3>*>& fields)
+{
+	fields.clear();
+
+	for (int idx = 0; idx < pMesh.size(); idx++) {
+
+		if (pMesh[idx]->Get_MonteCarlo_Disabled()) continue;
+
+		switch (pMesh[idx]->GetMeshType()) {
+
+		case MESH_FERROMAGNETIC:
+			fields.push_back(&dynamic_cast<Mesh*>(pMesh[idx])->M);
+			break;
+
+		case MESH_ANTIFERROMAGNETIC:
+			fields.push_back(&dynamic_cast<Mesh*>(pMesh[idx])->M);
+			fields.push_back(&dynamic_cast<Mesh*>(pMesh[idx])->M2);
+			break;
+
+		case MESH_ATOM_CUBIC:
+			fields.push_back(&dynamic_cast<Atom_Mesh*>(pMesh[idx])->M1);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+//module effective fields in meshes taking part in Monte Carlo (only those which have been allocated, e.g. demag fields used to compute energy changes)
+void SuperMesh::ParallelTempering_GetModuleFields(std::vector<VEC<DBL3>*>& module_fields)
+{
+	module_fields.clear();
+
+	for (int idx = 0; idx < pMesh.size(); idx++) {
+
+		if (pMesh[idx]->Get_MonteCarlo_Disabled()) continue;
+
+		MeshBase& mesh = *pMesh[idx];
+
+		for (int mod_idx = 0; mod_idx < mesh().size(); mod_idx++) {
+
+			if (mesh[mod_idx]->Get_Module_Heff().linear_size()) module_fields.push_back(&mesh[mod_idx]->Get_Module_Heff());
+			if (mesh[mod_idx]->Get_Module_Heff2().linear_size()) module_fields.push_back(&mesh[mod_idx]->Get_Module_Heff2());
+		}
+	}
+}
+
+//check parallel tempering can be used with the current configuration : energy of a configuration must not depend on temperature
+BError SuperMesh::ParallelTempering_CheckConfig(void)
+{
+	BError error(__FUNCTION__);
+
+	for (int idx = 0; idx < pMesh.size(); idx++) {
+
+		if (pMesh[idx]->Get_MonteCarlo_Disabled()) continue;
+
+		//a base temperature equation would also override the ladder temperatures when modules are updated
+		if (pMesh[idx]->T_equation.is_set()) return error(BERROR_INCORRECTCONFIG);
+
+		for (int param_idx = 0; param_idx < pMesh[idx]->get_num_meshparams(); param_idx++) {
+
+			if (pMesh[idx]->is_paramtemp_set((PARAM_)pMesh[idx]->get_meshparam_id(param_idx))) return error(BERROR_INCORRECTCONFIG);
+		}
+	}
+
+	return error;
+}
+
+//set temperature ladder with given number of replicas between Tmin and Tmax (K); replicas < 2 disables parallel tempering. Averages and swap statistics are reset.
+BError SuperMesh::ParallelTempering_Set(double Tmin, double Tmax, int replicas)
+{
+	BError error(__FUNCTION__);
+
+	if (replicas < 2) {
+
+		pt_temperatures.clear();
+		pt_states.clear();
+		pt_module_fields.clear();
+		pt_cone_angles.clear();
+		ParallelTempering_ResetStatistics();
+
+		return error;
+	}
+
+#if COMPILECUDA == 1
+	if (pSMeshCUDA) return error(BERROR_INCORRECTACTION);
+#endif
+
+	if (Tmin <= 0.0 || Tmax <= Tmin) return error(BERROR_INCORRECTVALUE);
+
+	error = ParallelTempering_CheckConfig();
+	if (error) return error;
+
+	//replicas are kept if the number of temperatures doesn't change, so the ladder can be adjusted without losing equilibrated configurations
+	if (replicas != pt_temperatures.size()) {
+
+		pt_states.clear();
+		pt_module_fields.clear();
+		pt_cone_angles.clear();
+	}
+
+	pt_temperatures.resize(replicas);
+
+	for (int r = 0; r < replicas; r++) {
+
+		pt_temperatures[r] = Tmin * pow(Tmax / Tmin, (double)r / (replicas - 1));
+	}
+
+	ParallelTempering_ResetStatistics();
+
+	return error;
+}
+
+//reset thermodynamic averages and swap statistics
+void SuperMesh::ParallelTempering_ResetStatistics(void)
+{
+	int replicas = pt_temperatures.size();
+
+	pt_energy.assign(replicas, 0.0);
+	pt_magnetization.assign(replicas, 0.0);
+	pt_E_sum.assign(replicas, 0.0);
+	pt_E2_sum.assign(replicas, 0.0);
+	pt_M_sum.assign(replicas, 0.0);
+	pt_samples = 0;
+
+	pt_swap_attempts.assign(replicas, 0);
+	pt_swap_accepted.assign(replicas, 0);
+	pt_swap_parity = 0;
+}
+
+//update effective fields for the configuration currently in the meshes, returning the total energy (J)
+double SuperMesh::ParallelTempering_UpdateFields(void)
+{
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+		pMesh[idx]->PrepareNewIteration();
+	}
+
+	//energy densities returned by meshes are averages over their non-empty magnetic volume, and supermesh modules return averages over all non-empty magnetic volume
+	double energy = 0.0, total_volume = 0.0;
+
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+		double volume = pMesh[idx]->Get_NonEmpty_Magnetic_Volume();
+
+		energy += pMesh[idx]->UpdateModules() * volume;
+		total_volume += volume;
+	}
+
+	for (int idx = 0; idx < (int)pSMod.size(); idx++) {
+
+		energy += pSMod[idx]->UpdateField() * total_volume;
+	}
+
+	return energy;
+}
+
+//total energy (J) and normalized magnetization length for the configuration currently in the meshes, also updating effective fields
+DBL2 SuperMesh::ParallelTempering_Measure(std::vector<VEC_VC<DBL3>*>& fields)
+{
+	double energy = ParallelTempering_UpdateFields();
+
+	double Mx = 0.0, My = 0.0, Mz = 0.0, M_norm = 0.0;
+
+	for (int f = 0; f < fields.size(); f++) {
+
+		VEC_VC<DBL3>& M = *fields[f];
+
+#pragma omp parallel for reduction(+:Mx, My, Mz, M_norm)
+		for (int idx = 0; idx < M.linear_size(); idx++) {
+
+			if (M.is_not_empty(idx)) {
+
+				Mx += M[idx].x;
+				My += M[idx].y;
+				Mz += M[idx].z;
+				M_norm += M[idx].norm();
+			}
+		}
+	}
+
+	return DBL2(energy, (M_norm > 0.0 ? DBL3(Mx, My, Mz).norm() / M_norm : 0.0));
+}
+
+//Take a parallel tempering Monte Carlo step : one Metropolis step for each replica, followed by swap attempts between neighboring temperatures
+void SuperMesh::Iterate_MonteCarlo_ParallelTempering(double acceptance_rate)
+{
+	int replicas = pt_temperatures.size();
+
+	std::vector<VEC_VC<DBL3>*> fields;
+	ParallelTempering_GetFields(fields);
+
+	//(re)initialize all replicas from the current configuration if not available, or if the meshes have changed
+	bool initialize = (pt_states.size() != replicas || pt_states[0].size() != fields.size() || pt_cone_angles[0].size() != pMesh.size());
+	for (int f = 0; f < fields.size() && !initialize; f++) initialize = (pt_states[0][f].size() != fields[f]->linear_size());
+
+	if (initialize) {
+
+		pt_module_fields.clear();
+		pt_states.assign(replicas, std::vector<std::vector<DBL3>>(fields.size()));
+		pt_cone_angles.assign(replicas, std::vector<double>(pMesh.size()));
+
+		for (int r = 0; r < replicas; r++) {
+
+			for (int f = 0; f < fields.size(); f++) {
+
+				VEC_VC<DBL3>& M = *fields[f];
+				pt_states[r][f].resize(M.linear_size());
+
+#pragma omp parallel for
+				for (int idx = 0; idx < M.linear_size(); idx++) pt_states[r][f][idx] = M[idx];
+			}
+
+			for (int idx = 0; idx < pMesh.size(); idx++) pt_cone_angles[r][idx] = pMesh[idx]->Get_MonteCarlo_Params().i;
+		}
+
+		ParallelTempering_ResetStatistics();
+	}
+
+	//module effective fields kept with each replica : (re)allocate if not available, in which case they are computed for each replica before its Metropolis step on this step only
+	std::vector<VEC<DBL3>*> module_fields;
+	if (Get_MonteCarlo_ComputeFields()) ParallelTempering_GetModuleFields(module_fields);
+
+	bool restore_module_fields = (pt_module_fields.size() == replicas && pt_module_fields[0].size() == module_fields.size());
+	for (int f = 0; f < module_fields.size() && restore_module_fields; f++) restore_module_fields = (pt_module_fields[0][f].size() == module_fields[f]->linear_size());
+
+	if (!restore_module_fields) {
+
+		pt_module_fields.assign(replicas, std::vector<std::vector<DBL3>>(module_fields.size()));
+
+		for (int r = 0; r < replicas; r++) {
+
+			for (int f = 0; f < module_fields.size(); f++) pt_module_fields[r][f].resize(module_fields[f]->linear_size());
+		}
+	}
+
+	//base temperatures set by the user, restored at the end of the step
+	std::vector<double> base_temperatures(pMesh.size());
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) base_temperatures[idx] = pMesh[idx]->GetBaseTemperature();
+
+	//Metropolis step for each replica, finishing with Tmin so its configuration is left in the meshes
+	for (int r = replicas - 1; r >= 0; r--) {
+
+		for (int f = 0; f < fields.size(); f++) {
+
+			VEC_VC<DBL3>& M = *fields[f];
+
+#pragma omp parallel for
+			for (int idx = 0; idx < M.linear_size(); idx++) M[idx] = pt_states[r][f][idx];
+		}
+
+		for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+			if (pMesh[idx]->Get_MonteCarlo_Disabled()) continue;
+
+			pMesh[idx]->SetBaseTemperature(pt_temperatures[r], false);
+			pMesh[idx]->Set_MonteCarlo_ConeAngle(pt_cone_angles[r][idx]);
+		}
+
+		//effective fields still hold values for the previous replica : modules which use them to compute energy changes (e.g. demag) need them for this replica
+		if (Get_MonteCarlo_ComputeFields()) {
+
+			if (restore_module_fields) {
+
+				for (int f = 0; f < module_fields.size(); f++) {
+
+					VEC<DBL3>& H = *module_fields[f];
+
+#pragma omp parallel for
+					for (int idx = 0; idx < H.linear_size(); idx++) H[idx] = pt_module_fields[r][f][idx];
+				}
+			}
+			else ParallelTempering_UpdateFields();
+		}
+
+		for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+			if (pMesh[idx]->Get_MonteCarlo_Disabled()) continue;
+
+			pMesh[idx]->Iterate_MonteCarlo(acceptance_rate);
+
+			pt_cone_angles[r][idx] = pMesh[idx]->Get_MonteCarlo_Params().i;
+		}
+
+		DBL2 measured = ParallelTempering_Measure(fields);
+		pt_energy[r] = measured.i;
+		pt_magnetization[r] = measured.j;
+
+		for (int f = 0; f < fields.size(); f++) {
+
+			VEC_VC<DBL3>& M = *fields[f];
+
+#pragma omp parallel for
+			for (int idx = 0; idx < M.linear_size(); idx++) pt_states[r][f][idx] = M[idx];
+		}
+
+		//fields computed with the energy are those needed for the next step of this replica
+		for (int f = 0; f < module_fields.size(); f++) {
+
+			VEC<DBL3>& H = *module_fields[f];
+
+#pragma omp parallel for
+			for (int idx = 0; idx < H.linear_size(); idx++) pt_module_fields[r][f][idx] = H[idx];
+		}
+	}
+
+	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+		if (pMesh[idx]->GetBaseTemperature() != base_temperatures[idx]) pMesh[idx]->SetBaseTemperature(base_temperatures[idx], false);
+	}
+
+	//swap configurations between neighboring temperatures : even pairs (0-1, 2-3, ...) and odd pairs (1-2, 3-4, ...) on alternate steps
+	bool swapped_Tmin = false;
+
+	for (int r = pt_swap_parity; r < replicas - 1; r += 2) {
+
+		pt_swap_attempts[r]++;
+
+		double exponent = (1.0 / pt_temperatures[r] - 1.0 / pt_temperatures[r + 1]) * (pt_energy[r] - pt_energy[r + 1]) / BOLTZMANN;
+
+		if (exponent >= 0.0 || pt_prng.rand() < exp(exponent)) {
+
+			pt_swap_accepted[r]++;
+
+			std::swap(pt_states[r], pt_states[r + 1]);
+			std::swap(pt_module_fields[r], pt_module_fields[r + 1]);
+			std::swap(pt_energy[r], pt_energy[r + 1]);
+			std::swap(pt_magnetization[r], pt_magnetization[r + 1]);
+
+			if (r == 0) swapped_Tmin = true;
+		}
+	}
+
+	pt_swap_parity = 1 - pt_swap_parity;
+
+	//accumulate thermodynamic averages for each temperature
+	for (int r = 0; r < replicas; r++) {
+
+		pt_E_sum[r] += pt_energy[r];
+		pt_E2_sum[r] += pt_energy[r] * pt_energy[r];
+		pt_M_sum[r] += pt_magnetization[r];
+	}
+
+	pt_samples++;
+
+	//configuration at Tmin changed : load it
+	if (swapped_Tmin) {
+
+		for (int f = 0; f < fields.size(); f++) {
+
+			VEC_VC<DBL3>& M = *fields[f];
+
+#pragma omp parallel for
+			for (int idx = 0; idx < M.linear_size(); idx++) M[idx] = pt_states[0][f][idx];
+		}
+	}
+}
+
+//per-temperature data accumulated since the last reset : temperature (K), average energy (J), heat capacity (J/K), average normalized magnetization length, and swap acceptance rate with the next temperature
+void SuperMesh::ParallelTempering_Get_Data(std::vector<double>& temperature, std::vector<double>& energy, std::vector<double>& heat_capacity, std::vector<double>& magnetization, std::vector<double>& swap_rate)
+{
+	int replicas = pt_temperatures.size();
+
+	temperature = pt_temperatures;
+	energy.assign(replicas, 0.0);
+	heat_capacity.assign(replicas, 0.0);
+	magnetization.assign(replicas, 0.0);
+	swap_rate.assign(replicas, 0.0);
+
+	for (int r = 0; r < replicas; r++) {
+
+		if (pt_samples) {
+
+			energy[r] = pt_E_sum[r] / pt_samples;
+			heat_capacity[r] = (pt_E2_sum[r] / pt_samples - energy[r] * energy[r]) / (BOLTZMANN * pt_temperatures[r] * pt_temperatures[r]);
+			magnetization[r] = pt_M_sum[r] / pt_samples;
+		}
+
+		if (pt_swap_attempts[r]) swap_rate[r] = (double)pt_swap_accepted[r] / pt_swap_attempts[r];
+	}
+}
+
+//swap acceptance rate over all neighboring temperature pairs since the last reset
+double SuperMesh::ParallelTempering_Get_SwapRate(void)
+{
+	int attempts = 0, accepted = 0;
+
+	for (int r = 0; r < pt_swap_attempts.size(); r++) {
+
+		attempts += pt_swap_attempts[r];
+		accepted += pt_swap_accepted[r];
+	}
+
+	return (attempts ? (double)accepted / attempts : 0.0);
+}
@@ -34,6 +34,10 @@ BError SuperMesh::InitializeAllModules(void)
 		}
 	}
 
+	//4. module effective fields kept for parallel tempering replicas may no longer apply (e.g. parameters changed), and temperature dependent parameters may have been set since parallel tempering was enabled
+	pt_module_fields.clear();
+	if (!error && ParallelTempering_Enabled()) error = ParallelTempering_CheckConfig();
+
 	return error;
 }
 
@@ -77,18 +81,32 @@ BError SuperMesh::InitializeAllModulesCUDA(void)
 		}
 	}
 
+	//4. parallel tempering is only available for CPU computations, but may have been enabled before CUDA was switched on : the CUDA Monte Carlo algorithms would silently ignore it
+	if (!error && ParallelTempering_Enabled()) error(BERROR_INCORRECTACTION);
+
 	return error;
 }
 #endif
 
 void SuperMesh::AdvanceTime(void)
 {
-	//Currently micromagnetic and atomistic meshes must have the same ODE evaluation method set, with the same time-step.
-	//In the future this will be changed to allow better performance, as it's possible in a multiscale simulation some micromagnetics meshes can be evaluated with a larger time-step compared to atomistic ones.
+	//Micromagnetic and atomistic meshes must have the same ODE evaluation method set, with the same time-step.
+	//The exception is multi-rate stepping (fixed time-step methods only), where micromagnetic meshes are evaluated with a larger time-step compared to atomistic ones : see AdvanceTime_Multirate.
 
 	//moving mesh algorithm, if enabled
 	odeSolver.MovingMeshAlgorithm(this);
 
+	//not with the heat equation : SHeat advances the temperature by the last time step whenever a time step is solved, so it would be advanced on both the micromagnetic and atomistic clocks
+	if (odeSolver.Multirate_Enabled() && !IsSuperMeshModuleSet(MODS_SHEAT)) {
+
+		AdvanceTime_Multirate();
+		return;
+	}
+
+	//active set relaxation, if enabled : frozen cells are released before the time step when a re-examination is due
+	bool activeset = odeSolver.ActiveSet_Enabled();
+	if (activeset) odeSolver.ActiveSet_Begin_Step();
+
 	do {
 
 		//prepare meshes for new iteration (typically involves setting some state flag)
@@ -112,10 +130,82 @@ void SuperMesh::AdvanceTime(void)
 			total_energy_density += pSMod[idx]->UpdateField();
 		}
 
+		//the nonlinear conjugate gradient line search checks for energy decrease
+		odeSolver.NCG_Set_Energy(total_energy_density);
+
 		//iterate ODE evaluation method - ODE solvers are called separately in the magnetic meshes. This is why the same evaluation method must be used in all the magnetic meshes, with the same time step.
 		odeSolver.Iterate();
 
 	} while (!odeSolver.TimeStepSolved());
+
+	//update frozen cells from torques computed during this time step
+	if (activeset) odeSolver.ActiveSet_End_Step();
+}
+
+//advance simulation by an atomistic time step, with the micromagnetic meshes advanced using a larger time step when due (multi-rate stepping)
+void SuperMesh::AdvanceTime_Multirate(void)
+{
+	//1. micromagnetic time step, if due : atomistic meshes are held at the current time (their effective fields are not needed)
+	if (odeSolver.Multirate_SlowStep_Due()) {
+
+		odeSolver.Multirate_Begin_SlowStep();
+
+		do {
+
+			for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+				pMesh[idx]->PrepareNewIteration();
+			}
+
+			multirate_energy_density = 0.0;
+
+			for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+				if (!pMesh[idx]->is_atomistic()) multirate_energy_density += (pMesh[idx]->UpdateModules() * energy_density_weights[idx]);
+			}
+
+			for (int idx = 0; idx < (int)pSMod.size(); idx++) {
+
+				multirate_energy_density += pSMod[idx]->UpdateField();
+			}
+
+			odeSolver.Iterate();
+
+		} while (!odeSolver.TimeStepSolved());
+
+		odeSolver.Multirate_End_SlowStep();
+	}
+
+	//2. atomistic time step : micromagnetic magnetization is interpolated to each evaluation time, so coupling fields follow it, but micromagnetic effective fields are not computed (restored from the micromagnetic time step after the atomistic step)
+	//the total energy density is kept from the micromagnetic time step evaluation (micromagnetic meshes and super-mesh modules), with atomistic mesh contributions added from the atomistic step
+	odeSolver.Multirate_Begin_FastStep();
+
+	do {
+
+		odeSolver.Multirate_Interpolate();
+
+		for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+			pMesh[idx]->PrepareNewIteration();
+		}
+
+		total_energy_density = multirate_energy_density;
+
+		for (int idx = 0; idx < (int)pMesh.size(); idx++) {
+
+			if (pMesh[idx]->is_atomistic()) total_energy_density += (pMesh[idx]->UpdateModules() * energy_density_weights[idx]);
+		}
+
+		for (int idx = 0; idx < (int)pSMod.size(); idx++) {
+
+			pSMod[idx]->UpdateField();
+		}
+
+		odeSolver.Iterate();
+
+	} while (!odeSolver.TimeStepSolved());
+
+	odeSolver.Multirate_End_FastStep();
 }
 
 #if COMPILECUDA == 1
@@ -235,6 +325,16 @@ void SuperMesh::UpdateTransportSolverCUDA(void)
 //Take a Monte Carlo step over all atomistic meshes using settings in each mesh; increase the iterations counters.
 void SuperMesh::Iterate_MonteCarlo(double acceptance_rate)
 {
+	if (ParallelTempering_Enabled()) {
+
+		Iterate_MonteCarlo_ParallelTempering(acceptance_rate);
+
+		//Increment iterations counters only (stage and global iterations)
+		odeSolver.Increment();
+
+		return;
+	}
+
 	for (int idx = 0; idx < (int)pMesh.size(); idx++) {
 
 		//Iterate Monte Carlo Metropolis algorithm
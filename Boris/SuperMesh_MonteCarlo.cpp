@@ -64,5 +64,29 @@ BError SuperMesh::Set_MonteCarlo_Disabled(bool status, std::string meshName)
 
 	pMesh[meshName]->Set_MonteCarlo_Disabled(status);
 
+	return error;
+}
+
+//set number of over-relaxation sweeps and enable/disable cluster updates taken after every Metropolis step in given mesh - all if meshName is the supermesh handle
+BError SuperMesh::Set_MonteCarlo_Moves(int overrelax, bool cluster, std::string meshName)
+{
+	BError error(__FUNCTION__);
+
+	if (!contains(meshName) && meshName != superMeshHandle) return error(BERROR_INCORRECTNAME);
+
+	if (meshName == superMeshHandle) {
+
+		//all meshes
+		for (int idx = 0; idx < pMesh.size(); idx++) {
+
+			pMesh[idx]->Set_MonteCarlo_Moves(overrelax, cluster);
+		}
+	}
+	else {
+
+		//named mesh only
+		pMesh[meshName]->Set_MonteCarlo_Moves(overrelax, cluster);
+	}
+
 	return error;
 }
\ No newline at end of file
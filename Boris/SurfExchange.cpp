@@ -212,6 +212,9 @@ double SurfExchange::UpdateField(void)
 	if (pMesh_Top.size() || paMesh_Top.size()) {
 
 		//surface exchange coupling at the top
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 		#pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -329,17 +332,23 @@ double SurfExchange::UpdateField(void)
 				}
 				
 				pMesh->Heff[cell_idx] += Hsurfexch;
-				energy += cell_energy;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[cell_idx] += Hsurfexch;
 				if (Module_energy.linear_size()) Module_energy[cell_idx] += cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 
 	if (pMesh_Bot.size() || paMesh_Bot.size()) {
 
 		//surface exchange coupling at the bottom
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 		#pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -450,12 +459,15 @@ double SurfExchange::UpdateField(void)
 				}
 
 				pMesh->Heff[cell_idx] += Hsurfexch;
-				energy += cell_energy;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 
 				if (Module_Heff.linear_size()) Module_Heff[cell_idx] += Hsurfexch;
 				if (Module_energy.linear_size()) Module_energy[cell_idx] += cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 	
 	energy /= pMesh->M.get_nonempty_cells();
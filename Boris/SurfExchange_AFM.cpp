@@ -194,6 +194,9 @@ double SurfExchange_AFM::UpdateField(void)
 	if (pMesh_Top.size()) {
 
 		//surface exchange coupling at the top
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 #pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -325,14 +328,21 @@ double SurfExchange_AFM::UpdateField(void)
 				if (Module_energy.linear_size()) Module_energy[cell_idx] += cell_energy1;
 				if (Module_energy2.linear_size()) Module_energy2[cell_idx] += cell_energy2;
 
-				energy += (cell_energy1 + cell_energy2) / 2;
+				double cell_energy = (cell_energy1 + cell_energy2) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 
 	if (pMesh_Bot.size()) {
 
 		//surface exchange coupling at the bottom
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.x * n.y);
+
 #pragma omp parallel for reduction(+:energy)
 		for (int j = 0; j < n.y; j++) {
 			for (int i = 0; i < n.x; i++) {
@@ -456,9 +466,13 @@ double SurfExchange_AFM::UpdateField(void)
 				if (Module_energy.linear_size()) Module_energy[cell_idx] += cell_energy1;
 				if (Module_energy2.linear_size()) Module_energy2[cell_idx] += cell_energy2;
 
-				energy += (cell_energy1 + cell_energy2) / 2;
+				double cell_energy = (cell_energy1 + cell_energy2) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, i + j * n.x);
+				else energy += cell_energy;
 			}
 		}
+
+		if (deterministic) energy += energy_reduction.sum();
 	}
 
 	energy /= pMesh->M.get_nonempty_cells();
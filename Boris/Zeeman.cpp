@@ -175,6 +175,9 @@ double Zeeman::UpdateField(void)
 
 			if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+				bool deterministic = OmpReduction_Deterministic();
+				if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 				for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -184,17 +187,24 @@ double Zeeman::UpdateField(void)
 					pMesh->Heff[idx] = Hext;
 					pMesh->Heff2[idx] = Hext;
 
-					energy += (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+					double cell_energy = (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+					if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+					else energy += cell_energy;
 
 					if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 					if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hext;
 					if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hext;
 					if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * pMesh->M2[idx] * Hext;
 				}
+
+				if (deterministic) energy = energy_reduction.sum();
 			}
 
 			else {
 
+				bool deterministic = OmpReduction_Deterministic();
+				if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 				for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -203,11 +213,15 @@ double Zeeman::UpdateField(void)
 
 					pMesh->Heff[idx] = Hext;
 
-					energy += pMesh->M[idx] * Hext;
+					double cell_energy = pMesh->M[idx] * Hext;
+					if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+					else energy += cell_energy;
 
 					if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 					if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hext;
 				}
+
+				if (deterministic) energy = energy_reduction.sum();
 			}
 		}
 		else {
@@ -218,6 +232,9 @@ double Zeeman::UpdateField(void)
 
 			if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+				bool deterministic = OmpReduction_Deterministic();
+				if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 				for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -230,17 +247,24 @@ double Zeeman::UpdateField(void)
 					pMesh->Heff[idx] = Hext;
 					pMesh->Heff2[idx] = Hext;
 
-					energy += (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+					double cell_energy = (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+					if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+					else energy += cell_energy;
 
 					if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 					if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hext;
 					if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hext;
 					if (Module_energy2.linear_size()) Module_energy2[idx] = -MU0 * pMesh->M2[idx] * Hext;
 				}
+
+				if (deterministic) energy = energy_reduction.sum();
 			}
 
 			else {
 
+				bool deterministic = OmpReduction_Deterministic();
+				if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 				for (int idx = 0; idx < pMesh->n.dim(); idx++) {
 
@@ -252,11 +276,15 @@ double Zeeman::UpdateField(void)
 
 					pMesh->Heff[idx] = Hext;
 
-					energy += pMesh->M[idx] * Hext;
+					double cell_energy = pMesh->M[idx] * Hext;
+					if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+					else energy += cell_energy;
 
 					if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 					if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hext;
 				}
+
+				if (deterministic) energy = energy_reduction.sum();
 			}
 		}
 	}
@@ -271,6 +299,9 @@ double Zeeman::UpdateField(void)
 
 		if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+			bool deterministic = OmpReduction_Deterministic();
+			if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 			for (int j = 0; j < pMesh->n.y; j++) {
 				for (int k = 0; k < pMesh->n.z; k++) {
@@ -291,7 +322,9 @@ double Zeeman::UpdateField(void)
 						pMesh->Heff[idx] = Hext;
 						pMesh->Heff2[idx] = Hext;
 
-						energy += (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+						double cell_energy = (pMesh->M[idx] + pMesh->M2[idx]) * Hext / 2;
+						if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+						else energy += cell_energy;
 
 						if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 						if (Module_Heff2.linear_size()) Module_Heff2[idx] = Hext;
@@ -300,10 +333,15 @@ double Zeeman::UpdateField(void)
 					}
 				}
 			}
+
+			if (deterministic) energy = energy_reduction.sum();
 		}
 
 		else {
 
+			bool deterministic = OmpReduction_Deterministic();
+			if (deterministic) energy_reduction.new_sum_reduction(pMesh->n.dim());
+
 #pragma omp parallel for reduction(+:energy)
 			for (int j = 0; j < pMesh->n.y; j++) {
 				for (int k = 0; k < pMesh->n.z; k++) {
@@ -323,13 +361,17 @@ double Zeeman::UpdateField(void)
 
 						pMesh->Heff[idx] = Hext;
 
-						energy += pMesh->M[idx] * Hext;
+						double cell_energy = pMesh->M[idx] * Hext;
+						if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+						else energy += cell_energy;
 
 						if (Module_Heff.linear_size()) Module_Heff[idx] = Hext;
 						if (Module_energy.linear_size()) Module_energy[idx] = -MU0 * pMesh->M[idx] * Hext;
 					}
 				}
 			}
+
+			if (deterministic) energy = energy_reduction.sum();
 		}
 	}
 
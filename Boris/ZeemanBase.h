@@ -58,6 +58,9 @@ public:
 	virtual void SetField(DBL3 Hxyz) = 0;
 	virtual DBL3 GetField(void) = 0;
 
+	//is the applied field uniform (Ha only, modulated by cHA) : no field equation, field VEC or global field set?
+	bool IsUniformField(void) { return !H_equation.is_set() && !Havec.linear_size() && !globalField.linear_size(); }
+
 	virtual BError SetFieldEquation(std::string equation_string, int step) = 0;
 
 	virtual BError SetFieldVEC_FromOVF2(std::string fileName) = 0;
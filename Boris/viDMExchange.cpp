@@ -117,6 +117,9 @@ double viDMExchange::UpdateField(void)
 
 	if (pMesh->GetMeshType() == MESH_FERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.dim());
+
 #pragma omp parallel for reduction(+:energy) 
 		for (int idx = 0; idx < n.dim(); idx++) {
 
@@ -217,7 +220,9 @@ double viDMExchange::UpdateField(void)
 
 				pMesh->Heff[idx] += Hexch_A + Hexch_D;
 
-				energy += pMesh->M[idx] * (Hexch_A + Hexch_D);
+				double cell_energy = pMesh->M[idx] * (Hexch_A + Hexch_D);
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				//spatial dependence display of effective field and energy density
 				if (Module_Heff.linear_size() && Module_energy.linear_size()) {
@@ -237,6 +242,8 @@ double viDMExchange::UpdateField(void)
 				}
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -245,6 +252,9 @@ double viDMExchange::UpdateField(void)
 
 	else if (pMesh->GetMeshType() == MESH_ANTIFERROMAGNETIC) {
 
+		bool deterministic = OmpReduction_Deterministic();
+		if (deterministic) energy_reduction.new_sum_reduction(n.dim());
+
 #pragma omp parallel for reduction(+:energy) 
 		for (int idx = 0; idx < n.dim(); idx++) {
 
@@ -401,7 +411,9 @@ double viDMExchange::UpdateField(void)
 				pMesh->Heff[idx] += (Hexch_A + Hexch_D);
 				pMesh->Heff2[idx] += (Hexch_A2 + Hexch_D2);
 
-				energy += (pMesh->M[idx] * (Hexch_A + Hexch_D) + pMesh->M2[idx] * (Hexch_A2 + Hexch_D2)) / 2;
+				double cell_energy = (pMesh->M[idx] * (Hexch_A + Hexch_D) + pMesh->M2[idx] * (Hexch_A2 + Hexch_D2)) / 2;
+				if (deterministic) energy_reduction.reduce_sum(cell_energy, idx);
+				else energy += cell_energy;
 
 				//spatial dependence display of effective field and energy density
 				if (Module_Heff.linear_size() && Module_energy.linear_size()) {
@@ -437,6 +449,8 @@ double viDMExchange::UpdateField(void)
 				}
 			}
 		}
+
+		if (deterministic) energy = energy_reduction.sum();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -27,6 +27,18 @@
 
 //omp_reduction.minmax();
 
+//Deterministic mode (average and sum reductions) :
+
+//The per-thread partial results above are combined in an order which depends on the number of threads and on loop scheduling, so floating point results can differ between machines and thread counts.
+//If OmpReduction_Deterministic() is set, and the reduction is started with the number of loop indexes (e.g. omp_reduction.new_average_reduction(n.dim())) then reduced with the loop index (omp_reduction.reduce_average(loop_value, idx)),
+//values are stored per index, then summed sequentially in fixed-size chunks and the chunk sums combined pairwise in a fixed order. The result is then bitwise reproducible, independent of the number of threads.
+
+//chunk size (number of indexes) used for deterministic reductions
+#define OMPREDUCTION_CHUNK	256
+
+//deterministic reductions mode for all OmpReduction objects (false by default)
+inline bool& OmpReduction_Deterministic(void) { static bool deterministic = false; return deterministic; }
+
 
 template <typename Type>
 class OmpReduction {
@@ -52,6 +64,92 @@ class OmpReduction {
 	//plain reduction (sum all values) but works for any Type with addition operator
 	std::vector<Type> sum_reduction;
 
+	//deterministic mode : values stored per index (and for average reductions, which indexes have been set), and partial sums for each chunk
+	//empty if deterministic mode not in use for the current reduction
+	std::vector<Type> deterministic_values;
+	std::vector<char> deterministic_set;
+	std::vector<Type> deterministic_chunks;
+	std::vector<int> deterministic_chunks_points;
+
+	//start a deterministic reduction over num_indexes indexes if deterministic mode is set, else free memory
+	void new_deterministic_reduction(int num_indexes, bool count_points)
+	{
+		if (!OmpReduction_Deterministic() || num_indexes <= 0) {
+
+			if (deterministic_values.size()) {
+
+				deterministic_values.clear(); deterministic_values.shrink_to_fit();
+				deterministic_set.clear(); deterministic_set.shrink_to_fit();
+			}
+
+			return;
+		}
+
+		if ((int)deterministic_values.size() != num_indexes) deterministic_values.resize(num_indexes);
+		if (count_points && (int)deterministic_set.size() != num_indexes) deterministic_set.resize(num_indexes);
+		else if (!count_points && deterministic_set.size()) { deterministic_set.clear(); deterministic_set.shrink_to_fit(); }
+
+#pragma omp parallel for
+		for (int idx = 0; idx < num_indexes; idx++) {
+
+			deterministic_values[idx] = Type();
+			if (count_points) deterministic_set[idx] = false;
+		}
+	}
+
+	//sum stored values : sequential sums over fixed-size chunks (chunks computed in parallel), then chunk sums combined pairwise in a fixed order. Also count set values if needed.
+	Type deterministic_sum(int& points_count)
+	{
+		int num_indexes = deterministic_values.size();
+		int num_chunks = (num_indexes + OMPREDUCTION_CHUNK - 1) / OMPREDUCTION_CHUNK;
+
+		points_count = 0;
+		if (!num_chunks) return Type();
+
+		if ((int)deterministic_chunks.size() != num_chunks) {
+
+			deterministic_chunks.resize(num_chunks);
+			deterministic_chunks_points.resize(num_chunks);
+		}
+
+		bool count_points = deterministic_set.size();
+
+#pragma omp parallel for
+		for (int chunk = 0; chunk < num_chunks; chunk++) {
+
+			Type chunk_sum = Type();
+			int chunk_points = 0;
+
+			int end = (chunk + 1) * OMPREDUCTION_CHUNK;
+			if (end > num_indexes) end = num_indexes;
+
+			for (int idx = chunk * OMPREDUCTION_CHUNK; idx < end; idx++) {
+
+				if (count_points && !deterministic_set[idx]) continue;
+
+				chunk_sum += deterministic_values[idx];
+				chunk_points++;
+			}
+
+			deterministic_chunks[chunk] = chunk_sum;
+			deterministic_chunks_points[chunk] = chunk_points;
+		}
+
+		//pairwise combination tree : at each level combine chunk i with chunk i + stride
+		for (int stride = 1; stride < num_chunks; stride *= 2) {
+
+			for (int chunk = 0; chunk + stride < num_chunks; chunk += 2 * stride) {
+
+				deterministic_chunks[chunk] += deterministic_chunks[chunk + stride];
+				deterministic_chunks_points[chunk] += deterministic_chunks_points[chunk + stride];
+			}
+		}
+
+		points_count = deterministic_chunks_points[0];
+
+		return deterministic_chunks[0];
+	}
+
 public:
 
 	//values available after reduction
@@ -438,11 +536,38 @@ public:
 		average_reduction[tn] = (average_reduction[tn] * (average_reduction_points[tn] - 1) + value) / average_reduction_points[tn];
 	}
 
+	//call this before starting a new average reduction, with the number of loop indexes : deterministic mode is used if set (reduce with reduce_average(value, idx))
+	void new_average_reduction(int num_indexes)
+	{
+		new_deterministic_reduction(num_indexes, true);
+		if (!deterministic_values.size()) new_average_reduction();
+	}
+
+	//reduce for average during a loop, with the loop index : deterministic mode if started with new_average_reduction(num_indexes)
+	void reduce_average(Type value, int idx)
+	{
+		if (deterministic_values.size()) {
+
+			deterministic_values[idx] = value;
+			deterministic_set[idx] = true;
+		}
+		else reduce_average(value);
+	}
+
 	//call this after a loop to get the final average
 	Type average(void)
 	{
 		av = Type();
 
+		if (deterministic_values.size()) {
+
+			int points_count = 0;
+			Type sum_values = deterministic_sum(points_count);
+			if (points_count) av = sum_values / points_count;
+
+			return av;
+		}
+
 		//count total points
 		int points_count = 0;
 		for (int idx = 0; idx < OmpThreads; idx++) {
@@ -483,11 +608,36 @@ public:
 		sum_reduction[tn] += value;
 	}
 
-	//call this after a loop to get the final average
+	//call this before starting a new sum reduction, with the number of loop indexes : deterministic mode is used if set (reduce with reduce_sum(value, idx))
+	void new_sum_reduction(int num_indexes)
+	{
+		new_deterministic_reduction(num_indexes, false);
+		if (!deterministic_values.size()) new_sum_reduction();
+	}
+
+	//reduce during a loop, with the loop index : deterministic mode if started with new_sum_reduction(num_indexes)
+	void reduce_sum(Type value, int idx)
+	{
+		if (deterministic_values.size()) deterministic_values[idx] = value;
+		else reduce_sum(value);
+	}
+
+	//is the current (average or sum) reduction in deterministic mode?
+	bool is_deterministic(void) { return deterministic_values.size(); }
+
+	//call this after a loop to get the final sum
 	Type sum(void)
 	{
 		total = Type();
 
+		if (deterministic_values.size()) {
+
+			int points_count = 0;
+			total = deterministic_sum(points_count);
+
+			return total;
+		}
+
 		for (int idx = 0; idx < OmpThreads; idx++) {
 
 			total += sum_reduction[idx];
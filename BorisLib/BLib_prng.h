@@ -4,6 +4,9 @@
 #include <vector>
 #include "Funcs_Math_base.h"
 
+//number of 4-value blocks generated together by BorisCBRand bulk generation
+#define PRNG_CHUNK	64
+
 //Very simple pseudo-random number generator based on LCG (linear congruential generator) with textbook values (modulus 2^32 used). Can be used in multi-threaded code.
 //This is much faster than the standard random number generator in <random> (over 5 times faster in testing)
 
@@ -19,11 +22,18 @@ class BorisRand {
 
 private:
 
-	//the random numbers: one per thread (prn size is equal to number of threads)
-	std::vector<unsigned> prn;
+	//per-thread generator state, padded to a cache line so threads generating numbers at the same time do not write to the same cache line (false sharing)
+	struct alignas(64) LCGState {
+
+		//the random number
+		unsigned prn;
 
-	//count number of random numbers generated between calls to check_periodicity : if this divides the LCG period it could be problematic so need to adjust
-	std::vector<unsigned> period;
+		//count number of random numbers generated between calls to check_periodicity : if this divides the LCG period it could be problematic so need to adjust
+		unsigned period;
+	};
+
+	//one state per thread (size is equal to number of threads)
+	std::vector<LCGState> state;
 	//set to true on first call to check_periodicity
 	bool calculate_period = false;
 
@@ -32,14 +42,13 @@ public:
 	BorisRand(unsigned seed)
 	{
 		int OmpThreads = omp_get_num_procs();
-		prn.resize(OmpThreads);
-		period.resize(OmpThreads);
+		state.resize(OmpThreads);
 
 		//seed all threads
 		for (int idx = 0; idx < OmpThreads; idx++) {
 
-			prn[idx] = seed * (idx + 1);
-			period[idx] = 0;
+			state[idx].prn = seed * (idx + 1);
+			state[idx].period = 0;
 		}
 	}
 
@@ -47,17 +56,17 @@ public:
 	{
 		calculate_period = true;
 
-		for (int idx = 0; idx < period.size(); idx++) {
+		for (int idx = 0; idx < state.size(); idx++) {
 
 			//if the generation period at this point matches the LCG period then notch generation by 1 point, i.e. increase period by 1.
-			if (period[idx] && (unsigned)4294967295 % period[idx] == period[idx] - 1) {
+			if (state[idx].period && (unsigned)4294967295 % state[idx].period == state[idx].period - 1) {
 
-				prn[idx] = ((unsigned)1664525 * prn[idx] + (unsigned)1013904223);
+				state[idx].prn = ((unsigned)1664525 * state[idx].prn + (unsigned)1013904223);
 
 				//reset period : set to 1 since a point has already been generated
-				period[idx] = 1;
+				state[idx].period = 1;
 			}
-			else period[idx] = 0;
+			else state[idx].period = 0;
 		}
 	}
 
@@ -67,12 +76,12 @@ public:
 		int tn = omp_get_thread_num();
 
 		//LCG equation used to generate next number in sequence : the modulo operation is free since unsigned is 32 bits wide
-		prn[tn] = ((unsigned)1664525 * prn[tn] + (unsigned)1013904223);
+		state[tn].prn = ((unsigned)1664525 * state[tn].prn + (unsigned)1013904223);
 
 		//count number of points generated on this thread since last call to check_periodicity
-		if (calculate_period) period[tn]++;
+		if (calculate_period) state[tn].period++;
 
-		return prn[tn];
+		return state[tn].prn;
 	}
 
 	//floating point value out in interval [0, 1]
@@ -80,12 +89,12 @@ public:
 	{
 		int tn = omp_get_thread_num();
 
-		prn[tn] = ((unsigned)1664525 * prn[tn] + (unsigned)1013904223);
+		state[tn].prn = ((unsigned)1664525 * state[tn].prn + (unsigned)1013904223);
 
 		//count number of points generated on this thread since last call to check_periodicity
-		if (calculate_period) period[tn]++;
+		if (calculate_period) state[tn].period++;
 
-		return (double)prn[tn] / (unsigned)4294967295;
+		return (double)state[tn].prn / (unsigned)4294967295;
 	}
 
 	//Box-Muller transform to generate Gaussian distribution from uniform distribution
@@ -110,3 +119,143 @@ public:
 		return z0 * std + mean;
 	}
 };
+
+//Counter-based pseudo-random number generator : Philox4x32-10 from J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11 (2011).
+//There is no generator state : each output block of 4 random 32-bit integers is a bijective function (10 rounds of multiply-xor mixing) of a 128-bit counter, keyed by the seed.
+//The counter is formed from (step, idx, stream), so the random numbers for a given cell index at a given step are always the same, irrespective of which thread generates them or in what order.
+//Thus results for a given seed do not depend on the number of threads, there is no shared state (no false sharing), and cells can be generated in any order, or vectorized.
+//Typical use : call advance() once per generation step (outside parallel loops), then either call rand_gauss4(idx, stream, z) for each cell in a parallel loop, or rand_gauss_fill for bulk generation.
+
+class BorisCBRand {
+
+private:
+
+	//Philox4x32 multipliers and Weyl sequence key increments
+	static const unsigned PHILOX_M0 = 0xD2511F53;
+	static const unsigned PHILOX_M1 = 0xCD9E8D57;
+	static const unsigned PHILOX_W0 = 0x9E3779B9;
+	static const unsigned PHILOX_W1 = 0xBB67AE85;
+
+	//the key, obtained from the seed
+	unsigned key[2];
+
+	//current generation step (forms the upper half of the counter)
+	unsigned long long step = 0;
+
+private:
+
+	//single Philox round
+	static void philox_round(unsigned* ctr, const unsigned* k)
+	{
+		unsigned long long prod0 = (unsigned long long)PHILOX_M0 * ctr[0];
+		unsigned long long prod1 = (unsigned long long)PHILOX_M1 * ctr[2];
+
+		unsigned hi0 = (unsigned)(prod0 >> 32), lo0 = (unsigned)prod0;
+		unsigned hi1 = (unsigned)(prod1 >> 32), lo1 = (unsigned)prod1;
+
+		ctr[0] = hi1 ^ ctr[1] ^ k[0];
+		ctr[1] = lo1;
+		ctr[2] = hi0 ^ ctr[3] ^ k[1];
+		ctr[3] = lo0;
+	}
+
+public:
+
+	BorisCBRand(unsigned seed) { this->seed(seed); }
+
+	//set new key from seed, and restart from step 0
+	void seed(unsigned seed)
+	{
+		key[0] = seed;
+		key[1] = 0x426F7269;
+		step = 0;
+	}
+
+	//move to next generation step : call once before each generation pass (not from within a parallel loop)
+	void advance(void) { step++; }
+
+	unsigned long long get_step(void) { return step; }
+
+	//4 random 32-bit integers for given cell index and stream (e.g. 0 for field, 1 for torque) at given step. Thread-safe : no state is modified.
+	void randi4(unsigned long long step, unsigned idx, unsigned stream, unsigned* out) const
+	{
+		unsigned ctr[4] = { (unsigned)step, (unsigned)(step >> 32), idx, stream };
+		unsigned k[2] = { key[0], key[1] };
+
+		philox_round(ctr, k);
+
+		for (int round = 1; round < 10; round++) {
+
+			k[0] += PHILOX_W0;
+			k[1] += PHILOX_W1;
+			philox_round(ctr, k);
+		}
+
+		out[0] = ctr[0]; out[1] = ctr[1]; out[2] = ctr[2]; out[3] = ctr[3];
+	}
+
+	//4 independent Gaussian random numbers (mean 0, std 1) for given cell index and stream at given step, using Box-Muller on the 4 random integers
+	void rand_gauss4(unsigned long long step, unsigned idx, unsigned stream, double* z) const
+	{
+		unsigned r[4];
+		randi4(step, idx, stream, r);
+
+		//uniform values in the open interval (0, 1), so log is always finite
+		double u1 = ((double)r[0] + 0.5) / 4294967296.0;
+		double u2 = ((double)r[1] + 0.5) / 4294967296.0;
+		double u3 = ((double)r[2] + 0.5) / 4294967296.0;
+		double u4 = ((double)r[3] + 0.5) / 4294967296.0;
+
+		double rad1 = sqrt(-2.0 * log(u1)), rad2 = sqrt(-2.0 * log(u3));
+
+		z[0] = rad1 * cos(TWO_PI * u2);
+		z[1] = rad1 * sin(TWO_PI * u2);
+		z[2] = rad2 * cos(TWO_PI * u4);
+		z[3] = rad2 * sin(TWO_PI * u4);
+	}
+
+	//as above at the current step
+	void rand_gauss4(unsigned idx, unsigned stream, double* z) const { rand_gauss4(step, idx, stream, z); }
+
+	//bulk generation at the current step : fill out with num Gaussian random numbers (mean 0, std 1), taking 4 values from each block counter (step, block index, stream).
+	//Blocks are processed in chunks : first the Philox rounds for the whole chunk, then the Box-Muller transform for the whole chunk, as separate loops which can be vectorized.
+	//Chunks are split between threads, and since each block only depends on its counter the result does not depend on the number of threads.
+	void rand_gauss_fill(int num, unsigned stream, double* out) const
+	{
+		int num_blocks = (num + 3) / 4;
+		int num_chunks = (num_blocks + PRNG_CHUNK - 1) / PRNG_CHUNK;
+
+#pragma omp parallel for
+		for (int chunk = 0; chunk < num_chunks; chunk++) {
+
+			int start_block = chunk * PRNG_CHUNK;
+			int blocks = (num_blocks - start_block < PRNG_CHUNK ? num_blocks - start_block : PRNG_CHUNK);
+
+			unsigned r[4 * PRNG_CHUNK];
+			double z[4 * PRNG_CHUNK];
+
+#pragma omp simd
+			for (int b = 0; b < blocks; b++) randi4(step, start_block + b, stream, r + 4 * b);
+
+#pragma omp simd
+			for (int b = 0; b < blocks; b++) {
+
+				double u1 = ((double)r[4 * b + 0] + 0.5) / 4294967296.0;
+				double u2 = ((double)r[4 * b + 1] + 0.5) / 4294967296.0;
+				double u3 = ((double)r[4 * b + 2] + 0.5) / 4294967296.0;
+				double u4 = ((double)r[4 * b + 3] + 0.5) / 4294967296.0;
+
+				double rad1 = sqrt(-2.0 * log(u1)), rad2 = sqrt(-2.0 * log(u3));
+
+				z[4 * b + 0] = rad1 * cos(TWO_PI * u2);
+				z[4 * b + 1] = rad1 * sin(TWO_PI * u2);
+				z[4 * b + 2] = rad2 * cos(TWO_PI * u4);
+				z[4 * b + 3] = rad2 * sin(TWO_PI * u4);
+			}
+
+			//last block may be partially used
+			int values = (4 * (start_block + blocks) <= num ? 4 * blocks : num - 4 * start_block);
+			for (int v = 0; v < values; v++) out[4 * start_block + v] = z[v];
+		}
+	}
+};
@@ -21,6 +21,9 @@ struct __ReIm {
 
 	//----------------------------- CONVERTING CONSTRUCTORS
 
+	//type conversion constructor (e.g. float to double precision)
+	template <typename CType> __ReIm(const __ReIm<CType> &convThis) { Re = (Type)convThis.Re; Im = (Type)convThis.Im; }
+
 	//copy constructor
 	__ReIm(const __ReIm &copyThis) { Re = copyThis.Re; Im = copyThis.Im; }
 
@@ -125,6 +128,9 @@ struct __ReIm3 {
 	
 	//----------------------------- CONVERTING CONSTRUCTORS
 
+	//type conversion constructor (e.g. float to double precision)
+	template <typename CType> __ReIm3(const __ReIm3<CType> &convThis) { x = __ReIm<Type>(convThis.x); y = __ReIm<Type>(convThis.y); z = __ReIm<Type>(convThis.z); }
+
 	//copy constructor
 	__ReIm3(const __ReIm3 &copyThis) { x = copyThis.x; y = copyThis.y; z = copyThis.z; }
 
@@ -207,4 +213,7 @@ struct __ReIm3 {
 };
 
 //this is the most common type to use : double precision.
-typedef __ReIm3<double> ReIm3;
\ No newline at end of file
+typedef __ReIm3<double> ReIm3;
+
+//single precision version, e.g. for single precision fft scratch spaces
+typedef __ReIm3<float> ReIm3F;
\ No newline at end of file
@@ -444,6 +444,9 @@ public:
 	//clear all skip cell flags
 	void clear_skipcells(void);
 
+	//mark single cell to be skipped during some computations (if status true, else clear the skip cell flag)
+	void set_skipcell(int index, bool status = true) { if (status) ngbrFlags[index] |= NF_SKIPCELL; else ngbrFlags[index] &= ~NF_SKIPCELL; }
+
 	void set_robin_conditions(DBL2 robin_v_, DBL2 robin_px_, DBL2 robin_nx_, DBL2 robin_py_, DBL2 robin_ny_, DBL2 robin_pz_, DBL2 robin_nz_);
 
 	//clear all Robin boundary conditions and values
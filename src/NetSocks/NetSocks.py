@@ -891,6 +891,10 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("2dmulticonvolution", [status])
     	self.SendCommand("buffercommand", ["2dmulticonvolution", status])
     
+    def activeset(self, threshold = '', halo = '', period = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("activeset", [threshold, halo, period])
+    	self.SendCommand("buffercommand", ["activeset", threshold, halo, period])
+    
     def addafmesh(self, name = '', rectangle = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("addafmesh", [name, rectangle])
     	self.SendCommand("buffercommand", ["addafmesh", name, rectangle])
@@ -962,6 +966,10 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("ambient", [meshname, ambient_temperature])
     	self.SendCommand("buffercommand", ["ambient", meshname, ambient_temperature])
     
+    def astepcontroller(self, type = '', kI = '', kP = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("astepcontroller", [type, kI, kP])
+    	self.SendCommand("buffercommand", ["astepcontroller", type, kI, kP])
+    
     def astepctrl(self, err_fail = '', dT_incr = '', dT_min = '', dT_max = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("astepctrl", [err_fail, dT_incr, dT_min, dT_max])
     	self.SendCommand("buffercommand", ["astepctrl", err_fail, dT_incr, dT_min, dT_max])
@@ -976,6 +984,19 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("averagemeshrect", [meshname, quantity, rectangle, dp_index])
     	self.SendCommand("buffercommand", ["averagemeshrect", meshname, quantity, rectangle, dp_index])
     
+    def benchffttiling(self, n = '', repeats = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("benchffttiling", [n, repeats])
+    	self.SendCommand("buffercommand", ["benchffttiling", n, repeats])
+    
+    def benchkernelsimd(self, length = '', repeats = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("benchkernelsimd", [length, repeats])
+    	self.SendCommand("buffercommand", ["benchkernelsimd", length, repeats])
+    
+    def benchode(self, meshname = '', repeats = '', bufferCommand = False):
+    	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
+    	if not bufferCommand: return self.SendCommand("benchode", [meshname, repeats])
+    	self.SendCommand("buffercommand", ["benchode", meshname, repeats])
+    
     def benchtime(self, bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("benchtime")
     	self.SendCommand("buffercommand", ["benchtime"])
@@ -1057,6 +1078,10 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("computefields")
     	self.SendCommand("buffercommand", ["computefields"])
     
+    def convprofiling(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("convprofiling", [status])
+    	self.SendCommand("buffercommand", ["convprofiling", status])
+    
     def copymeshdata(self, meshname_from = '', meshname_to = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("copymeshdata", [meshname_from, meshname_to])
     	self.SendCommand("buffercommand", ["copymeshdata", meshname_from, meshname_to])
@@ -1142,10 +1167,27 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("delsurfacestress", [index])
     	self.SendCommand("buffercommand", ["delsurfacestress", index])
     
+    def demagasymptotic(self, distance = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("demagasymptotic", [distance])
+    	self.SendCommand("buffercommand", ["demagasymptotic", distance])
+    
+    def demagkernelcache(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("demagkernelcache", [status])
+    	self.SendCommand("buffercommand", ["demagkernelcache", status])
+    
+    def demagtree(self, meshname = '', near_distance = '', opening_angle = '', bufferCommand = False):
+    	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
+    	if not bufferCommand: return self.SendCommand("demagtree", [meshname, near_distance, opening_angle])
+    	self.SendCommand("buffercommand", ["demagtree", meshname, near_distance, opening_angle])
+    
     def designateground(self, electrode_index = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("designateground", [electrode_index])
     	self.SendCommand("buffercommand", ["designateground", electrode_index])
     
+    def deterministic(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("deterministic", [status])
+    	self.SendCommand("buffercommand", ["deterministic", status])
+    
     def dipolevelocity(self, meshname = '', velocity = '', clipping = '', bufferCommand = False):
     	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
     	if not bufferCommand: return self.SendCommand("dipolevelocity", [meshname, velocity, clipping])
@@ -1531,6 +1573,10 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("electrodes")
     	self.SendCommand("buffercommand", ["electrodes"])
     
+    def ensemble(self, replicas = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("ensemble", [replicas])
+    	self.SendCommand("buffercommand", ["ensemble", replicas])
+    
     def equationconstants(self, name = '', value = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("equationconstants", [name, value])
     	self.SendCommand("buffercommand", ["equationconstants", name, value])
@@ -1557,6 +1603,27 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("excludemulticonvdemag", [meshname, status])
     	self.SendCommand("buffercommand", ["excludemulticonvdemag", meshname, status])
     
+    def fftpadding(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("fftpadding", [status])
+    	self.SendCommand("buffercommand", ["fftpadding", status])
+    
+    def fftprecisioncheck(self, meshname = '', bufferCommand = False):
+    	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
+    	if not bufferCommand: return self.SendCommand("fftprecisioncheck", [meshname])
+    	self.SendCommand("buffercommand", ["fftprecisioncheck", meshname])
+    
+    def fftsingleprecision(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("fftsingleprecision", [status])
+    	self.SendCommand("buffercommand", ["fftsingleprecision", status])
+    
+    def ffttiling(self, status = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("ffttiling", [status])
+    	self.SendCommand("buffercommand", ["ffttiling", status])
+    
+    def fftwplanner(self, level = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("fftwplanner", [level])
+    	self.SendCommand("buffercommand", ["fftwplanner", level])
+    
     def flower(self, meshname = '', direction = '', radius = '', thickness = '', centre = '', bufferCommand = False):
     	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
     	if not bufferCommand: return self.SendCommand("flower", [meshname, direction, radius, thickness, centre])
@@ -1590,6 +1657,26 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("getvalue", [meshname, quantity, position])
     	self.SendCommand("buffercommand", ["getvalue", meshname, quantity, position])
     
+    def gneb(self, images = '', iterations = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("gneb", [images, iterations])
+    	self.SendCommand("buffercommand", ["gneb", images, iterations])
+    
+    def gnebendpoint(self, endpoint = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("gnebendpoint", [endpoint])
+    	self.SendCommand("buffercommand", ["gnebendpoint", endpoint])
+    
+    def gnebimage(self, index = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("gnebimage", [index])
+    	self.SendCommand("buffercommand", ["gnebimage", index])
+    
+    def gnebmep(self, dp_coord = '', dp_energy = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("gnebmep", [dp_coord, dp_energy])
+    	self.SendCommand("buffercommand", ["gnebmep", dp_coord, dp_energy])
+    
+    def gnebsettings(self, spring = '', climbing = '', step = '', tolerance = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("gnebsettings", [spring, climbing, step, tolerance])
+    	self.SendCommand("buffercommand", ["gnebsettings", spring, climbing, step, tolerance])
+    
     def gpukernels(self, status = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("gpukernels", [status])
     	self.SendCommand("buffercommand", ["gpukernels", status])
@@ -1620,6 +1707,10 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("iterupdate", [iterations])
     	self.SendCommand("buffercommand", ["iterupdate", iterations])
     
+    def kernelsimd(self, level = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("kernelsimd", [level])
+    	self.SendCommand("buffercommand", ["kernelsimd", level])
+    
     def linkdtelastic(self, flag = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("linkdtelastic", [flag])
     	self.SendCommand("buffercommand", ["linkdtelastic", flag])
@@ -1716,6 +1807,11 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("mcellsize", [meshname, value])
     	self.SendCommand("buffercommand", ["mcellsize", meshname, value])
     
+    def mcmoves(self, meshname = '', overrelax = '', cluster = '', bufferCommand = False):
+    	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
+    	if not bufferCommand: return self.SendCommand("mcmoves", [meshname, overrelax, cluster])
+    	self.SendCommand("buffercommand", ["mcmoves", meshname, overrelax, cluster])
+    
     def mcserial(self, meshname = '', value = '', bufferCommand = False):
     	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
     	if not bufferCommand: return self.SendCommand("mcserial", [meshname, value])
@@ -1770,6 +1866,14 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("multiconvolution", [status])
     	self.SendCommand("buffercommand", ["multiconvolution", status])
     
+    def multiconvtasks(self, mode = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("multiconvtasks", [mode])
+    	self.SendCommand("buffercommand", ["multiconvtasks", mode])
+    
+    def multirate(self, subcycles = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("multirate", [subcycles])
+    	self.SendCommand("buffercommand", ["multirate", subcycles])
+    
     def ncommon(self, sizes = '', bufferCommand = False):
     	if not bufferCommand: return self.SendCommand("ncommon", [sizes])
     	self.SendCommand("buffercommand", ["ncommon", sizes])
@@ -1804,6 +1908,14 @@ class NSClient:
     	if not bufferCommand: return self.SendCommand("openpotentialresistance", [resistance])
     	self.SendCommand("buffercommand", ["openpotentialresistance", resistance])
     
+    def paralleltempering(self, Tmin = '', Tmax = '', replicas = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("paralleltempering", [Tmin, Tmax, replicas])
+    	self.SendCommand("buffercommand", ["paralleltempering", Tmin, Tmax, replicas])
+    
+    def paralleltemperingdata(self, dp_T = '', dp_E = '', dp_C = '', dp_M = '', dp_swap = '', bufferCommand = False):
+    	if not bufferCommand: return self.SendCommand("paralleltemperingdata", [dp_T, dp_E, dp_C, dp_M, dp_swap])
+    	self.SendCommand("buffercommand", ["paralleltemperingdata", dp_T, dp_E, dp_C, dp_M, dp_swap])
+    
     def params(self, meshname = '', bufferCommand = False):
     	if issubclass(type(meshname), self.Mesh): meshname = meshname.meshname
     	if not bufferCommand: return self.SendCommand("params", [meshname])
@@ -4117,6 +4229,9 @@ class NSClient:
         def averagemeshrect(self, quantity = '', rectangle = '', dp_index = ''):
         	return self.ns.averagemeshrect(self.meshname, quantity, rectangle, dp_index)
         
+        def benchode(self, repeats = ''):
+        	return self.ns.benchode(self.meshname, repeats)
+        
         def blochpreparemovingmesh(self):
         	return self.ns.blochpreparemovingmesh(self.meshname)
         
@@ -4141,6 +4256,9 @@ class NSClient:
         def delrect(self, rectangle = ''):
         	return self.ns.delrect(self.meshname, rectangle)
         
+        def demagtree(self, near_distance = '', opening_angle = ''):
+        	return self.ns.demagtree(self.meshname, near_distance, opening_angle)
+        
         def dipolevelocity(self, velocity = '', clipping = ''):
         	return self.ns.dipolevelocity(self.meshname, velocity, clipping)
         
@@ -4276,6 +4394,9 @@ class NSClient:
         def mcellsize(self, value = ''):
         	return self.ns.mcellsize(self.meshname, value)
         
+        def mcmoves(self, overrelax = '', cluster = ''):
+        	return self.ns.mcmoves(self.meshname, overrelax, cluster)
+        
         def mcserial(self, value = ''):
         	return self.ns.mcserial(self.meshname, value)
         